@@ -0,0 +1,68 @@
+# Generates the built-in part of the profile catalog (title, beverage type,
+# recipe mode for every profile in resources/profiles) so the app doesn't
+# have to open and parse each bundled JSON file at startup.
+#
+# Usage: cmake -DPROFILES_DIR=<dir> -DOUTPUT_FILE=<header> [-DSTAMP_FILE=<stamp>] -P GenerateProfileCatalog.cmake
+
+file(GLOB PROFILE_FILES "${PROFILES_DIR}/*.json")
+list(SORT PROFILE_FILES)
+
+# C string literal; titles are UTF-8 and may contain quotes
+function(escape_c_string input output)
+    string(REPLACE "\\" "\\\\" escaped "${input}")
+    string(REPLACE "\"" "\\\"" escaped "${escaped}")
+    set(${output} "${escaped}" PARENT_SCOPE)
+endfunction()
+
+set(ENTRIES "")
+foreach(PROFILE_FILE ${PROFILE_FILES})
+    get_filename_component(NAME "${PROFILE_FILE}" NAME_WE)
+    file(READ "${PROFILE_FILE}" CONTENT)
+
+    string(JSON TITLE ERROR_VARIABLE TITLE_ERROR GET "${CONTENT}" title)
+    if(TITLE_ERROR)
+        set(TITLE "")
+    endif()
+    string(JSON BEVERAGE_TYPE ERROR_VARIABLE BEVERAGE_ERROR GET "${CONTENT}" beverage_type)
+    if(BEVERAGE_ERROR)
+        set(BEVERAGE_TYPE "")
+    endif()
+    string(JSON RECIPE_MODE ERROR_VARIABLE RECIPE_ERROR GET "${CONTENT}" is_recipe_mode)
+    if(NOT RECIPE_ERROR AND RECIPE_MODE)
+        set(RECIPE_MODE "true")
+    else()
+        set(RECIPE_MODE "false")
+    endif()
+
+    escape_c_string("${TITLE}" TITLE)
+    escape_c_string("${BEVERAGE_TYPE}" BEVERAGE_TYPE)
+    string(APPEND ENTRIES "    { \"${NAME}\", \"${TITLE}\", \"${BEVERAGE_TYPE}\", ${RECIPE_MODE} },\n")
+endforeach()
+
+set(HEADER "#pragma once
+// Auto-generated by cmake/GenerateProfileCatalog.cmake - do not edit directly
+
+struct BuiltInProfileEntry {
+    const char* filename;      // Without .json
+    const char* title;         // UTF-8
+    const char* beverageType;
+    bool isRecipeMode;
+};
+
+static const BuiltInProfileEntry BUILTIN_PROFILES[] = {
+${ENTRIES}};
+")
+
+# Only touch the file when it changes, so dependents don't rebuild needlessly
+if(EXISTS "${OUTPUT_FILE}")
+    file(READ "${OUTPUT_FILE}" EXISTING)
+endif()
+if(NOT "${EXISTING}" STREQUAL "${HEADER}")
+    file(WRITE "${OUTPUT_FILE}" "${HEADER}")
+endif()
+
+# The build tracks the stamp, which is always refreshed; the header keeps its
+# timestamp when nothing changed
+if(DEFINED STAMP_FILE)
+    file(TOUCH "${STAMP_FILE}")
+endif()
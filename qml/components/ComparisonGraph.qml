@@ -69,6 +69,7 @@ ChartView {
         }
 
         // Update axes - fit to data with small padding (minimum 15s for very short shots)
+        timeAxis.min = Math.floor(comparisonModel.minTime)
         timeAxis.max = Math.max(15, comparisonModel.maxTime + 0.5)
     }
 
@@ -17,6 +17,8 @@ ChartView {
     // Properties
     property var frames: []
     property int selectedFrameIndex: -1
+    // Simulated shot for these frames (MainController.predictCurrentProfile()), or null
+    property var prediction: null
 
     // Signals
     signal frameSelected(int index)
@@ -40,12 +42,15 @@ ChartView {
         return Math.max(total, 5)  // Minimum 5 seconds
     }
 
+    // Frames can run longer than the predicted shot, but not the other way round
+    property double axisDuration: Math.max(totalDuration, prediction ? prediction.shotTime || 0 : 0)
+
     // Time axis (X)
     ValueAxis {
         id: timeAxis
         min: 0
-        max: totalDuration * 1.1  // 10% padding
-        tickCount: Math.min(10, Math.max(3, Math.floor(totalDuration / 5) + 1))
+        max: axisDuration * 1.1  // 10% padding
+        tickCount: Math.min(10, Math.max(3, Math.floor(axisDuration / 5) + 1))
         labelFormat: "%.0f"
         labelsColor: Theme.textSecondaryColor
         labelsFont.pixelSize: Theme.scaled(12)
@@ -141,6 +146,37 @@ ChartView {
         axisYRight: tempAxis
     }
 
+    // Predicted weight axis (hidden): scaled to the predicted yield
+    ValueAxis {
+        id: predictedWeightAxis
+        visible: false
+        min: 0
+        max: prediction && prediction.finalWeight > 0 ? prediction.finalWeight * 1.2 : 50
+    }
+
+    // Predicted shot (solid, thin), drawn under the goal curves' dashes
+    LineSeries {
+        id: predictedPressureSeries
+        color: Theme.pressureColor
+        width: Math.max(1, Theme.graphLineWidth - 1)
+        axisX: timeAxis
+        axisY: pressureAxis
+    }
+    LineSeries {
+        id: predictedFlowSeries
+        color: Theme.flowColor
+        width: Math.max(1, Theme.graphLineWidth - 1)
+        axisX: timeAxis
+        axisY: pressureAxis
+    }
+    LineSeries {
+        id: predictedWeightSeries
+        color: Theme.weightColor
+        width: Math.max(1, Theme.graphLineWidth - 1)
+        axisX: timeAxis
+        axisY: predictedWeightAxis
+    }
+
     // Arrays to track which static series to use
     property var pressureSeriesPool: [pressureSeries0, pressureSeries1, pressureSeries2]
     property var flowSeriesPool: [flowSeries0, flowSeries1, flowSeries2]
@@ -336,11 +372,29 @@ ChartView {
         }
     }
 
+    // Refill the predicted series from prediction's point lists
+    function updatePrediction() {
+        predictedPressureSeries.clear()
+        predictedFlowSeries.clear()
+        predictedWeightSeries.clear()
+        if (!prediction) return
+
+        var i
+        var pressure = prediction.pressure || []
+        for (i = 0; i < pressure.length; i++) predictedPressureSeries.append(pressure[i].x, pressure[i].y)
+        var flow = prediction.flow || []
+        for (i = 0; i < flow.length; i++) predictedFlowSeries.append(flow[i].x, flow[i].y)
+        var weight = prediction.weight || []
+        for (i = 0; i < weight.length; i++) predictedWeightSeries.append(weight[i].x, weight[i].y)
+    }
+
     // Re-generate curves when frames change
     onFramesChanged: {
         updateCurves()
     }
 
+    onPredictionChanged: updatePrediction()
+
     // Timer for delayed initial update (ensures chart is fully ready)
     Timer {
         id: initialUpdateTimer
@@ -377,5 +431,17 @@ ChartView {
             Rectangle { width: Theme.scaled(16); height: Theme.scaled(3); radius: Theme.scaled(1); color: Theme.temperatureGoalColor; anchors.verticalCenter: parent.verticalCenter }
             Text { text: "Temp"; color: Theme.textSecondaryColor; font: Theme.captionFont }
         }
+        Row {
+            visible: chart.prediction !== null
+            spacing: Theme.scaled(4)
+            Rectangle { width: Theme.scaled(16); height: Theme.scaled(2); radius: Theme.scaled(1); color: Theme.weightColor; anchors.verticalCenter: parent.verticalCenter }
+            Text {
+                text: chart.prediction
+                      ? "Predicted " + chart.prediction.finalWeight.toFixed(0) + "g in " + chart.prediction.shotTime.toFixed(0) + "s"
+                      : ""
+                color: Theme.textSecondaryColor
+                font: Theme.captionFont
+            }
+        }
     }
 }
@@ -26,8 +26,12 @@ ChartView {
             [frameMarker1, frameMarker2, frameMarker3, frameMarker4, frameMarker5,
              frameMarker6, frameMarker7, frameMarker8, frameMarker9, frameMarker10]
         )
+        ShotDataModel.setChartPixelWidth(plotWidth)
     }
 
+    // Series are decimated to about one point per pixel column of the plot area
+    onPlotWidthChanged: ShotDataModel.setChartPixelWidth(plotWidth)
+
     // Calculate axis max: data fills frame with exactly 5 scaled pixels padding at right
     // Solve: max = rawTime + paddingPixels * (max / plotWidth)
     // => max = rawTime * plotWidth / (plotWidth - paddingPixels)
@@ -1239,6 +1239,25 @@ Page {
                             font: Theme.bodyFont
                             color: Theme.textSecondaryColor
                         }
+
+                        Item { Layout.fillWidth: true }
+
+                        Text {
+                            text: TranslationManager.translate("postshotreview.conversation.stop", "Stop")
+                            font: Theme.bodyFont
+                            color: Theme.primaryColor
+
+                            Accessible.role: Accessible.Button
+                            Accessible.name: TranslationManager.translate("postshotreview.conversation.stop", "Stop")
+                            Accessible.onPressAction: stopArea.clicked(null)
+
+                            MouseArea {
+                                id: stopArea
+                                anchors.fill: parent
+                                anchors.margins: -Theme.scaled(4)
+                                onClicked: MainController.aiManager.conversation.cancel()
+                            }
+                        }
                     }
 
                     // Shot data attached indicator
@@ -1383,6 +1402,23 @@ Page {
                 // Refresh conversation text
                 conversationText.text = MainController.aiManager.conversation.getConversationText()
             }
+            function onStreamingResponseChanged() {
+                if (!streamRefreshTimer.running) streamRefreshTimer.start()
+            }
+        }
+
+        // Show the reply as it streams in, following the end. Rebuilding the
+        // Markdown text per token is quadratic on a long reply, so at most ~7 Hz.
+        Timer {
+            id: streamRefreshTimer
+            interval: 150
+            onTriggered: {
+                if (!MainController.aiManager || !MainController.aiManager.conversation) return
+                conversationText.text = MainController.aiManager.conversation.getConversationText()
+                Qt.callLater(function() {
+                    conversationFlickable.contentY = Math.max(0, conversationFlickable.contentHeight - conversationFlickable.height)
+                })
+            }
         }
     }
 }
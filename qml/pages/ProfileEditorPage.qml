@@ -96,6 +96,46 @@ Page {
             // Force graph to update by creating a new array reference
             // (assigning same reference doesn't trigger onFramesChanged)
             profileGraph.frames = profile.steps.slice()
+            predictionTimer.restart()
+            robustnessReport = null  // Describes the profile before this edit
+        }
+    }
+
+    // Re-simulate the shot once edits pause (slider drags upload on every step)
+    Timer {
+        id: predictionTimer
+        interval: 300
+        onTriggered: {
+            profileGraph.prediction = profile && profile.steps && profile.steps.length > 0
+                ? MainController.predictCurrentProfile() : null
+        }
+    }
+
+    // Monte Carlo spread under varied grind, dose and channeling (null until run)
+    property var robustnessReport: null
+    property bool robustnessRunning: false
+
+    function robustnessSummary(r) {
+        function range(d, unit, digits) {
+            return d.p10.toFixed(digits) + "\u2013" + d.p90.toFixed(digits) + unit
+        }
+        var parts = [qsTr("shot time %1").arg(range(r.shotTime, "s", 0))]
+        if (r.yieldTime.count > 0)
+            parts.push(qsTr("target weight at %1").arg(range(r.yieldTime, "s", 0)))
+        if (r.yieldMissed > 0)
+            parts.push(qsTr("%1% never reach %2g").arg(Math.round(100 * r.yieldMissed / r.runs))
+                       .arg(r.targetWeight.toFixed(0)))
+        parts.push(qsTr("peak %1").arg(range(r.peakPressure, " bar", 1)))
+        return qsTr("%1 simulated preps, 10th to 90th percentile: ").arg(r.runs) + parts.join(", ")
+    }
+
+    Connections {
+        target: MainController
+        function onRobustnessAnalysisReady(report) {
+            robustnessRunning = false
+            robustnessReport = report
+            if (typeof AccessibilityManager !== "undefined" && AccessibilityManager.enabled)
+                AccessibilityManager.announce(robustnessSummary(report))
         }
     }
 
@@ -243,9 +283,33 @@ Page {
                                 enabled: selectedStepIndex >= 0 && selectedStepIndex < (profile ? profile.steps.length - 1 : 0)
                                 onClicked: moveStep(selectedStepIndex, selectedStepIndex + 1)
                             }
+
+                            AccessibleButton {
+                                text: robustnessRunning ? qsTr("Simulating...") : qsTr("Robustness")
+                                accessibleName: qsTr("Simulate 200 shots with varied puck prep")
+                                enabled: !robustnessRunning && profile && profile.steps.length > 0
+                                onClicked: {
+                                    robustnessRunning = true
+                                    MainController.analyzeCurrentProfileRobustness(200)
+                                }
+                            }
                         }
                     }
 
+                    // Robustness summary (until the next edit)
+                    Text {
+                        Layout.fillWidth: true
+                        Layout.leftMargin: Theme.scaled(8)
+                        Layout.rightMargin: Theme.scaled(8)
+                        visible: robustnessReport !== null
+                        text: robustnessReport ? robustnessSummary(robustnessReport) : ""
+                        font: Theme.captionFont
+                        color: Theme.textSecondaryColor
+                        wrapMode: Text.WordWrap
+                        Accessible.role: Accessible.StaticText
+                        Accessible.name: text
+                    }
+
                     // Profile graph
                     Item {
                         Layout.fillWidth: true
@@ -1797,6 +1861,8 @@ Page {
         if (profile && profile.steps) {
             profileGraph.frames = profile.steps.slice()
         }
+        robustnessReport = null
+        predictionTimer.restart()
     }
 
     // Reload profile when page becomes active (StackView reactivation)
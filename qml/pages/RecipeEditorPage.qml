@@ -119,6 +119,16 @@ Page {
         onTriggered: scrollingFromSelection = false
     }
 
+    // Re-simulate the shot once edits pause (slider drags regenerate on every step)
+    Timer {
+        id: predictionTimer
+        interval: 300
+        onTriggered: {
+            profileGraph.prediction = profile && profile.steps && profile.steps.length > 0
+                ? MainController.predictCurrentProfile() : null
+        }
+    }
+
     // Load profile data from MainController
     function loadCurrentProfile() {
         recipe = MainController.getCurrentRecipeParams()
@@ -135,6 +145,7 @@ Page {
 
         originalProfileName = MainController.baseProfileName || ""
         recipeModified = false
+        predictionTimer.restart()
     }
 
     // Update recipe and upload to machine
@@ -153,6 +164,7 @@ Page {
             profileGraph.frames = profile.steps.slice()
             profileGraph.refresh()
         }
+        predictionTimer.restart()
     }
 
     // Apply a preset
@@ -167,6 +179,7 @@ Page {
             profileGraph.frames = profile.steps.slice()
             profileGraph.refresh()
         }
+        predictionTimer.restart()
     }
 
     // Editor mode header
@@ -292,6 +292,33 @@ Page {
                         onClicked: showWeight = !showWeight
                     }
                 }
+
+                // Alignment toggle (cycles shot start -> first drip -> first frame change)
+                Rectangle {
+                    width: alignToggleText.width + Theme.scaled(16)
+                    height: Theme.scaled(32)
+                    radius: Theme.scaled(16)
+                    color: comparisonModel.alignMode !== 0 ? Theme.surfaceColor : "transparent"
+                    border.color: comparisonModel.alignMode !== 0 ? Theme.primaryColor : Theme.borderColor
+                    border.width: 1
+
+                    Text {
+                        id: alignToggleText
+                        anchors.centerIn: parent
+                        text: comparisonModel.alignMode === 1
+                              ? TranslationManager.translate("comparison.alignFirstDrip", "Align: First drip")
+                              : comparisonModel.alignMode === 2
+                                ? TranslationManager.translate("comparison.alignPhase", "Align: Frame")
+                                : TranslationManager.translate("comparison.alignStart", "Align: Start")
+                        font: Theme.captionFont
+                        color: Theme.textColor
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        onClicked: comparisonModel.alignMode = (comparisonModel.alignMode + 1) % 3
+                    }
+                }
             }
 
             // Shot columns
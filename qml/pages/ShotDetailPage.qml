@@ -492,6 +492,11 @@ Page {
         height: parent.height * 0.8
         modal: true
 
+        // Loaded on open - debug logs aren't part of getShot()
+        property string logText: ""
+        onAboutToShow: logText = MainController.shotHistory.getShotDebugLog(shotId)
+        onClosed: logText = ""
+
         background: Rectangle {
             color: Theme.surfaceColor
             radius: Theme.cardRadius
@@ -502,7 +507,7 @@ Page {
             contentWidth: availableWidth
 
             TextArea {
-                text: shotData.debugLog || TranslationManager.translate("shotdetail.nodebuglog", "No debug log available")
+                text: debugLogDialog.logText || TranslationManager.translate("shotdetail.nodebuglog", "No debug log available")
                 font.family: "monospace"
                 font.pixelSize: Theme.scaled(12)
                 color: Theme.textColor
@@ -651,6 +656,25 @@ Page {
                             font: Theme.bodyFont
                             color: Theme.textSecondaryColor
                         }
+
+                        Item { Layout.fillWidth: true }
+
+                        Text {
+                            text: TranslationManager.translate("shotdetail.conversation.stop", "Stop")
+                            font: Theme.bodyFont
+                            color: Theme.primaryColor
+
+                            Accessible.role: Accessible.Button
+                            Accessible.name: TranslationManager.translate("shotdetail.conversation.stop", "Stop")
+                            Accessible.onPressAction: stopArea.clicked(null)
+
+                            MouseArea {
+                                id: stopArea
+                                anchors.fill: parent
+                                anchors.margins: -Theme.scaled(4)
+                                onClicked: MainController.aiManager.conversation.cancel()
+                            }
+                        }
                     }
 
                     // Shot data attached indicator
@@ -795,6 +819,23 @@ Page {
                 // Refresh conversation text
                 conversationText.text = MainController.aiManager.conversation.getConversationText()
             }
+            function onStreamingResponseChanged() {
+                if (!streamRefreshTimer.running) streamRefreshTimer.start()
+            }
+        }
+
+        // Show the reply as it streams in, following the end. Rebuilding the
+        // Markdown text per token is quadratic on a long reply, so at most ~7 Hz.
+        Timer {
+            id: streamRefreshTimer
+            interval: 150
+            onTriggered: {
+                if (!MainController.aiManager || !MainController.aiManager.conversation) return
+                conversationText.text = MainController.aiManager.conversation.getConversationText()
+                Qt.callLater(function() {
+                    conversationFlickable.contentY = Math.max(0, conversationFlickable.contentHeight - conversationFlickable.height)
+                })
+            }
         }
     }
 
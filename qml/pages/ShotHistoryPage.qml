@@ -492,6 +492,17 @@ Page {
                         }
                     }
 
+                    // Sparkline thumbnail (pre-rendered, cached on disk - no chart per row)
+                    Image {
+                        Layout.preferredWidth: Theme.scaled(120)
+                        Layout.preferredHeight: Theme.scaled(36)
+                        source: "image://shotthumb/" + model.id + "/" + (model.uuid || "")
+                        sourceSize.width: Theme.scaled(120)
+                        sourceSize.height: Theme.scaled(36)
+                        asynchronous: true
+                        fillMode: Image.Stretch
+                    }
+
                     // Rating percentage
                     Text {
                         text: shotDelegate.shotEnjoyment > 0 ? shotDelegate.shotEnjoyment + "%" : ""
@@ -447,6 +447,20 @@ KeyboardAwareContainer {
                         font: Theme.bodyFont
                         color: Theme.textSecondaryColor
                     }
+
+                    Item { Layout.fillWidth: true }
+
+                    Text {
+                        text: TranslationManager.translate("settings.ai.conversation.stop", "Stop")
+                        font: Theme.bodyFont
+                        color: Theme.primaryColor
+
+                        MouseArea {
+                            anchors.fill: parent
+                            anchors.margins: -Theme.scaled(4)
+                            onClicked: MainController.aiManager?.conversation?.cancel()
+                        }
+                    }
                 }
 
                 RowLayout {
@@ -490,6 +504,12 @@ KeyboardAwareContainer {
             function onHistoryChanged() {
                 conversationText.text = MainController.aiManager?.conversation?.getConversationText() ?? ""
             }
+            function onStreamingResponseChanged() {
+                conversationText.text = MainController.aiManager?.conversation?.getConversationText() ?? ""
+                Qt.callLater(function() {
+                    conversationFlickable.contentY = Math.max(0, conversationFlickable.contentHeight - conversationFlickable.height)
+                })
+            }
         }
     }
 
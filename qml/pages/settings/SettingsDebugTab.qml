@@ -158,6 +158,67 @@ Item {
                 }
             }
 
+            // Hot-path log categories (per-write / per-sample logging)
+            Rectangle {
+                Layout.fillWidth: true
+                implicitHeight: logCategoriesContent.implicitHeight + Theme.scaled(30)
+                color: Theme.surfaceColor
+                radius: Theme.cardRadius
+
+                ColumnLayout {
+                    id: logCategoriesContent
+                    anchors.left: parent.left
+                    anchors.right: parent.right
+                    anchors.top: parent.top
+                    anchors.margins: Theme.scaled(15)
+                    spacing: Theme.scaled(10)
+
+                    Tr {
+                        key: "settings.debug.logCategories"
+                        fallback: "Verbose Logging"
+                        color: Theme.textColor
+                        font.pixelSize: Theme.scaled(16)
+                        font.bold: true
+                    }
+
+                    Tr {
+                        Layout.fillWidth: true
+                        key: "settings.debug.logCategoriesDesc"
+                        fallback: "High-frequency log categories. Shown in the web debug log and the shot debug log."
+                        color: Theme.textSecondaryColor
+                        font.pixelSize: Theme.scaled(12)
+                        wrapMode: Text.Wrap
+                    }
+
+                    Repeater {
+                        model: Object.keys(Settings.logCategories)
+
+                        RowLayout {
+                            Layout.fillWidth: true
+                            spacing: Theme.scaled(20)
+
+                            Text {
+                                text: modelData
+                                color: Theme.textColor
+                                font.pixelSize: Theme.scaled(14)
+                            }
+
+                            Item { Layout.fillWidth: true }
+
+                            StyledSwitch {
+                                checked: Settings.logCategories[modelData] === true
+                                accessibleName: modelData
+                                onToggled: {
+                                    var levels = Settings.logCategories
+                                    levels[modelData] = checked
+                                    Settings.logCategories = levels
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
             // Profile Converter section
             Rectangle {
                 Layout.fillWidth: true
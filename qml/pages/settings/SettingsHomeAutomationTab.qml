@@ -169,6 +169,14 @@ Item {
                         }
                     }
 
+                    Text {
+                        text: "Queued: " + MainController.mqttClient.queueDepth +
+                              "   Dropped: " + MainController.mqttClient.droppedMessages
+                        color: Theme.textSecondaryColor
+                        font.pixelSize: Theme.scaled(10)
+                        visible: MainController.mqttClient.queueDepth > 0 || MainController.mqttClient.droppedMessages > 0
+                    }
+
                     // Connect/Disconnect buttons
                     RowLayout {
                         Layout.fillWidth: true
@@ -285,6 +293,84 @@ Item {
                         Layout.fillWidth: true
                     }
 
+                    // Batched JSON state
+                    RowLayout {
+                        Layout.fillWidth: true
+                        Layout.rightMargin: Theme.scaled(5)
+
+                        Text {
+                            text: "Single JSON State Topic"
+                            color: Theme.textColor
+                            font.pixelSize: Theme.scaled(12)
+                            Layout.fillWidth: true
+                        }
+
+                        StyledSwitch {
+                            checked: Settings.mqttJsonState
+                            onCheckedChanged: Settings.mqttJsonState = checked
+                        }
+                    }
+
+                    Text {
+                        text: "Publish all values as one JSON message on the telemetry topic instead of one topic each"
+                        color: Theme.textSecondaryColor
+                        font.pixelSize: Theme.scaled(10)
+                        wrapMode: Text.WordWrap
+                        Layout.fillWidth: true
+                    }
+
+                    // Shot stream
+                    RowLayout {
+                        Layout.fillWidth: true
+                        Layout.rightMargin: Theme.scaled(5)
+
+                        Text {
+                            text: "Shot Stream"
+                            color: Theme.textColor
+                            font.pixelSize: Theme.scaled(12)
+                            Layout.fillWidth: true
+                        }
+
+                        StyledSwitch {
+                            checked: Settings.mqttShotStream
+                            onCheckedChanged: Settings.mqttShotStream = checked
+                        }
+                    }
+
+                    Text {
+                        text: "Stream every sample during extractions on the shot/stream topic"
+                        color: Theme.textSecondaryColor
+                        font.pixelSize: Theme.scaled(10)
+                        wrapMode: Text.WordWrap
+                        Layout.fillWidth: true
+                    }
+
+                    // Offline queue persistence
+                    RowLayout {
+                        Layout.fillWidth: true
+                        Layout.rightMargin: Theme.scaled(5)
+
+                        Text {
+                            text: "Keep Unsent Events on Disk"
+                            color: Theme.textColor
+                            font.pixelSize: Theme.scaled(12)
+                            Layout.fillWidth: true
+                        }
+
+                        StyledSwitch {
+                            checked: Settings.mqttPersistQueue
+                            onCheckedChanged: Settings.mqttPersistQueue = checked
+                        }
+                    }
+
+                    Text {
+                        text: "State and shot events queued while the broker is down survive an app restart"
+                        color: Theme.textSecondaryColor
+                        font.pixelSize: Theme.scaled(10)
+                        wrapMode: Text.WordWrap
+                        Layout.fillWidth: true
+                    }
+
                     // Separator
                     Rectangle {
                         Layout.fillWidth: true
@@ -721,6 +721,35 @@ KeyboardAwareContainer {
                             }
                         }
                     }
+
+                    RowLayout {
+                        Layout.fillWidth: true
+                        Layout.topMargin: Theme.scaled(4)
+
+                        Text {
+                            text: qsTr("Scale flow estimation")
+                            color: Theme.textColor
+                            font.pixelSize: Theme.scaled(12)
+                        }
+
+                        Item { Layout.fillWidth: true }
+
+                        StyledComboBox {
+                            Layout.preferredWidth: Theme.scaled(180)
+                            Accessible.name: qsTr("Scale flow estimation")
+                            model: [qsTr("Moving average"), qsTr("Savitzky-Golay"), qsTr("Kalman filter")]
+                            currentIndex: {
+                                var estimator = Settings.scaleFlowEstimator
+                                if (estimator === "savitzky_golay") return 1
+                                if (estimator === "kalman") return 2
+                                return 0
+                            }
+                            onActivated: function(index) {
+                                var estimators = ["moving_average", "savitzky_golay", "kalman"]
+                                Settings.scaleFlowEstimator = estimators[index]
+                            }
+                        }
+                    }
                 }
             }
 
@@ -11,10 +11,14 @@ AIConversation::AIConversation(AIManager* aiManager, QObject* parent)
 {
     // Connect to AIManager signals
     if (m_aiManager) {
+        connect(m_aiManager, &AIManager::analysisChunk,
+                this, &AIConversation::onAnalysisChunk);
         connect(m_aiManager, &AIManager::recommendationReceived,
                 this, &AIConversation::onAnalysisComplete);
         connect(m_aiManager, &AIManager::errorOccurred,
                 this, &AIConversation::onAnalysisFailed);
+        connect(m_aiManager, &AIManager::analysisCancelled,
+                this, &AIConversation::onAnalysisCancelled);
         connect(m_aiManager, &AIManager::providerChanged,
                 this, &AIConversation::providerChanged);
     }
@@ -63,6 +67,13 @@ void AIConversation::followUp(const QString& userMessage)
     emit historyChanged();
 }
 
+void AIConversation::cancel()
+{
+    if (!m_busy || !m_aiManager) return;
+
+    m_aiManager->cancelAnalysis();  // Comes back through onAnalysisCancelled()
+}
+
 void AIConversation::clearHistory()
 {
     m_messages = QJsonArray();
@@ -99,6 +110,7 @@ void AIConversation::sendRequest()
     }
 
     m_busy = true;
+    m_streamingResponse.clear();
     emit busyChanged();
 
     // Build the full prompt with conversation history
@@ -123,12 +135,21 @@ void AIConversation::sendRequest()
     m_aiManager->analyze(m_systemPrompt, fullPrompt);
 }
 
+void AIConversation::onAnalysisChunk(const QString& chunk)
+{
+    if (!m_busy) return;  // Not our request
+
+    m_streamingResponse += chunk;
+    emit streamingResponseChanged();
+}
+
 void AIConversation::onAnalysisComplete(const QString& response)
 {
     if (!m_busy) return;  // Not our request
 
     m_busy = false;
     m_lastResponse = response;
+    m_streamingResponse.clear();
 
     // Add assistant response to history
     addAssistantMessage(response);
@@ -151,9 +172,7 @@ void AIConversation::onAnalysisFailed(const QString& error)
     m_errorMessage = error;
 
     // Remove the last user message since it failed
-    if (!m_messages.isEmpty()) {
-        m_messages.removeLast();
-    }
+    dropUnansweredMessage();
 
     emit busyChanged();
     emit historyChanged();
@@ -162,6 +181,30 @@ void AIConversation::onAnalysisFailed(const QString& error)
     qDebug() << "AIConversation: Request failed:" << error;
 }
 
+void AIConversation::onAnalysisCancelled()
+{
+    if (!m_busy) return;  // Not our request
+
+    m_busy = false;
+    dropUnansweredMessage();
+
+    emit busyChanged();
+    emit historyChanged();
+
+    qDebug() << "AIConversation: Request cancelled";
+}
+
+void AIConversation::dropUnansweredMessage()
+{
+    if (!m_messages.isEmpty()) {
+        m_messages.removeLast();
+    }
+    if (!m_streamingResponse.isEmpty()) {
+        m_streamingResponse.clear();
+        emit streamingResponseChanged();
+    }
+}
+
 QString AIConversation::getConversationText() const
 {
     QString text;
@@ -222,6 +265,12 @@ QString AIConversation::getConversationText() const
         }
     }
 
+    // Reply still streaming in
+    if (m_busy && !m_streamingResponse.isEmpty()) {
+        if (!text.isEmpty()) text += "\n\n---\n\n";
+        text += "**" + providerName() + ":** " + m_streamingResponse;
+    }
+
     return text;
 }
 
@@ -24,6 +24,7 @@ class AIConversation : public QObject {
     Q_PROPERTY(bool hasHistory READ hasHistory NOTIFY historyChanged)
     Q_PROPERTY(bool hasSavedConversation READ hasSavedConversation NOTIFY savedConversationChanged)
     Q_PROPERTY(QString lastResponse READ lastResponse NOTIFY responseReceived)
+    Q_PROPERTY(QString streamingResponse READ streamingResponse NOTIFY streamingResponseChanged)
     Q_PROPERTY(QString providerName READ providerName NOTIFY providerChanged)
     Q_PROPERTY(int messageCount READ messageCount NOTIFY historyChanged)
     Q_PROPERTY(QString errorMessage READ errorMessage NOTIFY errorOccurred)
@@ -34,6 +35,7 @@ public:
     bool isBusy() const { return m_busy; }
     bool hasHistory() const { return !m_messages.isEmpty(); }
     QString lastResponse() const { return m_lastResponse; }
+    QString streamingResponse() const { return m_streamingResponse; }  // Partial reply while busy
     QString providerName() const;
     int messageCount() const { return static_cast<int>(m_messages.size()); }
     QString errorMessage() const { return m_errorMessage; }
@@ -50,13 +52,19 @@ public:
      */
     Q_INVOKABLE void followUp(const QString& userMessage);
 
+    /**
+     * Stop waiting for the current reply; the unanswered message is dropped
+     */
+    Q_INVOKABLE void cancel();
+
     /**
      * Clear conversation history
      */
     Q_INVOKABLE void clearHistory();
 
     /**
-     * Get full conversation as formatted text (for display)
+     * Get full conversation as formatted text (for display), including the
+     * reply streaming in
      */
     Q_INVOKABLE QString getConversationText() const;
 
@@ -83,6 +91,7 @@ public:
 
 signals:
     void responseReceived(const QString& response);
+    void streamingResponseChanged();
     void errorOccurred(const QString& error);
     void busyChanged();
     void historyChanged();
@@ -90,18 +99,22 @@ signals:
     void savedConversationChanged();
 
 private slots:
+    void onAnalysisChunk(const QString& chunk);
     void onAnalysisComplete(const QString& response);
     void onAnalysisFailed(const QString& error);
+    void onAnalysisCancelled();
 
 private:
     void sendRequest();
     void addUserMessage(const QString& message);
     void addAssistantMessage(const QString& message);
+    void dropUnansweredMessage();
 
     AIManager* m_aiManager;
     QString m_systemPrompt;
     QJsonArray m_messages;  // Array of {role, content} objects
     QString m_lastResponse;
+    QString m_streamingResponse;
     QString m_errorMessage;
     bool m_busy = false;
 };
@@ -2,8 +2,10 @@
 #include "aiprovider.h"
 #include "aiconversation.h"
 #include "shotsummarizer.h"
+#include "airesponsecache.h"
 #include "../core/settings.h"
 #include "../models/shotdatamodel.h"
+#include "../models/shotphasestats.h"
 #include "../profile/profile.h"
 #include "../network/visualizeruploader.h"
 
@@ -12,6 +14,7 @@
 #include <QDir>
 #include <QFile>
 #include <QDateTime>
+#include <QJsonObject>
 #include <QDebug>
 
 AIManager::AIManager(Settings* settings, QObject* parent)
@@ -19,9 +22,13 @@ AIManager::AIManager(Settings* settings, QObject* parent)
     , m_settings(settings)
     , m_networkManager(new QNetworkAccessManager(this))
     , m_summarizer(std::make_unique<ShotSummarizer>(this))
+    , m_responseCache(std::make_unique<AIResponseCache>())
 {
     createProviders();
 
+    m_responseCache->setTtlDays(m_settings->value("ai/cacheTtlDays", 30).toInt());
+    m_responseCache->open();
+
     // Create conversation handler for multi-turn interactions
     m_conversation = new AIConversation(this, this);
 
@@ -42,6 +49,7 @@ void AIManager::createProviders()
     // Create OpenAI provider
     QString openaiKey = m_settings->value("ai/openaiKey").toString();
     auto* openai = new OpenAIProvider(m_networkManager, openaiKey, this);
+    connect(openai, &AIProvider::analysisChunk, this, &AIManager::onAnalysisChunk);
     connect(openai, &AIProvider::analysisComplete, this, &AIManager::onAnalysisComplete);
     connect(openai, &AIProvider::analysisFailed, this, &AIManager::onAnalysisFailed);
     connect(openai, &AIProvider::testResult, this, &AIManager::onTestResult);
@@ -50,6 +58,7 @@ void AIManager::createProviders()
     // Create Anthropic provider
     QString anthropicKey = m_settings->value("ai/anthropicKey").toString();
     auto* anthropic = new AnthropicProvider(m_networkManager, anthropicKey, this);
+    connect(anthropic, &AIProvider::analysisChunk, this, &AIManager::onAnalysisChunk);
     connect(anthropic, &AIProvider::analysisComplete, this, &AIManager::onAnalysisComplete);
     connect(anthropic, &AIProvider::analysisFailed, this, &AIManager::onAnalysisFailed);
     connect(anthropic, &AIProvider::testResult, this, &AIManager::onTestResult);
@@ -58,6 +67,7 @@ void AIManager::createProviders()
     // Create Gemini provider
     QString geminiKey = m_settings->value("ai/geminiKey").toString();
     auto* gemini = new GeminiProvider(m_networkManager, geminiKey, this);
+    connect(gemini, &AIProvider::analysisChunk, this, &AIManager::onAnalysisChunk);
     connect(gemini, &AIProvider::analysisComplete, this, &AIManager::onAnalysisComplete);
     connect(gemini, &AIProvider::analysisFailed, this, &AIManager::onAnalysisFailed);
     connect(gemini, &AIProvider::testResult, this, &AIManager::onTestResult);
@@ -67,6 +77,7 @@ void AIManager::createProviders()
     QString openrouterKey = m_settings->value("ai/openrouterKey").toString();
     QString openrouterModel = m_settings->value("ai/openrouterModel", "anthropic/claude-sonnet-4").toString();
     auto* openrouter = new OpenRouterProvider(m_networkManager, openrouterKey, openrouterModel, this);
+    connect(openrouter, &AIProvider::analysisChunk, this, &AIManager::onAnalysisChunk);
     connect(openrouter, &AIProvider::analysisComplete, this, &AIManager::onAnalysisComplete);
     connect(openrouter, &AIProvider::analysisFailed, this, &AIManager::onAnalysisFailed);
     connect(openrouter, &AIProvider::testResult, this, &AIManager::onTestResult);
@@ -76,6 +87,7 @@ void AIManager::createProviders()
     QString ollamaEndpoint = m_settings->value("ai/ollamaEndpoint", "http://localhost:11434").toString();
     QString ollamaModel = m_settings->value("ai/ollamaModel").toString();
     auto* ollama = new OllamaProvider(m_networkManager, ollamaEndpoint, ollamaModel, this);
+    connect(ollama, &AIProvider::analysisChunk, this, &AIManager::onAnalysisChunk);
     connect(ollama, &AIProvider::analysisComplete, this, &AIManager::onAnalysisComplete);
     connect(ollama, &AIProvider::analysisFailed, this, &AIManager::onAnalysisFailed);
     connect(ollama, &AIProvider::testResult, this, &AIManager::onTestResult);
@@ -339,6 +351,45 @@ QString AIManager::generateHistoryShotSummary(const QVariantMap& shotData)
     }
     out << "\n";
 
+    // Phase statistics saved with the shot (none for shots saved before they were kept)
+    if (shotData.contains("phaseStats")) {
+        const ShotPhaseStats stats = ShotPhaseStats::fromJson(
+            QJsonObject::fromVariantMap(shotData.value("phaseStats").toMap()));
+
+        auto writePhase = [&out](const PhaseStats& phase, const QString& name, double length) {
+            out << "### " << name << " (" << QString::number(length, 'f', 0) << "s) - "
+                << (phase.isFlowMode ? "FLOW-CONTROLLED" : "PRESSURE-CONTROLLED") << "\n";
+            out << "- " << QString::number(phase.pressure.mean, 'f', 1) << " bar ("
+                << QString::number(phase.pressure.minimum(), 'f', 1) << "-"
+                << QString::number(phase.pressure.maximum(), 'f', 1) << "), ";
+            out << QString::number(phase.flow.mean, 'f', 1) << " ml/s ("
+                << QString::number(phase.flow.minimum(), 'f', 1) << "-"
+                << QString::number(phase.flow.maximum(), 'f', 1) << "), ";
+            out << QString::number(phase.temperature.mean, 'f', 0) << " C (sd "
+                << QString::number(phase.temperature.stdDev(), 'f', 1) << ")\n";
+        };
+
+        out << "## Phase Data\n\n";
+        out << "Phase averages with (min-max).\n\n";
+        const QVector<PhaseStats>& phases = stats.phases();
+        if (phases.isEmpty()) {
+            writePhase(stats.wholeShot(), "Extraction", duration);
+        }
+        for (int i = 0; i < phases.size(); i++) {
+            double endTime = (i + 1 < phases.size()) ? phases[i + 1].startTime : duration;
+            if (endTime <= phases[i].startTime || phases[i].pressure.count == 0) continue;
+            writePhase(phases[i], phases[i].label, endTime - phases[i].startTime);
+        }
+        if (stats.timeToFirstDrip() > 0) {
+            out << "- **First drip**: " << QString::number(stats.timeToFirstDrip(), 'f', 0) << "s\n";
+        }
+        if (stats.temperatureGoalDeviation().count > 0) {
+            out << "- **Temperature vs target**: "
+                << QString::number(stats.temperatureGoalDeviation().mean, 'f', 1) << " C average deviation\n";
+        }
+        out << "\n";
+    }
+
     // Tasting feedback
     out << "## Tasting Feedback\n\n";
     int enjoyment = shotData.value("enjoyment", 0).toInt();
@@ -401,9 +452,50 @@ void AIManager::analyze(const QString& systemPrompt, const QString& userPrompt)
     m_lastUserPrompt = userPrompt;
 
     logPrompt(selectedProvider(), systemPrompt, userPrompt);
+
+    m_pendingCacheKey.clear();
+    if (m_responseCache->isEnabled()) {
+        QString cacheKey = AIResponseCache::key(provider->id(), provider->modelName(), systemPrompt, userPrompt);
+        QString cached;
+        if (m_responseCache->lookup(cacheKey, &cached)) {
+            qDebug() << "AI: Serving cached response for" << provider->id() << provider->modelName();
+            // Queued, so listeners see the same order of signals as for a network reply
+            QMetaObject::invokeMethod(this, [this, cached]() {
+                if (!m_analyzing) return;  // Cancelled
+                m_lastRecommendationCached = true;
+                emit analysisChunk(cached);
+                onAnalysisComplete(cached);
+            }, Qt::QueuedConnection);
+            return;
+        }
+        m_pendingCacheKey = cacheKey;
+        m_pendingProvider = provider->id();
+        m_pendingModel = provider->modelName();
+    }
+
+    m_lastRecommendationCached = false;
+    m_firstChunkReceived = false;
+    m_requestTimer.start();
     provider->analyze(systemPrompt, userPrompt);
 }
 
+void AIManager::cancelAnalysis()
+{
+    if (!m_analyzing) return;
+
+    // Only the selected provider can have a request in flight
+    if (AIProvider* provider = currentProvider()) {
+        provider->cancel();
+    }
+
+    m_analyzing = false;
+    m_pendingCacheKey.clear();
+    qDebug() << "AI: Analysis cancelled";
+
+    emit analyzingChanged();
+    emit analysisCancelled();
+}
+
 void AIManager::refreshOllamaModels()
 {
     auto* ollama = dynamic_cast<OllamaProvider*>(m_ollamaProvider.get());
@@ -412,12 +504,39 @@ void AIManager::refreshOllamaModels()
     }
 }
 
+QVariantMap AIManager::responseCacheStats() const
+{
+    return m_responseCache->stats();
+}
+
+void AIManager::clearResponseCache()
+{
+    m_responseCache->clear();
+    qDebug() << "AI: Response cache cleared";
+}
+
+void AIManager::onAnalysisChunk(const QString& chunk)
+{
+    if (!m_analyzing) return;
+
+    if (!m_firstChunkReceived) {
+        m_firstChunkReceived = true;
+        qDebug() << "AI: First token after" << m_requestTimer.elapsed() << "ms";
+    }
+    emit analysisChunk(chunk);
+}
+
 void AIManager::onAnalysisComplete(const QString& response)
 {
     m_analyzing = false;
     m_lastRecommendation = response;
     m_lastError.clear();
 
+    if (!m_pendingCacheKey.isEmpty()) {
+        m_responseCache->store(m_pendingCacheKey, m_pendingProvider, m_pendingModel, response);
+        m_pendingCacheKey.clear();
+    }
+
     // Log the successful response
     logResponse(selectedProvider(), response, true);
 
@@ -429,6 +548,7 @@ void AIManager::onAnalysisFailed(const QString& error)
 {
     m_analyzing = false;
     m_lastError = error;
+    m_pendingCacheKey.clear();
 
     // Log the failed response
     logResponse(selectedProvider(), error, false);
@@ -480,6 +600,8 @@ void AIManager::onSettingsChanged()
         ollama->setModel(m_settings->value("ai/ollamaModel").toString());
     }
 
+    m_responseCache->setTtlDays(m_settings->value("ai/cacheTtlDays", 30).toInt());
+
     emit configurationChanged();
 }
 
@@ -4,12 +4,14 @@
 #include <QString>
 #include <QStringList>
 #include <QVariantMap>
+#include <QElapsedTimer>
 #include <memory>
 
 class QNetworkAccessManager;
 class AIProvider;
 class AIConversation;
 class ShotSummarizer;
+class AIResponseCache;
 class ShotDataModel;
 class Profile;
 class Settings;
@@ -23,6 +25,7 @@ class AIManager : public QObject {
     Q_PROPERTY(bool isConfigured READ isConfigured NOTIFY configurationChanged)
     Q_PROPERTY(bool isAnalyzing READ isAnalyzing NOTIFY analyzingChanged)
     Q_PROPERTY(QString lastRecommendation READ lastRecommendation NOTIFY recommendationReceived)
+    Q_PROPERTY(bool lastRecommendationCached READ lastRecommendationCached NOTIFY recommendationReceived)
     Q_PROPERTY(QString lastError READ lastError NOTIFY errorOccurred)
     Q_PROPERTY(QString lastTestResult READ lastTestResult NOTIFY testResultChanged)
     Q_PROPERTY(bool lastTestSuccess READ lastTestSuccess NOTIFY testResultChanged)
@@ -40,6 +43,7 @@ public:
     bool isConfigured() const;
     bool isAnalyzing() const { return m_analyzing; }
     QString lastRecommendation() const { return m_lastRecommendation; }
+    bool lastRecommendationCached() const { return m_lastRecommendationCached; }
     QString lastError() const { return m_lastError; }
     QString lastTestResult() const { return m_lastTestResult; }
     bool lastTestSuccess() const { return m_lastTestSuccess; }
@@ -88,22 +92,34 @@ public:
     // Provider testing
     Q_INVOKABLE void testConnection();
 
-    // Generic analysis - sends system prompt and user prompt to current provider
+    // Generic analysis - sends system prompt and user prompt to current provider.
+    // Text streams in through analysisChunk() before recommendationReceived().
     Q_INVOKABLE void analyze(const QString& systemPrompt, const QString& userPrompt);
 
+    // Abort the analysis in flight (emits analysisCancelled)
+    Q_INVOKABLE void cancelAnalysis();
+
     // Ollama-specific
     Q_INVOKABLE void refreshOllamaModels();
 
+    // Response cache (repeated prompts are answered without a request)
+    Q_INVOKABLE QVariantMap responseCacheStats() const;  // {entries, hits, misses, ttlDays}
+    Q_INVOKABLE void clearResponseCache();
+    AIResponseCache* responseCache() const { return m_responseCache.get(); }  // Never null
+
 signals:
     void providerChanged();
     void configurationChanged();
     void analyzingChanged();
     void recommendationReceived(const QString& recommendation);
+    void analysisChunk(const QString& chunk);
+    void analysisCancelled();
     void errorOccurred(const QString& error);
     void testResultChanged();
     void ollamaModelsChanged();
 
 private slots:
+    void onAnalysisChunk(const QString& chunk);
     void onAnalysisComplete(const QString& response);
     void onAnalysisFailed(const QString& error);
     void onTestResult(bool success, const QString& message);
@@ -130,6 +146,7 @@ private:
     Settings* m_settings = nullptr;
     QNetworkAccessManager* m_networkManager = nullptr;
     std::unique_ptr<ShotSummarizer> m_summarizer;
+    std::unique_ptr<AIResponseCache> m_responseCache;
 
     // Providers
     std::unique_ptr<AIProvider> m_openaiProvider;
@@ -141,6 +158,12 @@ private:
     // State
     bool m_analyzing = false;
     QString m_lastRecommendation;
+    bool m_lastRecommendationCached = false;
+    QString m_pendingCacheKey;  // Set while a request that should be cached is in flight
+    QString m_pendingProvider;
+    QString m_pendingModel;
+    QElapsedTimer m_requestTimer;     // Time to first token, for the log
+    bool m_firstChunkReceived = false;
     QString m_lastError;
     QString m_lastTestResult;
     bool m_lastTestSuccess = false;
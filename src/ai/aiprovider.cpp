@@ -24,6 +24,144 @@ void AIProvider::setStatus(Status status)
     }
 }
 
+void AIProvider::cancel()
+{
+    if (m_streamReply) {
+        m_streamCancelled = true;
+        m_streamReply->abort();
+    }
+}
+
+void AIProvider::startStreaming(QNetworkReply* reply)
+{
+    cancel();  // One analysis at a time
+    setStatus(Status::Busy);
+
+    m_streamReply = reply;
+    m_streamBuffer.clear();
+    m_streamBody.clear();
+    m_streamText.clear();
+    m_streamError.clear();
+    m_streamDone = false;
+    m_streamCancelled = false;
+
+    connect(reply, &QNetworkReply::readyRead, this, [this, reply]() {
+        onStreamData(reply);
+    });
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        onStreamFinished(reply);
+    });
+}
+
+void AIProvider::onStreamData(QNetworkReply* reply)
+{
+    if (reply != m_streamReply) return;  // Superseded or cancelled
+
+    QByteArray data = reply->readAll();
+    if (m_streamText.isEmpty() && m_streamBody.size() < MAX_ERROR_BODY) {
+        m_streamBody += data;
+    }
+
+    m_streamBuffer += data;
+    qsizetype newline;
+    while ((newline = m_streamBuffer.indexOf('\n')) >= 0) {
+        handleStreamLine(m_streamBuffer.left(newline));
+        m_streamBuffer.remove(0, newline + 1);
+    }
+}
+
+void AIProvider::handleStreamLine(QByteArray line)
+{
+    line = line.trimmed();
+    if (line.startsWith("data:")) {
+        line = line.mid(5).trimmed();
+    } else if (line.startsWith("event:") || line.startsWith(':')) {
+        return;  // SSE event names and keep-alive comments
+    }
+    if (line.isEmpty()) return;
+    if (line == "[DONE]") {
+        m_streamDone = true;  // OpenAI-style terminator
+        return;
+    }
+
+    // Lines of a pretty-printed (non-streamed) error body aren't objects; see onStreamFinished()
+    QJsonDocument doc = QJsonDocument::fromJson(line);
+    if (!doc.isObject()) return;
+
+    QJsonObject event = doc.object();
+    QString error = errorMessage(event);
+    if (!error.isEmpty()) {
+        m_streamError = error;
+        return;
+    }
+
+    QString chunk = streamChunk(event);
+    if (!chunk.isEmpty()) {
+        m_streamText += chunk;
+        emit analysisChunk(chunk);
+    }
+    if (streamDone(event)) {
+        m_streamDone = true;
+    }
+}
+
+void AIProvider::onStreamFinished(QNetworkReply* reply)
+{
+    reply->deleteLater();
+    if (reply != m_streamReply) return;
+
+    const bool cancelled = m_streamCancelled;
+    m_streamReply = nullptr;
+    m_streamCancelled = false;
+    setStatus(Status::Ready);
+    if (cancelled) return;
+
+    if (!m_streamBuffer.isEmpty()) {
+        handleStreamLine(m_streamBuffer);  // Last line without a newline
+        m_streamBuffer.clear();
+    }
+
+    // Rejected requests (bad key, unknown model) answer with a plain JSON body
+    if (m_streamError.isEmpty() && m_streamText.isEmpty()) {
+        QJsonDocument doc = QJsonDocument::fromJson(m_streamBody);
+        if (doc.isObject()) {
+            m_streamError = errorMessage(doc.object());
+        }
+    }
+
+    if (!m_streamError.isEmpty()) {
+        emit analysisFailed(name() + " error: " + m_streamError);
+        return;
+    }
+
+    if (reply->error() != QNetworkReply::NoError) {
+        emit analysisFailed(name() + " request failed: " + reply->errorString());
+        return;
+    }
+
+    if (m_streamText.isEmpty()) {
+        emit analysisFailed(name() + " returned no response");
+        return;
+    }
+
+    // Closed cleanly but mid-answer: don't pass off (or cache) a truncated reply
+    if (!m_streamDone) {
+        emit analysisFailed(name() + " response was cut off before it finished");
+        return;
+    }
+
+    emit analysisComplete(m_streamText);
+}
+
+QString AIProvider::errorMessage(const QJsonObject& root)
+{
+    QJsonValue error = root.value("error");
+    if (error.isObject()) {
+        return error.toObject().value("message").toString();
+    }
+    return error.toString();  // Ollama: plain string
+}
+
 // ============================================================================
 // OpenAI Provider
 // ============================================================================
@@ -58,6 +196,7 @@ void OpenAIProvider::analyze(const QString& systemPrompt, const QString& userPro
     messages.append(userMsg);
     requestBody["messages"] = messages;
     requestBody["max_tokens"] = 1024;
+    requestBody["stream"] = true;
 
     QUrl url(QString::fromLatin1(API_URL));
     QNetworkRequest req;
@@ -66,39 +205,21 @@ void OpenAIProvider::analyze(const QString& systemPrompt, const QString& userPro
     req.setRawHeader("Authorization", ("Bearer " + m_apiKey).toUtf8());
 
     QByteArray body = QJsonDocument(requestBody).toJson();
-    QNetworkReply* reply = m_networkManager->post(req, body);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onAnalysisReply(reply);
-    });
+    startStreaming(m_networkManager->post(req, body));
 }
 
-void OpenAIProvider::onAnalysisReply(QNetworkReply* reply)
+QString OpenAIProvider::streamChunk(const QJsonObject& event) const
 {
-    reply->deleteLater();
-    setStatus(Status::Ready);
-
-    if (reply->error() != QNetworkReply::NoError) {
-        emit analysisFailed("OpenAI request failed: " + reply->errorString());
-        return;
-    }
-
-    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-    QJsonObject root = doc.object();
-
-    if (root.contains("error")) {
-        QString errorMsg = root["error"].toObject()["message"].toString();
-        emit analysisFailed("OpenAI error: " + errorMsg);
-        return;
-    }
-
-    QJsonArray choices = root["choices"].toArray();
-    if (choices.isEmpty()) {
-        emit analysisFailed("OpenAI returned no response");
-        return;
-    }
+    QJsonArray choices = event["choices"].toArray();
+    if (choices.isEmpty()) return QString();
+    return choices[0].toObject()["delta"].toObject()["content"].toString();
+}
 
-    QString content = choices[0].toObject()["message"].toObject()["content"].toString();
-    emit analysisComplete(content);
+bool OpenAIProvider::streamDone(const QJsonObject& event) const
+{
+    // The last chunk carries a finish_reason ("stop", "length"), then "data: [DONE]"
+    QJsonArray choices = event["choices"].toArray();
+    return !choices.isEmpty() && choices[0].toObject()["finish_reason"].isString();
 }
 
 void OpenAIProvider::testConnection()
@@ -164,6 +285,7 @@ void AnthropicProvider::analyze(const QString& systemPrompt, const QString& user
     requestBody["model"] = QString::fromLatin1(MODEL);
     requestBody["max_tokens"] = 1024;
     requestBody["system"] = systemPrompt;
+    requestBody["stream"] = true;
     QJsonArray messages;
     QJsonObject userMsg;
     userMsg["role"] = QString("user");
@@ -179,39 +301,19 @@ void AnthropicProvider::analyze(const QString& systemPrompt, const QString& user
     req.setRawHeader("anthropic-version", "2023-06-01");
 
     QByteArray body = QJsonDocument(requestBody).toJson();
-    QNetworkReply* reply = m_networkManager->post(req, body);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onAnalysisReply(reply);
-    });
+    startStreaming(m_networkManager->post(req, body));
 }
 
-void AnthropicProvider::onAnalysisReply(QNetworkReply* reply)
+QString AnthropicProvider::streamChunk(const QJsonObject& event) const
 {
-    reply->deleteLater();
-    setStatus(Status::Ready);
-
-    if (reply->error() != QNetworkReply::NoError) {
-        emit analysisFailed("Anthropic request failed: " + reply->errorString());
-        return;
-    }
-
-    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-    QJsonObject root = doc.object();
-
-    if (root.contains("error")) {
-        QString errorMsg = root["error"].toObject()["message"].toString();
-        emit analysisFailed("Anthropic error: " + errorMsg);
-        return;
-    }
-
-    QJsonArray content = root["content"].toArray();
-    if (content.isEmpty()) {
-        emit analysisFailed("Anthropic returned no response");
-        return;
-    }
+    // message_start, content_block_start, ping, ... carry no text
+    if (event["type"].toString() != "content_block_delta") return QString();
+    return event["delta"].toObject()["text"].toString();
+}
 
-    QString text = content[0].toObject()["text"].toString();
-    emit analysisComplete(text);
+bool AnthropicProvider::streamDone(const QJsonObject& event) const
+{
+    return event["type"].toString() == "message_stop";
 }
 
 void AnthropicProvider::testConnection()
@@ -284,6 +386,13 @@ QString GeminiProvider::apiUrl() const
         .arg(MODEL);
 }
 
+QString GeminiProvider::streamUrl() const
+{
+    // Same response objects as generateContent, one per SSE event
+    return QString("https://generativelanguage.googleapis.com/v1beta/models/%1:streamGenerateContent?alt=sse")
+        .arg(MODEL);
+}
+
 void GeminiProvider::analyze(const QString& systemPrompt, const QString& userPrompt)
 {
     if (!isConfigured()) {
@@ -317,52 +426,34 @@ void GeminiProvider::analyze(const QString& systemPrompt, const QString& userPro
     contents.append(userContent);
     requestBody["contents"] = contents;
 
-    QUrl url(apiUrl());
+    QUrl url(streamUrl());
     QNetworkRequest req;
     req.setUrl(url);
     req.setHeader(QNetworkRequest::ContentTypeHeader, QVariant(QString("application/json")));
     req.setRawHeader("x-goog-api-key", m_apiKey.toUtf8());
 
     QByteArray body = QJsonDocument(requestBody).toJson();
-    QNetworkReply* reply = m_networkManager->post(req, body);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onAnalysisReply(reply);
-    });
+    startStreaming(m_networkManager->post(req, body));
 }
 
-void GeminiProvider::onAnalysisReply(QNetworkReply* reply)
+QString GeminiProvider::streamChunk(const QJsonObject& event) const
 {
-    reply->deleteLater();
-    setStatus(Status::Ready);
-
-    if (reply->error() != QNetworkReply::NoError) {
-        emit analysisFailed("Gemini request failed: " + reply->errorString());
-        return;
-    }
-
-    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-    QJsonObject root = doc.object();
-
-    if (root.contains("error")) {
-        QString errorMsg = root["error"].toObject()["message"].toString();
-        emit analysisFailed("Gemini error: " + errorMsg);
-        return;
-    }
+    QJsonArray candidates = event["candidates"].toArray();
+    if (candidates.isEmpty()) return QString();
 
-    QJsonArray candidates = root["candidates"].toArray();
-    if (candidates.isEmpty()) {
-        emit analysisFailed("Gemini returned no response");
-        return;
-    }
-
-    QJsonArray parts = candidates[0].toObject()["content"].toObject()["parts"].toArray();
-    if (parts.isEmpty()) {
-        emit analysisFailed("Gemini returned empty content");
-        return;
+    QString text;
+    const QJsonArray parts = candidates[0].toObject()["content"].toObject()["parts"].toArray();
+    for (const auto& part : parts) {
+        text += part.toObject()["text"].toString();
     }
+    return text;
+}
 
-    QString text = parts[0].toObject()["text"].toString();
-    emit analysisComplete(text);
+bool GeminiProvider::streamDone(const QJsonObject& event) const
+{
+    // The last response object carries the candidate's finishReason
+    QJsonArray candidates = event["candidates"].toArray();
+    return !candidates.isEmpty() && !candidates[0].toObject()["finishReason"].toString().isEmpty();
 }
 
 void GeminiProvider::testConnection()
@@ -454,6 +545,7 @@ void OpenRouterProvider::analyze(const QString& systemPrompt, const QString& use
     messages.append(userMsg);
     requestBody["messages"] = messages;
     requestBody["max_tokens"] = 1024;
+    requestBody["stream"] = true;
 
     QUrl url(QString::fromLatin1(API_URL));
     QNetworkRequest req;
@@ -465,39 +557,20 @@ void OpenRouterProvider::analyze(const QString& systemPrompt, const QString& use
     req.setRawHeader("X-Title", "Decenza DE1");
 
     QByteArray body = QJsonDocument(requestBody).toJson();
-    QNetworkReply* reply = m_networkManager->post(req, body);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onAnalysisReply(reply);
-    });
+    startStreaming(m_networkManager->post(req, body));
 }
 
-void OpenRouterProvider::onAnalysisReply(QNetworkReply* reply)
+QString OpenRouterProvider::streamChunk(const QJsonObject& event) const
 {
-    reply->deleteLater();
-    setStatus(Status::Ready);
-
-    if (reply->error() != QNetworkReply::NoError) {
-        emit analysisFailed("OpenRouter request failed: " + reply->errorString());
-        return;
-    }
-
-    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-    QJsonObject root = doc.object();
-
-    if (root.contains("error")) {
-        QString errorMsg = root["error"].toObject()["message"].toString();
-        emit analysisFailed("OpenRouter error: " + errorMsg);
-        return;
-    }
-
-    QJsonArray choices = root["choices"].toArray();
-    if (choices.isEmpty()) {
-        emit analysisFailed("OpenRouter returned no response");
-        return;
-    }
+    QJsonArray choices = event["choices"].toArray();
+    if (choices.isEmpty()) return QString();
+    return choices[0].toObject()["delta"].toObject()["content"].toString();
+}
 
-    QString content = choices[0].toObject()["message"].toObject()["content"].toString();
-    emit analysisComplete(content);
+bool OpenRouterProvider::streamDone(const QJsonObject& event) const
+{
+    QJsonArray choices = event["choices"].toArray();
+    return !choices.isEmpty() && choices[0].toObject()["finish_reason"].isString();
 }
 
 void OpenRouterProvider::testConnection()
@@ -579,7 +652,7 @@ void OllamaProvider::analyze(const QString& systemPrompt, const QString& userPro
     requestBody["model"] = m_model;
     requestBody["prompt"] = userPrompt;
     requestBody["system"] = systemPrompt;
-    requestBody["stream"] = false;
+    requestBody["stream"] = true;
 
     QString urlStr = m_endpoint;
     if (!urlStr.endsWith(QString("/"))) urlStr += QString("/");
@@ -591,37 +664,18 @@ void OllamaProvider::analyze(const QString& systemPrompt, const QString& userPro
     req.setHeader(QNetworkRequest::ContentTypeHeader, QVariant(QString("application/json")));
 
     QByteArray body = QJsonDocument(requestBody).toJson();
-    QNetworkReply* reply = m_networkManager->post(req, body);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onAnalysisReply(reply);
-    });
+    startStreaming(m_networkManager->post(req, body));
 }
 
-void OllamaProvider::onAnalysisReply(QNetworkReply* reply)
+QString OllamaProvider::streamChunk(const QJsonObject& event) const
 {
-    reply->deleteLater();
-    setStatus(Status::Ready);
-
-    if (reply->error() != QNetworkReply::NoError) {
-        emit analysisFailed("Ollama request failed: " + reply->errorString());
-        return;
-    }
-
-    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-    QJsonObject root = doc.object();
-
-    if (root.contains("error")) {
-        emit analysisFailed("Ollama error: " + root["error"].toString());
-        return;
-    }
-
-    QString response = root["response"].toString();
-    if (response.isEmpty()) {
-        emit analysisFailed("Ollama returned empty response");
-        return;
-    }
+    // One JSON object per line; the last has "done": true and no text
+    return event["response"].toString();
+}
 
-    emit analysisComplete(response);
+bool OllamaProvider::streamDone(const QJsonObject& event) const
+{
+    return event["done"].toBool();
 }
 
 void OllamaProvider::testConnection()
@@ -4,6 +4,8 @@
 #include <QString>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QPointer>
+#include <QJsonObject>
 
 // Abstract base class for AI providers
 class AIProvider : public QObject {
@@ -18,18 +20,24 @@ public:
 
     virtual QString name() const = 0;
     virtual QString id() const = 0;  // "openai", "anthropic", "gemini", "ollama"
+    virtual QString modelName() const = 0;
     virtual bool isConfigured() const = 0;
     virtual bool isLocal() const { return false; }
 
     Status status() const { return m_status; }
 
-    // Main analysis method
+    // Main analysis method. The response streams in through analysisChunk(),
+    // then analysisComplete() carries the whole text.
     virtual void analyze(const QString& systemPrompt, const QString& userPrompt) = 0;
 
+    // Abort the analysis in flight; no further signals are emitted for it
+    void cancel();
+
     // Test connection
     virtual void testConnection() = 0;
 
 signals:
+    void analysisChunk(const QString& chunk);
     void analysisComplete(const QString& response);
     void analysisFailed(const QString& error);
     void statusChanged(Status status);
@@ -37,8 +45,33 @@ signals:
 
 protected:
     void setStatus(Status status);
+
+    // Read an analysis reply as it arrives: SSE ("data: {...}" lines) or JSON lines (Ollama)
+    void startStreaming(QNetworkReply* reply);
+    // Text carried by one stream event, empty for events without text
+    virtual QString streamChunk(const QJsonObject& event) const = 0;
+    // True for the event that ends a complete answer. A stream that closes
+    // without one was cut off (dropped connection, proxy timeout) and fails.
+    virtual bool streamDone(const QJsonObject& event) const = 0;
+
     QNetworkAccessManager* m_networkManager = nullptr;
     Status m_status = Status::Ready;
+
+private:
+    void onStreamData(QNetworkReply* reply);
+    void onStreamFinished(QNetworkReply* reply);
+    void handleStreamLine(QByteArray line);
+    static QString errorMessage(const QJsonObject& root);
+
+    QPointer<QNetworkReply> m_streamReply;
+    QByteArray m_streamBuffer;      // Incomplete last line
+    QByteArray m_streamBody;        // Raw body until text arrives (error replies aren't streamed)
+    QString m_streamText;
+    QString m_streamError;
+    bool m_streamDone = false;      // The provider's end-of-answer event arrived
+    bool m_streamCancelled = false;
+
+    static constexpr int MAX_ERROR_BODY = 64 * 1024;
 };
 
 // OpenAI GPT-4o provider
@@ -52,6 +85,7 @@ public:
 
     QString name() const override { return "OpenAI"; }
     QString id() const override { return "openai"; }
+    QString modelName() const override { return QString::fromLatin1(MODEL); }
     bool isConfigured() const override { return !m_apiKey.isEmpty(); }
 
     void setApiKey(const QString& key) { m_apiKey = key; }
@@ -60,10 +94,12 @@ public:
     void testConnection() override;
 
 private slots:
-    void onAnalysisReply(QNetworkReply* reply);
     void onTestReply(QNetworkReply* reply);
 
 private:
+    QString streamChunk(const QJsonObject& event) const override;
+    bool streamDone(const QJsonObject& event) const override;
+
     QString m_apiKey;
     static constexpr const char* API_URL = "https://api.openai.com/v1/chat/completions";
     static constexpr const char* MODEL = "gpt-4o";
@@ -80,6 +116,7 @@ public:
 
     QString name() const override { return "Anthropic"; }
     QString id() const override { return "anthropic"; }
+    QString modelName() const override { return QString::fromLatin1(MODEL); }
     bool isConfigured() const override { return !m_apiKey.isEmpty(); }
 
     void setApiKey(const QString& key) { m_apiKey = key; }
@@ -88,10 +125,12 @@ public:
     void testConnection() override;
 
 private slots:
-    void onAnalysisReply(QNetworkReply* reply);
     void onTestReply(QNetworkReply* reply);
 
 private:
+    QString streamChunk(const QJsonObject& event) const override;
+    bool streamDone(const QJsonObject& event) const override;
+
     QString m_apiKey;
     static constexpr const char* API_URL = "https://api.anthropic.com/v1/messages";
     static constexpr const char* MODEL = "claude-sonnet-4-20250514";
@@ -108,6 +147,7 @@ public:
 
     QString name() const override { return "Google Gemini"; }
     QString id() const override { return "gemini"; }
+    QString modelName() const override { return QString::fromLatin1(MODEL); }
     bool isConfigured() const override { return !m_apiKey.isEmpty(); }
 
     void setApiKey(const QString& key) { m_apiKey = key; }
@@ -116,13 +156,16 @@ public:
     void testConnection() override;
 
 private slots:
-    void onAnalysisReply(QNetworkReply* reply);
     void onTestReply(QNetworkReply* reply);
 
 private:
+    QString streamChunk(const QJsonObject& event) const override;
+    bool streamDone(const QJsonObject& event) const override;
+
     QString m_apiKey;
     static constexpr const char* MODEL = "gemini-2.0-flash";
     QString apiUrl() const;
+    QString streamUrl() const;
 };
 
 // OpenRouter provider (multiple models via OpenAI-compatible API)
@@ -137,6 +180,7 @@ public:
 
     QString name() const override { return "OpenRouter"; }
     QString id() const override { return "openrouter"; }
+    QString modelName() const override { return m_model; }
     bool isConfigured() const override { return !m_apiKey.isEmpty() && !m_model.isEmpty(); }
 
     void setApiKey(const QString& key) { m_apiKey = key; }
@@ -146,10 +190,12 @@ public:
     void testConnection() override;
 
 private slots:
-    void onAnalysisReply(QNetworkReply* reply);
     void onTestReply(QNetworkReply* reply);
 
 private:
+    QString streamChunk(const QJsonObject& event) const override;
+    bool streamDone(const QJsonObject& event) const override;
+
     QString m_apiKey;
     QString m_model;
     static constexpr const char* API_URL = "https://openrouter.ai/api/v1/chat/completions";
@@ -167,6 +213,7 @@ public:
 
     QString name() const override { return "Ollama"; }
     QString id() const override { return "ollama"; }
+    QString modelName() const override { return m_model; }
     bool isConfigured() const override { return !m_endpoint.isEmpty() && !m_model.isEmpty(); }
     bool isLocal() const override { return true; }
 
@@ -183,11 +230,13 @@ signals:
     void modelsRefreshed(const QStringList& models);
 
 private slots:
-    void onAnalysisReply(QNetworkReply* reply);
     void onTestReply(QNetworkReply* reply);
     void onModelsReply(QNetworkReply* reply);
 
 private:
+    QString streamChunk(const QJsonObject& event) const override;
+    bool streamDone(const QJsonObject& event) const override;
+
     QString m_endpoint;
     QString m_model;
 };
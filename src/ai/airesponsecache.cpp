@@ -0,0 +1,219 @@
+#include "airesponsecache.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QStandardPaths>
+#include <QDir>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QDebug>
+
+const QString AIResponseCache::DB_CONNECTION_NAME = "AIResponseCacheConnection";
+
+AIResponseCache::AIResponseCache() = default;
+
+AIResponseCache::~AIResponseCache()
+{
+    if (m_db.isOpen()) {
+        m_db.close();
+    }
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(DB_CONNECTION_NAME);
+}
+
+bool AIResponseCache::open(const QString& dbPath)
+{
+    QString path = dbPath;
+    if (path.isEmpty()) {
+        QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+        QDir().mkpath(dataDir);
+        path = dataDir + "/ai_cache.db";
+    }
+
+    if (QSqlDatabase::contains(DB_CONNECTION_NAME)) {
+        QSqlDatabase::removeDatabase(DB_CONNECTION_NAME);
+    }
+
+    m_db = QSqlDatabase::addDatabase("QSQLITE", DB_CONNECTION_NAME);
+    m_db.setDatabaseName(path);
+
+    if (!m_db.open()) {
+        qWarning() << "AIResponseCache: Failed to open database:" << m_db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery pragma(m_db);
+    pragma.exec("PRAGMA journal_mode=WAL");
+
+    if (!createTables()) {
+        m_db.close();
+        return false;
+    }
+
+    int purged = purgeExpired();
+    qDebug() << "AIResponseCache: Opened" << path << "(" << purged << "expired entries removed)";
+    return true;
+}
+
+bool AIResponseCache::createTables()
+{
+    QSqlQuery query(m_db);
+
+    QString createResponses = R"(
+        CREATE TABLE IF NOT EXISTS ai_responses (
+            cache_key TEXT PRIMARY KEY,
+            provider TEXT NOT NULL,
+            model TEXT NOT NULL,
+            response TEXT NOT NULL,
+            created_at INTEGER NOT NULL,
+            hit_count INTEGER DEFAULT 0
+        )
+    )";
+
+    if (!query.exec(createResponses)) {
+        qWarning() << "AIResponseCache: Failed to create ai_responses table:" << query.lastError().text();
+        return false;
+    }
+
+    // Single row of lookup counters
+    QString createStats = R"(
+        CREATE TABLE IF NOT EXISTS ai_cache_stats (
+            id INTEGER PRIMARY KEY CHECK (id = 1),
+            hits INTEGER NOT NULL DEFAULT 0,
+            misses INTEGER NOT NULL DEFAULT 0
+        )
+    )";
+
+    if (!query.exec(createStats)) {
+        qWarning() << "AIResponseCache: Failed to create ai_cache_stats table:" << query.lastError().text();
+        return false;
+    }
+    query.exec("INSERT OR IGNORE INTO ai_cache_stats (id, hits, misses) VALUES (1, 0, 0)");
+    query.exec("CREATE INDEX IF NOT EXISTS idx_ai_responses_created ON ai_responses(created_at)");
+
+    return true;
+}
+
+QString AIResponseCache::normalize(const QString& prompt)
+{
+    // Line endings and trailing whitespace don't change what the model is asked
+    QString text = prompt;
+    text.replace("\r\n", "\n");
+
+    QStringList lines = text.split('\n');
+    for (QString& line : lines) {
+        while (!line.isEmpty() && line.back().isSpace()) {
+            line.chop(1);
+        }
+    }
+    return lines.join('\n').trimmed();
+}
+
+QString AIResponseCache::key(const QString& provider, const QString& model,
+                             const QString& systemPrompt, const QString& userPrompt)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(provider.toUtf8());
+    hash.addData(QByteArrayView("\0", 1));
+    hash.addData(model.toUtf8());
+    hash.addData(QByteArrayView("\0", 1));
+    hash.addData(normalize(systemPrompt).toUtf8());
+    hash.addData(QByteArrayView("\0", 1));
+    hash.addData(normalize(userPrompt).toUtf8());
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+qint64 AIResponseCache::expiryCutoff() const
+{
+    return m_clock() - static_cast<qint64>(m_ttlDays) * 24 * 60 * 60 * 1000;
+}
+
+bool AIResponseCache::lookup(const QString& key, QString* response)
+{
+    if (!isEnabled()) return false;
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT response FROM ai_responses WHERE cache_key = ? AND created_at >= ?");
+    query.addBindValue(key);
+    query.addBindValue(expiryCutoff());
+
+    bool hit = query.exec() && query.next();
+    if (hit) {
+        *response = query.value(0).toString();
+
+        QSqlQuery update(m_db);
+        update.prepare("UPDATE ai_responses SET hit_count = hit_count + 1 WHERE cache_key = ?");
+        update.addBindValue(key);
+        update.exec();
+    }
+
+    countLookup(hit);
+    return hit;
+}
+
+void AIResponseCache::store(const QString& key, const QString& provider, const QString& model,
+                            const QString& response)
+{
+    if (!isEnabled() || response.isEmpty()) return;
+
+    QSqlQuery query(m_db);
+    query.prepare(R"(
+        INSERT OR REPLACE INTO ai_responses (cache_key, provider, model, response, created_at, hit_count)
+        VALUES (?, ?, ?, ?, ?, 0)
+    )");
+    query.addBindValue(key);
+    query.addBindValue(provider);
+    query.addBindValue(model);
+    query.addBindValue(response);
+    query.addBindValue(m_clock());
+
+    if (!query.exec()) {
+        qWarning() << "AIResponseCache: Failed to store response:" << query.lastError().text();
+    }
+}
+
+void AIResponseCache::countLookup(bool hit)
+{
+    QSqlQuery query(m_db);
+    query.exec(hit ? "UPDATE ai_cache_stats SET hits = hits + 1 WHERE id = 1"
+                   : "UPDATE ai_cache_stats SET misses = misses + 1 WHERE id = 1");
+}
+
+void AIResponseCache::clear()
+{
+    if (!isOpen()) return;
+
+    QSqlQuery query(m_db);
+    query.exec("DELETE FROM ai_responses");
+    query.exec("UPDATE ai_cache_stats SET hits = 0, misses = 0 WHERE id = 1");
+}
+
+int AIResponseCache::purgeExpired()
+{
+    if (!isOpen() || m_ttlDays <= 0) return 0;
+
+    QSqlQuery query(m_db);
+    query.prepare("DELETE FROM ai_responses WHERE created_at < ?");
+    query.addBindValue(expiryCutoff());
+    return query.exec() ? query.numRowsAffected() : 0;
+}
+
+QVariantMap AIResponseCache::stats() const
+{
+    QVariantMap result;
+    result["entries"] = 0;
+    result["hits"] = 0;
+    result["misses"] = 0;
+    result["ttlDays"] = m_ttlDays;
+    if (!isOpen()) return result;
+
+    QSqlQuery query(m_db);
+    if (query.exec("SELECT COUNT(*) FROM ai_responses") && query.next()) {
+        result["entries"] = query.value(0).toInt();
+    }
+    if (query.exec("SELECT hits, misses FROM ai_cache_stats WHERE id = 1") && query.next()) {
+        result["hits"] = query.value(0).toLongLong();
+        result["misses"] = query.value(1).toLongLong();
+    }
+    return result;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QString>
+#include <QSqlDatabase>
+#include <QDateTime>
+#include <QVariantMap>
+#include <functional>
+
+/**
+ * AIResponseCache - Persistent cache of AI responses
+ *
+ * Re-analyzing a shot with unchanged metadata builds the same prompt, which
+ * takes seconds on Ollama and costs money on cloud providers. Responses are
+ * stored in SQLite keyed by provider, model and a SHA-256 of the normalized
+ * system and user prompts, so repeats are served without a request.
+ *
+ * Entries expire after the TTL (ttlDays <= 0 disables the cache). Hit and
+ * miss counts are persisted with the entries.
+ */
+class AIResponseCache {
+public:
+    AIResponseCache();
+    ~AIResponseCache();
+
+    bool open(const QString& dbPath = QString());  // Default: AppDataLocation/ai_cache.db
+    bool isOpen() const { return m_db.isOpen(); }
+
+    void setTtlDays(int days) { m_ttlDays = days; }
+    int ttlDays() const { return m_ttlDays; }
+    bool isEnabled() const { return isOpen() && m_ttlDays > 0; }
+
+    static QString key(const QString& provider, const QString& model,
+                       const QString& systemPrompt, const QString& userPrompt);
+
+    // Counts a hit or miss; returns false on a miss or expired entry
+    bool lookup(const QString& key, QString* response);
+    void store(const QString& key, const QString& provider, const QString& model, const QString& response);
+
+    void clear();
+    int purgeExpired();
+
+    // {entries, hits, misses, ttlDays}
+    QVariantMap stats() const;
+
+    // Time source for created_at and expiry, ms since epoch. Defaults to the wall
+    // clock; de1harness --ai-cache-check moves it forward to age entries past the TTL.
+    void setClock(std::function<qint64()> clock) { m_clock = std::move(clock); }
+
+private:
+    bool createTables();
+    void countLookup(bool hit);
+    qint64 expiryCutoff() const;  // created_at (ms since epoch) below this has expired
+
+    static QString normalize(const QString& prompt);
+
+    QSqlDatabase m_db;
+    int m_ttlDays = DEFAULT_TTL_DAYS;
+    std::function<qint64()> m_clock = &QDateTime::currentMSecsSinceEpoch;
+
+    static constexpr int DEFAULT_TTL_DAYS = 30;
+    static const QString DB_CONNECTION_NAME;
+};
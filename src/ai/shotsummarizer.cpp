@@ -3,9 +3,6 @@
 #include "../profile/profile.h"
 #include "../network/visualizeruploader.h"
 
-#include <cmath>
-#include <algorithm>
-
 ShotSummarizer::ShotSummarizer(QObject* parent)
     : QObject(parent)
 {
@@ -67,107 +64,74 @@ ShotSummary ShotSummarizer::summarize(const ShotDataModel* shotData,
     summary.enjoymentScore = metadata.espressoEnjoyment;
     summary.tastingNotes = metadata.espressoNotes;
 
+    // Running statistics were accumulated while the shot was recorded
+    const ShotPhaseStats& stats = shotData->phaseStats();
+
     // Extraction indicators
-    summary.timeToFirstDrip = findTimeToFirstDrip(flowData);
+    summary.timeToFirstDrip = stats.timeToFirstDrip();
     // Channeling detection will be done after phase processing (see below)
 
     // Temperature stability check - compare actual vs TARGET (not just variance)
     // A declining temperature profile is intentional, not "unstable"
-    const auto& tempGoalData = shotData->temperatureGoalData();
-    if (!tempGoalData.isEmpty()) {
-        // Calculate average deviation from target
-        double deviationSum = 0;
-        int count = 0;
-        for (const auto& point : tempData) {
-            double target = findValueAtTime(tempGoalData, point.x());
-            if (target > 0) {
-                deviationSum += std::abs(point.y() - target);
-                count++;
-            }
-        }
-        double avgDeviation = count > 0 ? deviationSum / count : 0;
-        summary.temperatureUnstable = avgDeviation > 2.0;  // >2°C average deviation from target
+    if (!shotData->temperatureGoalData().isEmpty()) {
+        // Average deviation from target
+        summary.temperatureUnstable = stats.temperatureGoalDeviation().mean > 2.0;  // >2°C average deviation from target
     } else {
         // No target data - fall back to variance check
-        double tempStdDev = calculateStdDev(tempData, 0, summary.totalDuration);
-        summary.temperatureUnstable = tempStdDev > 2.0;
+        summary.temperatureUnstable = stats.wholeShot().temperature.stdDev() > 2.0;
     }
 
-    // Get phase markers from shot data
-    QVariantList markers = shotData->phaseMarkersVariant();
-
-    if (markers.isEmpty()) {
-        // No markers - create a single "Extraction" phase
+    auto makePhase = [&](const PhaseStats& phaseStats, const QString& name, double startTime, double endTime) {
         PhaseSummary phase;
-        phase.name = "Extraction";
-        phase.startTime = 0;
-        phase.endTime = summary.totalDuration;
-        phase.duration = summary.totalDuration;
-
-        phase.avgPressure = calculateAverage(pressureData, 0, summary.totalDuration);
-        phase.maxPressure = calculateMax(pressureData, 0, summary.totalDuration);
-        phase.minPressure = calculateMin(pressureData, 0, summary.totalDuration);
-        phase.pressureAtStart = findValueAtTime(pressureData, 0);
-        phase.pressureAtMiddle = findValueAtTime(pressureData, summary.totalDuration / 2);
-        phase.pressureAtEnd = findValueAtTime(pressureData, summary.totalDuration);
-
-        phase.avgFlow = calculateAverage(flowData, 0, summary.totalDuration);
-        phase.maxFlow = calculateMax(flowData, 0, summary.totalDuration);
-        phase.minFlow = calculateMin(flowData, 0, summary.totalDuration);
-        phase.flowAtStart = findValueAtTime(flowData, 0);
-        phase.flowAtMiddle = findValueAtTime(flowData, summary.totalDuration / 2);
-        phase.flowAtEnd = findValueAtTime(flowData, summary.totalDuration);
-
-        phase.avgTemperature = calculateAverage(tempData, 0, summary.totalDuration);
-        phase.tempStability = calculateStdDev(tempData, 0, summary.totalDuration);
-
-        double startWeight = findValueAtTime(cumulativeWeightData, 0);
-        double endWeight = findValueAtTime(cumulativeWeightData, summary.totalDuration);
+        phase.name = name;
+        phase.startTime = startTime;
+        phase.endTime = endTime;
+        phase.duration = endTime - startTime;
+        phase.isFlowMode = phaseStats.isFlowMode;
+
+        // Pressure metrics
+        phase.avgPressure = phaseStats.pressure.mean;
+        phase.maxPressure = phaseStats.pressure.maximum();
+        phase.minPressure = phaseStats.pressure.minimum();
+        phase.pressureAtStart = findValueAtTime(pressureData, startTime);
+        phase.pressureAtMiddle = findValueAtTime(pressureData, (startTime + endTime) / 2);
+        phase.pressureAtEnd = findValueAtTime(pressureData, endTime);
+
+        // Flow metrics
+        phase.avgFlow = phaseStats.flow.mean;
+        phase.maxFlow = phaseStats.flow.maximum();
+        phase.minFlow = phaseStats.flow.minimum();
+        phase.flowAtStart = findValueAtTime(flowData, startTime);
+        phase.flowAtMiddle = findValueAtTime(flowData, (startTime + endTime) / 2);
+        phase.flowAtEnd = findValueAtTime(flowData, endTime);
+
+        // Temperature metrics
+        phase.avgTemperature = phaseStats.temperature.mean;
+        phase.tempStability = phaseStats.temperature.stdDev();
+
+        // Weight gained
+        double startWeight = findValueAtTime(cumulativeWeightData, startTime);
+        double endWeight = findValueAtTime(cumulativeWeightData, endTime);
         phase.weightGained = endWeight - startWeight;
+        return phase;
+    };
+
+    const QVector<PhaseStats>& phases = stats.phases();
 
-        summary.phases.append(phase);
+    if (phases.isEmpty()) {
+        // No markers - create a single "Extraction" phase
+        summary.phases.append(makePhase(stats.wholeShot(), "Extraction", 0, summary.totalDuration));
     } else {
         // Process each phase from markers
-        for (int i = 0; i < markers.size(); i++) {
-            QVariantMap marker = markers[i].toMap();
-            double startTime = marker["time"].toDouble();
-            double endTime = (i + 1 < markers.size())
-                ? markers[i + 1].toMap()["time"].toDouble()
+        for (int i = 0; i < phases.size(); i++) {
+            double startTime = phases[i].startTime;
+            double endTime = (i + 1 < phases.size())
+                ? phases[i + 1].startTime
                 : summary.totalDuration;
 
             if (endTime <= startTime) continue;
 
-            PhaseSummary phase;
-            phase.name = marker["label"].toString();
-            phase.startTime = startTime;
-            phase.endTime = endTime;
-            phase.duration = endTime - startTime;
-            phase.isFlowMode = marker["isFlowMode"].toBool();
-
-            // Pressure metrics
-            phase.avgPressure = calculateAverage(pressureData, startTime, endTime);
-            phase.maxPressure = calculateMax(pressureData, startTime, endTime);
-            phase.minPressure = calculateMin(pressureData, startTime, endTime);
-            phase.pressureAtStart = findValueAtTime(pressureData, startTime);
-            phase.pressureAtMiddle = findValueAtTime(pressureData, (startTime + endTime) / 2);
-            phase.pressureAtEnd = findValueAtTime(pressureData, endTime);
-
-            // Flow metrics
-            phase.avgFlow = calculateAverage(flowData, startTime, endTime);
-            phase.maxFlow = calculateMax(flowData, startTime, endTime);
-            phase.minFlow = calculateMin(flowData, startTime, endTime);
-            phase.flowAtStart = findValueAtTime(flowData, startTime);
-            phase.flowAtMiddle = findValueAtTime(flowData, (startTime + endTime) / 2);
-            phase.flowAtEnd = findValueAtTime(flowData, endTime);
-
-            // Temperature metrics
-            phase.avgTemperature = calculateAverage(tempData, startTime, endTime);
-            phase.tempStability = calculateStdDev(tempData, startTime, endTime);
-
-            // Weight gained
-            double startWeight = findValueAtTime(cumulativeWeightData, startTime);
-            double endWeight = findValueAtTime(cumulativeWeightData, endTime);
-            phase.weightGained = endWeight - startWeight;
+            PhaseSummary phase = makePhase(phases[i], phases[i].label, startTime, endTime);
 
             // Track preinfusion duration
             QString lowerName = phase.name.toLower();
@@ -194,7 +158,9 @@ ShotSummary ShotSummarizer::summarize(const ShotDataModel* shotData,
             break;
         }
     }
-    summary.channelingDetected = detectChanneling(flowData, extractionStartTime);
+    // Sudden flow spikes (>50% increase in 0.5s) AFTER preinfusion
+    // During preinfusion, flow naturally ramps up as water saturates the puck - this is normal
+    summary.channelingDetected = stats.lastFlowSpikeTime() >= extractionStartTime;
 
     return summary;
 }
@@ -389,110 +355,25 @@ If the shot tasted good (score 80+), acknowledge success! Suggest only minor ref
 Keep responses concise and practical. The goal is a better-tasting next shot, not a perfect analysis.)");
 }
 
-double ShotSummarizer::findValueAtTime(const QVector<QPointF>& data, double time) const
-{
-    if (data.isEmpty()) return 0;
-
-    // Find closest point
-    for (int i = 0; i < data.size(); i++) {
-        if (data[i].x() >= time) {
-            if (i == 0) return data[i].y();
-            // Linear interpolation
-            double t = (time - data[i-1].x()) / (data[i].x() - data[i-1].x());
-            return data[i-1].y() + t * (data[i].y() - data[i-1].y());
-        }
-    }
-    return data.last().y();
-}
-
-double ShotSummarizer::calculateAverage(const QVector<QPointF>& data, double startTime, double endTime) const
-{
-    if (data.isEmpty()) return 0;
-
-    double sum = 0;
-    int count = 0;
-    for (const auto& point : data) {
-        if (point.x() >= startTime && point.x() <= endTime) {
-            sum += point.y();
-            count++;
-        }
-    }
-    return count > 0 ? sum / count : 0;
-}
-
-double ShotSummarizer::calculateMax(const QVector<QPointF>& data, double startTime, double endTime) const
-{
-    if (data.isEmpty()) return 0;
-
-    double maxVal = -std::numeric_limits<double>::infinity();
-    for (const auto& point : data) {
-        if (point.x() >= startTime && point.x() <= endTime) {
-            maxVal = std::max(maxVal, point.y());
-        }
-    }
-    return maxVal == -std::numeric_limits<double>::infinity() ? 0 : maxVal;
-}
-
-double ShotSummarizer::calculateMin(const QVector<QPointF>& data, double startTime, double endTime) const
+double ShotSummarizer::findValueAtTime(const SampleView& data, double time) const
 {
     if (data.isEmpty()) return 0;
 
-    double minVal = std::numeric_limits<double>::infinity();
-    for (const auto& point : data) {
-        if (point.x() >= startTime && point.x() <= endTime) {
-            minVal = std::min(minVal, point.y());
-        }
-    }
-    return minVal == std::numeric_limits<double>::infinity() ? 0 : minVal;
-}
-
-double ShotSummarizer::calculateStdDev(const QVector<QPointF>& data, double startTime, double endTime) const
-{
-    if (data.isEmpty()) return 0;
-
-    double avg = calculateAverage(data, startTime, endTime);
-    double sumSquares = 0;
-    int count = 0;
-
-    for (const auto& point : data) {
-        if (point.x() >= startTime && point.x() <= endTime) {
-            double diff = point.y() - avg;
-            sumSquares += diff * diff;
-            count++;
-        }
-    }
-
-    return count > 1 ? std::sqrt(sumSquares / (count - 1)) : 0;
-}
-
-double ShotSummarizer::findTimeToFirstDrip(const QVector<QPointF>& flowData) const
-{
-    const double threshold = 0.5;  // mL/s - when we consider "drip" has started
-    for (const auto& point : flowData) {
-        if (point.y() >= threshold) {
-            return point.x();
+    // First point at or after time (curves are in time order)
+    qsizetype lo = 0;
+    qsizetype hi = data.size();
+    while (lo < hi) {
+        qsizetype mid = lo + (hi - lo) / 2;
+        if (data.time(mid) >= time) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
         }
     }
-    return 0;
-}
 
-bool ShotSummarizer::detectChanneling(const QVector<QPointF>& flowData, double afterTime) const
-{
-    if (flowData.size() < 10) return false;
-
-    // Look for sudden flow spikes (>50% increase in 0.5s) AFTER preinfusion
-    // During preinfusion, flow naturally ramps up as water saturates the puck - this is normal
-    for (int i = 5; i < flowData.size() - 5; i++) {
-        // Skip preinfusion phase - flow variations are expected there
-        if (flowData[i].x() < afterTime) continue;
-
-        double prevFlow = flowData[i - 5].y();
-        double currFlow = flowData[i].y();
-
-        // Only flag channeling if we see sudden spikes during main extraction
-        if (prevFlow > 0.5 && currFlow > prevFlow * 1.5) {
-            return true;
-        }
-    }
-    return false;
+    if (lo == data.size()) return data.last().y();
+    if (lo == 0) return data.value(0);
+    // Linear interpolation
+    double t = (time - data.time(lo - 1)) / (data.time(lo) - data.time(lo - 1));
+    return data.value(lo - 1) + t * (data.value(lo) - data.value(lo - 1));
 }
@@ -5,6 +5,7 @@
 #include <QList>
 #include <QVector>
 #include <QPointF>
+#include "../models/shotsamplestore.h"
 
 class ShotDataModel;
 class Profile;
@@ -57,16 +58,16 @@ struct ShotSummary {
     // Phase breakdown
     QList<PhaseSummary> phases;
 
-    // Raw curve data for detailed analysis
-    QVector<QPointF> pressureCurve;
-    QVector<QPointF> flowCurve;
-    QVector<QPointF> tempCurve;
-    QVector<QPointF> weightCurve;
+    // Raw curve data for detailed analysis (views into the shot's sample store)
+    SampleView pressureCurve;
+    SampleView flowCurve;
+    SampleView tempCurve;
+    SampleView weightCurve;
 
     // Target/goal curves (what the profile intended)
-    QVector<QPointF> pressureGoalCurve;
-    QVector<QPointF> flowGoalCurve;
-    QVector<QPointF> tempGoalCurve;
+    SampleView pressureGoalCurve;
+    SampleView flowGoalCurve;
+    SampleView tempGoalCurve;
 
     // Extraction indicators
     double timeToFirstDrip = 0;  // When flow > 0.5 mL/s
@@ -94,7 +95,8 @@ class ShotSummarizer : public QObject {
 public:
     explicit ShotSummarizer(QObject* parent = nullptr);
 
-    // Main summarization method
+    // Main summarization method. Averages, extrema and anomaly flags come from the
+    // statistics ShotDataModel accumulated while recording, not from rescanning curves.
     ShotSummary summarize(const ShotDataModel* shotData,
                           const Profile* profile,
                           const ShotMetadata& metadata,
@@ -108,12 +110,6 @@ public:
     static QString systemPrompt();
 
 private:
-    // Helper methods
-    double findValueAtTime(const QVector<QPointF>& data, double time) const;
-    double calculateAverage(const QVector<QPointF>& data, double startTime, double endTime) const;
-    double calculateMax(const QVector<QPointF>& data, double startTime, double endTime) const;
-    double calculateMin(const QVector<QPointF>& data, double startTime, double endTime) const;
-    double calculateStdDev(const QVector<QPointF>& data, double startTime, double endTime) const;
-    double findTimeToFirstDrip(const QVector<QPointF>& flowData) const;
-    bool detectChanneling(const QVector<QPointF>& flowData, double afterTime) const;
+    // Interpolated curve value (binary search); phase aggregates come from ShotDataModel::phaseStats()
+    double findValueAtTime(const SampleView& data, double time) const;
 };
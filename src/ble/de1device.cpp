@@ -2,6 +2,9 @@
 #include "protocol/binarycodec.h"
 #include "profile/profile.h"
 #include "../core/settings.h"
+#include "../core/monotonicclock.h"
+#include "../core/hotpathlog.h"
+#include "../core/flightrecorder.h"
 
 #if (defined(Q_OS_WIN) || defined(Q_OS_MACOS)) && defined(QT_DEBUG)
 #include "../simulator/de1simulator.h"
@@ -502,9 +505,8 @@ void DE1Device::onCharacteristicChanged(const QLowEnergyCharacteristic& c, const
 }
 
 void DE1Device::onCharacteristicWritten(const QLowEnergyCharacteristic& c, const QByteArray& value) {
-    // Log all writes for debugging
-    QString uuidShort = c.uuid().toString().mid(1, 8);  // Extract xxxx from {0000xxxx-...}
-    qDebug() << "DE1Device: Write confirmed to" << uuidShort << "data:" << value.toHex();
+    // Log all writes for debugging (raw bytes; hex only built if someone reads the log)
+    HOT_LOG_BYTES(lcBleWrite, "DE1Device: Write confirmed to %x1 data: %b", value, static_cast<double>(c.uuid().toUInt32()));
     m_writePending = false;
     m_writeTimeoutTimer.stop();  // Cancel timeout - write succeeded
     m_writeRetryCount = 0;       // Reset retry count on successful write
@@ -527,6 +529,7 @@ void DE1Device::parseStateInfo(const QByteArray& data) {
     if (stateChanged || subStateChanged) {
         qDebug() << "DE1Device: State changed to" << DE1::stateToString(newState)
                  << "/" << DE1::subStateToString(newSubState);
+        FlightRecorder::recordState(static_cast<int>(newState), static_cast<int>(newSubState));
     }
 
     m_state = newState;
@@ -547,14 +550,14 @@ void DE1Device::parseShotSample(const QByteArray& data) {
 
     const uint8_t* d = reinterpret_cast<const uint8_t*>(data.constData());
     ShotSample sample;
-    sample.timestamp = QDateTime::currentMSecsSinceEpoch();
+    sample.timestamp = MonotonicClock::nowMs();
 
     // Detect BLE spec based on packet size
     bool newSpec = (data.size() >= 19);
 
     if (newSpec) {
         // NEW BLE SPEC (>= 1.0): 19 bytes
-        // Bytes 0-1: SampleTime (Short, big-endian, /100 for seconds - actually half-cycles)
+        // Bytes 0-1: SampleTime (Short, big-endian, mains half-cycles; /100 is seconds only on 50 Hz)
         // Bytes 2-3: GroupPressure (Short, /4096.0)
         // Bytes 4-5: GroupFlow (Short, /4096.0)
         // Bytes 6-7: MixTemp (Short, /256.0)
@@ -606,8 +609,11 @@ void DE1Device::parseShotSample(const QByteArray& data) {
         return;
     }
 
-    // Uncomment for debugging:
-    // qDebug() << "DE1Device: ShotSample - headTemp:" << sample.headTemp << "pressure:" << sample.groupPressure;
+    HOT_LOG(lcShotSample, "DE1Device: ShotSample - timer: %1 headTemp: %2 pressure: %3 flow: %4",
+            sample.timer, sample.headTemp, sample.groupPressure, sample.groupFlow);
+    FlightRecorder::recordShotSample(sample.timer, sample.groupPressure, sample.groupFlow, sample.mixTemp,
+                                     sample.headTemp, sample.setPressureGoal, sample.setFlowGoal,
+                                     sample.setTempGoal, sample.frameNumber);
 
     // Update internal state
     m_pressure = sample.groupPressure;
@@ -779,7 +785,8 @@ void DE1Device::writeCharacteristic(const QBluetoothUuid& uuid, const QByteArray
         return;
     }
     QString uuidShort = uuid.toString().mid(1, 8);  // Extract xxxx from {0000xxxx-...}
-    qDebug() << "DE1Device: Writing to" << uuidShort << "data:" << data.toHex();
+    HOT_LOG_BYTES(lcBleWrite, "DE1Device: Writing to %x1 data: %b", data, static_cast<double>(uuid.toUInt32()));
+    FlightRecorder::recordCommand(uuid.toUInt32(), data);
     m_writePending = true;
     m_lastWriteUuid = uuidShort;   // Store for error logging
     m_lastWriteData = data;        // Store for error logging
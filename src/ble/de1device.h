@@ -18,7 +18,7 @@ class DE1Simulator;
 #endif
 
 struct ShotSample {
-    qint64 timestamp = 0;
+    qint64 timestamp = 0;       // MonotonicClock ms at arrival (not wall clock)
     double timer = 0.0;
     double groupPressure = 0.0;
     double groupFlow = 0.0;
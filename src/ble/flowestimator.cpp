@@ -0,0 +1,177 @@
+#include "flowestimator.h"
+#include <cmath>
+
+std::unique_ptr<FlowEstimator> FlowEstimator::create(Type type) {
+    switch (type) {
+    case Type::SavitzkyGolay:
+        return std::make_unique<SavitzkyGolayFlowEstimator>();
+    case Type::Kalman:
+        return std::make_unique<KalmanFlowEstimator>();
+    case Type::MovingAverage:
+        break;
+    }
+    return std::make_unique<MovingAverageFlowEstimator>();
+}
+
+FlowEstimator::Type FlowEstimator::typeFromString(const QString& name) {
+    if (name == "savitzky_golay") return Type::SavitzkyGolay;
+    if (name == "kalman") return Type::Kalman;
+    return Type::MovingAverage;
+}
+
+QString FlowEstimator::typeToString(Type type) {
+    switch (type) {
+    case Type::SavitzkyGolay: return QStringLiteral("savitzky_golay");
+    case Type::Kalman: return QStringLiteral("kalman");
+    case Type::MovingAverage: break;
+    }
+    return QStringLiteral("moving_average");
+}
+
+// --- Moving average ---
+
+void MovingAverageFlowEstimator::addSample(double weight, double timeSec) {
+    if (!m_hasPrev) {
+        m_prevWeight = weight;
+        m_prevTime = timeSec;
+        m_hasPrev = true;
+        return;
+    }
+
+    double timeDelta = timeSec - m_prevTime;
+    if (timeDelta < MIN_INTERVAL) {
+        // Batched notification - keep the baseline so the delta lands in the next interval
+        return;
+    }
+
+    if (timeDelta < MAX_SAMPLE_GAP) {
+        m_rates.push((weight - m_prevWeight) / timeDelta);
+
+        double sum = 0;
+        for (std::size_t i = 0; i < m_rates.size(); ++i) {
+            sum += m_rates[i];
+        }
+        m_flowRate = sum / m_rates.size();
+    }
+
+    m_prevWeight = weight;
+    m_prevTime = timeSec;
+}
+
+void MovingAverageFlowEstimator::reset() {
+    m_rates.clear();
+    m_prevWeight = 0.0;
+    m_prevTime = 0.0;
+    m_hasPrev = false;
+    m_flowRate = 0.0;
+}
+
+// --- Savitzky-Golay ---
+
+namespace {
+
+double det3(double a, double b, double c,
+            double d, double e, double f,
+            double g, double h, double i) {
+    return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+}
+
+}  // namespace
+
+void SavitzkyGolayFlowEstimator::addSample(double weight, double timeSec) {
+    if (!m_window.isEmpty()) {
+        double timeDelta = timeSec - m_window.back().time;
+        if (timeDelta < 0) return;  // Out of order
+        if (timeDelta > MAX_SAMPLE_GAP) m_window.clear();
+    }
+    m_window.push({timeSec, weight});
+
+    const std::size_t n = m_window.size();
+    if (n < 3) return;
+
+    // Fit w(t) = a + b*t + c*t^2 around the newest sample (t = 0), so the
+    // flow at the newest sample is simply b. Timestamps need not be uniform.
+    const Point& newest = m_window.back();
+    double s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+    double y0 = 0, y1 = 0, y2 = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        double t = m_window[i].time - newest.time;
+        double w = m_window[i].weight - newest.weight;
+        double t2 = t * t;
+        s1 += t;
+        s2 += t2;
+        s3 += t2 * t;
+        s4 += t2 * t2;
+        y0 += w;
+        y1 += t * w;
+        y2 += t2 * w;
+    }
+
+    double span = newest.time - m_window.front().time;
+
+    // Quadratic needs a reasonable spread of timestamps to be well-conditioned
+    if (n >= 5 && span >= 0.2) {
+        double det = det3(n, s1, s2, s1, s2, s3, s2, s3, s4);
+        if (std::abs(det) > 1e-12) {
+            m_flowRate = det3(n, y0, s2, s1, y1, s3, s2, y2, s4) / det;
+            return;
+        }
+    }
+
+    // Fall back to a linear least-squares slope
+    double denom = n * s2 - s1 * s1;
+    if (span >= 0.05 && std::abs(denom) > 1e-12) {
+        m_flowRate = (n * y1 - s1 * y0) / denom;
+    }
+}
+
+void SavitzkyGolayFlowEstimator::reset() {
+    m_window.clear();
+    m_flowRate = 0.0;
+}
+
+// --- Kalman ---
+
+void KalmanFlowEstimator::addSample(double weight, double timeSec) {
+    double dt = timeSec - m_lastTime;
+    if (!m_initialized || dt > MAX_SAMPLE_GAP) {
+        m_weight = weight;
+        m_flow = m_initialized ? m_flow : 0.0;
+        m_p00 = MEASUREMENT_VARIANCE;
+        m_p01 = 0.0;
+        m_p11 = INITIAL_FLOW_VARIANCE;
+        m_lastTime = timeSec;
+        m_initialized = true;
+        return;
+    }
+    if (dt < 0) return;  // Out of order
+
+    // Predict: weight advances by flow*dt, flow follows a random walk
+    m_weight += m_flow * dt;
+    double q = FLOW_CHANGE_DENSITY;
+    double dt2 = dt * dt;
+    double p00 = m_p00 + dt * (2.0 * m_p01 + dt * m_p11) + q * dt2 * dt / 3.0;
+    double p01 = m_p01 + dt * m_p11 + q * dt2 / 2.0;
+    double p11 = m_p11 + q * dt;
+
+    // Update with the weight measurement
+    double s = p00 + MEASUREMENT_VARIANCE;
+    double k0 = p00 / s;
+    double k1 = p01 / s;
+    double innovation = weight - m_weight;
+
+    m_weight += k0 * innovation;
+    m_flow += k1 * innovation;
+    m_p00 = (1.0 - k0) * p00;
+    m_p01 = (1.0 - k0) * p01;
+    m_p11 = p11 - k1 * p01;
+    m_lastTime = timeSec;
+}
+
+void KalmanFlowEstimator::reset() {
+    m_initialized = false;
+    m_lastTime = 0.0;
+    m_weight = 0.0;
+    m_flow = 0.0;
+    m_p00 = m_p01 = m_p11 = 0.0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QString>
+#include <memory>
+#include "../core/samplering.h"
+
+/**
+ * FlowEstimator turns a stream of (weight, time) readings into a flow rate (g/s).
+ *
+ * Timestamps are monotonic seconds: either the host's steady clock at arrival
+ * or the scale's own clock when the protocol reports one. Estimators never
+ * look at wall-clock time, so they are unaffected by NTP adjustments.
+ *
+ * Implementations:
+ * - MovingAverage: mean of the last 5 instantaneous rates (legacy behavior)
+ * - SavitzkyGolay: local quadratic least-squares fit, derivative at newest sample
+ * - Kalman: constant-flow Kalman filter over (weight, flow)
+ */
+class FlowEstimator {
+public:
+    enum class Type { MovingAverage, SavitzkyGolay, Kalman };
+
+    virtual ~FlowEstimator() = default;
+
+    virtual void addSample(double weight, double timeSec) = 0;
+    virtual double flowRate() const = 0;
+    virtual void reset() = 0;
+    virtual Type type() const = 0;
+
+    static std::unique_ptr<FlowEstimator> create(Type type);
+
+    // Settings strings: "moving_average", "savitzky_golay", "kalman"
+    // Unknown names fall back to MovingAverage
+    static Type typeFromString(const QString& name);
+    static QString typeToString(Type type);
+
+protected:
+    // Readings further apart than this are treated as a gap and restart the estimate
+    static constexpr double MAX_SAMPLE_GAP = 1.0;
+};
+
+class MovingAverageFlowEstimator : public FlowEstimator {
+public:
+    void addSample(double weight, double timeSec) override;
+    double flowRate() const override { return m_flowRate; }
+    void reset() override;
+    Type type() const override { return Type::MovingAverage; }
+
+private:
+    // Readings closer than this are batched notifications: the weight delta is
+    // carried into the next interval instead of producing a huge instantaneous rate
+    static constexpr double MIN_INTERVAL = 0.01;
+
+    SampleRing<double, 5> m_rates;
+    double m_prevWeight = 0.0;
+    double m_prevTime = 0.0;
+    bool m_hasPrev = false;
+    double m_flowRate = 0.0;
+};
+
+class SavitzkyGolayFlowEstimator : public FlowEstimator {
+public:
+    void addSample(double weight, double timeSec) override;
+    double flowRate() const override { return m_flowRate; }
+    void reset() override;
+    Type type() const override { return Type::SavitzkyGolay; }
+
+private:
+    struct Point { double time; double weight; };
+
+    // ~1 second of history at typical 10 Hz scale rates
+    SampleRing<Point, 9> m_window;
+    double m_flowRate = 0.0;
+};
+
+class KalmanFlowEstimator : public FlowEstimator {
+public:
+    void addSample(double weight, double timeSec) override;
+    double flowRate() const override { return m_flow; }
+    void reset() override;
+    Type type() const override { return Type::Kalman; }
+
+private:
+    // Measurement noise: ~0.1 g scale resolution
+    static constexpr double MEASUREMENT_VARIANCE = 0.01;
+    // Process noise: how fast flow is allowed to change (g/s^2 spectral density)
+    static constexpr double FLOW_CHANGE_DENSITY = 2.0;
+    // Initial flow uncertainty (g/s)^2
+    static constexpr double INITIAL_FLOW_VARIANCE = 4.0;
+
+    bool m_initialized = false;
+    double m_lastTime = 0.0;
+    double m_weight = 0.0;
+    double m_flow = 0.0;
+    // Covariance [[p00, p01], [p01, p11]]
+    double m_p00 = 0.0;
+    double m_p01 = 0.0;
+    double m_p11 = 0.0;
+};
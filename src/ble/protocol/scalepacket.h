@@ -0,0 +1,208 @@
+#pragma once
+
+#include <QByteArray>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+/**
+ * Shared building blocks for parsing scale notifications.
+ *
+ * Scale drivers receive raw characteristic values and decode fixed offsets.
+ * Malformed or truncated packets must never read out of bounds, and the
+ * weight path runs at 5-20 Hz, so nothing here allocates:
+ *
+ *   PacketView        - non-owning, bounds-checked view with endian readers.
+ *                       Reads past the end yield zero bytes.
+ *   PacketChecksum    - XOR / additive checksums used by scale protocols
+ *   PacketReassembler - fixed-capacity ring buffer that stitches fragmented
+ *                       notifications into complete frames
+ */
+class PacketView {
+public:
+    PacketView() = default;
+    PacketView(const uint8_t* data, qsizetype size) : m_data(data), m_size(data ? size : 0) {}
+    explicit PacketView(const QByteArray& bytes)
+        : m_data(reinterpret_cast<const uint8_t*>(bytes.constData())), m_size(bytes.size()) {}
+
+    const uint8_t* data() const { return m_data; }
+    qsizetype size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    // True if [offset, offset + count) lies inside the view
+    bool has(qsizetype offset, qsizetype count) const {
+        return offset >= 0 && count >= 0 && offset + count <= m_size;
+    }
+
+    // Sub-view; clamped to the available bytes. count < 0 means "to the end".
+    PacketView mid(qsizetype offset, qsizetype count = -1) const {
+        if (offset < 0 || offset >= m_size) return PacketView();
+        qsizetype available = m_size - offset;
+        return PacketView(m_data + offset, (count < 0 || count > available) ? available : count);
+    }
+
+    bool startsWith(std::initializer_list<uint8_t> prefix) const {
+        qsizetype i = 0;
+        for (uint8_t b : prefix) {
+            if (i >= m_size || m_data[i] != b) return false;
+            ++i;
+        }
+        return true;
+    }
+
+    uint8_t u8(qsizetype i) const { return (i >= 0 && i < m_size) ? m_data[i] : 0; }
+    int8_t s8(qsizetype i) const { return static_cast<int8_t>(u8(i)); }
+
+    uint16_t u16be(qsizetype i) const { return static_cast<uint16_t>((u8(i) << 8) | u8(i + 1)); }
+    uint16_t u16le(qsizetype i) const { return static_cast<uint16_t>(u8(i) | (u8(i + 1) << 8)); }
+    int16_t s16be(qsizetype i) const { return static_cast<int16_t>(u16be(i)); }
+    int16_t s16le(qsizetype i) const { return static_cast<int16_t>(u16le(i)); }
+
+    uint32_t u24be(qsizetype i) const {
+        return (static_cast<uint32_t>(u8(i)) << 16) | (u8(i + 1) << 8) | u8(i + 2);
+    }
+    uint32_t u24le(qsizetype i) const {
+        return u8(i) | (u8(i + 1) << 8) | (static_cast<uint32_t>(u8(i + 2)) << 16);
+    }
+
+    uint32_t u32be(qsizetype i) const {
+        return (static_cast<uint32_t>(u8(i)) << 24) | (static_cast<uint32_t>(u8(i + 1)) << 16)
+             | (u8(i + 2) << 8) | u8(i + 3);
+    }
+    uint32_t u32le(qsizetype i) const {
+        return u8(i) | (u8(i + 1) << 8) | (static_cast<uint32_t>(u8(i + 2)) << 16)
+             | (static_cast<uint32_t>(u8(i + 3)) << 24);
+    }
+    int32_t s32le(qsizetype i) const { return static_cast<int32_t>(u32le(i)); }
+
+    // ASCII decimal field (optional surrounding spaces and sign), like QByteArray::toInt()
+    bool asciiInt(qsizetype offset, qsizetype count, int& out) const {
+        if (!has(offset, count)) return false;
+        qsizetype i = offset, end = offset + count;
+        while (i < end && m_data[i] == ' ') ++i;
+        while (end > i && m_data[end - 1] == ' ') --end;
+
+        bool negative = false;
+        if (i < end && (m_data[i] == '+' || m_data[i] == '-')) {
+            negative = m_data[i] == '-';
+            ++i;
+        }
+        if (i == end) return false;
+
+        long long value = 0;
+        for (; i < end; ++i) {
+            if (m_data[i] < '0' || m_data[i] > '9') return false;
+            value = value * 10 + (m_data[i] - '0');
+            if (value > 0x7FFFFFFF) return false;
+        }
+        out = static_cast<int>(negative ? -value : value);
+        return true;
+    }
+
+private:
+    const uint8_t* m_data = nullptr;
+    qsizetype m_size = 0;
+};
+
+class PacketChecksum {
+public:
+    static uint8_t xor8(PacketView bytes) {
+        uint8_t result = 0;
+        for (qsizetype i = 0; i < bytes.size(); ++i) result ^= bytes.data()[i];
+        return result;
+    }
+
+    static uint8_t sum8(PacketView bytes) {
+        uint8_t result = 0;
+        for (qsizetype i = 0; i < bytes.size(); ++i) result = static_cast<uint8_t>(result + bytes.data()[i]);
+        return result;
+    }
+};
+
+/**
+ * Fixed-capacity byte ring for protocols whose frames span several BLE
+ * notifications (or several frames share one). Typical use:
+ *
+ *   m_frames.append(PacketView(value));
+ *   while (m_frames.syncTo(0xEF, 0xDD) && m_frames.size() >= headerLen) {
+ *       int frameLen = ...from m_frames.peek()...;
+ *       if (m_frames.size() < frameLen) break;
+ *       PacketView frame = m_frames.take(frameLen, scratch);
+ *       ...
+ *   }
+ *
+ * If a single append would overflow, buffered bytes are stale garbage and
+ * are dropped.
+ */
+template <int Capacity>
+class PacketReassembler {
+public:
+    void append(PacketView bytes) {
+        qsizetype count = bytes.size();
+        const uint8_t* src = bytes.data();
+        if (count > Capacity) {
+            // Only the tail can still hold a frame start
+            src += count - Capacity;
+            count = Capacity;
+        }
+        if (m_size + count > Capacity) {
+            clear();
+        }
+        for (qsizetype i = 0; i < count; ++i) {
+            m_data[(m_start + m_size + i) % Capacity] = src[i];
+        }
+        m_size += static_cast<int>(count);
+    }
+
+    void clear() { m_start = 0; m_size = 0; }
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    static constexpr int capacity() { return Capacity; }
+
+    uint8_t peek(int i) const { return (i >= 0 && i < m_size) ? m_data[(m_start + i) % Capacity] : 0; }
+
+    void consume(int count) {
+        if (count >= m_size) {
+            clear();
+            return;
+        }
+        m_start = (m_start + count) % Capacity;
+        m_size -= count;
+    }
+
+    // Drop bytes until the buffer starts with h0 h1. Keeps a trailing h0 that
+    // may be completed by the next notification. Returns true when aligned.
+    bool syncTo(uint8_t h0, uint8_t h1) {
+        int i = 0;
+        while (i + 1 < m_size && !(peek(i) == h0 && peek(i + 1) == h1)) ++i;
+        if (i + 1 >= m_size && !(m_size > 0 && peek(m_size - 1) == h0)) {
+            clear();
+            return false;
+        }
+        consume(i);
+        return m_size >= 2;
+    }
+
+    // Copy the first `count` bytes into `scratch` and consume them.
+    // Returns a view over scratch (truncated if scratch is smaller).
+    template <std::size_t N>
+    PacketView take(int count, std::array<uint8_t, N>& scratch) {
+        int n = count < m_size ? count : m_size;
+        if (n > static_cast<int>(N)) n = static_cast<int>(N);
+        int first = Capacity - m_start;
+        if (first >= n) {
+            std::memcpy(scratch.data(), m_data.data() + m_start, n);
+        } else {
+            std::memcpy(scratch.data(), m_data.data() + m_start, first);
+            std::memcpy(scratch.data() + first, m_data.data(), n - first);
+        }
+        consume(count);
+        return PacketView(scratch.data(), n);
+    }
+
+private:
+    std::array<uint8_t, Capacity> m_data{};
+    int m_start = 0;
+    int m_size = 0;
+};
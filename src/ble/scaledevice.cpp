@@ -1,8 +1,9 @@
 #include "scaledevice.h"
-#include <QDateTime>
+#include "../core/monotonicclock.h"
 
 ScaleDevice::ScaleDevice(QObject* parent)
     : QObject(parent)
+    , m_flowEstimator(FlowEstimator::create(FlowEstimator::Type::MovingAverage))
 {
 }
 
@@ -71,9 +72,46 @@ void ScaleDevice::setConnected(bool connected) {
     }
 }
 
+void ScaleDevice::setFlowEstimatorType(FlowEstimator::Type type) {
+    if (m_flowEstimator->type() == type) {
+        return;
+    }
+    m_flowEstimator = FlowEstimator::create(type);
+    m_usingDeviceClock = false;
+    m_lastDeviceTimeMs = 0;
+}
+
 void ScaleDevice::setWeight(double weight) {
+    if (m_usingDeviceClock) {
+        // Switching time base - old samples are on a different clock
+        m_flowEstimator->reset();
+        m_usingDeviceClock = false;
+    }
+    updateWeight(weight, MonotonicClock::nowSec());
+}
+
+void ScaleDevice::setWeight(double weight, qint64 deviceTimeMs) {
+    // Device timers stop (or reset to 0) when the scale's timer isn't running,
+    // so only trust the device clock while it keeps advancing
+    if (deviceTimeMs <= m_lastDeviceTimeMs) {
+        m_lastDeviceTimeMs = deviceTimeMs;
+        setWeight(weight);
+        return;
+    }
+    m_lastDeviceTimeMs = deviceTimeMs;
+
+    if (!m_usingDeviceClock) {
+        m_flowEstimator->reset();
+        m_usingDeviceClock = true;
+    }
+    updateWeight(weight, deviceTimeMs / 1000.0);
+}
+
+void ScaleDevice::updateWeight(double weight, double timeSec) {
+    // Every reading feeds the estimator (unchanged weight means zero flow),
+    // but only changes are emitted
+    calculateFlowRate(weight, timeSec);
     if (m_weight != weight) {
-        calculateFlowRate(weight);
         m_weight = weight;
         emit weightChanged(weight);
     }
@@ -94,35 +132,13 @@ void ScaleDevice::setBatteryLevel(int level) {
 }
 
 void ScaleDevice::resetFlowCalculation() {
-    m_flowHistory.clear();
-    m_prevTimestamp = 0;
-    m_prevWeight = 0.0;
+    m_flowEstimator->reset();
+    m_lastDeviceTimeMs = 0;
+    m_usingDeviceClock = false;
     setFlowRate(0.0);
 }
 
-void ScaleDevice::calculateFlowRate(double newWeight) {
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-
-    if (m_prevTimestamp > 0) {
-        double timeDelta = (currentTime - m_prevTimestamp) / 1000.0;
-        if (timeDelta > 0.01 && timeDelta < 1.0) {  // Valid time range
-            double instantRate = (newWeight - m_prevWeight) / timeDelta;
-
-            // Add to history for smoothing
-            m_flowHistory.append(instantRate);
-            if (m_flowHistory.size() > FLOW_HISTORY_SIZE) {
-                m_flowHistory.removeFirst();
-            }
-
-            // Calculate average flow rate
-            double sum = 0;
-            for (double rate : m_flowHistory) {
-                sum += rate;
-            }
-            setFlowRate(sum / m_flowHistory.size());
-        }
-    }
-
-    m_prevWeight = newWeight;
-    m_prevTimestamp = currentTime;
+void ScaleDevice::calculateFlowRate(double newWeight, double timeSec) {
+    m_flowEstimator->addSample(newWeight, timeSec);
+    setFlowRate(m_flowEstimator->flowRate());
 }
@@ -4,7 +4,8 @@
 #include <QBluetoothDeviceInfo>
 #include <QLowEnergyController>
 #include <QLowEnergyService>
-#include <QList>
+#include <memory>
+#include "flowestimator.h"
 
 class ScaleDevice : public QObject {
     Q_OBJECT
@@ -32,6 +33,10 @@ public:
     bool simulationMode() const { return m_simulationMode; }
     void setSimulationMode(bool enabled);
 
+    // Flow rate estimation algorithm (see FlowEstimator)
+    FlowEstimator::Type flowEstimatorType() const { return m_flowEstimator->type(); }
+    void setFlowEstimatorType(FlowEstimator::Type type);
+
 public slots:
     virtual void tare() = 0;
     virtual void startTimer() {}
@@ -60,9 +65,12 @@ signals:
 protected:
     void setConnected(bool connected);
     void setWeight(double weight);
+    // For protocols that report their own timestamp (ms, monotonic while the scale timer runs).
+    // Falls back to the host clock whenever the device clock stops advancing.
+    void setWeight(double weight, qint64 deviceTimeMs);
     void setFlowRate(double rate);
     void setBatteryLevel(int level);
-    void calculateFlowRate(double newWeight);
+    void calculateFlowRate(double newWeight, double timeSec);
 
     QLowEnergyController* m_controller = nullptr;
     QLowEnergyService* m_service = nullptr;
@@ -74,9 +82,10 @@ private:
     double m_flowRate = 0.0;
     int m_batteryLevel = 100;
 
-    // Flow rate calculation
-    double m_prevWeight = 0.0;
-    qint64 m_prevTimestamp = 0;
-    QList<double> m_flowHistory;
-    static const int FLOW_HISTORY_SIZE = 5;
+    void updateWeight(double weight, double timeSec);
+
+    // Flow rate calculation (monotonic clock - immune to wall-clock jumps)
+    std::unique_ptr<FlowEstimator> m_flowEstimator;
+    qint64 m_lastDeviceTimeMs = 0;
+    bool m_usingDeviceClock = false;
 };
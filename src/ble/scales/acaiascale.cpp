@@ -79,7 +79,7 @@ void AcaiaScale::connectToDevice(const QBluetoothDeviceInfo& device) {
     m_weightReceived = false;
     m_isConnecting = true;
     m_identRetryCount = 0;
-    m_buffer.clear();
+    m_frames.clear();
 
     m_name = device.name();
     m_transport->connectToDevice(device);
@@ -302,76 +302,49 @@ void AcaiaScale::sendCommand(const QByteArray& command) {
 }
 
 void AcaiaScale::parseResponse(const QByteArray& data) {
-    // Append to buffer
-    m_buffer.append(data);
+    m_frames.append(PacketView(data));
 
-    // Need at least 6 bytes for a valid message
-    if (m_buffer.size() < 6) return;
+    // A notification may carry a partial message, or the tail of one and the start of the next
+    std::array<uint8_t, ACAIA_MAX_MESSAGE_LEN> message;
+    while (m_frames.syncTo(0xEF, 0xDD)) {
+        // Check if we have enough data for metadata
+        if (m_frames.size() < ACAIA_METADATA_LEN + 1) return;
 
-    const uint8_t* buf = reinterpret_cast<const uint8_t*>(m_buffer.constData());
+        uint8_t msgType = m_frames.peek(2);
+        uint8_t length = m_frames.peek(3);
+        uint8_t eventType = m_frames.peek(4);
 
-    // Find message start (0xEF 0xDD)
-    int msgStart = -1;
-    for (int i = 0; i < m_buffer.size() - 1; i++) {
-        if (buf[i] == 0xEF && buf[i + 1] == 0xDD) {
-            msgStart = i;
-            break;
+        // Mark that we're receiving notifications (not just info messages)
+        if (msgType != 7) {
+            m_receivingNotifications = true;
         }
-    }
-
-    if (msgStart < 0) {
-        m_buffer.clear();
-        return;
-    }
-
-    // Skip bytes before message start
-    if (msgStart > 0) {
-        m_buffer = m_buffer.mid(msgStart);
-        buf = reinterpret_cast<const uint8_t*>(m_buffer.constData());
-    }
 
-    // Check if we have enough data for metadata
-    if (m_buffer.size() < ACAIA_METADATA_LEN + 1) return;
+        // Check if we have the complete message
+        int msgEnd = ACAIA_METADATA_LEN + length;
+        if (m_frames.size() < msgEnd) return;
 
-    uint8_t msgType = buf[2];
-    uint8_t length = buf[3];
-    uint8_t eventType = buf[4];
+        PacketView msg = m_frames.take(msgEnd, message);
 
-    // Mark that we're receiving notifications (not just info messages)
-    if (msgType != 7) {
-        m_receivingNotifications = true;
-    }
-
-    // Check if we have the complete message
-    int msgEnd = ACAIA_METADATA_LEN + length;
-    if (m_buffer.size() < msgEnd) return;
-
-    // Only process weight messages (msgType 0x0C, eventType 5 or 11)
-    if (msgType == 0x0C && (eventType == 5 || eventType == 11)) {
-        int payloadOffset = (eventType == 5) ? ACAIA_METADATA_LEN : ACAIA_METADATA_LEN + 3;
-        decodeWeight(m_buffer, payloadOffset);
+        // Only process weight messages (msgType 0x0C, eventType 5 or 11)
+        if (msgType == 0x0C && (eventType == 5 || eventType == 11)) {
+            int payloadOffset = (eventType == 5) ? ACAIA_METADATA_LEN : ACAIA_METADATA_LEN + 3;
+            decodeWeight(msg.mid(payloadOffset));
+        }
     }
-
-    // Clear buffer after processing
-    m_buffer.clear();
 }
 
-void AcaiaScale::decodeWeight(const QByteArray& data, int payloadOffset) {
-    if (data.size() < payloadOffset + 6) return;
-
-    const uint8_t* payload = reinterpret_cast<const uint8_t*>(data.constData()) + payloadOffset;
+void AcaiaScale::decodeWeight(PacketView payload) {
+    if (!payload.has(0, 6)) return;
 
     // Weight is 3 bytes, little-endian
-    int32_t value = ((payload[2] & 0xFF) << 16) |
-                    ((payload[1] & 0xFF) << 8) |
-                    (payload[0] & 0xFF);
+    int32_t value = static_cast<int32_t>(payload.u24le(0));
 
     // Unit is in payload[4]
-    uint8_t unit = payload[4] & 0xFF;
+    uint8_t unit = payload.u8(4);
     double weight = value / std::pow(10.0, unit);
 
     // Sign is in payload[5]
-    bool isNegative = payload[5] > 1;
+    bool isNegative = payload.u8(5) > 1;
     if (isNegative) {
         weight = -weight;
     }
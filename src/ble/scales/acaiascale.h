@@ -2,6 +2,7 @@
 
 #include "../scaledevice.h"
 #include "../transport/scalebletransport.h"
+#include "../protocol/scalepacket.h"
 #include <QTimer>
 #include <QByteArray>
 
@@ -38,7 +39,7 @@ private slots:
 
 private:
     void parseResponse(const QByteArray& data);
-    void decodeWeight(const QByteArray& payload, int payloadOffset);
+    void decodeWeight(PacketView payload);
     QByteArray encodePacket(uint8_t msgType, const QByteArray& payload);
     void sendCommand(const QByteArray& command);
     void sendTareCommand();  // Internal: sends a single tare command
@@ -60,11 +61,12 @@ private:
     QTimer* m_initTimer = nullptr;  // Recurring timer for ident/config sequence
     int m_identRetryCount = 0;
 
-    // Message parsing state
-    QByteArray m_buffer;
+    // Message parsing state (messages may span notifications, or share one)
+    PacketReassembler<512> m_frames;
 
     // Constants
     static constexpr int ACAIA_METADATA_LEN = 5;
+    static constexpr int ACAIA_MAX_MESSAGE_LEN = ACAIA_METADATA_LEN + 255;
     static constexpr int MAX_IDENT_RETRIES = 10;  // Same as de1app
     static constexpr int INIT_TIMER_INTERVAL_MS = 500;  // Ident + config every 500ms
 };
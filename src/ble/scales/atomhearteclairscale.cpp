@@ -1,5 +1,6 @@
 #include "atomhearteclairscale.h"
 #include "../protocol/de1characteristics.h"
+#include "../protocol/scalepacket.h"
 #include <QDebug>
 #include <QTimer>
 
@@ -114,39 +115,23 @@ void AtomheartEclairScale::onCharacteristicsDiscoveryFinished(const QBluetoothUu
     });
 }
 
-bool AtomheartEclairScale::validateXor(const QByteArray& data) {
-    if (data.size() < 2) return false;
-
-    const uint8_t* d = reinterpret_cast<const uint8_t*>(data.constData());
-
-    // XOR all bytes except header and last (XOR) byte
-    uint8_t xorResult = 0;
-    for (int i = 1; i < data.size() - 1; i++) {
-        xorResult ^= d[i];
-    }
-
-    return xorResult == d[data.size() - 1];
-}
-
 void AtomheartEclairScale::onCharacteristicChanged(const QBluetoothUuid& characteristicUuid,
                                                     const QByteArray& value) {
     if (characteristicUuid == Scale::AtomheartEclair::STATUS) {
         // Atomheart Eclair format: 'W' (0x57) header, 4-byte weight in milligrams, 4-byte timer, XOR byte
-        if (value.size() >= 9) {
-            const uint8_t* d = reinterpret_cast<const uint8_t*>(value.constData());
-
+        PacketView d(value);
+        if (d.has(0, 9)) {
             // Check header is 'W' (0x57)
-            if (d[0] != 0x57) return;
+            if (d.u8(0) != 0x57) return;
 
-            // Validate XOR checksum
-            if (!validateXor(value)) {
+            // Validate XOR checksum over all bytes except header and last (XOR) byte
+            if (PacketChecksum::xor8(d.mid(1, d.size() - 2)) != d.u8(d.size() - 1)) {
                 ECLAIR_LOG("XOR checksum failed");
                 return;
             }
 
             // Weight is 4-byte signed int32 in milligrams (little-endian)
-            int32_t weightMg = d[1] | (d[2] << 8) | (d[3] << 16) | (d[4] << 24);
-            double weight = weightMg / 1000.0;  // Convert to grams
+            double weight = d.s32le(1) / 1000.0;  // Convert to grams
 
             setWeight(weight);
         }
@@ -31,7 +31,6 @@ private slots:
 
 private:
     void sendCommand(const QByteArray& cmd);
-    bool validateXor(const QByteArray& data);
 
     ScaleBleTransport* m_transport = nullptr;
     QString m_name = "Atomheart Eclair";
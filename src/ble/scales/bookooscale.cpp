@@ -1,5 +1,6 @@
 #include "bookooscale.h"
 #include "../protocol/de1characteristics.h"
+#include "../protocol/scalepacket.h"
 #include <QDebug>
 #include <QTimer>
 
@@ -143,22 +144,23 @@ void BookooScale::onNotificationsEnabled(const QBluetoothUuid& characteristicUui
 }
 
 void BookooScale::parseWeightData(const QByteArray& data) {
-    // Bookoo format: h1 h2 h3 h4 h5 h6 sign w1 w2 w3 (10 bytes)
+    // Bookoo format: h1 h2 t1 t2 t3 unit sign w1 w2 w3 (10 bytes)
+    // t1-t3 = scale timer in milliseconds (only advances while the timer runs)
     // de1app checks >= 9 bytes, we check >= 10 to be safe
-    if (data.size() >= 10) {
-        const uint8_t* d = reinterpret_cast<const uint8_t*>(data.constData());
+    PacketView d(data);
+    if (d.has(0, 10)) {
+        qint64 timerMs = d.u24be(2);
 
-        char sign = static_cast<char>(d[6]);
+        char sign = static_cast<char>(d.u8(6));
 
         // Weight is 3 bytes big-endian in hundredths of gram
-        uint32_t weightRaw = (d[7] << 16) | (d[8] << 8) | d[9];
-        double weight = weightRaw / 100.0;
+        double weight = d.u24be(7) / 100.0;
 
         if (sign == '-') {
             weight = -weight;
         }
 
-        setWeight(weight);
+        setWeight(weight, timerMs);
     }
 }
 
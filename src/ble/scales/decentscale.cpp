@@ -1,5 +1,6 @@
 #include "decentscale.h"
 #include "../protocol/de1characteristics.h"
+#include "../protocol/scalepacket.h"
 #include <algorithm>
 #include <QTimer>
 
@@ -157,20 +158,18 @@ void DecentScale::onCharacteristicChanged(const QBluetoothUuid& characteristicUu
 }
 
 void DecentScale::parseWeightData(const QByteArray& data) {
-    if (data.size() < 7) return;
+    PacketView d(data);
+    if (!d.has(0, 7)) return;
 
-    const uint8_t* d = reinterpret_cast<const uint8_t*>(data.constData());
-
-    uint8_t command = d[1];
+    uint8_t command = d.u8(1);
 
     if (command == 0xCE || command == 0xCA) {
         // Weight data
-        int16_t weightRaw = (static_cast<int16_t>(d[2]) << 8) | d[3];
-        double weight = weightRaw / 10.0;  // Weight in grams
+        double weight = d.s16be(2) / 10.0;  // Weight in grams
         setWeight(weight);
     } else if (command == 0xAA) {
         // Button pressed
-        int button = d[2];
+        int button = d.u8(2);
         emit buttonPressed(button);
     }
 }
@@ -185,19 +184,11 @@ void DecentScale::sendCommand(const QByteArray& command) {
         packet[i + 1] = command[i];
     }
 
-    packet[6] = calculateXor(packet);
+    packet[6] = static_cast<char>(PacketChecksum::xor8(PacketView(packet).mid(0, 6)));
 
     m_transport->writeCharacteristic(Scale::Decent::SERVICE, Scale::Decent::WRITE, packet);
 }
 
-uint8_t DecentScale::calculateXor(const QByteArray& data) {
-    uint8_t result = 0;
-    for (int i = 0; i < data.size() - 1; i++) {
-        result ^= static_cast<uint8_t>(data[i]);
-    }
-    return result;
-}
-
 void DecentScale::tare() {
     sendCommand(QByteArray::fromHex("0F0100"));
 }
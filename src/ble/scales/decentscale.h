@@ -40,7 +40,6 @@ private:
     void sendHeartbeat();
     void startHeartbeat();
     void stopHeartbeat();
-    uint8_t calculateXor(const QByteArray& data);
 
     ScaleBleTransport* m_transport = nullptr;
     QString m_name = "Decent Scale";
@@ -1,5 +1,6 @@
 #include "difluidscale.h"
 #include "../protocol/de1characteristics.h"
+#include "../protocol/scalepacket.h"
 #include <QDebug>
 #include <QTimer>
 
@@ -123,13 +124,12 @@ void DifluidScale::onCharacteristicChanged(const QBluetoothUuid& characteristicU
                                            const QByteArray& value) {
     if (characteristicUuid == Scale::DiFluid::CHARACTERISTIC) {
         // Difluid format: header bytes, then hex-encoded weight
-        if (value.size() >= 19) {
-            // Weight is in bytes 5-8 as hex-encoded integer
-            QString hexStr = value.mid(5, 8).toHex();
-            bool ok;
-            uint32_t weightRaw = hexStr.toUInt(&ok, 16);
+        PacketView d(value);
+        if (d.has(0, 19)) {
+            // Weight is in bytes 5-8 as big-endian integer (tenths of gram)
+            uint32_t weightRaw = d.u32be(5);
 
-            if (ok && weightRaw < 20000) {
+            if (weightRaw < 20000) {
                 double weight = weightRaw / 10.0;
                 setWeight(weight);
             }
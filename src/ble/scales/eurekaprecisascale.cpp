@@ -1,5 +1,6 @@
 #include "eurekaprecisascale.h"
 #include "../protocol/de1characteristics.h"
+#include "../protocol/scalepacket.h"
 #include <QDebug>
 #include <QTimer>
 
@@ -123,20 +124,18 @@ void EurekaPrecisaScale::onCharacteristicChanged(const QBluetoothUuid& character
     if (characteristicUuid == Scale::Generic::STATUS) {
         // Eureka Precisa format: AA 09 41 timer_running timer sign weight(2 bytes)
         // Header check: h1=0xAA (170), h2=0x09, h3=0x41 (65)
-        if (value.size() >= 9) {
-            const uint8_t* d = reinterpret_cast<const uint8_t*>(value.constData());
-
+        PacketView d(value);
+        if (d.has(0, 9)) {
             // Check header
-            if (d[0] != 0xAA || d[1] != 0x09 || d[2] != 0x41) {
+            if (!d.startsWith({0xAA, 0x09, 0x41})) {
                 return;
             }
 
             // Weight is in bytes 6-7 as unsigned short (tenths of gram)
-            uint16_t weightRaw = (d[6] << 8) | d[7];
-            double weight = weightRaw / 10.0;
+            double weight = d.u16be(6) / 10.0;
 
             // Sign is in byte 5 (1 = negative)
-            if (d[5] == 1) {
+            if (d.u8(5) == 1) {
                 weight = -weight;
             }
 
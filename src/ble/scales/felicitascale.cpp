@@ -1,5 +1,6 @@
 #include "felicitascale.h"
 #include "../protocol/de1characteristics.h"
+#include "../protocol/scalepacket.h"
 #include <QDebug>
 #include <QTimer>
 
@@ -123,21 +124,18 @@ void FelicitaScale::onCharacteristicChanged(const QBluetoothUuid& characteristic
 
 void FelicitaScale::parseResponse(const QByteArray& data) {
     // Felicita format: header1 header2 sign weight[6] ... battery
-    if (data.size() < 9) return;
-
-    const uint8_t* d = reinterpret_cast<const uint8_t*>(data.constData());
+    PacketView d(data);
+    if (!d.has(0, 9)) return;
 
     // Check headers
-    if (d[0] != 0x01 || d[1] != 0x02) return;
+    if (!d.startsWith({0x01, 0x02})) return;
 
     // Sign is at byte 2 ('+' or '-')
-    char sign = static_cast<char>(d[2]);
+    char sign = static_cast<char>(d.u8(2));
 
     // Weight is 6 ASCII digits starting at byte 3
-    QByteArray weightStr = data.mid(3, 6);
-    bool ok;
-    int weightInt = weightStr.toInt(&ok);
-    if (!ok) return;
+    int weightInt;
+    if (!d.asciiInt(3, 6, weightInt)) return;
 
     double weight = weightInt / 100.0;  // Weight in grams with 2 decimal places
     if (sign == '-') {
@@ -147,8 +145,8 @@ void FelicitaScale::parseResponse(const QByteArray& data) {
     setWeight(weight);
 
     // Battery level is at byte 15 if available
-    if (data.size() >= 16) {
-        uint8_t battery = d[15];
+    if (d.has(15, 1)) {
+        uint8_t battery = d.u8(15);
         // Battery formula from de1app: ((battery - 129) / 29.0) * 100
         int battLevel = static_cast<int>(((battery - 129) / 29.0) * 100);
         battLevel = qBound(0, battLevel, 100);
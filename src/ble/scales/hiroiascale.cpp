@@ -1,5 +1,6 @@
 #include "hiroiascale.h"
 #include "../protocol/de1characteristics.h"
+#include "../protocol/scalepacket.h"
 #include <QDebug>
 #include <QTimer>
 
@@ -118,15 +119,11 @@ void HiroiaScale::onCharacteristicChanged(const QBluetoothUuid& characteristicUu
                                           const QByteArray& value) {
     if (characteristicUuid == Scale::HiroiaJimmy::STATUS) {
         // Hiroia format: 4 bytes header, then 4 bytes weight (unsigned, tenths of gram)
-        if (value.size() >= 7) {
-            // Append a zero byte to make it 8 bytes for easy parsing
-            QByteArray padded = value;
-            padded.append(static_cast<char>(0));
-
-            const uint8_t* d = reinterpret_cast<const uint8_t*>(padded.constData());
-
+        PacketView d(value);
+        if (d.has(0, 7)) {
             // Weight is in bytes 4-7 as unsigned 32-bit little-endian
-            uint32_t weightRaw = d[4] | (d[5] << 8) | (d[6] << 16) | (d[7] << 24);
+            // (7-byte packets omit the top byte; PacketView reads it as zero)
+            uint32_t weightRaw = d.u32le(4);
 
             // Handle negative values (if >= 8388608, it's negative)
             double weight;
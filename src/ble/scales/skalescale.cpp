@@ -1,5 +1,6 @@
 #include "skalescale.h"
 #include "../protocol/de1characteristics.h"
+#include "../protocol/scalepacket.h"
 #include <QDebug>
 #include <QTimer>
 
@@ -139,10 +140,9 @@ void SkaleScale::onCharacteristicChanged(const QBluetoothUuid& characteristicUui
                                          const QByteArray& value) {
     if (characteristicUuid == Scale::Skale::WEIGHT) {
         // Skale weight format: byte 0 = type, bytes 1-2 = unsigned short weight (10ths of gram)
-        if (value.size() >= 3) {
-            const uint8_t* d = reinterpret_cast<const uint8_t*>(value.constData());
-            int16_t weightRaw = static_cast<int16_t>((d[2] << 8) | d[1]);
-            double weight = weightRaw / 10.0;
+        PacketView d(value);
+        if (d.has(0, 3)) {
+            double weight = d.s16le(1) / 10.0;
             setWeight(weight);
         }
     } else if (characteristicUuid == Scale::Skale::BUTTON) {
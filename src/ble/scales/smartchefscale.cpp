@@ -1,5 +1,6 @@
 #include "smartchefscale.h"
 #include "../protocol/de1characteristics.h"
+#include "../protocol/scalepacket.h"
 #include <QDebug>
 #include <QTimer>
 
@@ -119,14 +120,12 @@ void SmartChefScale::onCharacteristicChanged(const QBluetoothUuid& characteristi
     if (characteristicUuid == Scale::Generic::STATUS) {
         // SmartChef format: weight in bytes 5-6 as unsigned short (tenths of gram)
         // Sign determined by byte 3
-        if (value.size() >= 7) {
-            const uint8_t* d = reinterpret_cast<const uint8_t*>(value.constData());
-
-            int16_t weightRaw = static_cast<int16_t>((d[5] << 8) | d[6]);
-            double weight = weightRaw / 10.0;
+        PacketView d(value);
+        if (d.has(0, 7)) {
+            double weight = d.s16be(5) / 10.0;
 
             // If byte 3 > 10, weight is negative
-            if (d[3] > 10) {
+            if (d.u8(3) > 10) {
                 weight = -weight;
             }
 
@@ -1,5 +1,6 @@
 #include "variaakuscale.h"
 #include "../protocol/de1characteristics.h"
+#include "../protocol/scalepacket.h"
 #include <QDebug>
 
 // Helper macro that logs to both qDebug and emits signal for UI/file logging
@@ -212,28 +213,24 @@ void VariaAkuScale::onCharacteristicChanged(const QBluetoothUuid& characteristic
     if (characteristicUuid == Scale::VariaAku::STATUS) {
         // Varia Aku format: header command length payload xor
         // Weight notification: command 0x01, length 0x03, payload w1 w2 w3 xor
-        if (value.size() >= 4) {
-            const uint8_t* d = reinterpret_cast<const uint8_t*>(value.constData());
-
-            uint8_t command = d[1];
-            uint8_t length = d[2];
+        PacketView d(value);
+        if (d.has(0, 4)) {
+            uint8_t command = d.u8(1);
+            uint8_t length = d.u8(2);
 
             // Weight notification
-            if (command == 0x01 && length == 0x03 && value.size() >= 7) {
+            if (command == 0x01 && length == 0x03 && d.has(0, 7)) {
                 // Tickle watchdog on every weight update
                 tickleWatchdog();
 
-                uint8_t w1 = d[3];
-                uint8_t w2 = d[4];
-                uint8_t w3 = d[5];
+                uint32_t raw = d.u24be(3);
 
                 // Sign is in highest nibble of w1 (0x10 means negative)
-                bool isNegative = (w1 & 0x10) != 0;
+                bool isNegative = (raw & 0x100000) != 0;
 
                 // Weight is 3 bytes big-endian in hundredths of gram
                 // Strip sign nibble from w1
-                uint32_t weightRaw = ((w1 & 0x0F) << 16) | (w2 << 8) | w3;
-                double weight = weightRaw / 100.0;
+                double weight = (raw & 0x0FFFFF) / 100.0;
 
                 if (isNegative) {
                     weight = -weight;
@@ -242,8 +239,8 @@ void VariaAkuScale::onCharacteristicChanged(const QBluetoothUuid& characteristic
                 setWeight(weight);
             }
             // Battery notification
-            else if (command == 0x85 && length == 0x01 && value.size() >= 5) {
-                uint8_t battery = d[3];
+            else if (command == 0x85 && length == 0x01 && d.has(0, 5)) {
+                uint8_t battery = d.u8(3);
                 VARIA_LOG(QString("Battery update: %1%").arg(battery));
                 setBatteryLevel(battery);
             }
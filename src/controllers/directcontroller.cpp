@@ -120,7 +120,7 @@ void DirectController::setLivePressure(double pressure) {
     if (m_active && m_currentFrameIndex >= 0 && m_currentFrameIndex < m_profile.steps().size()) {
         ProfileFrame frame = m_profile.steps()[m_currentFrameIndex];
         frame.pressure = pressure;
-        frame.pump = "pressure";
+        frame.pump = ProfileFrame::Pump::Pressure;
 
         QByteArray frameData = frameToBytes(frame, 0);
         m_device->writeFrame(frameData);
@@ -136,7 +136,7 @@ void DirectController::setLiveFlow(double flow) {
     if (m_active && m_currentFrameIndex >= 0 && m_currentFrameIndex < m_profile.steps().size()) {
         ProfileFrame frame = m_profile.steps()[m_currentFrameIndex];
         frame.flow = flow;
-        frame.pump = "flow";
+        frame.pump = ProfileFrame::Pump::Flow;
 
         QByteArray frameData = frameToBytes(frame, 0);
         m_device->writeFrame(frameData);
@@ -260,8 +260,8 @@ void DirectController::sendCurrentFrame() {
 
     qDebug() << "DirectController: Sent frame" << m_currentFrameIndex
              << "(" << frame.name << ")"
-             << (frame.pump == "flow" ? "flow" : "pressure") << "="
-             << (frame.pump == "flow" ? frame.flow : frame.pressure)
+             << (frame.pump == ProfileFrame::Pump::Flow ? "flow" : "pressure") << "="
+             << (frame.pump == ProfileFrame::Pump::Flow ? frame.flow : frame.pressure)
              << "temp=" << frame.temperature;
 }
 
@@ -287,13 +287,13 @@ void DirectController::advanceToNextFrame() {
 bool DirectController::checkExitCondition(const ProfileFrame& frame, const ShotSample& sample) {
     if (!frame.exitIf) return false;
 
-    if (frame.exitType == "pressure_over") {
+    if (frame.exitType == ProfileFrame::Exit::PressureOver) {
         return sample.groupPressure > frame.exitPressureOver;
-    } else if (frame.exitType == "pressure_under") {
+    } else if (frame.exitType == ProfileFrame::Exit::PressureUnder) {
         return sample.groupPressure < frame.exitPressureUnder;
-    } else if (frame.exitType == "flow_over") {
+    } else if (frame.exitType == ProfileFrame::Exit::FlowOver) {
         return sample.groupFlow > frame.exitFlowOver;
-    } else if (frame.exitType == "flow_under") {
+    } else if (frame.exitType == ProfileFrame::Exit::FlowUnder) {
         return sample.groupFlow < frame.exitFlowUnder;
     }
 
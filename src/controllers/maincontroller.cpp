@@ -7,6 +7,8 @@
 #include "../models/shotdatamodel.h"
 #include "../profile/recipegenerator.h"
 #include "../profile/recipeanalyzer.h"
+#include "../simulator/shotphysics.h"
+#include "../simulator/robustnessanalysis.h"
 #include "../models/shotcomparisonmodel.h"
 #include "../network/visualizeruploader.h"
 #include "../network/visualizerimporter.h"
@@ -17,6 +19,7 @@
 #include "../network/shotserver.h"
 #include "../network/locationprovider.h"
 #include "../core/crashhandler.h"
+#include "../core/flightrecorder.h"
 #include <QDir>
 #include <QFile>
 #include <QTextStream>
@@ -27,6 +30,7 @@
 #include <QStandardPaths>
 #include <QVariantMap>
 #include <QRandomGenerator>
+#include <QSet>
 #include <algorithm>
 
 #ifndef Q_OS_WIN
@@ -110,6 +114,7 @@ MainController::MainController(Settings* settings, DE1Device* device,
     // Create shot history storage and comparison model
     m_shotHistory = new ShotHistoryStorage(this);
     m_shotHistory->initialize();
+    m_thumbnailCache = new ShotThumbnailCache(m_shotHistory, this);
 
     // Create shot importer for importing .shot files from DE1 app
     m_shotImporter = new ShotImporter(m_shotHistory, this);
@@ -131,6 +136,7 @@ MainController::MainController(Settings* settings, DE1Device* device,
     m_shotServer = new ShotServer(m_shotHistory, m_device, this);
     m_shotServer->setSettings(m_settings);
     m_shotServer->setProfileStorage(m_profileStorage);
+    m_shotServer->setThumbnailCache(m_thumbnailCache);
     if (m_settings) {
         m_shotServer->setPort(m_settings->shotServerPort());
 
@@ -232,6 +238,24 @@ MainController::MainController(Settings* settings, DE1Device* device,
     // Load initial profile
     refreshProfiles();
 
+    // One robustness analysis at a time; it parallelizes internally
+    m_analysisPool.setMaxThreadCount(1);
+
+    // Pick up profiles copied into the external folder while the app runs.
+    // Internal folders are only written by the app, which refreshes itself.
+    m_profileRefreshTimer.setSingleShot(true);
+    m_profileRefreshTimer.setInterval(500);
+    connect(&m_profileRefreshTimer, &QTimer::timeout, this, &MainController::refreshProfiles);
+    connect(&m_profileWatcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+        m_profileRefreshTimer.start();
+    });
+    if (m_profileStorage && m_profileStorage->isConfigured()) {
+        QString externalPath = m_profileStorage->externalProfilesPath();
+        if (!externalPath.isEmpty() && QDir(externalPath).exists()) {
+            m_profileWatcher.addPath(externalPath);
+        }
+    }
+
     // Check for temp file (modified profile from previous session)
     QString tempPath = profilesPath() + "/_current.json";
     if (QFile::exists(tempPath)) {
@@ -602,15 +626,15 @@ QVariantMap MainController::getCurrentProfile() const {
         QVariantMap step;
         step["name"] = frame.name;
         step["temperature"] = frame.temperature;
-        step["sensor"] = frame.sensor;
-        step["pump"] = frame.pump;
-        step["transition"] = frame.transition;
+        step["sensor"] = ProfileFrame::toString(frame.sensor);
+        step["pump"] = ProfileFrame::toString(frame.pump);
+        step["transition"] = ProfileFrame::toString(frame.transition);
         step["pressure"] = frame.pressure;
         step["flow"] = frame.flow;
         step["seconds"] = frame.seconds;
         step["volume"] = frame.volume;
         step["exit_if"] = frame.exitIf;
-        step["exit_type"] = frame.exitType;
+        step["exit_type"] = ProfileFrame::toString(frame.exitType);
         step["exit_pressure_over"] = frame.exitPressureOver;
         step["exit_pressure_under"] = frame.exitPressureUnder;
         step["exit_flow_over"] = frame.exitFlowOver;
@@ -686,15 +710,15 @@ QVariantMap MainController::getProfileByFilename(const QString& filename) const
         QVariantMap step;
         step["name"] = frame.name;
         step["temperature"] = frame.temperature;
-        step["sensor"] = frame.sensor;
-        step["pump"] = frame.pump;
-        step["transition"] = frame.transition;
+        step["sensor"] = ProfileFrame::toString(frame.sensor);
+        step["pump"] = ProfileFrame::toString(frame.pump);
+        step["transition"] = ProfileFrame::toString(frame.transition);
         step["pressure"] = frame.pressure;
         step["flow"] = frame.flow;
         step["seconds"] = frame.seconds;
         step["volume"] = frame.volume;
         step["exit_if"] = frame.exitIf;
-        step["exit_type"] = frame.exitType;
+        step["exit_type"] = ProfileFrame::toString(frame.exitType);
         step["exit_pressure_over"] = frame.exitPressureOver;
         step["exit_pressure_under"] = frame.exitPressureUnder;
         step["exit_flow_over"] = frame.exitFlowOver;
@@ -937,120 +961,68 @@ void MainController::refreshProfiles() {
     m_profileTitles.clear();
     m_allProfiles.clear();
 
-    // Helper to load profile metadata from file path
-    auto loadProfileMeta = [](const QString& path) -> std::tuple<QString, QString, bool> {
-        QFile file(path);
-        if (file.open(QIODevice::ReadOnly)) {
-            QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-            QJsonObject obj = doc.object();
-            return {obj["title"].toString(), obj["beverage_type"].toString(), obj["is_recipe_mode"].toBool(false)};
-        }
-        return {QString(), QString(), false};
-    };
-
-    // Helper to load profile metadata from JSON string
-    auto loadProfileMetaFromJson = [](const QString& jsonContent) -> std::tuple<QString, QString, bool> {
-        QJsonDocument doc = QJsonDocument::fromJson(jsonContent.toUtf8());
-        QJsonObject obj = doc.object();
-        return {obj["title"].toString(), obj["beverage_type"].toString(), obj["is_recipe_mode"].toBool(false)};
-    };
-
-    QStringList filters;
-    filters << "*.json";
-
-    // 1. Load built-in profiles (always available)
-    QDir builtInDir(":/profiles");
-    QStringList files = builtInDir.entryList(filters, QDir::Files);
-    for (const QString& file : files) {
-        QString name = file.left(file.length() - 5);  // Remove .json
-        auto [title, beverageType, isRecipeMode] = loadProfileMeta(":/profiles/" + file);
+    QSet<QString> loaded;  // First source wins for a given filename
 
+    auto addProfile = [this, &loaded](const QString& name, const ProfileCatalog::Entry& meta, ProfileSource source) {
         ProfileInfo info;
         info.filename = name;
-        info.title = title.isEmpty() ? name : title;
-        info.beverageType = beverageType;
-        info.source = ProfileSource::BuiltIn;
-        info.isRecipeMode = isRecipeMode;
+        info.title = meta.title.isEmpty() ? name : meta.title;
+        info.beverageType = meta.beverageType;
+        info.source = source;
+        info.isRecipeMode = meta.isRecipeMode;
         m_allProfiles.append(info);
 
         m_availableProfiles.append(name);
         m_profileTitles[name] = info.title;
+        loaded.insert(name);
+    };
+
+    // 1. Built-in profiles (always available) - metadata generated at build time
+    for (const auto& builtIn : ProfileCatalog::builtInProfiles()) {
+        addProfile(builtIn.first, builtIn.second, ProfileSource::BuiltIn);
     }
 
+    // Files on disk: metadata comes from the catalog, which only parses changed files
+    m_profileCatalog.beginScan();
+
     // 2. Load profiles from ProfileStorage (SAF folder or fallback)
     if (m_profileStorage) {
-        QStringList storageProfiles = m_profileStorage->listProfiles();
-        for (const QString& name : storageProfiles) {
-            if (m_availableProfiles.contains(name)) {
+        const auto storageProfiles = m_profileStorage->listProfileFiles();
+        for (const auto& [name, path] : storageProfiles) {
+            if (loaded.contains(name)) {
                 continue;  // Skip if already loaded (e.g., built-in with same name)
             }
 
-            QString jsonContent = m_profileStorage->readProfile(name);
-            if (jsonContent.isEmpty()) {
-                continue;
+            ProfileCatalog::Entry meta;
+            if (m_profileCatalog.lookup(path, &meta)) {
+                addProfile(name, meta, ProfileSource::UserCreated);  // All SAF profiles are user-created
             }
-
-            auto [title, beverageType, isRecipeMode] = loadProfileMetaFromJson(jsonContent);
-
-            ProfileInfo info;
-            info.filename = name;
-            info.title = title.isEmpty() ? name : title;
-            info.beverageType = beverageType;
-            info.source = ProfileSource::UserCreated;  // All SAF profiles are user-created
-            info.isRecipeMode = isRecipeMode;
-            m_allProfiles.append(info);
-
-            m_availableProfiles.append(name);
-            m_profileTitles[name] = info.title;
         }
     }
 
-    // 3. Load downloaded profiles (legacy local folder)
-    QDir downloadedDir(downloadedProfilesPath());
-    files = downloadedDir.entryList(filters, QDir::Files);
-    for (const QString& file : files) {
-        QString name = file.left(file.length() - 5);
-        if (m_availableProfiles.contains(name)) {
-            continue;  // Skip if already loaded from ProfileStorage
-        }
-
-        auto [title, beverageType, isRecipeMode] = loadProfileMeta(downloadedDir.filePath(file));
-
-        ProfileInfo info;
-        info.filename = name;
-        info.title = title.isEmpty() ? name : title;
-        info.beverageType = beverageType;
-        info.source = ProfileSource::Downloaded;
-        info.isRecipeMode = isRecipeMode;
-        m_allProfiles.append(info);
-
-        m_availableProfiles.append(name);
-        m_profileTitles[name] = info.title;
-    }
+    // 3. Downloaded profiles, then 4. user-created profiles (legacy local folders)
+    const QList<QPair<QString, ProfileSource>> legacyFolders = {
+        {downloadedProfilesPath(), ProfileSource::Downloaded},
+        {userProfilesPath(), ProfileSource::UserCreated},
+    };
+    for (const auto& [folder, source] : legacyFolders) {
+        QDir dir(folder);
+        const QStringList files = dir.entryList({"*.json"}, QDir::Files);
+        for (const QString& file : files) {
+            QString name = file.left(file.length() - 5);  // Remove .json
+            if (loaded.contains(name)) {
+                continue;  // Skip if already loaded from ProfileStorage
+            }
 
-    // 4. Load user-created profiles (legacy local folder)
-    QDir userDir(userProfilesPath());
-    files = userDir.entryList(filters, QDir::Files);
-    for (const QString& file : files) {
-        QString name = file.left(file.length() - 5);
-        if (m_availableProfiles.contains(name)) {
-            continue;  // Skip if already loaded from ProfileStorage
+            ProfileCatalog::Entry meta;
+            if (m_profileCatalog.lookup(dir.filePath(file), &meta)) {
+                addProfile(name, meta, source);
+            }
         }
-
-        auto [title, beverageType, isRecipeMode] = loadProfileMeta(userDir.filePath(file));
-
-        ProfileInfo info;
-        info.filename = name;
-        info.title = title.isEmpty() ? name : title;
-        info.beverageType = beverageType;
-        info.source = ProfileSource::UserCreated;
-        info.isRecipeMode = isRecipeMode;
-        m_allProfiles.append(info);
-
-        m_availableProfiles.append(name);
-        m_profileTitles[name] = info.title;
     }
 
+    m_profileCatalog.endScan();
+
     emit profilesChanged();
 }
 
@@ -1188,15 +1160,15 @@ void MainController::uploadProfile(const QVariantMap& profileData) {
             ProfileFrame frame;
             frame.name = step["name"].toString();
             frame.temperature = step["temperature"].toDouble();
-            frame.sensor = step["sensor"].toString();
-            frame.pump = step["pump"].toString();
-            frame.transition = step["transition"].toString();
+            frame.sensor = ProfileFrame::parseSensor(step["sensor"].toString());
+            frame.pump = ProfileFrame::parsePump(step["pump"].toString());
+            frame.transition = ProfileFrame::parseTransition(step["transition"].toString());
             frame.pressure = step["pressure"].toDouble();
             frame.flow = step["flow"].toDouble();
             frame.seconds = step["seconds"].toDouble();
             frame.volume = step["volume"].toDouble();
             frame.exitIf = step["exit_if"].toBool();
-            frame.exitType = step["exit_type"].toString();
+            frame.exitType = ProfileFrame::parseExit(step["exit_type"].toString());
             frame.exitPressureOver = step["exit_pressure_over"].toDouble();
             frame.exitPressureUnder = step["exit_pressure_under"].toDouble();
             frame.exitFlowOver = step["exit_flow_over"].toDouble();
@@ -1437,9 +1409,9 @@ void MainController::addFrame(int afterIndex) {
     ProfileFrame newFrame;
     newFrame.name = QString("Step %1").arg(m_currentProfile.steps().size() + 1);
     newFrame.temperature = 93.0;
-    newFrame.sensor = "coffee";
-    newFrame.pump = "pressure";
-    newFrame.transition = "fast";
+    newFrame.sensor = ProfileFrame::Sensor::Coffee;
+    newFrame.pump = ProfileFrame::Pump::Pressure;
+    newFrame.transition = ProfileFrame::Transition::Fast;
     newFrame.pressure = 9.0;
     newFrame.flow = 2.0;
     newFrame.seconds = 30.0;
@@ -1565,16 +1537,16 @@ void MainController::setFrameProperty(int index, const QString& property, const
     // Basic properties
     if (property == "name") frame.name = value.toString();
     else if (property == "temperature") frame.temperature = value.toDouble();
-    else if (property == "sensor") frame.sensor = value.toString();
-    else if (property == "pump") frame.pump = value.toString();
-    else if (property == "transition") frame.transition = value.toString();
+    else if (property == "sensor") frame.sensor = ProfileFrame::parseSensor(value.toString());
+    else if (property == "pump") frame.pump = ProfileFrame::parsePump(value.toString());
+    else if (property == "transition") frame.transition = ProfileFrame::parseTransition(value.toString());
     else if (property == "pressure") frame.pressure = value.toDouble();
     else if (property == "flow") frame.flow = value.toDouble();
     else if (property == "seconds") frame.seconds = value.toDouble();
     else if (property == "volume") frame.volume = value.toDouble();
     // Exit conditions
     else if (property == "exitIf") frame.exitIf = value.toBool();
-    else if (property == "exitType") frame.exitType = value.toString();
+    else if (property == "exitType") frame.exitType = ProfileFrame::parseExit(value.toString());
     else if (property == "exitPressureOver") frame.exitPressureOver = value.toDouble();
     else if (property == "exitPressureUnder") frame.exitPressureUnder = value.toDouble();
     else if (property == "exitFlowOver") frame.exitFlowOver = value.toDouble();
@@ -1613,9 +1585,9 @@ QVariantMap MainController::getFrameAt(int index) const {
     // Basic properties
     map["name"] = frame.name;
     map["temperature"] = frame.temperature;
-    map["sensor"] = frame.sensor;
-    map["pump"] = frame.pump;
-    map["transition"] = frame.transition;
+    map["sensor"] = ProfileFrame::toString(frame.sensor);
+    map["pump"] = ProfileFrame::toString(frame.pump);
+    map["transition"] = ProfileFrame::toString(frame.transition);
     map["pressure"] = frame.pressure;
     map["flow"] = frame.flow;
     map["seconds"] = frame.seconds;
@@ -1623,7 +1595,7 @@ QVariantMap MainController::getFrameAt(int index) const {
 
     // Exit conditions
     map["exitIf"] = frame.exitIf;
-    map["exitType"] = frame.exitType;
+    map["exitType"] = ProfileFrame::toString(frame.exitType);
     map["exitPressureOver"] = frame.exitPressureOver;
     map["exitPressureUnder"] = frame.exitPressureUnder;
     map["exitFlowOver"] = frame.exitFlowOver;
@@ -1644,6 +1616,55 @@ int MainController::frameCount() const {
     return m_currentProfile.steps().size();
 }
 
+QVariantMap MainController::predictCurrentProfile() const {
+    double dose = 18.0;
+    double grindFactor = 1.0;
+    if (m_settings) {
+        if (m_settings->dyeBeanWeight() > 0) dose = m_settings->dyeBeanWeight();
+        grindFactor = ShotPhysics::grindFactorFor(m_settings->dyeGrinderSetting());
+    }
+
+    // Fixed seed: the curve only changes when the profile does
+    ShotPhysics::Prediction prediction = ShotPhysics::predict(m_currentProfile, dose, grindFactor);
+
+    auto toList = [](const QList<QPointF>& points) {
+        QVariantList list;
+        list.reserve(points.size());
+        for (const QPointF& p : points) {
+            list.append(p);
+        }
+        return list;
+    };
+
+    QVariantMap result;
+    result["pressure"] = toList(prediction.pressure);
+    result["flow"] = toList(prediction.flow);
+    result["weight"] = toList(prediction.weight);
+    result["shotTime"] = prediction.shotTime;
+    result["finalWeight"] = prediction.finalWeight;
+    result["peakPressure"] = prediction.peakPressure;
+    return result;
+}
+
+void MainController::analyzeCurrentProfileRobustness(int runs) {
+    RobustnessAnalysis::Options options;
+    options.runs = qBound(1, runs, 5000);
+    if (m_settings) {
+        if (m_settings->dyeBeanWeight() > 0) options.dose = m_settings->dyeBeanWeight();
+        options.grindFactor = ShotPhysics::grindFactorFor(m_settings->dyeGrinderSetting());
+    }
+    options.targetWeight = m_currentProfile.targetWeight();
+
+    // The analysis spreads its runs over its own pool; this one just keeps the UI thread free
+    const Profile profile = m_currentProfile;
+    m_analysisPool.start([this, profile, options]() {
+        QVariantMap report = RobustnessAnalysis::toVariantMap(RobustnessAnalysis::analyze(profile, options));
+        QMetaObject::invokeMethod(this, [this, report]() {
+            emit robustnessAnalysisReady(report);
+        }, Qt::QueuedConnection);
+    });
+}
+
 void MainController::createNewProfile(const QString& title) {
     // Create a new profile with a single default frame
     m_currentProfile = Profile();
@@ -1661,9 +1682,9 @@ void MainController::createNewProfile(const QString& title) {
     ProfileFrame defaultFrame;
     defaultFrame.name = "Extraction";
     defaultFrame.temperature = 93.0;
-    defaultFrame.sensor = "coffee";
-    defaultFrame.pump = "pressure";
-    defaultFrame.transition = "fast";
+    defaultFrame.sensor = ProfileFrame::Sensor::Coffee;
+    defaultFrame.pump = ProfileFrame::Pump::Pressure;
+    defaultFrame.transition = ProfileFrame::Transition::Fast;
     defaultFrame.pressure = 9.0;
     defaultFrame.flow = 2.0;
     defaultFrame.seconds = 60.0;
@@ -2101,11 +2122,11 @@ void MainController::startCalibrationDispense(double flowRate, double targetWeig
     // Use volume limit so DE1 stops based on its own flow sensor (what we're calibrating)
     ProfileFrame frame;
     frame.name = "Calibration";
-    frame.pump = "flow";           // Flow control mode
+    frame.pump = ProfileFrame::Pump::Flow;  // Flow control mode
     frame.flow = flowRate;         // Target flow rate in mL/s
     frame.temperature = m_settings->waterTemperature();  // Use hot water temp
-    frame.sensor = "water";        // Use mix temp sensor (not basket/coffee)
-    frame.transition = "fast";     // Instant transition
+    frame.sensor = ProfileFrame::Sensor::Water;  // Use mix temp sensor (not basket/coffee)
+    frame.transition = ProfileFrame::Transition::Fast;  // Instant transition
     frame.seconds = 120.0;         // 2 minutes max timeout
     frame.volume = targetWeight;   // DE1 stops when its flow sensor thinks this much dispensed
     frame.pressure = 0;            // Not used in flow mode
@@ -2148,11 +2169,11 @@ void MainController::startVerificationDispense(double targetWeight) {
     // FlowScale's calibrated weight will trigger stop-at-weight
     ProfileFrame frame;
     frame.name = "Verification";
-    frame.pump = "flow";
+    frame.pump = ProfileFrame::Pump::Flow;
     frame.flow = 6.0;  // Medium flow rate
     frame.temperature = m_settings->waterTemperature();
-    frame.sensor = "water";
-    frame.transition = "fast";
+    frame.sensor = ProfileFrame::Sensor::Water;
+    frame.transition = ProfileFrame::Transition::Fast;
     frame.seconds = 120.0;  // Long timeout - FlowScale will stop it
     frame.volume = 0;       // NO volume limit - let FlowScale stop
     frame.pressure = 0;
@@ -2204,6 +2225,7 @@ void MainController::onEspressoCycleStarted() {
     m_lastShotTime = 0;
     m_extractionStarted = false;
     m_lastFrameNumber = -1;
+    m_shotFrames = m_currentProfile.frameTable();
     m_frameWeightSkipSent = -1;
     m_tareDone = true;
     if (m_shotDataModel) {
@@ -2287,11 +2309,11 @@ void MainController::onShotEnded() {
         }
     }
 
-    // Stop debug logging and get the captured log
-    QString debugLog;
+    // Stop debug logging and get the captured log (compressed on stop)
+    QByteArray debugLog;
     if (m_shotDebugLogger) {
         m_shotDebugLogger->stopCapture();
-        debugLog = m_shotDebugLogger->getCapturedLog();
+        debugLog = m_shotDebugLogger->compressedLog();
     }
 
     // Build metadata for history
@@ -2539,6 +2561,11 @@ void MainController::onShotSampleReceived(const ShotSample& sample) {
         return;
     }
 
+    // The DE1 clock is aligned from every sample, so it's settled before a shot starts
+    if (m_timingController) {
+        m_timingController->observeDe1Timer(sample);
+    }
+
     MachineState::Phase phase = m_machineState->phase();
 
     // Forward flow samples to MachineState for FlowScale during any dispensing phase
@@ -2591,18 +2618,19 @@ void MainController::onShotSampleReceived(const ShotSample& sample) {
     double pressureGoal = sample.setPressureGoal;
     double flowGoal = sample.setFlowGoal;
     bool isFlowMode = false;
-    {
-        int fi = sample.frameNumber;
-        const auto& steps = m_currentProfile.steps();
-        if (fi >= 0 && fi < steps.size()) {
-            isFlowMode = steps[fi].isFlowControl();
-            if (isFlowMode) {
-                pressureGoal = 0;  // Flow mode - hide pressure goal
-            } else {
-                flowGoal = 0;      // Pressure mode - hide flow goal
-            }
+    const Profile::FrameInfo* frameInfo = nullptr;
+    if (m_shotFrames.isEmpty() && sample.frameNumber >= 0) {
+        // Shot already running when we connected, so no cycle start built the table
+        m_shotFrames = m_currentProfile.frameTable();
+    }
+    if (sample.frameNumber >= 0 && sample.frameNumber < m_shotFrames.size()) {
+        frameInfo = m_shotFrames.constData() + sample.frameNumber;
+        isFlowMode = frameInfo->isFlowMode;
+        if (isFlowMode) {
+            pressureGoal = 0;  // Flow mode - hide pressure goal
+        } else {
+            flowGoal = 0;      // Pressure mode - hide flow goal
         }
-
     }
 
     // Detect frame changes and add markers with frame names from profile
@@ -2611,10 +2639,9 @@ void MainController::onShotSampleReceived(const ShotSample& sample) {
         QString frameName;
         int frameIndex = sample.frameNumber;
 
-        // Look up frame name from current profile
-        const auto& steps = m_currentProfile.steps();
-        if (frameIndex >= 0 && frameIndex < steps.size()) {
-            frameName = steps[frameIndex].name;
+        // Look up frame name from the shot's frame table
+        if (frameInfo) {
+            frameName = frameInfo->name;
         }
 
         // Fall back to frame number if no name
@@ -2634,8 +2661,8 @@ void MainController::onShotSampleReceived(const ShotSample& sample) {
     if (m_timingController) {
         m_timingController->onShotSample(sample, pressureGoal, flowGoal, sample.setTempGoal,
                                           sample.frameNumber, isFlowMode);
-        // Use timing controller's time for graph data (ensures weight and other curves align)
-        time = m_timingController->shotTime();
+        // Use timing controller's DE1-clock time for graph data (ensures weight and other curves align)
+        time = m_timingController->lastSampleTime();
     }
 
     // Add sample data to graph
@@ -2650,9 +2677,11 @@ void MainController::onScaleWeightChanged(double weight) {
         return;
     }
 
+    double flowRate = m_machineState->scaleFlowRate();
+    FlightRecorder::recordWeight(weight, flowRate);
+
     // Forward to timing controller which handles stop-at-weight and graph data
     if (m_timingController) {
-        double flowRate = m_machineState->scaleFlowRate();
         m_timingController->onWeightSample(weight, flowRate);
     }
 }
@@ -2669,17 +2698,17 @@ void MainController::loadDefaultProfile() {
     // Create a simple default profile
     ProfileFrame preinfusion;
     preinfusion.name = "Preinfusion";
-    preinfusion.pump = "pressure";
+    preinfusion.pump = ProfileFrame::Pump::Pressure;
     preinfusion.pressure = 4.0;
     preinfusion.temperature = 93.0;
     preinfusion.seconds = 10.0;
     preinfusion.exitIf = true;
-    preinfusion.exitType = "pressure_over";
+    preinfusion.exitType = ProfileFrame::Exit::PressureOver;
     preinfusion.exitPressureOver = 3.0;
 
     ProfileFrame extraction;
     extraction.name = "Extraction";
-    extraction.pump = "pressure";
+    extraction.pump = ProfileFrame::Pump::Pressure;
     extraction.pressure = 9.0;
     extraction.temperature = 93.0;
     extraction.seconds = 30.0;
@@ -4,6 +4,8 @@
 #include <QVariantList>
 #include <QMap>
 #include <QTimer>
+#include <QFileSystemWatcher>
+#include <QThreadPool>
 #include "../profile/profile.h"
 #include "../network/visualizeruploader.h"
 #include "../network/visualizerimporter.h"
@@ -11,8 +13,10 @@
 #include "../models/shotdatamodel.h"
 #include "../history/shothistorystorage.h"
 #include "../history/shotimporter.h"
+#include "../history/shotthumbnailcache.h"
 #include "../profile/profileconverter.h"
 #include "../profile/profileimporter.h"
+#include "../profile/profilecatalog.h"
 #include "../models/shotcomparisonmodel.h"
 #include "../network/shotserver.h"
 #include "../network/shotreporter.h"
@@ -120,6 +124,7 @@ public:
     QString currentFrameName() const { return m_currentFrameName; }
     bool isCurrentProfileRecipe() const { return m_currentProfile.isRecipeMode(); }
     ShotHistoryStorage* shotHistory() const { return m_shotHistory; }
+    ShotThumbnailCache* thumbnailCache() const { return m_thumbnailCache; }
     ShotImporter* shotImporter() const { return m_shotImporter; }
     ProfileConverter* profileConverter() const { return m_profileConverter; }
     ProfileImporter* profileImporter() const { return m_profileImporter; }
@@ -170,6 +175,15 @@ public:
     Q_INVOKABLE QVariantMap getFrameAt(int index) const;  // Get frame as QVariantMap for QML
     Q_INVOKABLE int frameCount() const;                   // Number of frames in current profile
 
+    // Predicted shot for the profile being edited (offline simulator run, a few ms):
+    // {pressure, flow, weight: [point], shotTime, finalWeight, peakPressure}, timed from frame 0
+    Q_INVOKABLE QVariantMap predictCurrentProfile() const;
+
+    // Monte Carlo spread of the profile under varied grind, dose and channeling.
+    // Runs in the background (well under a second for 200 runs); the result
+    // arrives via robustnessAnalysisReady() as RobustnessAnalysis::toVariantMap().
+    Q_INVOKABLE void analyzeCurrentProfileRobustness(int runs = 200);
+
     // New profile creation
     Q_INVOKABLE void createNewProfile(const QString& title = "New Profile");
 
@@ -243,6 +257,9 @@ signals:
     // Remote sleep: emitted when sleep is triggered via MQTT or REST API
     void remoteSleepRequested();
 
+    // Result of analyzeCurrentProfileRobustness()
+    void robustnessAnalysisReady(const QVariantMap& report);
+
 private slots:
     void onShotSampleReceived(const ShotSample& sample);
 
@@ -260,6 +277,9 @@ private:
     MachineState* m_machineState = nullptr;
     ShotDataModel* m_shotDataModel = nullptr;
     ProfileStorage* m_profileStorage = nullptr;
+    ProfileCatalog m_profileCatalog;          // Cached metadata for refreshProfiles()
+    QFileSystemWatcher m_profileWatcher;      // External profile folder (files added outside the app)
+    QTimer m_profileRefreshTimer;             // Coalesces watcher notifications
     VisualizerUploader* m_visualizer = nullptr;
     VisualizerImporter* m_visualizerImporter = nullptr;
     AIManager* m_aiManager = nullptr;
@@ -274,6 +294,7 @@ private:
     double m_lastShotTime = 0;    // Last shot sample time relative to shot start (for weight sync)
     bool m_extractionStarted = false;
     int m_lastFrameNumber = -1;
+    QVector<Profile::FrameInfo> m_shotFrames;  // Frame table of the running shot's profile
     int m_frameWeightSkipSent = -1;  // Frame number for which we've sent a weight-based skip command
     bool m_tareDone = false;  // Track if we've tared for this shot
 
@@ -298,6 +319,7 @@ private:
 
     // Shot history and comparison
     ShotHistoryStorage* m_shotHistory = nullptr;
+    ShotThumbnailCache* m_thumbnailCache = nullptr;
     ShotImporter* m_shotImporter = nullptr;
     ProfileConverter* m_profileConverter = nullptr;
     ProfileImporter* m_profileImporter = nullptr;
@@ -309,4 +331,7 @@ private:
     LocationProvider* m_locationProvider = nullptr;
     DataMigrationClient* m_dataMigration = nullptr;
     ShotReporter* m_shotReporter = nullptr;
+
+    // Last member: destroyed (and waited for) before anything a worker reports back to
+    QThreadPool m_analysisPool;
 };
@@ -0,0 +1,155 @@
+#include "sawpredictor.h"
+#include <QJsonObject>
+#include <QtMath>
+
+void SawPredictor::load(const QJsonArray& history, const QString& scaleType, const QString& profile) {
+    m_entries.clear();
+
+    double latencySum = 0, stopSum = 0;
+    int latencyCount = 0, stopCount = 0;
+
+    for (qsizetype i = history.size() - 1; i >= 0 && m_entries.size() < 10; --i) {
+        const QJsonObject obj = history[i].toObject();
+        if (obj["scale"].toString() != scaleType) continue;
+
+        double drip, flow;
+        if (obj.contains("drip")) {
+            drip = obj["drip"].toDouble();
+            flow = obj["flow"].toDouble();
+        } else if (obj.contains("lag")) {
+            // Convert old lag format: drip = lag * flow (approximate)
+            flow = 4.0;  // Assume average flow for old entries
+            drip = obj["lag"].toDouble() * flow;
+        } else {
+            continue;
+        }
+
+        // Remove the in-flight part this shot measured, leaving only the drain
+        double latency = obj["latency"].toDouble(-1);
+        double stop = obj["rtt"].toDouble(-1);
+        double inFlight = flow * (qMax(0.0, latency) + qMax(0.0, stop));
+        double drain = qMax(0.0, drip - inFlight);
+
+        m_entries.append({drain, flow, !profile.isEmpty() && obj["profile"].toString() == profile});
+
+        // Latencies are properties of the scale/machine, not the profile
+        if (latency >= 0 && latencyCount < 5) {
+            latencySum += latency;
+            latencyCount++;
+        }
+        if (stop >= 0 && stopCount < 5) {
+            stopSum += stop;
+            stopCount++;
+        }
+    }
+
+    m_scaleLatency = latencyCount > 0 ? latencySum / latencyCount : 0.0;
+    m_stopLatency = stopCount > 0 ? stopSum / stopCount : 0.0;
+}
+
+double SawPredictor::expectedDrain(double flowRate) const {
+    if (m_entries.isEmpty()) {
+        // Default: assume 1.5s lag worth of drip
+        return flowRate * 1.5;
+    }
+
+    // Weighted average: weight by recency, flow similarity and profile match
+    // Recency: most recent = weight 10, oldest = weight 1
+    // Flow similarity: closer flow = higher weight (gaussian-ish)
+    // Profile: same profile counts 3x (puck drain depends on basket/prep)
+    double weightedSum = 0;
+    double totalWeight = 0;
+
+    for (qsizetype i = 0; i < m_entries.size(); ++i) {
+        const Entry& e = m_entries[i];
+
+        double recencyWeight = 10.0 - i;
+
+        // Gaussian with sigma=2 ml/s
+        double flowDiff = qAbs(e.flow - flowRate);
+        double flowWeight = qExp(-(flowDiff * flowDiff) / 8.0);  // sigma^2 * 2 = 8
+
+        double profileWeight = e.sameProfile ? 3.0 : 1.0;
+
+        double weight = recencyWeight * flowWeight * profileWeight;
+        weightedSum += e.drain * weight;
+        totalWeight += weight;
+    }
+
+    if (totalWeight < 0.01) {
+        // All entries have very different flow rates - fall back to default
+        return flowRate * 1.5;
+    }
+
+    return weightedSum / totalWeight;
+}
+
+double SawPredictor::expectedDrip(double flowRate) const {
+    double inFlight = flowRate * (m_scaleLatency + m_stopLatency);
+    double expected = inFlight + expectedDrain(flowRate);
+
+    // Clamp to reasonable range (0.5 to 15 grams)
+    return qBound(0.5, expected, 15.0);
+}
+
+namespace {
+
+// Linear interpolation of a time-sorted series; returns false outside its range
+bool interpolate(const QVector<QPointF>& series, double t, qsizetype& hint, double& out) {
+    if (series.size() < 2 || t < series.first().x() || t > series.last().x()) return false;
+    while (hint + 1 < series.size() && series[hint + 1].x() < t) ++hint;
+    if (hint + 1 >= series.size()) {
+        out = series.last().y();
+        return true;
+    }
+    const QPointF& a = series[hint];
+    const QPointF& b = series[hint + 1];
+    double span = b.x() - a.x();
+    out = span > 0 ? a.y() + (b.y() - a.y()) * (t - a.x()) / span : b.y();
+    return true;
+}
+
+}  // namespace
+
+double SawPredictor::measureScaleLatency(const QVector<QPointF>& machineFlow,
+                                         const QVector<QPointF>& scaleFlow) {
+    constexpr double MAX_LAG = 1.5;
+    constexpr double LAG_STEP = 0.05;
+    constexpr int MIN_PAIRS = 20;
+    constexpr double MIN_CORRELATION = 0.6;
+
+    double bestLag = -1;
+    double bestCorrelation = MIN_CORRELATION;
+
+    for (double lag = 0; lag <= MAX_LAG + 1e-9; lag += LAG_STEP) {
+        double sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+        int n = 0;
+        qsizetype hint = 0;
+
+        for (const QPointF& m : machineFlow) {
+            if (m.y() < 0.5) continue;  // Preinfusion/absorption - no flow reaching the cup yet
+            double s;
+            if (!interpolate(scaleFlow, m.x() + lag, hint, s)) continue;
+            sx += m.y();
+            sy += s;
+            sxx += m.y() * m.y();
+            syy += s * s;
+            sxy += m.y() * s;
+            n++;
+        }
+        if (n < MIN_PAIRS) continue;
+
+        double cov = sxy - sx * sy / n;
+        double varX = sxx - sx * sx / n;
+        double varY = syy - sy * sy / n;
+        if (varX <= 0 || varY <= 0) continue;
+
+        double correlation = cov / qSqrt(varX * varY);
+        if (correlation > bestCorrelation) {
+            bestCorrelation = correlation;
+            bestLag = lag;
+        }
+    }
+
+    return bestLag;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QJsonArray>
+#include <QString>
+#include <QVector>
+#include <QPointF>
+
+/**
+ * SawPredictor decides when to send the stop command so the cup lands on target.
+ *
+ * The grams that arrive after we decide to stop are split into two parts:
+ * - In-flight: flow * (scale notification latency + DE1 stop round-trip).
+ *   The weight we see is already `scaleLatency` old, and the pump keeps running
+ *   for `stopLatency` after the command is sent. Scales linearly with current flow.
+ * - Drain: what drips from the puck and spout after the pump stops, learned
+ *   per scale model (and preferentially per profile) from previous shots.
+ *
+ * Latencies are measured each shot by ShotTimingController and persisted with
+ * the drip in the SAW learning history (see Settings::addSawLearningPoint).
+ * Entries without latency data (older history) have their whole drip treated
+ * as drain, which reproduces the previous drip-only behavior.
+ */
+class SawPredictor {
+public:
+    // Load learned parameters for a scale model + profile from persisted history
+    void load(const QJsonArray& history, const QString& scaleType, const QString& profile);
+
+    double scaleLatency() const { return m_scaleLatency; }
+    double stopLatency() const { return m_stopLatency; }
+
+    // Grams expected to land after a stop decided now, at the given flow (g/s)
+    double expectedDrip(double flowRate) const;
+
+    // Estimate how far the scale's flow lags the DE1's flow (seconds) by
+    // cross-correlating the two series. Points are (time, flow) on the same clock.
+    // Returns -1 if the curves don't correlate well enough to trust.
+    static double measureScaleLatency(const QVector<QPointF>& machineFlow,
+                                      const QVector<QPointF>& scaleFlow);
+
+private:
+    struct Entry {
+        double drain;
+        double flow;
+        bool sameProfile;
+    };
+
+    double expectedDrain(double flowRate) const;
+
+    QVector<Entry> m_entries;  // Most recent first
+    double m_scaleLatency = 0.0;
+    double m_stopLatency = 0.0;
+};
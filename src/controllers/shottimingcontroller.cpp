@@ -3,6 +3,7 @@
 #include "../ble/scaledevice.h"
 #include "../core/settings.h"
 #include "../machine/machinestate.h"
+#include "../core/hotpathlog.h"
 #include <QDebug>
 
 ShotTimingController::ShotTimingController(DE1Device* device, QObject* parent)
@@ -17,6 +18,31 @@ ShotTimingController::ShotTimingController(DE1Device* device, QObject* parent)
     m_settlingTimer.setSingleShot(true);
     m_settlingTimer.setInterval(7000);  // 7 seconds for drips to stop
     connect(&m_settlingTimer, &QTimer::timeout, this, &ShotTimingController::onSettlingComplete);
+
+    // Predictive SAW timer - sends stop between scale samples when the crossing is imminent
+    m_predictiveStopTimer.setSingleShot(true);
+    m_predictiveStopTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_predictiveStopTimer, &QTimer::timeout, this, &ShotTimingController::onPredictiveStopTimeout);
+
+    // The DE1 timer counts mains half-cycles (sample.timer = ticks / 100): 1.0 per
+    // second on 50 Hz mains, 1.2 on 60 Hz. The aligner measures which.
+    m_de1Clock.setRateCandidates({1.0, 1.2});
+
+    // DE1 state change after SAW fires = stop command round-trip
+    if (m_device) {
+        connect(m_device, &DE1Device::stateChanged, this, &ShotTimingController::onMachineStateChanged);
+        connect(m_device, &DE1Device::subStateChanged, this, &ShotTimingController::onMachineStateChanged);
+
+        // The timer runs freely across shots; only a new connection (maybe another machine) starts over
+        connect(m_device, &DE1Device::connectedChanged, this, [this]() {
+            if (!m_device->isConnected()) {
+                m_de1Clock.reset();
+            }
+        });
+    }
+
+    m_machineFlowSeries.reserve(600);
+    m_scaleFlowSeries.reserve(600);
 }
 
 double ShotTimingController::shotTime() const
@@ -25,14 +51,30 @@ double ShotTimingController::shotTime() const
     if (!m_extractionStarted) {
         return 0.0;
     }
-    // Calculate time from wall clock during shot OR during settling (for drip phase)
-    if ((m_shotActive || m_settlingTimer.isActive()) && m_displayTimeBase > 0) {
-        qint64 elapsed = QDateTime::currentMSecsSinceEpoch() - m_displayTimeBase;
-        return elapsed / 1000.0;
+    // Live time on the DE1 timeline during shot OR during settling (for drip phase)
+    if ((m_shotActive || m_settlingTimer.isActive()) && m_timeBase >= 0) {
+        return qMax(m_currentTime, hostToShotTime(MonotonicClock::nowSec()));
     }
     return m_currentTime;
 }
 
+double ShotTimingController::hostToShotTime(double hostSec) const
+{
+    if (m_timeBase < 0 || !m_de1Clock.isValid()) {
+        return m_currentTime;
+    }
+    return m_de1Clock.toDeviceTime(hostSec) - m_timeBase;
+}
+
+void ShotTimingController::emitWeightSample(double weight)
+{
+    // Place the weight on the DE1 timeline at its arrival time (sub-sample accuracy)
+    double time = qMax(m_lastWeightGraphTime, hostToShotTime(MonotonicClock::nowSec()));
+    m_lastWeightGraphTime = time;
+    m_weightEmittedSinceSample = true;
+    emit weightSampleReady(time, weight);
+}
+
 void ShotTimingController::setScale(ScaleDevice* scale)
 {
     m_scale = scale;
@@ -62,7 +104,7 @@ void ShotTimingController::startShot()
 {
     // Cancel settling timer if running (user started new shot before settling completed)
     if (m_settlingTimer.isActive()) {
-        qDebug() << "[SAW] Cancelling settling timer - new shot started";
+        qCDebug(lcSaw) << "[SAW] Cancelling settling timer - new shot started";
         m_settlingTimer.stop();
     }
 
@@ -86,11 +128,31 @@ void ShotTimingController::startShot()
     m_lastStableWeight = 0.0;
     m_lastWeightChangeTime = 0;
 
+    // Reset predictive SAW state and load what we learned for this scale + profile
+    m_predictiveStopTimer.stop();
+    m_lastWeightSampleTime = 0.0;
+    m_weightSampleInterval = 0.1;
+    m_stopSentTime = -1.0;
+    m_stopLatencyThisShot = -1.0;
+    m_machineFlowSeries.clear();
+    m_scaleFlowSeries.clear();
+    if (m_settings) {
+        m_sawPredictor.load(m_settings->sawLearningHistory(), m_settings->scaleType(),
+                            m_settings->currentProfile());
+        qCDebug(lcSaw) << "[SAW] Predictor loaded: scaleLatency=" << m_sawPredictor.scaleLatency()
+                 << "s stopLatency=" << m_sawPredictor.stopLatency() << "s";
+    }
+
     // Reset tare state (will be set to Complete when tare() is called)
     m_tareState = TareState::Idle;
 
+    // The DE1 clock alignment carries over from before the shot (drift needs
+    // minutes of span); the time base is set by the shot's first sample
+    m_timeBase = -1.0;
+    m_lastWeightGraphTime = 0;
+    m_weightEmittedSinceSample = false;
+
     // Start display timer for smooth UI updates
-    m_displayTimeBase = QDateTime::currentMSecsSinceEpoch();
     m_displayTimer.start();
 
     emit shotTimeChanged();
@@ -101,6 +163,7 @@ void ShotTimingController::startShot()
 void ShotTimingController::endShot()
 {
     m_shotActive = false;
+    m_predictiveStopTimer.stop();
 
     // Start settling timer if SAW triggered this shot (for learning)
     // Keep display timer running during settling so graph continues to update
@@ -108,17 +171,24 @@ void ShotTimingController::endShot()
         startSettlingTimer();
         // Don't stop display timer - keep time incrementing for graph
         // shotProcessingReady will be emitted after settling completes
-        qDebug() << "[SAW] SAW triggered - waiting for weight to settle before processing shot";
+        qCDebug(lcSaw) << "[SAW] SAW triggered - waiting for weight to settle before processing shot";
     } else {
         m_displayTimer.stop();
         // No SAW - shot can be processed immediately
-        qDebug() << "[SAW] No SAW - emitting shotProcessingReady immediately";
+        qCDebug(lcSaw) << "[SAW] No SAW - emitting shotProcessingReady immediately";
         emit shotProcessingReady();
     }
 
     emit shotTimeChanged();
 }
 
+void ShotTimingController::observeDe1Timer(const ShotSample& sample)
+{
+    // Align DE1 sample time with host arrival time (sample.timestamp is MonotonicClock ms)
+    double hostArrival = sample.timestamp > 0 ? sample.timestamp / 1000.0 : MonotonicClock::nowSec();
+    m_lastDe1Time = m_de1Clock.addObservation(sample.timer, hostArrival);
+}
+
 void ShotTimingController::onShotSample(const ShotSample& sample, double pressureGoal,
                                          double flowGoal, double tempGoal,
                                          int frameNumber, bool isFlowMode)
@@ -129,6 +199,12 @@ void ShotTimingController::onShotSample(const ShotSample& sample, double pressur
         return;
     }
 
+    // Already added to the aligner by observeDe1Timer()
+    const double deviceTime = m_lastDe1Time;
+    if (m_timeBase < 0) {
+        m_timeBase = deviceTime;  // Preheating counts from shot start
+    }
+
     // Track frame number change and detect extraction start (skip during settling)
     if (!isSettling && frameNumber != m_currentFrameNumber) {
         if (m_currentProfile && frameNumber >= 0 && frameNumber < m_currentProfile->steps().size()) {
@@ -141,13 +217,20 @@ void ShotTimingController::onShotSample(const ShotSample& sample, double pressur
         // Extraction starts when frame 0 is reached (preheating shows higher frame numbers like 2-3)
         if (frameNumber == 0 && !m_extractionStarted) {
             m_extractionStarted = true;
-            m_displayTimeBase = QDateTime::currentMSecsSinceEpoch();
+            m_timeBase = deviceTime;
+            m_currentTime = 0;
+            m_lastWeightGraphTime = 0;
             qDebug() << "EXTRACTION STARTED at frame 0";
         }
     }
 
-    // Calculate time from wall clock (simple and reliable)
-    double time = (QDateTime::currentMSecsSinceEpoch() - m_displayTimeBase) / 1000.0;
+    // Time on the DE1's own clock - immune to BLE delivery jitter and wall-clock jumps
+    double time = deviceTime - m_timeBase;
+    if (time < m_currentTime) {
+        // DE1 timer restarted mid-shot - rebase so the timeline stays continuous
+        m_timeBase -= m_currentTime - time;
+        time = m_currentTime;
+    }
     m_currentTime = time;
 
     emit shotTimeChanged();
@@ -156,11 +239,17 @@ void ShotTimingController::onShotSample(const ShotSample& sample, double pressur
     emit sampleReady(time, sample.groupPressure, sample.groupFlow, sample.headTemp,
                      pressureGoal, flowGoal, tempGoal, frameNumber, isFlowMode);
 
-    // Emit weight sample with same timestamp as other curves (perfect sync)
-    // Weight value is cached from onWeightSample, emitted here for graph alignment
-    if (m_extractionStarted && m_weight >= 0.1) {
-        emit weightSampleReady(time, m_weight);
+    // DE1 flow for scale latency measurement (only up to the stop decision)
+    if (m_extractionStarted && !m_stopAtWeightTriggered && !isSettling) {
+        m_machineFlowSeries.append(QPointF(hostArrival, sample.groupFlow));
+    }
+
+    // Scales only notify on change - hold the last weight so the curve keeps up with the shot
+    if (m_extractionStarted && m_weight >= 0.1 && !m_weightEmittedSinceSample) {
+        m_lastWeightGraphTime = qMax(m_lastWeightGraphTime, time);
+        emit weightSampleReady(m_lastWeightGraphTime, m_weight);
     }
+    m_weightEmittedSinceSample = false;
 }
 
 void ShotTimingController::onWeightSample(double weight, double flowRate)
@@ -170,18 +259,15 @@ void ShotTimingController::onWeightSample(double weight, double flowRate)
         m_weight = weight;
         emit weightChanged();
 
-        // Also emit to graph so drip is visible (use live calculated time)
-        double time = shotTime();
-        emit weightSampleReady(time, weight);
+        // Also emit to graph so drip is visible
+        emitWeightSample(weight);
 
         // Check for weight stabilization (time-based since scale only sends on change)
         double delta = qAbs(weight - m_lastStableWeight);
-        qint64 now = QDateTime::currentMSecsSinceEpoch();
+        qint64 now = MonotonicClock::nowMs();
         qint64 stableMs = now - m_lastWeightChangeTime;
 
-        qDebug() << "[SAW] Settling:" << QString::number(weight, 'f', 1) << "g"
-                 << "delta:" << QString::number(delta, 'f', 2)
-                 << "stable:" << stableMs << "ms";
+        HOT_LOG(lcSaw, "[SAW] Settling: %1 g delta: %2 stable: %3 ms", weight, delta, static_cast<double>(stableMs));
 
         if (delta >= 0.1) {
             // Significant weight change - reset stability timer
@@ -189,7 +275,7 @@ void ShotTimingController::onWeightSample(double weight, double flowRate)
             m_lastWeightChangeTime = now;
         } else if (stableMs >= 1000) {
             // Weight stable for 1 second
-            qDebug() << "[SAW] Weight stabilized at" << weight << "g (stable for" << stableMs << "ms)";
+            qCDebug(lcSaw) << "[SAW] Weight stabilized at" << weight << "g (stable for" << stableMs << "ms)";
             m_settlingTimer.stop();
             onSettlingComplete();
         }
@@ -205,9 +291,25 @@ void ShotTimingController::onWeightSample(double weight, double flowRate)
     m_weight = weight;
     m_flowRate = flowRate;
 
+    // Track sample timing for extrapolation between samples
+    double now = MonotonicClock::nowSec();
+    if (m_lastWeightSampleTime > 0) {
+        double interval = now - m_lastWeightSampleTime;
+        if (interval > 0 && interval < 1.0) {
+            m_weightSampleInterval = 0.8 * m_weightSampleInterval + 0.2 * interval;
+        }
+    }
+    m_lastWeightSampleTime = now;
+    if (!m_stopAtWeightTriggered) {
+        m_scaleFlowSeries.append(QPointF(now, flowRate));
+    }
+
     emit weightChanged();
 
-    // Weight is cached here, emitted to graph in onShotSample for perfect timestamp sync
+    if (weight >= 0.1) {
+        emitWeightSample(weight);
+    }
+
     // Check stop conditions
     checkStopAtWeight();
 
@@ -238,14 +340,14 @@ void ShotTimingController::onTareTimeout()
 
 void ShotTimingController::updateDisplayTimer()
 {
-    // Just emit the signal - shotTime() calculates from wall clock
+    // Just emit the signal - shotTime() calculates from the aligned DE1 clock
     emit shotTimeChanged();
 
     // Also check settling stability here (in case scale stops sending samples)
     if (m_settlingTimer.isActive() && m_lastWeightChangeTime > 0) {
-        qint64 stableMs = QDateTime::currentMSecsSinceEpoch() - m_lastWeightChangeTime;
+        qint64 stableMs = MonotonicClock::nowMs() - m_lastWeightChangeTime;
         if (stableMs >= 1000) {
-            qDebug() << "[SAW] Weight stabilized at" << m_weight << "g (stable for" << stableMs << "ms, detected by timer)";
+            qCDebug(lcSaw) << "[SAW] Weight stabilized at" << m_weight << "g (stable for" << stableMs << "ms, detected by timer)";
             m_settlingTimer.stop();
             onSettlingComplete();
         }
@@ -260,11 +362,11 @@ void ShotTimingController::checkStopAtWeight()
     // Sanity check: if we're very early in extraction and weight is unreasonably high,
     // assume tare hasn't completed yet (race condition when preheating is skipped).
     // Real coffee can't drip 50g in 3 seconds.
-    if (m_extractionStarted && m_displayTimeBase > 0) {
-        double extractionTime = (QDateTime::currentMSecsSinceEpoch() - m_displayTimeBase) / 1000.0;
+    if (m_extractionStarted) {
+        double extractionTime = shotTime();
         if (extractionTime < 3.0 && m_weight > 50.0) {
-            qDebug() << "[SAW] Sanity check: weight" << m_weight << "g at" << extractionTime
-                     << "s - likely untared cup, skipping SAW check";
+            HOT_LOG(lcSaw, "[SAW] Sanity check: weight %1 g at %2 s - likely untared cup, skipping SAW check",
+                    m_weight, extractionTime);
             return;
         }
     }
@@ -282,43 +384,78 @@ void ShotTimingController::checkStopAtWeight()
     if (target <= 0) return;
 
     double stopThreshold;
+    double weight = m_weight;
     if (state == DE1::State::HotWater) {
         // Hot water: use fixed 5g offset (predictable, avoids scale-dependent issues)
         stopThreshold = target - 5.0;
     } else {
-        // Espresso: predict drip based on current flow and learning history
+        // Espresso: predict drip based on current flow, measured latencies and learning history
         double flowRate = m_flowRate;
         if (flowRate > 12.0) flowRate = 12.0;  // Cap at reasonable max
         if (flowRate < 0.5) flowRate = 0.5;    // Minimum to avoid division issues
-        double expectedDrip = m_settings ? m_settings->getExpectedDrip(flowRate) : (flowRate * 1.5);
+        double expectedDrip = m_sawPredictor.expectedDrip(flowRate);
         stopThreshold = target - expectedDrip;
 
+        // Extrapolate since the last scale sample (non-zero when called from the predictive timer)
+        if (m_flowRate > 0) {
+            double sinceSample = MonotonicClock::nowSec() - m_lastWeightSampleTime;
+            weight += m_flowRate * qBound(0.0, sinceSample, m_weightSampleInterval * 2);
+        }
+
         // Debug: log the expected drip (once per shot when it changes significantly)
         static double lastLoggedDrip = -1;
         if (qAbs(expectedDrip - lastLoggedDrip) > 0.5) {
-            qDebug() << "[SAW] Expected drip:" << expectedDrip << "g at flow" << flowRate << "ml/s";
+            qCDebug(lcSaw) << "[SAW] Expected drip:" << expectedDrip << "g at flow" << flowRate << "ml/s";
             lastLoggedDrip = expectedDrip;
         }
     }
 
-    if (m_weight >= stopThreshold) {
-        m_stopAtWeightTriggered = true;
-
-        // Capture state for SAW learning (espresso only)
-        if (state != DE1::State::HotWater) {
-            m_sawTriggeredThisShot = true;
-            m_flowRateAtStop = m_flowRate;
-            m_weightAtStop = m_weight;
-            m_targetWeightAtStop = target;
-            double expectedDrip = m_settings ? m_settings->getExpectedDrip(m_flowRate) : 0;
-            qDebug() << "[SAW] Stop triggered: weight=" << m_weightAtStop
-                     << "threshold=" << stopThreshold
-                     << "expectedDrip=" << expectedDrip
-                     << "flow=" << m_flowRateAtStop
-                     << "target=" << m_targetWeightAtStop;
+    if (weight < stopThreshold) {
+        // Crossing due before the next scale sample arrives? Schedule the stop for then,
+        // otherwise fast turbo shots overshoot by up to one full sample interval.
+        if (state != DE1::State::HotWater && m_flowRate > 0.5) {
+            double lead = (stopThreshold - weight) / m_flowRate;
+            if (lead < m_weightSampleInterval) {
+                m_predictiveStopTimer.start(qRound(lead * 1000));
+            }
         }
+        return;
+    }
 
-        emit stopAtWeightReached();
+    m_stopAtWeightTriggered = true;
+    m_predictiveStopTimer.stop();
+    m_stopSentTime = MonotonicClock::nowSec();
+
+    // Capture state for SAW learning (espresso only)
+    if (state != DE1::State::HotWater) {
+        m_sawTriggeredThisShot = true;
+        m_flowRateAtStop = m_flowRate;
+        m_weightAtStop = m_weight;
+        m_targetWeightAtStop = target;
+        double expectedDrip = m_sawPredictor.expectedDrip(m_flowRate);
+        qCDebug(lcSaw) << "[SAW] Stop triggered: weight=" << m_weightAtStop
+                 << "projected=" << weight
+                 << "threshold=" << stopThreshold
+                 << "expectedDrip=" << expectedDrip
+                 << "flow=" << m_flowRateAtStop
+                 << "target=" << m_targetWeightAtStop;
+    }
+
+    emit stopAtWeightReached();
+}
+
+void ShotTimingController::onPredictiveStopTimeout()
+{
+    if (!m_shotActive || !m_extractionStarted) return;
+    checkStopAtWeight();
+}
+
+void ShotTimingController::onMachineStateChanged()
+{
+    // First state change after SAW fired is the DE1 acknowledging the stop
+    if (m_stopSentTime >= 0 && m_stopLatencyThisShot < 0) {
+        m_stopLatencyThisShot = MonotonicClock::nowSec() - m_stopSentTime;
+        qCDebug(lcSaw) << "[SAW] Stop round-trip:" << qRound(m_stopLatencyThisShot * 1000) << "ms";
     }
 }
 
@@ -329,8 +466,8 @@ void ShotTimingController::checkPerFrameWeight(int frameNumber)
     if (m_tareState != TareState::Complete) return;
 
     // Same sanity check as SAW - skip if weight is unreasonably high early in extraction
-    if (m_extractionStarted && m_displayTimeBase > 0) {
-        double extractionTime = (QDateTime::currentMSecsSinceEpoch() - m_displayTimeBase) / 1000.0;
+    if (m_extractionStarted) {
+        double extractionTime = shotTime();
         if (extractionTime < 3.0 && m_weight > 50.0) {
             return;  // Likely untared cup
         }
@@ -351,9 +488,9 @@ void ShotTimingController::checkPerFrameWeight(int frameNumber)
 
 void ShotTimingController::startSettlingTimer()
 {
-    qDebug() << "[SAW] Starting settling (max 15s, or stable for 1s) - current weight:" << m_weight;
+    qCDebug(lcSaw) << "[SAW] Starting settling (max 15s, or stable for 1s) - current weight:" << m_weight;
     m_lastStableWeight = m_weight;
-    m_lastWeightChangeTime = QDateTime::currentMSecsSinceEpoch();
+    m_lastWeightChangeTime = MonotonicClock::nowMs();
     m_settlingTimer.setInterval(15000);  // 15 second max timeout
     m_settlingTimer.start();
     emit sawSettlingChanged();
@@ -371,13 +508,13 @@ void ShotTimingController::onSettlingComplete()
 
     // Check scale is still connected
     if (!m_scale || !m_scale->isConnected()) {
-        qDebug() << "[SAW] Scale disconnected, skipping learning";
+        qCDebug(lcSaw) << "[SAW] Scale disconnected, skipping learning";
         return;
     }
 
     // Validate flow rate at stop (low flow makes division unstable)
     if (m_flowRateAtStop < 0.5) {
-        qDebug() << "[SAW] Flow at stop too low (" << m_flowRateAtStop << "), skipping learning";
+        qCDebug(lcSaw) << "[SAW] Flow at stop too low (" << m_flowRateAtStop << "), skipping learning";
         return;
     }
 
@@ -389,13 +526,17 @@ void ShotTimingController::onSettlingComplete()
 
     // Validate drip is in reasonable range (0 to 15 grams)
     if (drip > 15.0) {
-        qDebug() << "[SAW] Drip out of range (" << drip << "g), skipping learning";
+        qCDebug(lcSaw) << "[SAW] Drip out of range (" << drip << "g), skipping learning";
         return;
     }
 
-    qDebug() << "[SAW] Learning: final=" << m_weight << "g target=" << m_targetWeightAtStop
-             << "drip=" << drip << "g flow=" << m_flowRateAtStop << "ml/s overshoot=" << overshoot << "g";
+    // How far the scale lags the DE1's flow meter (includes puck-to-cup transit)
+    double scaleLatency = SawPredictor::measureScaleLatency(m_machineFlowSeries, m_scaleFlowSeries);
+
+    qCDebug(lcSaw) << "[SAW] Learning: final=" << m_weight << "g target=" << m_targetWeightAtStop
+             << "drip=" << drip << "g flow=" << m_flowRateAtStop << "ml/s overshoot=" << overshoot << "g"
+             << "scaleLatency=" << scaleLatency << "s stopLatency=" << m_stopLatencyThisShot << "s";
 
     // Emit signal for main.cpp to handle persistence (drip and flow, not lag)
-    emit sawLearningComplete(drip, m_flowRateAtStop, overshoot);
+    emit sawLearningComplete(drip, m_flowRateAtStop, overshoot, scaleLatency, m_stopLatencyThisShot);
 }
@@ -2,8 +2,11 @@
 
 #include <QObject>
 #include <QTimer>
-#include <QDateTime>
+#include <QVector>
+#include <QPointF>
 #include "../profile/profile.h"
+#include "../core/monotonicclock.h"
+#include "sawpredictor.h"
 
 class DE1Device;
 class ScaleDevice;
@@ -19,7 +22,9 @@ struct ShotSample;
  * - MainController (DE1 BLE timer sync)
  * - ShotDataModel (raw time tracking)
  *
- * Single source of truth: DE1's BLE timer (sample.timer)
+ * Single source of truth: DE1's BLE timer (sample.timer). Scale weights arrive on the
+ * host's MonotonicClock and are mapped onto the DE1 timeline via DeviceClockAligner,
+ * so weight and pressure curves line up independent of BLE jitter or wall-clock jumps.
  *
  * Responsibilities:
  * 1. Shot timing using DE1's BLE timer
@@ -43,6 +48,7 @@ public:
 
     // Properties
     double shotTime() const;
+    double lastSampleTime() const { return m_currentTime; }  // DE1 time of the latest sample
     bool isTareComplete() const { return m_tareState == TareState::Complete; }
     double currentWeight() const { return m_weight; }
     TareState tareState() const { return m_tareState; }
@@ -60,6 +66,7 @@ public:
     void endShot();     // Called when shot ends
 
     // Data ingestion (called by MainController)
+    void observeDe1Timer(const ShotSample& sample);  // Every DE1 sample, shot or not
     void onShotSample(const ShotSample& sample, double pressureGoal, double flowGoal,
                       double tempGoal, int frameNumber, bool isFlowMode);
     void onWeightSample(double weight, double flowRate);
@@ -83,8 +90,10 @@ signals:
     void stopAtWeightReached();
     void perFrameWeightReached(int frameNumber);
 
-    // SAW learning - emits drip (grams after stop) and flow rate for learning
-    void sawLearningComplete(double drip, double flowAtStop, double overshoot);
+    // SAW learning - emits drip (grams after stop), flow rate and the measured
+    // scale/stop latencies (seconds, -1 if not measurable this shot) for learning
+    void sawLearningComplete(double drip, double flowAtStop, double overshoot,
+                             double scaleLatency, double stopLatency);
 
     // Emitted when shot is ready to be saved/processed
     // (immediately if no SAW, or after settling if SAW triggered)
@@ -94,8 +103,12 @@ private slots:
     void onTareTimeout();
     void updateDisplayTimer();
     void onSettlingComplete();
+    void onPredictiveStopTimeout();
+    void onMachineStateChanged();
 
 private:
+    double hostToShotTime(double hostSec) const;
+    void emitWeightSample(double weight);
     void startSettlingTimer();
     void checkStopAtWeight();
     void checkPerFrameWeight(int frameNumber);
@@ -106,8 +119,13 @@ private:
     MachineState* m_machineState = nullptr;
     const Profile* m_currentProfile = nullptr;
 
-    // Timing state (wall clock based - simple and reliable)
-    double m_currentTime = 0;      // Current shot time in seconds
+    // Timing state (DE1 timeline, seconds since shot/extraction start)
+    double m_currentTime = 0;      // Shot time of the latest DE1 sample
+    DeviceClockAligner m_de1Clock{655.36};  // sample.timer (16-bit ticks / 100) <-> MonotonicClock
+    double m_lastDe1Time = 0.0;    // Unwrapped DE1 time of the latest sample (s)
+    double m_timeBase = -1.0;      // DE1 time at shot start, rebased at extraction start
+    double m_lastWeightGraphTime = 0;   // Keeps weight graph points monotonic
+    bool m_weightEmittedSinceSample = false;
     bool m_shotActive = false;
 
     // Weight state
@@ -126,7 +144,17 @@ private:
     double m_targetWeightAtStop = 0.0;
     QTimer m_settlingTimer;
     double m_lastStableWeight = 0.0;  // For detecting weight stabilization
-    qint64 m_lastWeightChangeTime = 0; // Timestamp of last significant weight change (ms)
+    qint64 m_lastWeightChangeTime = 0; // MonotonicClock ms of last significant weight change
+
+    // Predictive SAW: fires between scale samples and learns latencies per shot
+    SawPredictor m_sawPredictor;
+    QTimer m_predictiveStopTimer;         // Fires at the predicted stop time between samples
+    double m_lastWeightSampleTime = 0.0;  // MonotonicClock seconds of latest weight sample
+    double m_weightSampleInterval = 0.1;  // Smoothed interval between weight samples (s)
+    double m_stopSentTime = -1.0;         // MonotonicClock seconds when SAW fired
+    double m_stopLatencyThisShot = -1.0;  // Stop command -> DE1 state change (s)
+    QVector<QPointF> m_machineFlowSeries; // (time, DE1 flow) for scale latency measurement
+    QVector<QPointF> m_scaleFlowSeries;   // (time, scale flow)
 
     // Tare state machine
     TareState m_tareState = TareState::Idle;
@@ -134,5 +162,4 @@ private:
 
     // Display timer (for smooth UI updates between BLE samples)
     QTimer m_displayTimer;
-    qint64 m_displayTimeBase = 0;  // Wall clock when shot started
 };
@@ -1,4 +1,5 @@
 #include "crashhandler.h"
+#include "flightrecorder.h"
 
 #include <QCoreApplication>
 #include <QDateTime>
@@ -32,6 +33,7 @@
 static char s_crashLogPath[512] = {0};
 static char s_debugLogPath[512] = {0};
 static char s_lastDebugMessage[4096] = {0};
+static void (*s_logFlushHook)() = nullptr;
 
 // Store recent debug messages for context
 static QtMessageHandler s_previousHandler = nullptr;
@@ -162,6 +164,9 @@ static void writeBacktraceToFile(FILE* f)
 
 void CrashHandler::writeCrashLog(int signal, const char* signalName)
 {
+    // Machine telemetry first - raw write of a static buffer, can't fail halfway through formatting
+    FlightRecorder::dumpToFile();
+
     // Open crash log file (using raw C file I/O - safer in signal handler)
     FILE* f = fopen(s_crashLogPath, "w");
     if (!f) return;
@@ -190,6 +195,11 @@ void CrashHandler::writeCrashLog(int signal, const char* signalName)
     fflush(f);
     fclose(f);
 
+    // Get buffered log lines out first so the report lands after them
+    if (s_logFlushHook) {
+        s_logFlushHook();
+    }
+
     // Also append to debug.log for persistence
     if (s_debugLogPath[0] != '\0') {
         FILE* debugLog = fopen(s_debugLogPath, "a");
@@ -247,6 +257,9 @@ void CrashHandler::install()
     QByteArray debugPathBytes = debugPath.toUtf8();
     strncpy(s_debugLogPath, debugPathBytes.constData(), sizeof(s_debugLogPath) - 1);
 
+    // Flight recorder dump path (flight.bin)
+    FlightRecorder::install();
+
     qDebug() << "CrashHandler: Installing signal handlers, crash log path:" << logPath;
 
     // Install message handler to capture last debug message
@@ -281,6 +294,11 @@ void CrashHandler::uninstall()
     }
 }
 
+void CrashHandler::setLogFlushHook(void (*hook)())
+{
+    s_logFlushHook = hook;
+}
+
 QString CrashHandler::crashLogPath()
 {
     return QString::fromUtf8(s_crashLogPath);
@@ -345,18 +363,23 @@ QString CrashHandler::getDebugLogTail(int lines)
         debugPath = dataPath + "/debug.log";
     }
 
-    QFile file(debugPath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return QString();
-    }
+    // debug.log rotates into debug.1.log; a fresh segment may be short
+    QString previousPath = debugPath;
+    previousPath.replace(QStringLiteral("debug.log"), QStringLiteral("debug.1.log"));
 
     // Read all lines and get the last N
     QStringList allLines;
-    QTextStream stream(&file);
-    while (!stream.atEnd()) {
-        allLines.append(stream.readLine());
+    for (const QString& path : {previousPath, debugPath}) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            continue;
+        }
+        QTextStream stream(&file);
+        while (!stream.atEnd()) {
+            allLines.append(stream.readLine());
+        }
+        file.close();
     }
-    file.close();
 
     // Get last N lines
     int startIndex = qMax(0, allLines.size() - lines);
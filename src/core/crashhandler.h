@@ -7,7 +7,7 @@
  * @brief Installs signal handlers to catch crashes and log debug info before dying.
  *
  * Catches: SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL
- * Logs to: <app_data>/crash.log
+ * Logs to: <app_data>/crash.log, plus the FlightRecorder ring to <app_data>/flight.bin
  *
  * Call CrashHandler::install() early in main() before QApplication.
  */
@@ -32,9 +32,13 @@ public:
     /// Read the crash log without clearing it
     static QString readCrashLog();
 
-    /// Get the last N lines of debug.log for context
+    /// Get the last N lines of debug.log (and its previous segment) for context
     static QString getDebugLogTail(int lines = 50);
 
+    /// Called from the signal handler before the report is appended to debug.log,
+    /// so a buffered logger can write out what it still holds. Must not block.
+    static void setLogFlushHook(void (*hook)());
+
 private:
     static void signalHandler(int signal);
     static void writeCrashLog(int signal, const char* signalName);
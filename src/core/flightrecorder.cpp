@@ -0,0 +1,237 @@
+#include "flightrecorder.h"
+#include "monotonicclock.h"
+#include "../ble/protocol/de1characteristics.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Dump file layout: DumpHeader, then CAPACITY Entry structs in native layout
+// (the file is only read back by the same build on the same device)
+struct DumpHeader {
+    char magic[8];
+    quint32 version;
+    quint32 entrySize;
+    quint32 capacity;
+    quint32 reserved;
+    qint64 dumpTimeMs;
+};
+
+constexpr char DUMP_MAGIC[8] = {'D', 'E', '1', 'F', 'L', 'I', 'G', 'H'};
+constexpr quint32 DUMP_VERSION = 1;
+
+// Static storage: recording and dumping never allocate
+FlightRecorder::Entry s_entries[FlightRecorder::CAPACITY];
+std::atomic<quint32> s_nextSequence{0};
+char s_dumpPath[512] = {0};
+
+}  // namespace
+
+void FlightRecorder::install()
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataPath);
+    QByteArray pathBytes = QString(dataPath + "/flight.bin").toUtf8();
+    strncpy(s_dumpPath, pathBytes.constData(), sizeof(s_dumpPath) - 1);
+}
+
+QString FlightRecorder::dumpPath()
+{
+    return QString::fromUtf8(s_dumpPath);
+}
+
+FlightRecorder::Entry* FlightRecorder::claim(Kind kind, quint32* sequence)
+{
+    *sequence = s_nextSequence.fetch_add(1, std::memory_order_relaxed) + 1;
+    Entry* entry = &s_entries[(*sequence - 1) % CAPACITY];
+
+    // Mark the slot empty while it is rewritten, so a dump never shows a torn entry as valid
+    entry->sequence = 0;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    entry->kind = kind;
+    entry->length = 0;
+    entry->tag = 0;
+    entry->timeMs = MonotonicClock::nowMs();
+    return entry;
+}
+
+void FlightRecorder::publish(Entry* entry, quint32 sequence)
+{
+    std::atomic_thread_fence(std::memory_order_release);
+    entry->sequence = sequence;
+}
+
+void FlightRecorder::recordShotSample(double timer, double pressure, double flow, double mixTemp,
+                                      double headTemp, double pressureGoal, double flowGoal,
+                                      double tempGoal, int frame)
+{
+    quint32 sequence;
+    Entry* entry = claim(Kind::ShotSample, &sequence);
+    entry->tag = static_cast<quint16>(frame);
+    entry->values[0] = static_cast<float>(timer);
+    entry->values[1] = static_cast<float>(pressure);
+    entry->values[2] = static_cast<float>(flow);
+    entry->values[3] = static_cast<float>(mixTemp);
+    entry->values[4] = static_cast<float>(headTemp);
+    entry->values[5] = static_cast<float>(pressureGoal);
+    entry->values[6] = static_cast<float>(flowGoal);
+    entry->values[7] = static_cast<float>(tempGoal);
+    publish(entry, sequence);
+}
+
+void FlightRecorder::recordWeight(double weight, double flowRate)
+{
+    quint32 sequence;
+    Entry* entry = claim(Kind::Weight, &sequence);
+    entry->values[0] = static_cast<float>(weight);
+    entry->values[1] = static_cast<float>(flowRate);
+    publish(entry, sequence);
+}
+
+void FlightRecorder::recordState(int state, int subState)
+{
+    quint32 sequence;
+    Entry* entry = claim(Kind::State, &sequence);
+    entry->tag = static_cast<quint16>(((state & 0xFF) << 8) | (subState & 0xFF));
+    publish(entry, sequence);
+}
+
+void FlightRecorder::recordCommand(quint32 characteristic, const QByteArray& data)
+{
+    quint32 sequence;
+    Entry* entry = claim(Kind::Command, &sequence);
+    entry->tag = static_cast<quint16>(characteristic);
+    const int length = qMin<int>(data.size(), MAX_PAYLOAD);
+    memcpy(entry->payload, data.constData(), length);
+    entry->length = static_cast<quint8>(length);
+    publish(entry, sequence);
+}
+
+void FlightRecorder::dumpToFile()
+{
+    // Signal handler context: open/write/close only
+    if (s_dumpPath[0] == '\0') return;
+
+#ifdef Q_OS_WIN
+    int fd = _open(s_dumpPath, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+#else
+    int fd = open(s_dumpPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    if (fd < 0) return;
+
+    DumpHeader header;
+    memcpy(header.magic, DUMP_MAGIC, sizeof(DUMP_MAGIC));
+    header.version = DUMP_VERSION;
+    header.entrySize = sizeof(Entry);
+    header.capacity = CAPACITY;
+    header.reserved = 0;
+    header.dumpTimeMs = MonotonicClock::nowMs();
+
+#ifdef Q_OS_WIN
+    _write(fd, &header, sizeof(header));
+    _write(fd, s_entries, sizeof(s_entries));
+    _close(fd);
+#else
+    ssize_t ignored = write(fd, &header, sizeof(header));
+    ignored = write(fd, s_entries, sizeof(s_entries));
+    (void)ignored;
+    close(fd);
+#endif
+}
+
+QStringList FlightRecorder::liveLines()
+{
+    QList<Entry> entries;
+    entries.reserve(CAPACITY);
+    for (const Entry& entry : s_entries) {
+        if (entry.sequence != 0) {
+            entries.append(entry);
+        }
+    }
+    return format(entries, MonotonicClock::nowMs());
+}
+
+QStringList FlightRecorder::lastCrashLines()
+{
+    QFile file(dumpPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QStringList();
+    }
+
+    const QByteArray data = file.readAll();
+    DumpHeader header;
+    if (data.size() < static_cast<qsizetype>(sizeof(header))) {
+        return QStringList();
+    }
+    memcpy(&header, data.constData(), sizeof(header));
+    if (memcmp(header.magic, DUMP_MAGIC, sizeof(DUMP_MAGIC)) != 0
+        || header.version != DUMP_VERSION || header.entrySize != sizeof(Entry)
+        || data.size() < static_cast<qsizetype>(sizeof(header) + header.capacity * sizeof(Entry))) {
+        return QStringList{QStringLiteral("Flight recorder dump from an incompatible build")};
+    }
+
+    QList<Entry> entries;
+    const char* cursor = data.constData() + sizeof(header);
+    for (quint32 i = 0; i < header.capacity; ++i, cursor += sizeof(Entry)) {
+        Entry entry;
+        memcpy(&entry, cursor, sizeof(Entry));
+        if (entry.sequence != 0) {
+            entries.append(entry);
+        }
+    }
+    return format(entries, header.dumpTimeMs);
+}
+
+QStringList FlightRecorder::format(QList<Entry> entries, qint64 endMs)
+{
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.sequence < b.sequence;
+    });
+
+    QStringList lines;
+    lines.reserve(entries.size());
+    for (const Entry& entry : entries) {
+        // Times relative to the crash (or now), e.g. "-12.345"
+        QString line = QString("[%1] ").arg((entry.timeMs - endMs) / 1000.0, 9, 'f', 3);
+        const float* v = entry.values;
+        switch (entry.kind) {
+        case Kind::ShotSample:
+            line += QString("SAMPLE  t=%1 P=%2 F=%3 mix=%4 head=%5 goalP=%6 goalF=%7 goalT=%8 frame=%9")
+                .arg(v[0], 0, 'f', 2).arg(v[1], 0, 'f', 2).arg(v[2], 0, 'f', 2)
+                .arg(v[3], 0, 'f', 1).arg(v[4], 0, 'f', 1).arg(v[5], 0, 'f', 1)
+                .arg(v[6], 0, 'f', 1).arg(v[7], 0, 'f', 1).arg(entry.tag);
+            break;
+        case Kind::Weight:
+            line += QString("WEIGHT  %1 g flow=%2 g/s").arg(v[0], 0, 'f', 1).arg(v[1], 0, 'f', 2);
+            break;
+        case Kind::State:
+            line += QString("STATE   %1 / %2")
+                .arg(DE1::stateToString(static_cast<DE1::State>(entry.tag >> 8)),
+                     DE1::subStateToString(static_cast<DE1::SubState>(entry.tag & 0xFF)));
+            break;
+        case Kind::Command:
+            line += QString("COMMAND %1 %2")
+                .arg(entry.tag, 4, 16, QChar('0'))
+                .arg(QString::fromLatin1(QByteArray(reinterpret_cast<const char*>(entry.payload), entry.length).toHex()));
+            break;
+        case Kind::Empty:
+            continue;
+        }
+        lines.append(line);
+    }
+    return lines;
+}
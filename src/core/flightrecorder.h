@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QStringList>
+
+/**
+ * Crash flight recorder: what the machine was doing in the minutes before a
+ * crash - DE1 shot samples, scale weights, state transitions and BLE commands.
+ *
+ * Entries live in a fixed, statically allocated ring (CAPACITY entries, about
+ * four minutes at shot rates). Recording claims a slot with one atomic add and
+ * copies plain values; nothing allocates. CrashHandler calls dumpToFile() from
+ * the signal handler, which writes the raw ring with open()/write() only - no
+ * allocation, no formatting. The dump is decoded on the next start
+ * (lastCrashLines()) and shown on the web debug page alongside the live ring.
+ */
+class FlightRecorder {
+public:
+    static constexpr int CAPACITY = 4096;
+    static constexpr int MAX_PAYLOAD = 20;  // One BLE packet
+
+    enum class Kind : quint8 {
+        Empty = 0,
+        ShotSample,
+        Weight,
+        State,
+        Command
+    };
+
+    // Plain data so the signal handler can write the array as-is
+    struct Entry {
+        quint32 sequence;               // 0 = empty or being written; set last
+        Kind kind;
+        quint8 length;                  // Command payload bytes
+        quint16 tag;                    // Frame number, (state << 8 | substate), or characteristic
+        qint64 timeMs;                  // MonotonicClock
+        float values[8];
+        quint8 payload[MAX_PAYLOAD];
+    };
+
+    /// Set the dump path. Call once at startup, before signals might fire.
+    static void install();
+
+    static void recordShotSample(double timer, double pressure, double flow, double mixTemp,
+                                 double headTemp, double pressureGoal, double flowGoal,
+                                 double tempGoal, int frame);
+    static void recordWeight(double weight, double flowRate);
+    static void recordState(int state, int subState);
+    static void recordCommand(quint32 characteristic, const QByteArray& data);
+
+    /// Async-signal-safe: writes the ring to flight.bin. Called by CrashHandler.
+    static void dumpToFile();
+
+    /// Current ring, oldest first, as text
+    static QStringList liveLines();
+
+    /// Ring saved by the last crash, or empty if there is none
+    static QStringList lastCrashLines();
+    static QString dumpPath();
+
+private:
+    static Entry* claim(Kind kind, quint32* sequence);
+    static void publish(Entry* entry, quint32 sequence);
+    static QStringList format(QList<Entry> entries, qint64 endMs);
+};
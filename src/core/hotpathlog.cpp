@@ -0,0 +1,186 @@
+#include "hotpathlog.h"
+#include "samplering.h"
+
+#include <QDateTime>
+#include <QMutex>
+#include <cstring>
+
+Q_LOGGING_CATEGORY(lcBleWrite, "decenza.ble.write")
+Q_LOGGING_CATEGORY(lcSaw, "decenza.saw")
+Q_LOGGING_CATEGORY(lcShotSample, "decenza.shot.sample", QtInfoMsg)  // 5 Hz - off unless asked for
+
+namespace {
+
+struct CategoryInfo {
+    const QLoggingCategory& (*category)();
+    const char* description;
+    bool defaultEnabled;
+};
+
+const CategoryInfo CATEGORIES[] = {
+    { lcBleWrite, "DE1 BLE writes and write confirmations", true },
+    { lcSaw, "Stop-at-weight settling and checks", true },
+    { lcShotSample, "Every DE1 shot sample", false },
+};
+
+const CategoryInfo* findCategory(const QString& name)
+{
+    for (const CategoryInfo& info : CATEGORIES) {
+        if (name == QLatin1String(info.category().categoryName())) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+// ~180 KB of inline storage; pushing only copies
+QMutex s_mutex;
+SampleRing<HotPathRecord, HotPathLog::CAPACITY> s_ring;
+quint64 s_sequence = 0;
+
+// Filter rules: the runtime levels first, extra rules after them so they win
+QMutex s_rulesMutex;
+QString s_levelRules;
+QString s_extraRules;
+
+void installFilterRules()  // Caller holds s_rulesMutex
+{
+    QLoggingCategory::setFilterRules(s_levelRules + s_extraRules);
+}
+
+}  // namespace
+
+QString HotPathRecord::message() const
+{
+    QString out;
+    if (!format) return out;
+
+    for (const char* p = format; *p; ++p) {
+        if (*p == '%') {
+            if (p[1] == 'b') {
+                for (int i = 0; i < byteCount; ++i) {
+                    out += QString::number(bytes[i], 16).rightJustified(2, QLatin1Char('0'));
+                }
+                if (truncated) out += QStringLiteral("...");
+                ++p;
+                continue;
+            }
+            const bool hex = p[1] == 'x';
+            const char* digit = p + (hex ? 2 : 1);
+            if (*digit >= '1' && *digit <= '0' + MAX_ARGS) {
+                const int index = *digit - '1';
+                if (index < argCount) {
+                    out += hex ? QString::number(static_cast<qint64>(args[index]), 16)
+                               : QString::number(args[index], 'g', 10);
+                }
+                p = digit;
+                continue;
+            }
+        }
+        out += QLatin1Char(*p);
+    }
+    return out;
+}
+
+void HotPathLog::record(const QLoggingCategory& category, const char* format,
+                        std::initializer_list<double> args, const QByteArray& bytes)
+{
+    HotPathRecord entry;
+    entry.timeMs = QDateTime::currentMSecsSinceEpoch();
+    entry.category = category.categoryName();
+    entry.format = format;
+    for (double value : args) {
+        if (entry.argCount == HotPathRecord::MAX_ARGS) break;
+        entry.args[entry.argCount++] = value;
+    }
+    const int byteCount = qMin<int>(bytes.size(), HotPathRecord::MAX_BYTES);
+    if (byteCount > 0) {
+        std::memcpy(entry.bytes, bytes.constData(), byteCount);
+    }
+    entry.byteCount = static_cast<quint8>(byteCount);
+    entry.truncated = bytes.size() > byteCount;
+
+    QMutexLocker lock(&s_mutex);
+    entry.sequence = ++s_sequence;
+    s_ring.push(entry);
+}
+
+// Caller holds s_mutex
+static QList<HotPathRecord> copySince(quint64 afterSequence, quint64* lastSequence)
+{
+    if (lastSequence) *lastSequence = s_sequence;
+
+    QList<HotPathRecord> result;
+    for (std::size_t i = 0; i < s_ring.size(); ++i) {
+        if (s_ring[i].sequence > afterSequence) {
+            result.append(s_ring[i]);
+        }
+    }
+    return result;
+}
+
+QList<HotPathRecord> HotPathLog::since(quint64 afterSequence, quint64* lastSequence)
+{
+    QMutexLocker lock(&s_mutex);
+    return copySince(afterSequence, lastSequence);
+}
+
+QList<HotPathRecord> HotPathLog::between(qint64 fromMs, qint64 toMs)
+{
+    QMutexLocker lock(&s_mutex);
+    QList<HotPathRecord> result;
+    for (std::size_t i = 0; i < s_ring.size(); ++i) {
+        if (s_ring[i].timeMs >= fromMs && s_ring[i].timeMs <= toMs) {
+            result.append(s_ring[i]);
+        }
+    }
+    return result;
+}
+
+void HotPathLog::clear()
+{
+    QMutexLocker lock(&s_mutex);
+    s_ring.clear();  // Sequence keeps counting so pollers don't re-read
+}
+
+QStringList HotPathLog::categoryNames()
+{
+    QStringList names;
+    for (const CategoryInfo& info : CATEGORIES) {
+        names.append(QLatin1String(info.category().categoryName()));
+    }
+    return names;
+}
+
+QString HotPathLog::categoryDescription(const QString& name)
+{
+    const CategoryInfo* info = findCategory(name);
+    return info ? QString::fromLatin1(info->description) : QString();
+}
+
+bool HotPathLog::defaultEnabled(const QString& name)
+{
+    const CategoryInfo* info = findCategory(name);
+    return info && info->defaultEnabled;
+}
+
+void HotPathLog::applyLevels(const QVariantMap& levels)
+{
+    QString rules;
+    for (const CategoryInfo& info : CATEGORIES) {
+        const QString name = QLatin1String(info.category().categoryName());
+        const bool enabled = levels.value(name, info.defaultEnabled).toBool();
+        rules += name + (enabled ? QStringLiteral(".debug=true\n") : QStringLiteral(".debug=false\n"));
+    }
+
+    QMutexLocker lock(&s_rulesMutex);
+    s_levelRules = rules;
+    installFilterRules();
+}
+
+void HotPathLog::setExtraFilterRules(const QString& rules)
+{
+    QMutexLocker lock(&s_rulesMutex);
+    s_extraRules = rules;
+    installFilterRules();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <initializer_list>
+
+// Subsystems that log per write / per sample. Debug level is switchable at
+// runtime (Settings::logCategories, settings Debug tab, web debug page).
+Q_DECLARE_LOGGING_CATEGORY(lcBleWrite)
+Q_DECLARE_LOGGING_CATEGORY(lcSaw)
+Q_DECLARE_LOGGING_CATEGORY(lcShotSample)
+
+/**
+ * One hot-path log entry, stored unformatted: a static format string plus
+ * raw numeric arguments and (optionally) a short byte payload.
+ *
+ * Format placeholders: %1..%4 argument, %x1..%x4 argument as hex,
+ * %b payload as hex.
+ */
+struct HotPathRecord {
+    static constexpr int MAX_ARGS = 4;
+    static constexpr int MAX_BYTES = 20;  // One BLE packet
+
+    quint64 sequence = 0;
+    qint64 timeMs = 0;                    // Wall clock, ms since epoch
+    const char* category = nullptr;       // Category name (static storage)
+    const char* format = nullptr;         // String literal
+    double args[MAX_ARGS] = {};
+    quint8 argCount = 0;
+    quint8 byteCount = 0;
+    bool truncated = false;
+    quint8 bytes[MAX_BYTES] = {};
+
+    QString message() const;
+};
+
+/**
+ * Structured ring buffer for hot-path logging.
+ *
+ * qDebug() on a per-sample path formats a QString (and runs every message
+ * handler) even when nobody reads the log. HOT_LOG() instead checks the
+ * category level and copies the raw arguments into a fixed ring - no
+ * allocation, no formatting. Lines are only built when /api/debug or the
+ * shot debug log reads them, and when the debug.log writer thread drains the
+ * ring on its next flush.
+ */
+class HotPathLog {
+public:
+    static constexpr int CAPACITY = 2048;
+
+    static void record(const QLoggingCategory& category, const char* format,
+                       std::initializer_list<double> args, const QByteArray& bytes = QByteArray());
+
+    // Records with sequence > afterSequence; lastSequence receives the newest sequence
+    static QList<HotPathRecord> since(quint64 afterSequence, quint64* lastSequence = nullptr);
+
+    // Records with fromMs <= timeMs <= toMs
+    static QList<HotPathRecord> between(qint64 fromMs, qint64 toMs);
+
+    static void clear();
+
+    // Runtime levels: category name -> debug enabled. Names not in the map keep their default.
+    // Installed as QLoggingCategory filter rules, so they go through setFilterRules()
+    // like any other rule instead of poking the category objects.
+    static QStringList categoryNames();
+    static QString categoryDescription(const QString& name);
+    static bool defaultEnabled(const QString& name);
+    static void applyLevels(const QVariantMap& levels);
+
+    // Rules installed after the levels (e.g. a CLI's "*.debug=false"). Use this
+    // instead of QLoggingCategory::setFilterRules(), which would drop the levels.
+    static void setExtraFilterRules(const QString& rules);
+};
+
+#define HOT_LOG(category, format, ...) \
+    do { \
+        if (category().isDebugEnabled()) \
+            HotPathLog::record(category(), format, {__VA_ARGS__}); \
+    } while (false)
+
+#define HOT_LOG_BYTES(category, format, bytes, ...) \
+    do { \
+        if (category().isDebugEnabled()) \
+            HotPathLog::record(category(), format, {__VA_ARGS__}, bytes); \
+    } while (false)
@@ -0,0 +1,148 @@
+#include "monotonicclock.h"
+#include <QElapsedTimer>
+#include <QtMath>
+#include <limits>
+
+qint64 MonotonicClock::nowNs() {
+    // Function-local static: started on first use, thread-safe initialization
+    static const QElapsedTimer clock = [] {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+void DeviceClockAligner::setRateCandidates(const QList<double>& unitsPerSecond) {
+    m_rateCandidates = unitsPerSecond.isEmpty() ? QList<double>{1.0} : unitsPerSecond;
+    reset();
+}
+
+void DeviceClockAligner::reset() {
+    m_wrapBase = 0.0;
+    m_lastRawDevice = -1.0;
+    m_rate = m_rateCandidates.first();
+    m_rateKnown = m_rateCandidates.size() == 1;
+    m_rateStart = {-1.0, 0.0};
+    restartFit();
+}
+
+void DeviceClockAligner::restartFit() {
+    m_window.clear();
+    m_envelope.clear();
+    m_blockOpen = false;
+    m_offset = 0.0;
+    m_drift = 0.0;
+}
+
+double DeviceClockAligner::unwrap(double deviceTime) const {
+    if (m_wrapPeriod > 0 && m_lastRawDevice >= 0 && deviceTime < m_lastRawDevice - m_wrapPeriod / 2) {
+        return (deviceTime + m_wrapBase + m_wrapPeriod) / m_rate;
+    }
+    return (deviceTime + m_wrapBase) / m_rate;
+}
+
+void DeviceClockAligner::measureRate(double unwrappedUnits, double hostTime) {
+    if (m_rateStart.device < 0) {
+        m_rateStart = {unwrappedUnits, hostTime};
+        return;
+    }
+    const double span = hostTime - m_rateStart.host;
+    if (span < RATE_SPAN) return;
+
+    // BLE delay at either end moves this by a few percent; candidates are further apart
+    const double measured = (unwrappedUnits - m_rateStart.device) / span;
+    double best = m_rateCandidates.first();
+    for (double candidate : m_rateCandidates) {
+        if (qAbs(candidate - measured) < qAbs(best - measured)) best = candidate;
+    }
+    m_rateKnown = true;
+    if (best != m_rate) {
+        m_rate = best;
+        restartFit();  // Observations so far were scaled by the wrong rate
+    }
+}
+
+double DeviceClockAligner::addObservation(double deviceTime, double hostTime) {
+    if (m_lastRawDevice >= 0 && deviceTime < m_lastRawDevice) {
+        if (m_wrapPeriod > 0 && deviceTime < m_lastRawDevice - m_wrapPeriod / 2) {
+            m_wrapBase += m_wrapPeriod;
+        } else {
+            // Device clock restarted - previous observations no longer apply
+            const bool rateKnown = m_rateKnown;
+            const double rate = m_rate;
+            reset();
+            m_rateKnown = rateKnown;  // Same device, same rate
+            m_rate = rate;
+        }
+    }
+    m_lastRawDevice = deviceTime;
+
+    if (!m_rateKnown) {
+        measureRate(deviceTime + m_wrapBase, hostTime);
+    }
+
+    double unwrapped = (deviceTime + m_wrapBase) / m_rate;
+    const Observation observation{unwrapped, hostTime};
+    m_window.push(observation);
+
+    if (!m_blockOpen) {
+        m_blockMin = observation;
+        m_blockOpen = true;
+    } else if (unwrapped - m_blockMin.device >= ENVELOPE_BLOCK) {
+        m_envelope.push(m_blockMin);
+        m_blockMin = observation;
+        refitDrift();
+    } else if (hostTime - unwrapped < m_blockMin.host - m_blockMin.device) {
+        m_blockMin = observation;
+    }
+
+    refit();
+    return unwrapped;
+}
+
+void DeviceClockAligner::refitDrift() {
+    // Least-squares slope of (host - device) against device time, over the envelope
+    const std::size_t n = m_envelope.size();
+    if (n < 3 || m_envelope.back().device - m_envelope.front().device < MIN_DRIFT_SPAN) return;
+
+    double meanX = 0, meanY = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        meanX += m_envelope[i].device;
+        meanY += m_envelope[i].host - m_envelope[i].device;
+    }
+    meanX /= n;
+    meanY /= n;
+
+    double sxx = 0, sxy = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        double dx = m_envelope[i].device - meanX;
+        sxx += dx * dx;
+        sxy += dx * (m_envelope[i].host - m_envelope[i].device - meanY);
+    }
+    if (sxx > 0) {
+        // Crystal drift is ppm-scale; anything beyond 1% is a stall, not drift
+        m_drift = qBound(-0.01, sxy / sxx, 0.01);
+    }
+}
+
+void DeviceClockAligner::refit() {
+    const std::size_t n = m_window.size();
+    if (n == 0) return;
+
+    // Offset: lower envelope - the packet that arrived fastest defines the mapping
+    double minResidual = std::numeric_limits<double>::max();
+    for (std::size_t i = 0; i < n; ++i) {
+        double residual = m_window[i].host - m_window[i].device * (1.0 + m_drift);
+        minResidual = qMin(minResidual, residual);
+    }
+    m_offset = minResidual;
+}
+
+double DeviceClockAligner::toHostTime(double unwrappedDeviceTime) const {
+    return m_offset + unwrappedDeviceTime * (1.0 + m_drift);
+}
+
+double DeviceClockAligner::toDeviceTime(double hostTime) const {
+    return (hostTime - m_offset) / (1.0 + m_drift);
+}
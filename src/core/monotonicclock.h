@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QList>
+#include "samplering.h"
+
+/**
+ * MonotonicClock is the app-wide time base for hot paths (shot samples, scale
+ * weights, shot timing). It is a steady clock started at first use, so NTP
+ * corrections or the user changing the wall clock mid-shot cannot make time
+ * jump. Use QDateTime only for values that are persisted or shown as dates.
+ */
+class MonotonicClock {
+public:
+    static qint64 nowNs();
+    static qint64 nowMs() { return nowNs() / 1000000; }
+    static double nowSec() { return nowNs() / 1e9; }
+};
+
+/**
+ * DeviceClockAligner maps a device clock (e.g. the DE1's sample.timer) onto
+ * MonotonicClock time and back.
+ *
+ * Each observation pairs a device timestamp with the host time the packet
+ * arrived. BLE delivery only ever adds delay, so the mapping follows the lower
+ * envelope of (host - device): the offset is the smallest residual over a
+ * recent window, and drift is a least-squares slope over the fastest packet of
+ * each ENVELOPE_BLOCK seconds, once those span at least MIN_DRIFT_SPAN. (Over
+ * the short window, jitter swamps ppm-scale drift, so the aligner has to live
+ * for minutes - across shots - before drift is estimated.) Counter wrap-around
+ * is unwrapped when a wrap period is given, in device units.
+ *
+ * A device whose tick rate isn't known up front can be given candidate rates:
+ * the DE1 timer counts mains half-cycles, 100/s on 50 Hz and 120/s on 60 Hz.
+ * The rate is measured over RATE_SPAN seconds of host time and snapped to the
+ * nearest candidate; until then the first is assumed, and a different choice
+ * restarts the fit. Device times in and out of the mapping are then seconds.
+ */
+class DeviceClockAligner {
+public:
+    explicit DeviceClockAligner(double wrapPeriod = 0.0) : m_wrapPeriod(wrapPeriod) {}
+
+    // Device units per second to choose from (default: units are seconds)
+    void setRateCandidates(const QList<double>& unitsPerSecond);
+    double rate() const { return m_rate; }
+    bool isRateKnown() const { return m_rateKnown; }
+
+    // Forget all observations, including the measured rate
+    void reset();
+
+    // deviceTime in device units; returns the unwrapped device time in seconds
+    double addObservation(double deviceTime, double hostTime);
+
+    bool isValid() const { return !m_window.isEmpty(); }
+    double offset() const { return m_offset; }  // host - device at device time 0 (s)
+    double drift() const { return m_drift; }    // Host seconds gained per device second
+
+    // Unwrap a raw device reading relative to the latest observation, in seconds
+    double unwrap(double deviceTime) const;
+
+    double toHostTime(double unwrappedDeviceTime) const;
+    double toDeviceTime(double hostTime) const;
+
+private:
+    struct Observation { double device; double host; };
+
+    void measureRate(double unwrappedUnits, double hostTime);
+    void restartFit();
+    void refit();
+    void refitDrift();
+
+    static constexpr double ENVELOPE_BLOCK = 10.0;   // Seconds of device time per envelope point
+    static constexpr double MIN_DRIFT_SPAN = 60.0;   // Envelope span before drift is estimated
+    static constexpr double RATE_SPAN = 5.0;         // Host seconds measured before choosing a rate
+
+    // ~12 seconds of DE1 samples at 5 Hz
+    SampleRing<Observation, 64> m_window;
+    // Fastest observation per block, ~10 minutes
+    SampleRing<Observation, 64> m_envelope;
+    Observation m_blockMin{0.0, 0.0};
+    bool m_blockOpen = false;
+    double m_wrapPeriod = 0.0;
+    double m_wrapBase = 0.0;          // Accumulated wrap periods
+    double m_lastRawDevice = -1.0;
+    QList<double> m_rateCandidates{1.0};
+    double m_rate = 1.0;              // Device units per second
+    bool m_rateKnown = true;
+    Observation m_rateStart{-1.0, 0.0};  // First observation of the rate measurement, in units
+    double m_offset = 0.0;
+    double m_drift = 0.0;
+};
@@ -4,6 +4,7 @@
 #include <QFile>
 #include <QDebug>
 #include <QSettings>
+#include <QSet>
 
 #ifdef Q_OS_ANDROID
 #include <QJniObject>
@@ -124,24 +125,40 @@ QString ProfileStorage::downloadedProfilesPath() const {
 
 QStringList ProfileStorage::listProfiles() const {
     QStringList profiles;
+    const auto files = listProfileFiles();
+    profiles.reserve(files.size());
+    for (const auto& file : files) {
+        profiles.append(file.first);
+    }
+    return profiles;
+}
+
+QList<QPair<QString, QString>> ProfileStorage::listProfileFiles() const {
+    QList<QPair<QString, QString>> profiles;
+    QSet<QString> seen;
     QStringList filters;
     filters << "*.json";
 
+    auto addFrom = [&](const QDir& dir) {
+        const QStringList files = dir.entryList(filters, QDir::Files);
+        for (const QString& file : files) {
+            if (!file.startsWith("_")) {
+                QString name = file.left(file.length() - 5);
+                if (!seen.contains(name)) {
+                    seen.insert(name);
+                    profiles.append({name, dir.filePath(file)});
+                }
+            }
+        }
+    };
+
     // Check external storage (Documents/Decenza) if configured
     if (isConfigured()) {
         QString extPath = externalProfilesPath();
         if (!extPath.isEmpty()) {
             QDir extDir(extPath);
             if (extDir.exists()) {
-                QStringList files = extDir.entryList(filters, QDir::Files);
-                for (const QString& file : files) {
-                    if (!file.startsWith("_")) {
-                        QString name = file.left(file.length() - 5);
-                        if (!profiles.contains(name)) {
-                            profiles.append(name);
-                        }
-                    }
-                }
+                addFrom(extDir);
             }
         }
     }
@@ -149,15 +166,7 @@ QStringList ProfileStorage::listProfiles() const {
     // Also check fallback path
     QDir fallbackDir(fallbackPath());
     if (fallbackDir.exists()) {
-        QStringList files = fallbackDir.entryList(filters, QDir::Files);
-        for (const QString& file : files) {
-            if (!file.startsWith("_")) {
-                QString name = file.left(file.length() - 5);
-                if (!profiles.contains(name)) {
-                    profiles.append(name);
-                }
-            }
-        }
+        addFrom(fallbackDir);
     }
 
     return profiles;
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QString>
 #include <QStringList>
+#include <QPair>
 
 // ProfileStorage handles profile persistence with external storage on Android
 // (Documents/Decenza folder) to ensure profiles survive app reinstalls.
@@ -34,6 +35,9 @@ public:
     // List all profile filenames (without .json extension)
     QStringList listProfiles() const;
 
+    // Same profiles as (filename, path of the file readProfile() would read)
+    QList<QPair<QString, QString>> listProfileFiles() const;
+
     // Read profile JSON content
     QString readProfile(const QString& filename) const;
 
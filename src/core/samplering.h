@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+/**
+ * Fixed-capacity ring buffer for per-sample history on hot paths.
+ *
+ * Storage is inline, so pushing never allocates. When full, the oldest
+ * entry is overwritten. Index 0 is the oldest entry, size()-1 the newest.
+ */
+template <typename T, std::size_t N>
+class SampleRing {
+public:
+    void push(const T& value) {
+        m_data[(m_start + m_size) % N] = value;
+        if (m_size < N) {
+            ++m_size;
+        } else {
+            m_start = (m_start + 1) % N;
+        }
+    }
+
+    // Removes the oldest entry; the slot is reset so it releases anything it owns
+    void popFront() {
+        m_data[m_start] = T{};
+        m_start = (m_start + 1) % N;
+        --m_size;
+    }
+
+    void clear() { m_start = 0; m_size = 0; }
+
+    const T& operator[](std::size_t i) const { return m_data[(m_start + i) % N]; }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[m_size - 1]; }
+
+    std::size_t size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    bool isFull() const { return m_size == N; }
+    static constexpr std::size_t capacity() { return N; }
+
+private:
+    std::array<T, N> m_data{};
+    std::size_t m_start = 0;
+    std::size_t m_size = 0;
+};
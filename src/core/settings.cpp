@@ -1,4 +1,5 @@
 #include "settings.h"
+#include "hotpathlog.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QJsonDocument>
@@ -122,6 +123,9 @@ Settings::Settings(QObject* parent)
     if (m_hasBrewYieldOverride) {
         m_brewYieldOverride = m_settings.value("brew/brewYieldOverride", 0.0).toDouble();
     }
+
+    // Restore hot-path log levels
+    HotPathLog::applyLevels(logCategories());
 }
 
 // Machine settings
@@ -169,6 +173,17 @@ void Settings::setScaleName(const QString& name) {
     }
 }
 
+QString Settings::scaleFlowEstimator() const {
+    return m_settings.value("scale/flowEstimator", "moving_average").toString();
+}
+
+void Settings::setScaleFlowEstimator(const QString& estimator) {
+    if (scaleFlowEstimator() != estimator) {
+        m_settings.setValue("scale/flowEstimator", estimator);
+        emit scaleFlowEstimatorChanged();
+    }
+}
+
 // Flow sensor calibration
 double Settings::flowCalibrationFactor() const {
     return m_settings.value("flow/calibrationFactor", 1.29).toDouble();
@@ -1961,6 +1976,30 @@ void Settings::setDeveloperTranslationUpload(bool enabled) {
     }
 }
 
+QVariantMap Settings::logCategories() const {
+    // Every known category with its effective level, so UIs can list them
+    QVariantMap stored = m_settings.value("developer/logCategories").toMap();
+    QVariantMap levels;
+    for (const QString& name : HotPathLog::categoryNames()) {
+        levels[name] = stored.value(name, HotPathLog::defaultEnabled(name)).toBool();
+    }
+    return levels;
+}
+
+void Settings::setLogCategories(const QVariantMap& levels) {
+    QVariantMap merged = logCategories();
+    for (auto it = levels.constBegin(); it != levels.constEnd(); ++it) {
+        if (merged.contains(it.key())) {
+            merged[it.key()] = it.value().toBool();
+        }
+    }
+    if (merged != logCategories()) {
+        m_settings.setValue("developer/logCategories", merged);
+        HotPathLog::applyLevels(merged);
+        emit logCategoriesChanged();
+    }
+}
+
 // Temperature override (persistent)
 double Settings::temperatureOverride() const {
     return m_temperatureOverride;
@@ -2273,6 +2312,39 @@ void Settings::setMqttClientId(const QString& clientId) {
     }
 }
 
+bool Settings::mqttJsonState() const {
+    return m_settings.value("mqtt/jsonState", false).toBool();
+}
+
+void Settings::setMqttJsonState(bool enabled) {
+    if (mqttJsonState() != enabled) {
+        m_settings.setValue("mqtt/jsonState", enabled);
+        emit mqttJsonStateChanged();
+    }
+}
+
+bool Settings::mqttShotStream() const {
+    return m_settings.value("mqtt/shotStream", false).toBool();
+}
+
+void Settings::setMqttShotStream(bool enabled) {
+    if (mqttShotStream() != enabled) {
+        m_settings.setValue("mqtt/shotStream", enabled);
+        emit mqttShotStreamChanged();
+    }
+}
+
+bool Settings::mqttPersistQueue() const {
+    return m_settings.value("mqtt/persistQueue", true).toBool();
+}
+
+void Settings::setMqttPersistQueue(bool enabled) {
+    if (mqttPersistQueue() != enabled) {
+        m_settings.setValue("mqtt/persistQueue", enabled);
+        emit mqttPersistQueueChanged();
+    }
+}
+
 // SAW (Stop-at-Weight) learning
 
 // Returns average lag for display in QML settings (calculated from stored drip/flow)
@@ -2310,90 +2382,35 @@ double Settings::sawLearnedLag() const {
     return count > 0 ? sumLag / count : 1.5;
 }
 
-double Settings::getExpectedDrip(double currentFlowRate) const {
-    QByteArray data = m_settings.value("saw/learningHistory").toByteArray();
-    if (data.isEmpty()) {
-        // Default: assume 1.5s lag worth of drip
-        return currentFlowRate * 1.5;
-    }
-
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    QJsonArray arr = doc.array();
-
-    // Filter to current scale type and collect recent entries
-    QString currentScale = scaleType();
-    struct Entry { double drip; double flow; };
-    QVector<Entry> entries;
-
-    for (int i = arr.size() - 1; i >= 0 && entries.size() < 10; --i) {
-        QJsonObject obj = arr[i].toObject();
-        if (obj["scale"].toString() == currentScale) {
-            // Support both old format (lag) and new format (drip, flow)
-            if (obj.contains("drip")) {
-                entries.append({obj["drip"].toDouble(), obj["flow"].toDouble()});
-            } else if (obj.contains("lag")) {
-                // Convert old lag format: drip = lag * flow (approximate)
-                double lag = obj["lag"].toDouble();
-                double flow = 4.0;  // Assume average flow for old entries
-                entries.append({lag * flow, flow});
-            }
-        }
-    }
-
-    if (entries.isEmpty()) {
-        return currentFlowRate * 1.5;  // Default for this scale type
-    }
-
-    // Weighted average: weight by recency AND flow similarity
-    // Recency: most recent = weight 10, oldest = weight 1
-    // Flow similarity: closer flow = higher weight (gaussian-ish)
-    double weightedDripSum = 0;
-    double totalWeight = 0;
-
-    for (int i = 0; i < entries.size(); ++i) {
-        const Entry& e = entries[i];
-
-        // Recency weight: newer entries have more weight
-        double recencyWeight = 10.0 - i;  // 10, 9, 8, 7, ...
-
-        // Flow similarity weight: gaussian with sigma=2 ml/s
-        double flowDiff = qAbs(e.flow - currentFlowRate);
-        double flowWeight = qExp(-(flowDiff * flowDiff) / 8.0);  // sigma^2 * 2 = 8
-
-        double weight = recencyWeight * flowWeight;
-        weightedDripSum += e.drip * weight;
-        totalWeight += weight;
-    }
-
-    if (totalWeight < 0.01) {
-        // All entries have very different flow rates - fall back to default
-        return currentFlowRate * 1.5;
-    }
-
-    double expectedDrip = weightedDripSum / totalWeight;
-
-    // Clamp to reasonable range (0.5 to 15 grams)
-    if (expectedDrip < 0.5) expectedDrip = 0.5;
-    if (expectedDrip > 15.0) expectedDrip = 15.0;
-
-    return expectedDrip;
+QJsonArray Settings::sawLearningHistory() const {
+    QJsonDocument doc = QJsonDocument::fromJson(m_settings.value("saw/learningHistory").toByteArray());
+    return doc.isArray() ? doc.array() : QJsonArray();
 }
 
-void Settings::addSawLearningPoint(double drip, double flowRate, const QString& scaleType) {
-    QByteArray data = m_settings.value("saw/learningHistory").toByteArray();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    QJsonArray arr = doc.isArray() ? doc.array() : QJsonArray();
+void Settings::addSawLearningPoint(double drip, double flowRate, const QString& scaleType,
+                                   const QString& profile, double scaleLatency, double stopLatency) {
+    QJsonArray arr = sawLearningHistory();
 
     // Create new entry with drip and flow (not pre-calculated lag)
     QJsonObject entry;
     entry["drip"] = drip;      // grams that came after stop command
     entry["flow"] = flowRate;  // flow rate when stop was triggered
     entry["scale"] = scaleType;
+    if (!profile.isEmpty()) {
+        entry["profile"] = profile;
+    }
+    // Measured latencies (seconds) - omitted when not measurable this shot
+    if (scaleLatency >= 0) {
+        entry["latency"] = scaleLatency;  // scale flow lag behind DE1 flow
+    }
+    if (stopLatency >= 0) {
+        entry["rtt"] = stopLatency;       // stop command -> DE1 state change
+    }
     entry["ts"] = QDateTime::currentSecsSinceEpoch();
     arr.append(entry);
 
-    // Trim to max 20 entries
-    while (arr.size() > 20) {
+    // Trim to max 50 entries (per-profile learning needs a little more history)
+    while (arr.size() > 50) {
         arr.removeFirst();
     }
 
@@ -18,6 +18,7 @@ class Settings : public QObject {
     Q_PROPERTY(QString scaleAddress READ scaleAddress WRITE setScaleAddress NOTIFY scaleAddressChanged)
     Q_PROPERTY(QString scaleType READ scaleType WRITE setScaleType NOTIFY scaleTypeChanged)
     Q_PROPERTY(QString scaleName READ scaleName WRITE setScaleName NOTIFY scaleNameChanged)
+    Q_PROPERTY(QString scaleFlowEstimator READ scaleFlowEstimator WRITE setScaleFlowEstimator NOTIFY scaleFlowEstimatorChanged)
 
     // Flow sensor calibration
     Q_PROPERTY(double flowCalibrationFactor READ flowCalibrationFactor WRITE setFlowCalibrationFactor NOTIFY flowCalibrationFactorChanged)
@@ -137,6 +138,7 @@ class Settings : public QObject {
 
     // Developer settings
     Q_PROPERTY(bool developerTranslationUpload READ developerTranslationUpload WRITE setDeveloperTranslationUpload NOTIFY developerTranslationUploadChanged)
+    Q_PROPERTY(QVariantMap logCategories READ logCategories WRITE setLogCategories NOTIFY logCategoriesChanged)
 
     // Temperature override (persistent)
     Q_PROPERTY(double temperatureOverride READ temperatureOverride WRITE setTemperatureOverride NOTIFY temperatureOverrideChanged)
@@ -170,6 +172,9 @@ class Settings : public QObject {
     Q_PROPERTY(bool mqttRetainMessages READ mqttRetainMessages WRITE setMqttRetainMessages NOTIFY mqttRetainMessagesChanged)
     Q_PROPERTY(bool mqttHomeAssistantDiscovery READ mqttHomeAssistantDiscovery WRITE setMqttHomeAssistantDiscovery NOTIFY mqttHomeAssistantDiscoveryChanged)
     Q_PROPERTY(QString mqttClientId READ mqttClientId WRITE setMqttClientId NOTIFY mqttClientIdChanged)
+    Q_PROPERTY(bool mqttJsonState READ mqttJsonState WRITE setMqttJsonState NOTIFY mqttJsonStateChanged)
+    Q_PROPERTY(bool mqttShotStream READ mqttShotStream WRITE setMqttShotStream NOTIFY mqttShotStreamChanged)
+    Q_PROPERTY(bool mqttPersistQueue READ mqttPersistQueue WRITE setMqttPersistQueue NOTIFY mqttPersistQueueChanged)
 
 public:
     explicit Settings(QObject* parent = nullptr);
@@ -196,6 +201,10 @@ public:
     QString scaleName() const;
     void setScaleName(const QString& name);
 
+    // Scale flow rate estimator: "moving_average", "savitzky_golay", "kalman"
+    QString scaleFlowEstimator() const;
+    void setScaleFlowEstimator(const QString& estimator);
+
     // Flow sensor calibration
     double flowCalibrationFactor() const;
     void setFlowCalibrationFactor(double factor);
@@ -477,6 +486,10 @@ public:
     bool developerTranslationUpload() const;
     void setDeveloperTranslationUpload(bool enabled);
 
+    // Hot-path log categories: name -> debug level enabled (persistent)
+    QVariantMap logCategories() const;
+    void setLogCategories(const QVariantMap& levels);
+
     // Temperature override (persistent)
     double temperatureOverride() const;
     void setTemperatureOverride(double temp);
@@ -528,11 +541,19 @@ public:
     void setMqttHomeAssistantDiscovery(bool enabled);
     QString mqttClientId() const;
     void setMqttClientId(const QString& clientId);
+    bool mqttJsonState() const;
+    void setMqttJsonState(bool enabled);
+    bool mqttShotStream() const;
+    void setMqttShotStream(bool enabled);
+    bool mqttPersistQueue() const;
+    void setMqttPersistQueue(bool enabled);
 
     // SAW (Stop-at-Weight) learning
     double sawLearnedLag() const;  // Average lag for display in QML (calculated from drip/flow)
-    double getExpectedDrip(double currentFlowRate) const;  // Predicts drip based on flow and history
-    void addSawLearningPoint(double drip, double flowRate, const QString& scaleType);
+    QJsonArray sawLearningHistory() const;  // Raw entries for SawPredictor (oldest first)
+    void addSawLearningPoint(double drip, double flowRate, const QString& scaleType,
+                             const QString& profile = QString(),
+                             double scaleLatency = -1, double stopLatency = -1);
     Q_INVOKABLE void resetSawLearning();
 
     // Generic settings access (for extensibility)
@@ -544,6 +565,7 @@ signals:
     void scaleAddressChanged();
     void scaleTypeChanged();
     void scaleNameChanged();
+    void scaleFlowEstimatorChanged();
     void flowCalibrationFactorChanged();
     void espressoTemperatureChanged();
     void targetWeightChanged();
@@ -615,6 +637,7 @@ signals:
     void autoCheckUpdatesChanged();
     void waterLevelDisplayUnitChanged();
     void developerTranslationUploadChanged();
+    void logCategoriesChanged();
     void temperatureOverrideChanged();
     void brewOverridesChanged();
     void showShotPlanChanged();
@@ -633,6 +656,9 @@ signals:
     void mqttRetainMessagesChanged();
     void mqttHomeAssistantDiscoveryChanged();
     void mqttClientIdChanged();
+    void mqttJsonStateChanged();
+    void mqttShotStreamChanged();
+    void mqttPersistQueueChanged();
     void sawLearnedLagChanged();
     void valueChanged(const QString& key);
 
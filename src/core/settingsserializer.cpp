@@ -28,6 +28,7 @@ QJsonObject SettingsSerializer::exportToJson(Settings* settings, bool includeSen
     scale["address"] = settings->scaleAddress();
     scale["type"] = settings->scaleType();
     scale["name"] = settings->scaleName();
+    scale["flowEstimator"] = settings->scaleFlowEstimator();
     root["scale"] = scale;
 
     // Calibration
@@ -260,6 +261,7 @@ bool SettingsSerializer::importFromJson(Settings* settings, const QJsonObject& j
         if (scale.contains("address")) settings->setScaleAddress(scale["address"].toString());
         if (scale.contains("type")) settings->setScaleType(scale["type"].toString());
         if (scale.contains("name")) settings->setScaleName(scale["name"].toString());
+        if (scale.contains("flowEstimator")) settings->setScaleFlowEstimator(scale["flowEstimator"].toString());
     }
 
     // Calibration
@@ -0,0 +1,96 @@
+#include "tcltokenizer.h"
+
+bool TclTokenizer::next(QStringView* word)
+{
+    const qsizetype length = m_source.size();
+    while (m_pos < length && m_source[m_pos].isSpace()) {
+        ++m_pos;
+    }
+    if (m_pos >= length) {
+        return false;
+    }
+
+    const QChar first = m_source[m_pos];
+    if (first == u'{' || first == u'"') {
+        const bool braced = first == u'{';
+        const qsizetype start = ++m_pos;
+        int depth = 1;
+        while (m_pos < length) {
+            const QChar c = m_source[m_pos];
+            if (c == u'\\') {
+                m_pos += 2;  // Escaped character never opens, closes or ends the word
+                continue;
+            }
+            if (braced && c == u'{') {
+                ++depth;
+            } else if (braced ? c == u'}' : c == u'"') {
+                if (--depth == 0) break;
+            }
+            ++m_pos;
+        }
+
+        if (m_pos >= length) {
+            // Unclosed: take the rest of the source
+            m_error = true;
+            m_pos = length;
+            *word = m_source.sliced(start);
+            return true;
+        }
+
+        *word = m_source.sliced(start, m_pos - start);
+        ++m_pos;  // Closing brace or quote
+        return true;
+    }
+
+    const qsizetype start = m_pos;
+    while (m_pos < length && !m_source[m_pos].isSpace()) {
+        ++m_pos;
+    }
+    *word = m_source.sliced(start, m_pos - start);
+    return true;
+}
+
+QList<QStringView> TclTokenizer::words(QStringView list)
+{
+    QList<QStringView> result;
+    TclTokenizer tokenizer(list);
+    QStringView word;
+    while (tokenizer.next(&word)) {
+        result.append(word);
+    }
+    return result;
+}
+
+QHash<QStringView, QStringView> TclTokenizer::dict(QStringView list, bool* error)
+{
+    QHash<QStringView, QStringView> result;
+    TclTokenizer tokenizer(list);
+    QStringView key;
+    QStringView value;
+    while (tokenizer.next(&key)) {
+        if (!tokenizer.next(&value)) {
+            tokenizer.m_error = true;  // Key without a value
+            break;
+        }
+        result.insert(key, value);
+    }
+    if (error) {
+        *error = tokenizer.hasError();
+    }
+    return result;
+}
+
+QStringView TclTokenizer::unwrap(QStringView list)
+{
+    QStringView trimmed = list.trimmed();
+    if (!trimmed.startsWith(u'{')) {
+        return trimmed;
+    }
+
+    TclTokenizer tokenizer(trimmed);
+    QStringView word;
+    if (tokenizer.next(&word) && !tokenizer.hasError() && tokenizer.m_pos == trimmed.size()) {
+        return word;
+    }
+    return trimmed;
+}
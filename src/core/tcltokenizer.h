@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QStringView>
+
+/**
+ * Single-pass tokenizer for the Tcl list syntax of de1app profiles (.tcl)
+ * and shot files (.shot).
+ *
+ * Splits a list into words: {braced} (nested, with backslash-escaped braces),
+ * "quoted" and bare words. Words are views into the source with the braces or
+ * quotes removed and no substitution applied, so tokenizing allocates nothing;
+ * callers convert only the values they keep. An unclosed brace or quote ends
+ * the word at the end of the source and sets hasError() - the tokenizer never
+ * reads past the source.
+ */
+class TclTokenizer
+{
+public:
+    explicit TclTokenizer(QStringView source) : m_source(source) {}
+
+    /// Next word of the list; false when the list is exhausted
+    bool next(QStringView* word);
+
+    bool hasError() const { return m_error; }
+
+    /// All words of a list
+    static QList<QStringView> words(QStringView list);
+
+    /// Key/value pairs of a Tcl dict (later duplicates win, as with "array set")
+    static QHash<QStringView, QStringView> dict(QStringView list, bool* error = nullptr);
+
+    /// "{a b}" -> "a b" when the whole input is one braced word, else the trimmed input
+    static QStringView unwrap(QStringView list);
+
+private:
+    QStringView m_source;
+    qsizetype m_pos = 0;
+    bool m_error = false;
+};
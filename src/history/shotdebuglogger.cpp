@@ -1,7 +1,9 @@
 #include "shotdebuglogger.h"
+#include "../core/hotpathlog.h"
 
 #include <QDebug>
 #include <QDateTime>
+#include <cstdio>
 
 // Static members
 ShotDebugLogger* ShotDebugLogger::s_instance = nullptr;
@@ -25,6 +27,10 @@ ShotDebugLogger::ShotDebugLogger(QObject* parent)
     : QObject(parent)
 {
     s_instance = this;
+
+    // Allocated once, reused by every shot
+    m_arena.reserve(ARENA_RESERVE);
+    m_lines.reserve(LINES_RESERVE);
 }
 
 ShotDebugLogger::~ShotDebugLogger()
@@ -36,30 +42,40 @@ ShotDebugLogger::~ShotDebugLogger()
     s_instance = nullptr;
 }
 
+void ShotDebugLogger::resetArena()
+{
+    // Shrinking keeps the allocation (a plain clear() would free it)
+    m_arena.truncate(0);
+    m_lines.resize(0);
+    m_compressed.clear();
+}
+
 void ShotDebugLogger::startCapture()
 {
     QMutexLocker locker(&m_mutex);
 
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const QString started = QDateTime::currentDateTime().toString(Qt::ISODate);
+
     // If already capturing, reset for new shot (don't install handler again)
     if (m_capturing) {
-        m_logLines.clear();
+        resetArena();
         m_timer.start();
-        m_logLines << QString("[%1] START Shot capture restarted - %2")
-                          .arg(formatTime())
-                          .arg(QDateTime::currentDateTime().toString(Qt::ISODate));
+        m_captureStartMs = now;
+        appendLine(now, "START", QString("Shot capture restarted - %1").arg(started));
         return;
     }
 
-    m_logLines.clear();
+    resetArena();
     m_timer.start();
     m_capturing = true;
+    m_captureStartMs = now;
+    m_captureStopMs = 0;
 
     // Install our message handler
     s_previousHandler = qInstallMessageHandler(shotDebugMessageHandler);
 
-    m_logLines << QString("[%1] START Shot capture started - %2")
-                      .arg(formatTime())
-                      .arg(QDateTime::currentDateTime().toString(Qt::ISODate));
+    appendLine(now, "START", QString("Shot capture started - %1").arg(started));
 }
 
 void ShotDebugLogger::stopCapture()
@@ -67,8 +83,9 @@ void ShotDebugLogger::stopCapture()
     QMutexLocker locker(&m_mutex);
 
     if (m_capturing) {
-        m_logLines << QString("[%1] STOP Shot capture stopped")
-                          .arg(formatTime());
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        appendLine(now, "STOP", u"Shot capture stopped");
+        m_captureStopMs = now;
         m_capturing = false;
 
         // Restore previous message handler
@@ -76,24 +93,77 @@ void ShotDebugLogger::stopCapture()
             qInstallMessageHandler(s_previousHandler);
             s_previousHandler = nullptr;
         }
+
+        // Final log is stored compressed; the arena is free for the next shot
+        m_compressed = qCompress(mergedLog());
+        m_arena.truncate(0);
+        m_lines.resize(0);
     }
 }
 
+QByteArray ShotDebugLogger::compressedLog() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_compressed;
+}
+
 QString ShotDebugLogger::getCapturedLog() const
 {
     QMutexLocker locker(&m_mutex);
-    return m_logLines.join("\n");
+    QByteArray log = m_capturing || m_compressed.isEmpty() ? mergedLog() : qUncompress(m_compressed);
+    if (log.endsWith('\n')) {
+        log.chop(1);
+    }
+    return QString::fromUtf8(log);
 }
 
 void ShotDebugLogger::clear()
 {
     QMutexLocker locker(&m_mutex);
-    m_logLines.clear();
+    resetArena();
+    m_captureStartMs = 0;
+}
+
+QByteArray ShotDebugLogger::mergedLog() const
+{
+    if (m_captureStartMs == 0) {
+        return m_arena;
+    }
+
+    const qint64 stopMs = m_captureStopMs > 0 ? m_captureStopMs : QDateTime::currentMSecsSinceEpoch();
+    const QList<HotPathRecord> records = HotPathLog::between(m_captureStartMs, stopMs);
+    if (records.isEmpty()) {
+        return m_arena;
+    }
+
+    auto appendRecord = [](QByteArray& out, const HotPathRecord& record) {
+        appendTime(out, record.timeMs);
+        out += "DEBUG ";
+        out += record.message().toUtf8();
+        out += '\n';
+    };
+
+    // Both are in time order: merge
+    QByteArray merged;
+    merged.reserve(m_arena.size() + records.size() * 80);
+    qsizetype r = 0;
+    qsizetype start = 0;
+    for (const LineMark& line : m_lines) {
+        while (r < records.size() && records[r].timeMs < line.timeMs) {
+            appendRecord(merged, records[r++]);
+        }
+        merged.append(m_arena.constData() + start, line.end - start);
+        start = line.end;
+    }
+    while (r < records.size()) {
+        appendRecord(merged, records[r++]);
+    }
+    return merged;
 }
 
 void ShotDebugLogger::handleMessage(QtMsgType type, const QString& message)
 {
-    QString category;
+    const char* category = "DEBUG";
     switch (type) {
     case QtDebugMsg:
         category = "DEBUG";
@@ -112,23 +182,39 @@ void ShotDebugLogger::handleMessage(QtMsgType type, const QString& message)
         break;
     }
 
-    appendLog(category, message);
+    QMutexLocker locker(&m_mutex);
+    if (!m_capturing) return;
+    appendLine(QDateTime::currentMSecsSinceEpoch(), category, message);
 }
 
 void ShotDebugLogger::logInfo(const QString& message)
-{
-    appendLog("INFO", message);
-}
-
-void ShotDebugLogger::appendLog(const QString& category, const QString& message)
 {
     QMutexLocker locker(&m_mutex);
     if (!m_capturing) return;
+    appendLine(QDateTime::currentMSecsSinceEpoch(), "INFO", message);
+}
 
-    m_logLines << QString("[%1] %2 %3").arg(formatTime(), category, message);
+void ShotDebugLogger::appendLine(qint64 timeMs, const char* category, QStringView message)
+{
+    // "[hh:mm:ss.zzz] CATEGORY message\n", encoded in place - no temporary QString/QByteArray
+    appendTime(m_arena, timeMs);
+    m_arena += category;
+    m_arena += ' ';
+
+    const qsizetype offset = m_arena.size();
+    m_arena.resize(offset + m_encoder.requiredSpace(message.size()));
+    char* end = m_encoder.appendToBuffer(m_arena.data() + offset, message);
+    m_arena.truncate(end - m_arena.constData());
+    m_arena += '\n';
+
+    m_lines.append({timeMs, m_arena.size()});
 }
 
-QString ShotDebugLogger::formatTime() const
+void ShotDebugLogger::appendTime(QByteArray& out, qint64 timeMs)
 {
-    return QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
+    const QTime time = QDateTime::fromMSecsSinceEpoch(timeMs).time();
+    char buffer[20];
+    const int length = std::snprintf(buffer, sizeof(buffer), "[%02d:%02d:%02d.%03d] ",
+                                     time.hour(), time.minute(), time.second(), time.msec());
+    out.append(buffer, length);
 }
@@ -1,10 +1,20 @@
 #pragma once
 
 #include <QObject>
-#include <QStringList>
+#include <QByteArray>
 #include <QMutex>
 #include <QElapsedTimer>
+#include <QStringEncoder>
+#include <QVector>
 
+/**
+ * Captures Qt debug output during a shot for the shot's debug log.
+ *
+ * Lines are encoded straight into a byte arena that is preallocated once and
+ * reused across shots, so capture doesn't allocate per message. stopCapture()
+ * merges in hot-path records (HotPathLog) from the capture window and
+ * compresses the result; ShotHistoryStorage stores that blob as-is.
+ */
 class ShotDebugLogger : public QObject {
     Q_OBJECT
 
@@ -17,7 +27,10 @@ public:
     void stopCapture();
     bool isCapturing() const { return m_capturing; }
 
-    // Get captured log (call after stopCapture)
+    // qCompress'd UTF-8 log of the last capture (valid after stopCapture)
+    QByteArray compressedLog() const;
+
+    // Captured log as text (decompresses after stopCapture, merges live while capturing)
     QString getCapturedLog() const;
     void clear();
 
@@ -32,14 +45,29 @@ public:
     static QtMessageHandler previousHandler() { return s_previousHandler; }
 
 private:
-    void appendLog(const QString& category, const QString& message);
-    QString formatTime() const;
+    struct LineMark {
+        qint64 timeMs;     // Wall clock, for merging hot-path records
+        qsizetype end;     // Arena offset one past the line's '\n'
+    };
+
+    void appendLine(qint64 timeMs, const char* category, QStringView message);  // Caller holds m_mutex
+    void resetArena();
+    QByteArray mergedLog() const;  // Caller holds m_mutex
+    static void appendTime(QByteArray& out, qint64 timeMs);
 
     mutable QMutex m_mutex;
-    QStringList m_logLines;
+    QByteArray m_arena;
+    QVector<LineMark> m_lines;
+    QStringEncoder m_encoder{QStringEncoder::Utf8};
+    QByteArray m_compressed;
+    qint64 m_captureStartMs = 0;
+    qint64 m_captureStopMs = 0;      // 0 while capturing
     QElapsedTimer m_timer;
     bool m_capturing = false;
 
+    static constexpr qsizetype ARENA_RESERVE = 256 * 1024;  // A long shot with SAW settling is ~100 KB
+    static constexpr qsizetype LINES_RESERVE = 4096;
+
     static ShotDebugLogger* s_instance;
     static QtMessageHandler s_previousHandler;
 };
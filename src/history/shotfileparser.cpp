@@ -1,6 +1,6 @@
 #include "shotfileparser.h"
+#include "../core/tcltokenizer.h"
 #include <QFile>
-#include <QRegularExpression>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QUuid>
@@ -12,8 +12,18 @@ ShotFileParser::ParseResult ShotFileParser::parse(const QByteArray& fileContents
     ParseResult result;
     QString content = QString::fromUtf8(fileContents);
 
+    // The file is one Tcl dict; tokenize it once and look values up by key
+    bool malformed = false;
+    const TclDict values = TclTokenizer::dict(content, &malformed);
+    if (malformed) {
+        qWarning() << "ShotFileParser: Unbalanced braces or quotes in" << filename;
+    }
+    auto extractValue = [&values](const char16_t* key) {
+        return values.value(QStringView(key));
+    };
+
     // Extract timestamp
-    QString clockStr = extractValue(content, "clock");
+    QStringView clockStr = extractValue(u"clock");
     if (clockStr.isEmpty()) {
         result.errorMessage = "Missing clock timestamp";
         return result;
@@ -29,22 +39,22 @@ ShotFileParser::ParseResult ShotFileParser::parse(const QByteArray& fileContents
     result.record.summary.uuid = generateUuid(timestamp, filename);
 
     // Extract time-series data
-    QVector<double> elapsed = parseTclList(extractValue(content, "espresso_elapsed"));
+    QVector<double> elapsed = parseTclList(extractValue(u"espresso_elapsed"));
     if (elapsed.isEmpty()) {
         result.errorMessage = "Missing espresso_elapsed data";
         return result;
     }
 
     // Core time-series
-    QVector<double> pressure = parseTclList(extractValue(content, "espresso_pressure"));
-    QVector<double> flow = parseTclList(extractValue(content, "espresso_flow"));
-    QVector<double> tempBasket = parseTclList(extractValue(content, "espresso_temperature_basket"));
-    QVector<double> weight = parseTclList(extractValue(content, "espresso_weight"));
+    QVector<double> pressure = parseTclList(extractValue(u"espresso_pressure"));
+    QVector<double> flow = parseTclList(extractValue(u"espresso_flow"));
+    QVector<double> tempBasket = parseTclList(extractValue(u"espresso_temperature_basket"));
+    QVector<double> weight = parseTclList(extractValue(u"espresso_weight"));
 
     // Goal/target values
-    QVector<double> pressureGoal = parseTclList(extractValue(content, "espresso_pressure_goal"));
-    QVector<double> flowGoal = parseTclList(extractValue(content, "espresso_flow_goal"));
-    QVector<double> tempGoal = parseTclList(extractValue(content, "espresso_temperature_goal"));
+    QVector<double> pressureGoal = parseTclList(extractValue(u"espresso_pressure_goal"));
+    QVector<double> flowGoal = parseTclList(extractValue(u"espresso_flow_goal"));
+    QVector<double> tempGoal = parseTclList(extractValue(u"espresso_temperature_goal"));
 
     // Convert to point vectors
     result.record.pressure = toPointVector(elapsed, pressure);
@@ -59,7 +69,7 @@ ShotFileParser::ParseResult ShotFileParser::parse(const QByteArray& fileContents
     result.record.summary.duration = elapsed.isEmpty() ? 0 : elapsed.last();
 
     // Parse settings block for metadata
-    QString settingsBlock = extractBracedBlock(content, "settings");
+    QStringView settingsBlock = extractValue(u"settings");
     if (!settingsBlock.isEmpty()) {
         QVariantMap settings = parseTclDict(settingsBlock);
 
@@ -90,13 +100,13 @@ ShotFileParser::ParseResult ShotFileParser::parse(const QByteArray& fileContents
     }
 
     // Extract profile JSON
-    result.record.profileJson = extractProfileJson(content);
+    result.record.profileJson = extractProfileJson(extractValue(u"profile"));
 
     // Parse phase markers from timers
-    QString preinfStartStr = extractValue(content, "timers(espresso_preinfusion_start)");
-    QString preinfStopStr = extractValue(content, "timers(espresso_preinfusion_stop)");
-    QString pourStartStr = extractValue(content, "timers(espresso_pour_start)");
-    QString espressoStartStr = extractValue(content, "timers(espresso_start)");
+    QStringView preinfStartStr = extractValue(u"timers(espresso_preinfusion_start)");
+    QStringView preinfStopStr = extractValue(u"timers(espresso_preinfusion_stop)");
+    QStringView pourStartStr = extractValue(u"timers(espresso_pour_start)");
+    QStringView espressoStartStr = extractValue(u"timers(espresso_start)");
 
     qint64 espressoStart = espressoStartStr.toLongLong();
     qint64 preinfStart = preinfStartStr.toLongLong();
@@ -140,23 +150,14 @@ ShotFileParser::ParseResult ShotFileParser::parseFile(const QString& filePath)
     return parse(file.readAll(), filename);
 }
 
-QVector<double> ShotFileParser::parseTclList(const QString& listStr)
+QVector<double> ShotFileParser::parseTclList(QStringView listStr)
 {
     QVector<double> result;
-    QString str = listStr.trimmed();
-
-    // Remove outer braces if present
-    if (str.startsWith('{') && str.endsWith('}')) {
-        str = str.mid(1, str.length() - 2);
-    }
-
-    // Split by whitespace
-    QStringList parts = str.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-
-    result.reserve(parts.size());
-    for (const QString& part : parts) {
+    TclTokenizer tokenizer(TclTokenizer::unwrap(listStr));
+    QStringView word;
+    while (tokenizer.next(&word)) {
         bool ok;
-        double val = part.toDouble(&ok);
+        double val = word.toDouble(&ok);
         if (ok) {
             result.append(val);
         }
@@ -165,112 +166,19 @@ QVector<double> ShotFileParser::parseTclList(const QString& listStr)
     return result;
 }
 
-QVariantMap ShotFileParser::parseTclDict(const QString& dictStr)
+QVariantMap ShotFileParser::parseTclDict(QStringView dictStr)
 {
     QVariantMap result;
-    QString str = dictStr.trimmed();
-
-    // Remove outer braces
-    if (str.startsWith('{') && str.endsWith('}')) {
-        str = str.mid(1, str.length() - 2);
-    }
-
-    int pos = 0;
-    while (pos < str.length()) {
-        // Skip whitespace
-        while (pos < str.length() && str[pos].isSpace()) pos++;
-        if (pos >= str.length()) break;
-
-        // Read key
-        QString key;
-        while (pos < str.length() && !str[pos].isSpace() && str[pos] != '{') {
-            key += str[pos++];
-        }
-
-        // Skip whitespace
-        while (pos < str.length() && str[pos].isSpace()) pos++;
-        if (pos >= str.length()) break;
-
-        // Read value
-        QString value;
-        if (str[pos] == '{') {
-            // Braced value - find matching close brace
-            int braceCount = 1;
-            pos++; // Skip opening brace
-            int valueStart = pos;
-            while (pos < str.length() && braceCount > 0) {
-                if (str[pos] == '{') braceCount++;
-                else if (str[pos] == '}') braceCount--;
-                pos++;
-            }
-            value = str.mid(valueStart, pos - valueStart - 1);
-        } else {
-            // Unbraced value - read until whitespace
-            while (pos < str.length() && !str[pos].isSpace()) {
-                value += str[pos++];
-            }
-        }
-
-        if (!key.isEmpty()) {
-            result[key] = value;
+    const TclDict values = TclTokenizer::dict(TclTokenizer::unwrap(dictStr));
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        if (!it.key().isEmpty()) {
+            result[it.key().toString()] = it.value().toString();
         }
     }
 
     return result;
 }
 
-QString ShotFileParser::extractValue(const QString& content, const QString& key)
-{
-    // Match patterns like: key {value} or key value
-    QRegularExpression re(QString("^%1\\s+(.+)$").arg(QRegularExpression::escape(key)),
-                          QRegularExpression::MultilineOption);
-    QRegularExpressionMatch match = re.match(content);
-
-    if (match.hasMatch()) {
-        QString value = match.captured(1).trimmed();
-
-        // Handle braced values
-        if (value.startsWith('{')) {
-            int braceCount = 1;
-            int pos = 1;
-            while (pos < value.length() && braceCount > 0) {
-                if (value[pos] == '{') braceCount++;
-                else if (value[pos] == '}') braceCount--;
-                pos++;
-            }
-            return value.left(pos);
-        }
-
-        // Simple value - return first word
-        return value.split(QRegularExpression("\\s+")).first();
-    }
-
-    return QString();
-}
-
-QString ShotFileParser::extractBracedBlock(const QString& content, const QString& key)
-{
-    // Find the key followed by a brace block
-    int keyPos = content.indexOf(QRegularExpression(QString("^%1\\s+\\{").arg(QRegularExpression::escape(key)),
-                                                     QRegularExpression::MultilineOption));
-    if (keyPos < 0) return QString();
-
-    // Find the opening brace
-    int braceStart = content.indexOf('{', keyPos);
-    if (braceStart < 0) return QString();
-
-    // Find matching closing brace
-    int braceCount = 1;
-    int pos = braceStart + 1;
-    while (pos < content.length() && braceCount > 0) {
-        if (content[pos] == '{') braceCount++;
-        else if (content[pos] == '}') braceCount--;
-        pos++;
-    }
-
-    return content.mid(braceStart, pos - braceStart);
-}
-
 QVector<QPointF> ShotFileParser::toPointVector(const QVector<double>& times, const QVector<double>& values)
 {
     QVector<QPointF> result;
@@ -287,25 +195,15 @@ QVector<QPointF> ShotFileParser::toPointVector(const QVector<double>& times, con
     return result;
 }
 
-QString ShotFileParser::extractProfileJson(const QString& content)
+QString ShotFileParser::extractProfileJson(QStringView profileBlock)
 {
-    // The profile is stored as a JSON block after "profile {"
-    qsizetype profileStart = content.indexOf(QRegularExpression("^profile\\s+\\{", QRegularExpression::MultilineOption));
-    if (profileStart < 0) return QString();
-
-    int jsonStart = content.indexOf('{', profileStart);
-    if (jsonStart < 0) return QString();
-
-    // Find matching closing brace
-    int braceCount = 1;
-    int pos = jsonStart + 1;
-    while (pos < content.length() && braceCount > 0) {
-        if (content[pos] == '{') braceCount++;
-        else if (content[pos] == '}') braceCount--;
-        pos++;
-    }
+    // The profile is stored as a JSON object in the "profile" value; the
+    // tokenizer stripped its outer braces
+    if (profileBlock.isEmpty()) return QString();
 
-    QString jsonStr = content.mid(jsonStart, pos - jsonStart);
+    QString jsonStr;
+    jsonStr.reserve(profileBlock.size() + 2);
+    jsonStr.append(QLatin1Char('{')).append(profileBlock).append(QLatin1Char('}'));
 
     // Validate it's actually JSON
     QJsonDocument doc = QJsonDocument::fromJson(jsonStr.toUtf8());
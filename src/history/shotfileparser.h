@@ -4,6 +4,8 @@
 #include <QVector>
 #include <QPointF>
 #include <QVariantMap>
+#include <QHash>
+#include <QStringView>
 #include "shothistorystorage.h"
 
 /**
@@ -31,23 +33,19 @@ public:
     static ParseResult parseFile(const QString& filePath);
 
 private:
+    using TclDict = QHash<QStringView, QStringView>;
+
     // Parse Tcl list format: {value1 value2 value3 ...}
-    static QVector<double> parseTclList(const QString& listStr);
+    static QVector<double> parseTclList(QStringView listStr);
 
     // Parse Tcl dictionary format: key1 value1 key2 value2 ...
-    static QVariantMap parseTclDict(const QString& dictStr);
-
-    // Extract a top-level key-value pair from the file
-    static QString extractValue(const QString& content, const QString& key);
-
-    // Extract a braced block (handles nested braces)
-    static QString extractBracedBlock(const QString& content, const QString& key);
+    static QVariantMap parseTclDict(QStringView dictStr);
 
     // Convert time + value arrays to QPointF vector
     static QVector<QPointF> toPointVector(const QVector<double>& times, const QVector<double>& values);
 
     // Parse the embedded JSON profile
-    static QString extractProfileJson(const QString& content);
+    static QString extractProfileJson(QStringView profileBlock);
 
     // Generate UUID from timestamp for deduplication
     static QString generateUuid(qint64 timestamp, const QString& filename);
@@ -12,6 +12,7 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDebug>
+#include <QThread>
 
 const QString ShotHistoryStorage::DB_CONNECTION_NAME = "ShotHistoryConnection";
 
@@ -117,7 +118,7 @@ bool ShotHistoryStorage::createTables()
             visualizer_id TEXT,
             visualizer_url TEXT,
 
-            debug_log TEXT,
+            debug_log TEXT,  -- Unused since schema 4, see shot_debug_logs
 
             temperature_override REAL,
             yield_override REAL,
@@ -146,6 +147,32 @@ bool ShotHistoryStorage::createTables()
         return false;
     }
 
+    // Shot debug logs (qCompress'd UTF-8), apart from shots so list queries never page them in
+    QString createDebugLogs = R"(
+        CREATE TABLE IF NOT EXISTS shot_debug_logs (
+            shot_id INTEGER PRIMARY KEY REFERENCES shots(id) ON DELETE CASCADE,
+            log_blob BLOB NOT NULL
+        )
+    )";
+
+    if (!query.exec(createDebugLogs)) {
+        qWarning() << "Failed to create shot_debug_logs table:" << query.lastError().text();
+        return false;
+    }
+
+    // Per-phase statistics from recording (qCompress'd JSON, see ShotPhaseStats::toJson())
+    QString createPhaseStats = R"(
+        CREATE TABLE IF NOT EXISTS shot_phase_stats (
+            shot_id INTEGER PRIMARY KEY REFERENCES shots(id) ON DELETE CASCADE,
+            stats_blob BLOB NOT NULL
+        )
+    )";
+
+    if (!query.exec(createPhaseStats)) {
+        qWarning() << "Failed to create shot_phase_stats table:" << query.lastError().text();
+        return false;
+    }
+
     // Phase markers
     QString createPhases = R"(
         CREATE TABLE IF NOT EXISTS shot_phases (
@@ -240,16 +267,67 @@ bool ShotHistoryStorage::runMigrations()
         currentVersion = 3;
     }
 
+    // Migration 4: Move debug logs out of the shots table, compressed. A shot's
+    // log is only cleared once its copy is in; any failure rolls the whole move
+    // back and leaves the version at 3, so it's retried on the next start.
+    if (currentVersion < 4) {
+        qDebug() << "ShotHistoryStorage: Running migration to version 4 (debug logs in shot_debug_logs)";
+
+        QString error;
+        auto check = [&error](QSqlQuery& q, bool ok) {
+            if (!ok && error.isEmpty()) error = q.lastError().text();
+            return ok;
+        };
+
+        // Ids first, so the shots table isn't updated under an open cursor
+        QList<qint64> ids;
+        QSqlQuery select(m_db);
+        if (check(select, select.exec("SELECT id FROM shots WHERE debug_log IS NOT NULL AND debug_log != ''"))) {
+            while (select.next()) {
+                ids.append(select.value(0).toLongLong());
+            }
+        }
+
+        bool ok = error.isEmpty() && m_db.transaction();
+        QSqlQuery read(m_db);
+        QSqlQuery insert(m_db);
+        QSqlQuery clear(m_db);
+        ok = ok && check(read, read.prepare("SELECT debug_log FROM shots WHERE id = ?"))
+                && check(insert, insert.prepare("INSERT OR REPLACE INTO shot_debug_logs (shot_id, log_blob) VALUES (?, ?)"))
+                && check(clear, clear.prepare("UPDATE shots SET debug_log = NULL WHERE id = ?"));
+        for (qsizetype i = 0; ok && i < ids.size(); ++i) {
+            read.bindValue(0, ids[i]);
+            ok = check(read, read.exec() && read.next());
+            if (!ok) break;
+
+            insert.bindValue(0, ids[i]);
+            insert.bindValue(1, qCompress(read.value(0).toString().toUtf8(), 9));
+            clear.bindValue(0, ids[i]);
+            ok = check(insert, insert.exec()) && check(clear, clear.exec());
+        }
+        ok = ok && check(query, query.exec("UPDATE schema_version SET version = 4")) && m_db.commit();
+
+        if (ok) {
+            qDebug() << "ShotHistoryStorage: Moved" << ids.size() << "debug logs";
+            currentVersion = 4;
+        } else {
+            if (error.isEmpty()) error = m_db.lastError().text();
+            qWarning() << "ShotHistoryStorage: Migration to version 4 failed, will retry:" << error;
+            m_db.rollback();
+        }
+    }
+
     m_schemaVersion = currentVersion;
     return true;
 }
 
-QJsonObject ShotHistoryStorage::pointsToJsonObject(const QVector<QPointF>& points)
+template <typename Points>
+static QJsonObject pointsToTimeValueObject(const Points& points)
 {
     QJsonArray timeArr, valueArr;
     for (const auto& pt : points) {
-        timeArr.append(pt.x());
-        valueArr.append(pt.y());
+        timeArr.append(roundedSample(pt.x()));
+        valueArr.append(roundedSample(pt.y()));
     }
     QJsonObject obj;
     obj["t"] = timeArr;
@@ -257,6 +335,16 @@ QJsonObject ShotHistoryStorage::pointsToJsonObject(const QVector<QPointF>& point
     return obj;
 }
 
+QJsonObject ShotHistoryStorage::pointsToJsonObject(const QVector<QPointF>& points)
+{
+    return pointsToTimeValueObject(points);
+}
+
+QJsonObject ShotHistoryStorage::pointsToJsonObject(const SampleView& points)
+{
+    return pointsToTimeValueObject(points);
+}
+
 QByteArray ShotHistoryStorage::compressSampleData(ShotDataModel* shotData)
 {
     QJsonObject root;
@@ -315,7 +403,7 @@ qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
                                      double finalWeight,
                                      double doseWeight,
                                      const ShotMetadata& metadata,
-                                     const QString& debugLog,
+                                     const QByteArray& compressedDebugLog,
                                      double temperatureOverride,
                                      bool hasTemperatureOverride,
                                      double yieldOverride,
@@ -350,7 +438,6 @@ qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
             bean_brand, bean_type, roast_date, roast_level,
             grinder_model, grinder_setting,
             drink_tds, drink_ey, enjoyment, espresso_notes, barista,
-            debug_log,
             temperature_override, yield_override
         ) VALUES (
             :uuid, :timestamp, :profile_name, :profile_json,
@@ -358,7 +445,6 @@ qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
             :bean_brand, :bean_type, :roast_date, :roast_level,
             :grinder_model, :grinder_setting,
             :drink_tds, :drink_ey, :enjoyment, :espresso_notes, :barista,
-            :debug_log,
             :temperature_override, :yield_override
         )
     )");
@@ -381,7 +467,6 @@ qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
     query.bindValue(":enjoyment", metadata.espressoEnjoyment);
     query.bindValue(":espresso_notes", metadata.espressoNotes);
     query.bindValue(":barista", metadata.barista);
-    query.bindValue(":debug_log", debugLog);
 
     // Bind override values (NULL if not set)
     if (hasTemperatureOverride) {
@@ -421,6 +506,27 @@ qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
         return -1;
     }
 
+    // Insert debug log (already compressed by ShotDebugLogger)
+    if (!compressedDebugLog.isEmpty()) {
+        query.prepare("INSERT INTO shot_debug_logs (shot_id, log_blob) VALUES (:id, :blob)");
+        query.bindValue(":id", shotId);
+        query.bindValue(":blob", compressedDebugLog);
+        if (!query.exec()) {
+            // Not worth losing the shot over
+            qWarning() << "ShotHistoryStorage: Failed to insert debug log:" << query.lastError().text();
+        }
+    }
+
+    // Insert phase statistics, so history summaries don't rescan the curves
+    if (shotData->phaseStats().sampleCount() > 0) {
+        query.prepare("INSERT INTO shot_phase_stats (shot_id, stats_blob) VALUES (:id, :blob)");
+        query.bindValue(":id", shotId);
+        query.bindValue(":blob", qCompress(QJsonDocument(shotData->phaseStats().toJson()).toJson(QJsonDocument::Compact)));
+        if (!query.exec()) {
+            qWarning() << "ShotHistoryStorage: Failed to insert phase stats:" << query.lastError().text();
+        }
+    }
+
     // Insert phase markers
     QVariantList markers = shotData->phaseMarkersVariant();
     for (const QVariant& markerVar : markers) {
@@ -689,7 +795,6 @@ QVariantMap ShotHistoryStorage::getShot(qint64 shotId)
     result["barista"] = record.barista;
     result["visualizerId"] = record.visualizerId;
     result["visualizerUrl"] = record.visualizerUrl;
-    result["debugLog"] = record.debugLog;
 
     // Export overrides as individual fields
     if (record.hasTemperatureOverride) {
@@ -733,6 +838,10 @@ QVariantMap ShotHistoryStorage::getShot(qint64 shotId)
     }
     result["phases"] = phases;
 
+    if (record.hasPhaseStats) {
+        result["phaseStats"] = record.phaseStats.toJson().toVariantMap();
+    }
+
     // Format date
     QDateTime dt = QDateTime::fromSecsSinceEpoch(record.summary.timestamp);
     result["dateTime"] = dt.toString("yyyy-MM-dd hh:mm:ss");
@@ -741,18 +850,23 @@ QVariantMap ShotHistoryStorage::getShot(qint64 shotId)
 }
 
 ShotRecord ShotHistoryStorage::getShotRecord(qint64 shotId)
+{
+    if (!m_ready) return ShotRecord();
+    return loadShotRecord(m_db, shotId);
+}
+
+ShotRecord ShotHistoryStorage::loadShotRecord(QSqlDatabase& db, qint64 shotId)
 {
     ShotRecord record;
-    if (!m_ready) return record;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(db);
     query.prepare(R"(
         SELECT id, uuid, timestamp, profile_name, profile_json,
                duration_seconds, final_weight, dose_weight,
                bean_brand, bean_type, roast_date, roast_level,
                grinder_model, grinder_setting,
                drink_tds, drink_ey, enjoyment, espresso_notes, barista,
-               visualizer_id, visualizer_url, debug_log,
+               visualizer_id, visualizer_url,
                temperature_override, yield_override
         FROM shots WHERE id = ?
     )");
@@ -784,16 +898,15 @@ ShotRecord ShotHistoryStorage::getShotRecord(qint64 shotId)
     record.barista = query.value(18).toString();
     record.visualizerId = query.value(19).toString();
     record.visualizerUrl = query.value(20).toString();
-    record.debugLog = query.value(21).toString();
 
     // Load overrides (check for NULL)
-    record.hasTemperatureOverride = !query.value(22).isNull();
+    record.hasTemperatureOverride = !query.value(21).isNull();
     if (record.hasTemperatureOverride) {
-        record.temperatureOverride = query.value(22).toDouble();
+        record.temperatureOverride = query.value(21).toDouble();
     }
-    record.hasYieldOverride = !query.value(23).isNull();
+    record.hasYieldOverride = !query.value(22).isNull();
     if (record.hasYieldOverride) {
-        record.yieldOverride = query.value(23).toDouble();
+        record.yieldOverride = query.value(22).toDouble();
     }
 
     record.summary.hasVisualizerUpload = !record.visualizerId.isEmpty();
@@ -820,9 +933,42 @@ ShotRecord ShotHistoryStorage::getShotRecord(qint64 shotId)
         }
     }
 
+    // Load phase statistics
+    query.prepare("SELECT stats_blob FROM shot_phase_stats WHERE shot_id = ?");
+    query.bindValue(0, shotId);
+    if (query.exec() && query.next()) {
+        QJsonDocument doc = QJsonDocument::fromJson(qUncompress(query.value(0).toByteArray()));
+        if (doc.isObject()) {
+            record.phaseStats = ShotPhaseStats::fromJson(doc.object());
+            record.hasPhaseStats = true;
+        }
+    }
+
     return record;
 }
 
+QString ShotHistoryStorage::getShotDebugLog(qint64 shotId)
+{
+    if (!m_ready) return QString();
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT log_blob FROM shot_debug_logs WHERE shot_id = ?");
+    query.bindValue(0, shotId);
+    if (query.exec() && query.next()) {
+        return QString::fromUtf8(qUncompress(query.value(0).toByteArray()));
+    }
+
+    // Not moved yet (migration 4 failed and will be retried)
+    if (m_schemaVersion < 4) {
+        query.prepare("SELECT debug_log FROM shots WHERE id = ?");
+        query.bindValue(0, shotId);
+        if (query.exec() && query.next()) {
+            return query.value(0).toString();
+        }
+    }
+    return QString();
+}
+
 QList<ShotRecord> ShotHistoryStorage::getShotsForComparison(const QList<qint64>& shotIds)
 {
     QList<ShotRecord> records;
@@ -835,6 +981,34 @@ QList<ShotRecord> ShotHistoryStorage::getShotsForComparison(const QList<qint64>&
     return records;
 }
 
+QList<ShotRecord> ShotHistoryStorage::loadShotsForComparison(const QString& dbPath, const QList<qint64>& shotIds)
+{
+    QList<ShotRecord> records;
+    if (dbPath.isEmpty() || shotIds.isEmpty()) return records;
+
+    // QSqlDatabase connections are per-thread; WAL mode lets this read alongside the GUI connection
+    const QString connectionName = QString("ShotHistoryReader_%1")
+        .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(dbPath);
+        db.setConnectOptions("QSQLITE_OPEN_READONLY");
+        if (!db.open()) {
+            qWarning() << "ShotHistoryStorage: Failed to open reader connection:" << db.lastError().text();
+        } else {
+            for (qint64 id : shotIds) {
+                ShotRecord record = loadShotRecord(db, id);
+                if (record.summary.id != 0) {
+                    records.append(record);
+                }
+            }
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return records;
+}
+
 bool ShotHistoryStorage::deleteShot(qint64 shotId)
 {
     if (!m_ready) return false;
@@ -1193,7 +1367,7 @@ QString ShotHistoryStorage::exportShotData(qint64 shotId)
     }
 
     stream << "--- Debug Log ---" << Qt::endl;
-    stream << record.debugLog << Qt::endl;
+    stream << getShotDebugLog(shotId) << Qt::endl;
     stream << Qt::endl;
 
     stream << "--- Sample Data Summary ---" << Qt::endl;
@@ -1381,6 +1555,8 @@ bool ShotHistoryStorage::importDatabase(const QString& filePath, bool merge)
         QSqlQuery delQuery(m_db);
         delQuery.exec("DELETE FROM shot_phases");
         delQuery.exec("DELETE FROM shot_samples");
+        delQuery.exec("DELETE FROM shot_debug_logs");
+        delQuery.exec("DELETE FROM shot_phase_stats");
         delQuery.exec("DELETE FROM shots");
         qDebug() << "ShotHistoryStorage: Cleared existing data for replace";
     }
@@ -1417,9 +1593,9 @@ bool ShotHistoryStorage::importDatabase(const QString& filePath, bool merge)
                 bean_brand, bean_type, roast_date, roast_level,
                 grinder_model, grinder_setting, drink_tds, drink_ey,
                 enjoyment, espresso_notes, barista,
-                visualizer_id, visualizer_url, debug_log,
+                visualizer_id, visualizer_url,
                 temperature_override, yield_override)
-            VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+            VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
         )");
 
         insert.addBindValue(uuid);
@@ -1442,7 +1618,6 @@ bool ShotHistoryStorage::importDatabase(const QString& filePath, bool merge)
         insert.addBindValue(srcShots.value("barista"));
         insert.addBindValue(srcShots.value("visualizer_id"));
         insert.addBindValue(srcShots.value("visualizer_url"));
-        insert.addBindValue(srcShots.value("debug_log"));
         insert.addBindValue(srcShots.value("temperature_override"));
         insert.addBindValue(srcShots.value("yield_override"));
 
@@ -1467,6 +1642,36 @@ bool ShotHistoryStorage::importDatabase(const QString& filePath, bool merge)
             insertSample.exec();
         }
 
+        // Import debug log: its own table in schema 4+, inline text in older databases
+        QByteArray debugLogBlob;
+        QSqlQuery srcDebugLog(srcDb);
+        srcDebugLog.prepare("SELECT log_blob FROM shot_debug_logs WHERE shot_id = ?");
+        srcDebugLog.addBindValue(oldId);
+        if (srcDebugLog.exec() && srcDebugLog.next()) {
+            debugLogBlob = srcDebugLog.value(0).toByteArray();
+        } else if (!srcShots.value("debug_log").toString().isEmpty()) {
+            debugLogBlob = qCompress(srcShots.value("debug_log").toString().toUtf8(), 9);
+        }
+        if (!debugLogBlob.isEmpty()) {
+            QSqlQuery insertDebugLog(m_db);
+            insertDebugLog.prepare("INSERT INTO shot_debug_logs (shot_id, log_blob) VALUES (?, ?)");
+            insertDebugLog.addBindValue(newId);
+            insertDebugLog.addBindValue(debugLogBlob);
+            insertDebugLog.exec();
+        }
+
+        // Import phase statistics (none in databases from before they were kept)
+        QSqlQuery srcPhaseStats(srcDb);
+        srcPhaseStats.prepare("SELECT stats_blob FROM shot_phase_stats WHERE shot_id = ?");
+        srcPhaseStats.addBindValue(oldId);
+        if (srcPhaseStats.exec() && srcPhaseStats.next()) {
+            QSqlQuery insertPhaseStats(m_db);
+            insertPhaseStats.prepare("INSERT INTO shot_phase_stats (shot_id, stats_blob) VALUES (?, ?)");
+            insertPhaseStats.addBindValue(newId);
+            insertPhaseStats.addBindValue(srcPhaseStats.value(0));
+            insertPhaseStats.exec();
+        }
+
         // Import phases for this shot
         QSqlQuery srcPhases(srcDb);
         srcPhases.prepare("SELECT time_offset, label, frame_number, is_flow_mode FROM shot_phases WHERE shot_id = ?");
@@ -1547,7 +1752,6 @@ qint64 ShotHistoryStorage::importShotRecord(const ShotRecord& record, bool overw
             bean_brand, bean_type, roast_date, roast_level,
             grinder_model, grinder_setting,
             drink_tds, drink_ey, enjoyment, espresso_notes, barista,
-            debug_log,
             temperature_override, yield_override
         ) VALUES (
             :uuid, :timestamp, :profile_name, :profile_json,
@@ -1555,7 +1759,6 @@ qint64 ShotHistoryStorage::importShotRecord(const ShotRecord& record, bool overw
             :bean_brand, :bean_type, :roast_date, :roast_level,
             :grinder_model, :grinder_setting,
             :drink_tds, :drink_ey, :enjoyment, :espresso_notes, :barista,
-            :debug_log,
             :temperature_override, :yield_override
         )
     )");
@@ -1578,7 +1781,6 @@ qint64 ShotHistoryStorage::importShotRecord(const ShotRecord& record, bool overw
     query.bindValue(":enjoyment", record.summary.enjoyment);
     query.bindValue(":espresso_notes", record.espressoNotes);
     query.bindValue(":barista", record.barista);
-    query.bindValue(":debug_log", QString());  // No debug log for imported shots
 
     // Bind overrides (NULL if not set)
     if (record.hasTemperatureOverride) {
@@ -1641,6 +1843,7 @@ qint64 ShotHistoryStorage::importShotRecord(const ShotRecord& record, bool overw
     }
 
     m_db.commit();
+    emit shotImported(shotId);
 
     return shotId;
 }
@@ -6,6 +6,8 @@
 #include <QVector>
 #include <QPointF>
 #include <QDateTime>
+#include "../models/shotsamplestore.h"
+#include "../models/shotphasestats.h"
 
 class ShotDataModel;
 class Profile;
@@ -62,8 +64,9 @@ struct ShotRecord {
     // Phase markers
     QList<HistoryPhaseMarker> phases;
 
-    // Debug log
-    QString debugLog;
+    // Statistics accumulated while recording (shots saved before they were kept have none)
+    ShotPhaseStats phaseStats;
+    bool hasPhaseStats = false;
 
     // Brew overrides (dedicated fields)
     double temperatureOverride = 0.0;
@@ -113,7 +116,7 @@ public:
                     double finalWeight,
                     double doseWeight,
                     const ShotMetadata& metadata,
-                    const QString& debugLog,
+                    const QByteArray& compressedDebugLog,
                     double temperatureOverride = 0.0,
                     bool hasTemperatureOverride = false,
                     double yieldOverride = 0.0,
@@ -132,9 +135,15 @@ public:
     Q_INVOKABLE QVariantMap getShot(qint64 shotId);
     ShotRecord getShotRecord(qint64 shotId);
 
+    // Shot debug log, loaded on demand (kept out of the shots table and ShotRecord)
+    Q_INVOKABLE QString getShotDebugLog(qint64 shotId);
+
     // Get multiple shots for comparison (efficient batch load)
     QList<ShotRecord> getShotsForComparison(const QList<qint64>& shotIds);
 
+    // Thread-safe variant for worker threads: opens its own read connection to dbPath
+    static QList<ShotRecord> loadShotsForComparison(const QString& dbPath, const QList<qint64>& shotIds);
+
     // Delete shot
     Q_INVOKABLE bool deleteShot(qint64 shotId);
 
@@ -192,6 +201,7 @@ signals:
     void readyChanged();
     void totalShotsChanged();
     void shotSaved(qint64 shotId);
+    void shotImported(qint64 shotId);
     void shotDeleted(qint64 shotId);
     void errorOccurred(const QString& message);
 
@@ -199,7 +209,8 @@ private:
     bool createTables();
     bool runMigrations();
     QByteArray compressSampleData(ShotDataModel* shotData);
-    void decompressSampleData(const QByteArray& blob, ShotRecord* record);
+    static void decompressSampleData(const QByteArray& blob, ShotRecord* record);
+    static ShotRecord loadShotRecord(QSqlDatabase& db, qint64 shotId);
     void updateTotalShots();
     QString buildFilterQuery(const ShotFilter& filter, QVariantList& bindValues);
     ShotFilter parseFilterMap(const QVariantMap& filterMap);
@@ -211,8 +222,9 @@ private:
     QStringList getDistinctValuesFiltered(const QString& column, const QString& excludeColumn,
                                           const QVariantMap& filter);
 
-    // Helper for converting QVector<QPointF> to JSON object with t/v arrays
+    // Helper for converting points (stored records or live sample views) to JSON object with t/v arrays
     static QJsonObject pointsToJsonObject(const QVector<QPointF>& points);
+    static QJsonObject pointsToJsonObject(const SampleView& points);
 
     QSqlDatabase m_db;
     QString m_dbPath;
@@ -0,0 +1,216 @@
+#include "shotthumbnailcache.h"
+#include "shothistorystorage.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QPainter>
+#include <QPolygonF>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QDebug>
+
+ShotThumbnailCache::ShotThumbnailCache(ShotHistoryStorage* storage, QObject* parent)
+    : QObject(parent)
+    , m_storage(storage)
+{
+    m_cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails";
+    QDir().mkpath(m_cacheDir);
+    scanCacheDir();
+
+    // One background thread is plenty: a thumbnail is a few milliseconds
+    m_renderer.setMaxThreadCount(1);
+
+    if (m_storage) {
+        connect(m_storage, &ShotHistoryStorage::shotSaved, this, &ShotThumbnailCache::renderInBackground);
+        connect(m_storage, &ShotHistoryStorage::shotImported, this, &ShotThumbnailCache::renderInBackground);
+        connect(m_storage, &ShotHistoryStorage::shotDeleted, this, &ShotThumbnailCache::remove);
+    }
+}
+
+ShotThumbnailCache::~ShotThumbnailCache()
+{
+    m_renderer.clear();
+    m_renderer.waitForDone();
+}
+
+QString ShotThumbnailCache::fileName(qint64 shotId, const QString& uuid) const
+{
+    QString revision = uuid;
+    revision.remove('{').remove('}');
+    return QString("%1-%2-v%3.png").arg(shotId).arg(revision).arg(RENDER_VERSION);
+}
+
+void ShotThumbnailCache::scanCacheDir()
+{
+    static const QRegularExpression pattern("^(\\d+)-.*-v(\\d+)\\.png$");
+
+    QDir dir(m_cacheDir);
+    const QStringList files = dir.entryList({"*.png"}, QDir::Files);
+    QMutexLocker lock(&m_mutex);
+    for (const QString& name : files) {
+        QRegularExpressionMatch match = pattern.match(name);
+        if (!match.hasMatch() || match.captured(2).toInt() != RENDER_VERSION) {
+            dir.remove(name);  // Stale renderer version or foreign file
+            continue;
+        }
+        m_files.insert(match.captured(1).toLongLong(), name);
+    }
+}
+
+QString ShotThumbnailCache::cachedFilePath(qint64 shotId, const QString& uuid)
+{
+    QMutexLocker lock(&m_mutex);
+    auto it = m_files.constFind(shotId);
+    if (it == m_files.constEnd() || (!uuid.isEmpty() && it.value() != fileName(shotId, uuid))) {
+        return QString();
+    }
+    return m_cacheDir + "/" + it.value();
+}
+
+QImage ShotThumbnailCache::thumbnail(qint64 shotId, const QString& uuid)
+{
+    const QString path = cachedFilePath(shotId, uuid);
+    if (!path.isEmpty()) {
+        QImage image(path);
+        if (!image.isNull()) return image;
+    }
+    return renderAndStore(shotId);
+}
+
+void ShotThumbnailCache::renderInBackground(qint64 shotId)
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_queued.contains(shotId)) return;
+        m_queued.insert(shotId);
+    }
+
+    m_renderer.start([this, shotId]() {
+        {
+            // From here on a new request needs a new render (the shot may have changed)
+            QMutexLocker lock(&m_mutex);
+            m_queued.remove(shotId);
+        }
+        if (renderAndStore(shotId).isNull()) return;
+        QMetaObject::invokeMethod(this, [this, shotId]() {
+            emit thumbnailReady(shotId);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ShotThumbnailCache::remove(qint64 shotId)
+{
+    QString name;
+    {
+        QMutexLocker lock(&m_mutex);
+        name = m_files.take(shotId);
+    }
+    if (!name.isEmpty()) {
+        QFile::remove(m_cacheDir + "/" + name);
+    }
+}
+
+QImage ShotThumbnailCache::renderAndStore(qint64 shotId)
+{
+    if (!m_storage) return QImage();
+
+    const QList<ShotRecord> records = ShotHistoryStorage::loadShotsForComparison(m_storage->databasePath(), {shotId});
+    if (records.isEmpty()) return QImage();
+
+    const ShotRecord& record = records.first();
+    QImage image = render(record);
+    const QString name = fileName(shotId, record.summary.uuid);
+
+    // Write atomically - provider threads may be reading the previous file
+    QSaveFile file(m_cacheDir + "/" + name);
+    if (!file.open(QIODevice::WriteOnly) || !image.save(&file, "PNG") || !file.commit()) {
+        qWarning() << "ShotThumbnailCache: Failed to write thumbnail for shot" << shotId;
+        return image;
+    }
+
+    QString previous;
+    {
+        QMutexLocker lock(&m_mutex);
+        previous = m_files.value(shotId);
+        m_files.insert(shotId, name);
+    }
+    if (!previous.isEmpty() && previous != name) {
+        QFile::remove(m_cacheDir + "/" + previous);
+    }
+    return image;
+}
+
+QImage ShotThumbnailCache::render(const ShotRecord& record, const QSize& size)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    double duration = record.summary.duration;
+    if (!record.pressure.isEmpty()) {
+        duration = qMax(duration, record.pressure.last().x());
+    }
+    if (duration <= 0) return image;
+
+    double maxWeight = record.summary.finalWeight;
+    for (const auto& pt : record.weight) {
+        maxWeight = qMax(maxWeight, pt.y());
+    }
+
+    const qreal margin = 2.0;
+    const qreal plotWidth = size.width() - 2 * margin;
+    const qreal plotHeight = size.height() - 2 * margin;
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // About two points per pixel column is all a sparkline can show
+    auto plot = [&](const QVector<QPointF>& points, double maxY, const QColor& color, qreal width) {
+        if (points.size() < 2 || maxY <= 0) return;
+        const qsizetype stride = qMax<qsizetype>(1, points.size() / (size.width() * 2));
+        QPolygonF line;
+        line.reserve(points.size() / stride + 1);
+        for (qsizetype i = 0; i < points.size(); i += stride) {
+            const QPointF& pt = points[i];
+            line << QPointF(margin + pt.x() / duration * plotWidth,
+                            margin + plotHeight - qBound(0.0, pt.y() / maxY, 1.0) * plotHeight);
+        }
+        const QPointF& last = points.last();
+        line << QPointF(margin + last.x() / duration * plotWidth,
+                        margin + plotHeight - qBound(0.0, last.y() / maxY, 1.0) * plotHeight);
+        painter.setPen(QPen(color, width, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+        painter.drawPolyline(line);
+    };
+
+    // Same colors as the shot graphs; weight underneath
+    plot(record.weight, maxWeight, QColor("#a2693d"), 1.0);
+    plot(record.flow, 12.0, QColor("#4e85f4"), 1.2);
+    plot(record.pressure, 12.0, QColor("#18c37e"), 1.5);
+
+    return image;
+}
+
+ShotThumbnailProvider::ShotThumbnailProvider(ShotThumbnailCache* cache)
+    : QQuickImageProvider(QQuickImageProvider::Image, QQmlImageProviderBase::ForceAsynchronousImageLoading)
+    , m_cache(cache)
+{
+}
+
+QImage ShotThumbnailProvider::requestImage(const QString& id, QSize* size, const QSize& requestedSize)
+{
+    // id is "<shotId>" or "<shotId>/<uuid>"
+    const QStringList parts = id.split('/');
+    bool ok = false;
+    const qint64 shotId = parts.value(0).toLongLong(&ok);
+
+    QImage image = ok && m_cache ? m_cache->thumbnail(shotId, parts.value(1)) : QImage();
+    if (image.isNull()) {
+        image = QImage(ShotThumbnailCache::WIDTH, ShotThumbnailCache::HEIGHT, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+    }
+    if (requestedSize.width() > 0 && requestedSize.height() > 0 && requestedSize != image.size()) {
+        image = image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    if (size) *size = image.size();
+    return image;
+}
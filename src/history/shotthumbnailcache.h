@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QObject>
+#include <QImage>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QThreadPool>
+#include <QQuickImageProvider>
+
+struct ShotRecord;
+class ShotHistoryStorage;
+
+/**
+ * Small pressure/flow/weight sparklines for the history list and the web
+ * shot list, so neither has to build charts per row.
+ *
+ * Thumbnails are drawn with QPainter into a QImage on a worker thread when a
+ * shot is saved or imported, and cached on disk as PNG keyed by shot id, shot
+ * uuid (an id can be reused after a replace-import) and renderer version.
+ * A miss renders on the calling thread; thumbnail() is thread-safe and reads
+ * the database through its own connection. Callers on the GUI thread (the web
+ * server) use cachedFilePath() instead and queue a background render on a miss.
+ */
+class ShotThumbnailCache : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int WIDTH = 160;
+    static constexpr int HEIGHT = 48;
+
+    explicit ShotThumbnailCache(ShotHistoryStorage* storage, QObject* parent = nullptr);
+    ~ShotThumbnailCache();
+
+    // Cached thumbnail, rendered on a miss. An empty uuid accepts any cached revision.
+    QImage thumbnail(qint64 shotId, const QString& uuid = QString());
+
+    // Path of the cached PNG, or empty if there is none yet. Never renders.
+    QString cachedFilePath(qint64 shotId, const QString& uuid = QString());
+
+    // Render (or re-render) in the background, e.g. after save/import.
+    // Requests for a shot that is already queued are merged.
+    void renderInBackground(qint64 shotId);
+    void remove(qint64 shotId);
+
+    static QImage render(const ShotRecord& record, const QSize& size = QSize(WIDTH, HEIGHT));
+
+signals:
+    void thumbnailReady(qint64 shotId);
+
+private:
+    QString fileName(qint64 shotId, const QString& uuid) const;
+    QImage renderAndStore(qint64 shotId);
+    void scanCacheDir();
+
+    ShotHistoryStorage* m_storage = nullptr;
+    QString m_cacheDir;
+    QMutex m_mutex;                    // Guards m_files and m_queued (provider threads, worker, GUI)
+    QHash<qint64, QString> m_files;    // Shot id -> cached file name
+    QSet<qint64> m_queued;             // Queued, not yet started renders
+    QThreadPool m_renderer;
+
+    static constexpr int RENDER_VERSION = 1;  // Bump when the drawing changes
+};
+
+/**
+ * image://shotthumb/<id>[/<uuid>] for QML. Loads off the GUI thread, so
+ * scrolling the history never renders on the GUI thread.
+ */
+class ShotThumbnailProvider : public QQuickImageProvider {
+public:
+    explicit ShotThumbnailProvider(ShotThumbnailCache* cache);
+    QImage requestImage(const QString& id, QSize* size, const QSize& requestedSize) override;
+
+private:
+    ShotThumbnailCache* m_cache;
+};
@@ -25,6 +25,7 @@
 #include "core/accessibilitymanager.h"
 #include "core/autowakemanager.h"
 #include "core/crashhandler.h"
+#include "core/flightrecorder.h"
 #include "network/crashreporter.h"
 #include "core/profilestorage.h"
 #include "ble/blemanager.h"
@@ -90,6 +91,13 @@ int main(int argc, char *argv[])
     if (CrashHandler::hasCrashLog()) {
         previousCrashLog = CrashHandler::readCrashLog();
         previousDebugLogTail = CrashHandler::getDebugLogTail(50);
+
+        // What the machine was doing right before the crash
+        const QStringList flight = FlightRecorder::lastCrashLines();
+        if (!flight.isEmpty()) {
+            previousDebugLogTail += "\n\n=== FLIGHT RECORDER (last 60 entries) ===\n"
+                + flight.mid(qMax(0, static_cast<int>(flight.size()) - 60)).join("\n");
+        }
         qWarning() << "=== PREVIOUS CRASH DETECTED ===";
         qWarning().noquote() << previousCrashLog;
         qWarning() << "=== END CRASH REPORT ===";
@@ -152,12 +160,16 @@ int main(int argc, char *argv[])
 
     // Connect SAW learning signal to settings persistence
     QObject::connect(&timingController, &ShotTimingController::sawLearningComplete,
-                     [&settings](double drip, double flowAtStop, double overshoot) {
+                     [&settings](double drip, double flowAtStop, double overshoot,
+                                 double scaleLatency, double stopLatency) {
                          QString scaleType = settings.scaleType();
-                         settings.addSawLearningPoint(drip, flowAtStop, scaleType);
+                         QString profile = settings.currentProfile();
+                         settings.addSawLearningPoint(drip, flowAtStop, scaleType, profile,
+                                                      scaleLatency, stopLatency);
                          qDebug() << "[SAW] Learning point saved: drip=" << drip
                                   << "flow=" << flowAtStop << "overshoot=" << overshoot
-                                  << "scale=" << scaleType;
+                                  << "scale=" << scaleType << "profile=" << profile
+                                  << "scaleLatency=" << scaleLatency << "stopLatency=" << stopLatency;
                      });
 
     // Forward sawSettling state to MainController for QML binding
@@ -238,6 +250,9 @@ int main(int argc, char *argv[])
     // Set up QML engine
     QQmlApplicationEngine engine;
 
+    // Shot history sparklines (image://shotthumb/<id>/<uuid>), loaded off the GUI thread
+    engine.addImageProvider("shotthumb", new ShotThumbnailProvider(mainController.thumbnailCache()));
+
     // Auto-connect when DE1 is discovered
     QObject::connect(&bleManager, &BLEManager::de1Discovered,
                      &de1Device, [&de1Device, &bleManager](const QBluetoothDeviceInfo& device) {
@@ -291,6 +306,8 @@ int main(int argc, char *argv[])
             return;
         }
 
+        physicalScale->setFlowEstimatorType(FlowEstimator::typeFromString(settings.scaleFlowEstimator()));
+
         // Stop the FlowScale fallback timer since we found a physical scale
         flowScaleFallbackTimer.stop();
 
@@ -367,6 +384,13 @@ int main(int argc, char *argv[])
         }
     });
 
+    // Apply flow estimator changes to the connected scale immediately
+    QObject::connect(&settings, &Settings::scaleFlowEstimatorChanged, [&physicalScale, &settings]() {
+        if (physicalScale) {
+            physicalScale->setFlowEstimatorType(FlowEstimator::typeFromString(settings.scaleFlowEstimator()));
+        }
+    });
+
     // Load saved scale address for direct wake connection
     QString savedScaleAddr = settings.scaleAddress();
     QString savedScaleType = settings.scaleType();
@@ -659,6 +683,11 @@ int main(int argc, char *argv[])
         // Shutdown accessibility to stop TTS before any other cleanup
         // This prevents race conditions with Android's hwuiTask thread
         accessibilityManager.shutdown();
+
+        // Stop the log writer; anything logged after this is written synchronously
+        if (WebDebugLogger::instance()) {
+            WebDebugLogger::instance()->shutdown();
+        }
     });
 
     int result = app.exec();
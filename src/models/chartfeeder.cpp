@@ -0,0 +1,122 @@
+#include "chartfeeder.h"
+#include <QtCharts/QXYSeries>
+#include <QtMath>
+
+void ChartFeeder::setPointBudget(int points) {
+    points = qMax(MIN_BUDGET, points);
+    if (points == m_budget) return;
+    m_budget = points;
+    reset();
+}
+
+void ChartFeeder::reset() {
+    m_series = nullptr;
+    m_sourceFed = 0;
+    m_seriesCount = 0;
+}
+
+void ChartFeeder::sync(QXYSeries* series, const SampleView& points) {
+    if (!series) return;
+
+    const qsizetype n = points.size();
+
+    // Series swapped, source shrank, or someone else touched the series: rebuild
+    bool rebuild = series != m_series || n < m_sourceFed || series->count() != m_seriesCount;
+
+    if (!rebuild) {
+        qsizetype tail = n - m_sourceFed;
+        if (tail == 0) return;
+        if (m_seriesCount + tail <= m_budget) {
+            copyPoints(points, m_sourceFed, m_scratch);
+            series->append(m_scratch);
+            m_sourceFed = n;
+            m_seriesCount += tail;
+            return;
+        }
+    }
+
+    m_series = series;
+    m_sourceFed = n;
+    if (n <= m_budget) {
+        copyPoints(points, 0, m_scratch);
+    } else {
+        decimateLttb(points, m_budget * 3 / 4, m_scratch);
+    }
+    series->replace(m_scratch);
+    m_seriesCount = m_scratch.size();
+}
+
+void ChartFeeder::copyPoints(const SampleView& points, qsizetype from, QVector<QPointF>& out) {
+    // clear() keeps the capacity of an unshared list, so steady-state flushes don't allocate
+    out.clear();
+    const qsizetype n = points.size();
+    if (from >= n) return;
+    out.reserve(n - from);
+
+    const float* time = points.timeData();
+    const float* value = points.valueData();
+    if (time && value) {
+        for (qsizetype i = from; i < n; ++i) {
+            out.append(QPointF(time[i], value[i]));
+        }
+    } else {
+        for (qsizetype i = from; i < n; ++i) {
+            out.append(points.at(i));
+        }
+    }
+}
+
+void ChartFeeder::decimateLttb(const SampleView& points, int threshold, QVector<QPointF>& out) {
+    out.clear();
+    const qsizetype n = points.size();
+    if (threshold < 3 || n <= threshold) {
+        copyPoints(points, 0, out);
+        return;
+    }
+
+    out.reserve(threshold);
+    out.append(points.first());
+
+    // Buckets exclude the first and last points
+    const double bucketSize = static_cast<double>(n - 2) / (threshold - 2);
+    qsizetype a = 0;  // Index of the previously selected point
+
+    for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+        qsizetype start = static_cast<qsizetype>(bucket * bucketSize) + 1;
+        qsizetype end = static_cast<qsizetype>((bucket + 1) * bucketSize) + 1;
+
+        // Average of the next bucket (or the last point) is the third triangle vertex
+        qsizetype nextStart = end;
+        qsizetype nextEnd = qMin(static_cast<qsizetype>((bucket + 2) * bucketSize) + 1, n);
+        double avgX = 0, avgY = 0;
+        if (nextStart >= nextEnd) {
+            avgX = points.last().x();
+            avgY = points.last().y();
+        } else {
+            for (qsizetype i = nextStart; i < nextEnd; ++i) {
+                avgX += points.time(i);
+                avgY += points.value(i);
+            }
+            avgX /= (nextEnd - nextStart);
+            avgY /= (nextEnd - nextStart);
+        }
+
+        const QPointF pa = points[a];
+        double maxArea = -1;
+        qsizetype selected = start;
+        for (qsizetype i = start; i < end; ++i) {
+            // Twice the triangle area - only the comparison matters
+            double area = qAbs((pa.x() - avgX) * (points.value(i) - pa.y())
+                               - (pa.x() - points.time(i)) * (avgY - pa.y()));
+            if (area > maxArea) {
+                maxArea = area;
+                selected = i;
+            }
+        }
+
+        out.append(points[selected]);
+        a = selected;
+    }
+
+    out.append(points.last());
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+#include "shotsamplestore.h"
+
+class QXYSeries;
+
+/**
+ * ChartFeeder keeps one chart series in sync with a growing sample channel
+ * while bounding the number of points the chart has to draw.
+ *
+ * - While the series has room, only the new tail is appended (no full replace).
+ * - Once it would exceed the point budget (~1 per pixel column), the whole
+ *   channel is decimated with LTTB to 3/4 of the budget and written with a single
+ *   replace(). The remaining quarter absorbs appends, so rebuilds happen once
+ *   per budget/4 new points and the series size - and redraw cost - stays
+ *   constant however long the shot runs.
+ *
+ * The source must only grow between syncs; call reset() after clearing it.
+ */
+class ChartFeeder {
+public:
+    static constexpr int DEFAULT_BUDGET = 1000;
+    static constexpr int MIN_BUDGET = 64;
+
+    void setPointBudget(int points);
+    int pointBudget() const { return m_budget; }
+
+    // Forget what was fed; the next sync() replaces the series contents
+    void reset();
+
+    void sync(QXYSeries* series, const SampleView& points);
+
+    // Largest-Triangle-Three-Buckets: keeps the visual shape (peaks, steps)
+    // with `threshold` points. First and last points are always kept.
+    static void decimateLttb(const SampleView& points, int threshold, QVector<QPointF>& out);
+
+private:
+    // Clears out and fills it with points[from..] straight from the columns
+    static void copyPoints(const SampleView& points, qsizetype from, QVector<QPointF>& out);
+
+    QXYSeries* m_series = nullptr;
+    qsizetype m_sourceFed = 0;    // Source points represented in the series
+    qsizetype m_seriesCount = 0;  // Points currently in the series
+    int m_budget = DEFAULT_BUDGET;
+    QVector<QPointF> m_scratch;   // Reused conversion/decimation output
+};
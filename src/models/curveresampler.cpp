@@ -0,0 +1,150 @@
+#include "curveresampler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+ResampleCurve ResampleCurve::fromPoints(const QVector<QPointF>& points) {
+    ResampleCurve curve;
+    curve.time.resize(points.size());
+    curve.value.resize(points.size());
+    for (qsizetype i = 0; i < points.size(); ++i) {
+        curve.time[i] = static_cast<float>(points[i].x());
+        curve.value[i] = static_cast<float>(points[i].y());
+    }
+    return curve;
+}
+
+ResampleCurve ResampleCurve::fromView(const SampleView& view) {
+    ResampleCurve curve;
+    curve.time.resize(view.size());
+    curve.value.resize(view.size());
+    if (view.timeData()) {
+        // Contiguous columns: straight copies
+        std::copy(view.timeData(), view.timeData() + view.size(), curve.time.begin());
+        std::copy(view.valueData(), view.valueData() + view.size(), curve.value.begin());
+    } else {
+        for (qsizetype i = 0; i < view.size(); ++i) {
+            curve.time[i] = static_cast<float>(view.time(i));
+            curve.value[i] = static_cast<float>(view.value(i));
+        }
+    }
+    return curve;
+}
+
+ResampleGrid ResampleGrid::covering(const QList<ResampleShot>& shots, double step) {
+    ResampleGrid grid;
+    grid.step = step;
+
+    double first = std::numeric_limits<double>::infinity();
+    double last = -std::numeric_limits<double>::infinity();
+    for (const ResampleShot& shot : shots) {
+        for (const ResampleCurve& curve : shot.curves) {
+            if (curve.isEmpty()) continue;
+            first = std::min(first, curve.time.first() - shot.offset);
+            last = std::max(last, curve.time.last() - shot.offset);
+        }
+    }
+    if (step <= 0 || first > last) return grid;
+
+    grid.start = std::floor(first / step) * step;
+    grid.count = static_cast<int>(std::ceil((last - grid.start) / step)) + 1;
+    return grid;
+}
+
+// Kernel with caller-owned scratch so batches don't allocate per curve
+static void resampleInto(const float* time, const float* value, qsizetype count,
+                         double offset, const ResampleGrid& grid, float* out,
+                         qsizetype* segment, float* sourceTime) {
+    const int n = grid.count;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    if (count < 2) {
+        for (int i = 0; i < n; ++i) {
+            out[i] = (count == 1 && static_cast<float>(grid.timeAt(i) + offset) == time[0]) ? value[0] : nan;
+        }
+        return;
+    }
+
+    // Pass 1: source segment for each grid point. Grid and source are both
+    // sorted, so one forward walk finds them all.
+    qsizetype j = 0;
+    for (int i = 0; i < n; ++i) {
+        const float t = static_cast<float>(grid.timeAt(i) + offset);
+        while (j < count - 2 && time[j + 1] < t) ++j;
+        segment[i] = j;
+        sourceTime[i] = t;
+    }
+
+    // Pass 2: branch-free lerp over contiguous arrays (selects, no jumps)
+    const float first = time[0];
+    const float last = time[count - 1];
+    for (int i = 0; i < n; ++i) {
+        const qsizetype a = segment[i];
+        const float t0 = time[a];
+        const float dt = time[a + 1] - t0;
+        const float v0 = value[a];
+        const float f = dt > 0.0f ? (sourceTime[i] - t0) / dt : 0.0f;
+        const float v = v0 + f * (value[a + 1] - v0);
+        out[i] = (sourceTime[i] < first || sourceTime[i] > last) ? nan : v;
+    }
+}
+
+void CurveResampler::resample(const float* time, const float* value, qsizetype count,
+                              double offset, const ResampleGrid& grid, float* out) {
+    if (grid.count <= 0) return;
+    QVector<qsizetype> segment(grid.count);
+    QVector<float> sourceTime(grid.count);
+    resampleInto(time, value, count, offset, grid, out, segment.data(), sourceTime.data());
+}
+
+QVector<float> CurveResampler::resampleShots(const QList<ResampleShot>& shots, const ResampleGrid& grid) {
+    if (shots.isEmpty() || grid.count <= 0) return QVector<float>();
+
+    const qsizetype channels = shots.first().curves.size();
+    QVector<float> result(shots.size() * channels * grid.count, std::numeric_limits<float>::quiet_NaN());
+    QVector<qsizetype> segment(grid.count);
+    QVector<float> sourceTime(grid.count);
+
+    float* rows = result.data();
+    for (qsizetype s = 0; s < shots.size(); ++s) {
+        const ResampleShot& shot = shots[s];
+        for (qsizetype c = 0; c < channels && c < shot.curves.size(); ++c) {
+            const ResampleCurve& curve = shot.curves[c];
+            float* out = rows + (s * channels + c) * grid.count;
+            resampleInto(curve.time.constData(), curve.value.constData(), curve.time.size(),
+                         shot.offset, grid, out, segment.data(), sourceTime.data());
+        }
+    }
+    return result;
+}
+
+double CurveResampler::firstDripTime(const ResampleCurve& weight, const ResampleCurve& flow) {
+    const ResampleCurve& curve = weight.isEmpty() ? flow : weight;
+    const float threshold = static_cast<float>(weight.isEmpty() ? FIRST_DRIP_FLOW : FIRST_DRIP_WEIGHT);
+    for (qsizetype i = 0; i < curve.value.size(); ++i) {
+        if (curve.value[i] >= threshold) {
+            return curve.time[i];
+        }
+    }
+    return 0;
+}
+
+double CurveResampler::phaseMarkerTime(const QList<ResampleMarker>& markers, const QString& label) {
+    for (const ResampleMarker& marker : markers) {
+        if (label.isEmpty() ? marker.frameNumber >= 1 : marker.label.compare(label, Qt::CaseInsensitive) == 0) {
+            return marker.time;
+        }
+    }
+    return 0;
+}
+
+QVector<QPointF> CurveResampler::toPoints(const float* row, const ResampleGrid& grid) {
+    QVector<QPointF> points;
+    points.reserve(grid.count);
+    for (int i = 0; i < grid.count; ++i) {
+        if (!std::isnan(row[i])) {
+            points.append(QPointF(grid.timeAt(i), row[i]));
+        }
+    }
+    return points;
+}
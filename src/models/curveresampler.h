@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QVector>
+#include <QList>
+#include <QPointF>
+#include <QString>
+#include "shotsamplestore.h"
+
+/**
+ * One channel of a shot as parallel float32 columns - the layout the
+ * resampling kernel works on. Built from stored history points or from a
+ * live SampleView.
+ */
+struct ResampleCurve {
+    QVector<float> time;
+    QVector<float> value;
+
+    bool isEmpty() const { return time.isEmpty(); }
+
+    static ResampleCurve fromPoints(const QVector<QPointF>& points);
+    static ResampleCurve fromView(const SampleView& view);
+};
+
+/**
+ * A shot to resample: its channels (same order for every shot in a call)
+ * and the alignment offset subtracted from every timestamp.
+ */
+struct ResampleShot {
+    QVector<ResampleCurve> curves;
+    double offset = 0;
+};
+
+/**
+ * A phase marker for alignment. "Start" and the first frame's marker are
+ * frame 0; frame changes have frameNumber >= 1.
+ */
+struct ResampleMarker {
+    double time = 0;
+    QString label;
+    int frameNumber = 0;
+};
+
+/**
+ * Regular time grid: start, start + step, ... (count points).
+ */
+struct ResampleGrid {
+    double start = 0;
+    double step = 0.1;
+    int count = 0;
+
+    double timeAt(int i) const { return start + i * step; }
+
+    // Grid covering every aligned curve in the batch
+    static ResampleGrid covering(const QList<ResampleShot>& shots, double step);
+};
+
+/**
+ * Resamples curves onto a common time grid by linear interpolation, so
+ * shots can be overlaid, compared point for point, or averaged.
+ *
+ * The kernel runs in two passes over the grid: a monotonic walk that finds
+ * the source segment for each grid point, then a branch-free lerp over
+ * contiguous arrays that the compiler can vectorize. Grid points outside a
+ * curve's time span are NaN so callers can leave gaps instead of inventing
+ * data.
+ */
+class CurveResampler {
+public:
+    enum class Align {
+        Start,        // Shot start (t = 0), i.e. no shift
+        FirstDrip,    // First liquid in the cup
+        PhaseMarker   // A frame boundary
+    };
+
+    // Resample one curve. out must hold grid.count floats.
+    static void resample(const float* time, const float* value, qsizetype count,
+                         double offset, const ResampleGrid& grid, float* out);
+
+    // Resample every channel of every shot in one call.
+    // Result is row-major: row (shot * channels + channel), grid.count floats per row.
+    static QVector<float> resampleShots(const QList<ResampleShot>& shots, const ResampleGrid& grid);
+
+    // Alignment helpers - both return 0 (no shift) when the event is not found.
+    // First drip uses the scale when present, else the flow threshold the AI summary uses.
+    static double firstDripTime(const ResampleCurve& weight, const ResampleCurve& flow);
+    // The marker with this label; an empty label picks the first frame change (frameNumber >= 1)
+    static double phaseMarkerTime(const QList<ResampleMarker>& markers, const QString& label);
+
+    // Grid row back to chart points, skipping the NaN gaps
+    static QVector<QPointF> toPoints(const float* row, const ResampleGrid& grid);
+
+    static constexpr double FIRST_DRIP_WEIGHT = 0.5;  // g
+    static constexpr double FIRST_DRIP_FLOW = 0.5;    // mL/s
+};
@@ -3,6 +3,7 @@
 
 #include <QDateTime>
 #include <algorithm>
+#include <cstdlib>
 
 // Shot colors: Green, Blue, Orange
 const QList<QColor> ShotComparisonModel::SHOT_COLORS = {
@@ -20,11 +21,23 @@ const QList<QColor> ShotComparisonModel::SHOT_COLORS_LIGHT = {
 ShotComparisonModel::ShotComparisonModel(QObject* parent)
     : QObject(parent)
 {
+    m_loader.setMaxThreadCount(1);
+}
+
+ShotComparisonModel::~ShotComparisonModel()
+{
+    m_loader.clear();
+    m_loader.waitForDone();
 }
 
 void ShotComparisonModel::setStorage(ShotHistoryStorage* storage)
 {
     m_storage = storage;
+    if (m_storage) {
+        connect(m_storage, &ShotHistoryStorage::shotDeleted, this, [this](qint64 shotId) {
+            m_cache.remove(shotId);
+        });
+    }
 }
 
 QVariantList ShotComparisonModel::shotsVariant() const
@@ -62,6 +75,7 @@ void ShotComparisonModel::removeShot(qint64 shotId)
     int index = m_shotIds.indexOf(shotId);
     if (index >= 0) {
         m_shotIds.removeAt(index);
+        m_cache.remove(shotId);
         // Adjust window start if needed
         int shotCount = static_cast<int>(m_shotIds.size());
         if (m_windowStart >= shotCount) {
@@ -77,7 +91,12 @@ void ShotComparisonModel::clearAll()
 {
     m_shotIds.clear();
     m_displayShots.clear();
+    m_alignedShots.clear();
+    m_cache.clear();  // Also picks up metadata edited since the last comparison
+    m_unavailable.clear();
+    setLoading(false);
     m_windowStart = 0;
+    m_minTime = 0.0;
     m_maxTime = 60.0;
     m_maxPressure = 12.0;
     m_maxFlow = 8.0;
@@ -125,96 +144,250 @@ bool ShotComparisonModel::hasShotId(qint64 shotId) const
 
 void ShotComparisonModel::loadDisplayWindow()
 {
-    m_displayShots.clear();
-
-    if (!m_storage || m_shotIds.isEmpty()) return;
+    if (!m_storage || m_shotIds.isEmpty()) {
+        m_displayShots.clear();
+        m_alignedShots.clear();
+        setLoading(false);
+        return;
+    }
 
     // Ensure window start is valid
     int shotCount = static_cast<int>(m_shotIds.size());
     if (m_windowStart < 0) m_windowStart = 0;
     if (m_windowStart >= shotCount) m_windowStart = std::max(0, shotCount - DISPLAY_WINDOW_SIZE);
 
-    // Get the subset of shot IDs for the current window
-    QList<qint64> windowIds;
+    // Window first, then its neighbours - the worker handles requests in order
     int windowEnd = std::min(m_windowStart + DISPLAY_WINDOW_SIZE, shotCount);
-    for (int i = m_windowStart; i < windowEnd; ++i) {
-        windowIds.append(m_shotIds[i]);
+    requestShots(m_shotIds.mid(m_windowStart, windowEnd - m_windowStart));
+
+    QList<qint64> neighbours;
+    for (int i = 1; i <= PREFETCH_MARGIN; ++i) {
+        if (windowEnd - 1 + i < shotCount) neighbours.append(m_shotIds[windowEnd - 1 + i]);
+        if (m_windowStart - i >= 0) neighbours.append(m_shotIds[m_windowStart - i]);
     }
+    requestShots(neighbours);
+
+    // Cached windows show immediately; otherwise the current shots stay up until the load lands
+    setLoading(!applyDisplayWindow());
+}
+
+bool ShotComparisonModel::applyDisplayWindow()
+{
+    int shotCount = static_cast<int>(m_shotIds.size());
+    int windowEnd = std::min(m_windowStart + DISPLAY_WINDOW_SIZE, shotCount);
 
-    QList<ShotRecord> records = m_storage->getShotsForComparison(windowIds);
-
-    for (const ShotRecord& record : records) {
-        ComparisonShot shot;
-        shot.id = record.summary.id;
-        shot.profileName = record.summary.profileName;
-        shot.beanBrand = record.summary.beanBrand;
-        shot.beanType = record.summary.beanType;
-        shot.roastDate = record.roastDate;
-        shot.roastLevel = record.roastLevel;
-        shot.grinderModel = record.grinderModel;
-        shot.grinderSetting = record.grinderSetting;
-        shot.duration = record.summary.duration;
-        shot.doseWeight = record.summary.doseWeight;
-        shot.finalWeight = record.summary.finalWeight;
-        shot.drinkTds = record.drinkTds;
-        shot.drinkEy = record.drinkEy;
-        shot.enjoyment = record.summary.enjoyment;
-        shot.timestamp = record.summary.timestamp;
-        shot.notes = record.espressoNotes;
-        shot.barista = record.barista;
-
-        shot.pressure = record.pressure;
-        shot.flow = record.flow;
-        shot.temperature = record.temperature;
-        shot.weight = record.weight;
-
-        for (const auto& phase : record.phases) {
-            ComparisonShot::PhaseMarker marker;
-            marker.time = phase.time;
-            marker.label = phase.label;
-            shot.phases.append(marker);
+    for (int i = m_windowStart; i < windowEnd; ++i) {
+        qint64 id = m_shotIds[i];
+        if (!m_cache.contains(id) && !m_unavailable.contains(id)) {
+            return false;
         }
+    }
 
-        m_displayShots.append(shot);
+    m_displayShots.clear();
+    for (int i = m_windowStart; i < windowEnd; ++i) {
+        auto it = m_cache.constFind(m_shotIds[i]);
+        if (it != m_cache.constEnd()) {
+            m_displayShots.append(it.value());
+        }
     }
 
+    alignDisplayShots();
     calculateMaxValues();
+    trimCache();
+    return true;
 }
 
-void ShotComparisonModel::calculateMaxValues()
+void ShotComparisonModel::setAlignMode(AlignMode mode)
 {
-    m_maxTime = 0.0;
-    m_maxPressure = 12.0;
-    m_maxFlow = 8.0;
-    m_maxWeight = 50.0;
+    if (m_alignMode == mode) return;
+    m_alignMode = mode;
+    alignDisplayShots();
+    calculateMaxValues();
+    emit alignmentChanged();
+    emit shotsChanged();
+}
 
-    for (const auto& shot : m_displayShots) {
-        // Max time from duration
-        if (shot.duration > m_maxTime) {
-            m_maxTime = shot.duration;
-        }
+void ShotComparisonModel::setAlignPhase(const QString& label)
+{
+    if (m_alignPhase == label) return;
+    m_alignPhase = label;
+    if (m_alignMode == AlignMode::PhaseMarker) {
+        alignDisplayShots();
+        calculateMaxValues();
+        emit shotsChanged();
+    }
+    emit alignmentChanged();
+}
 
-        // Max pressure
-        for (const auto& pt : shot.pressure) {
-            if (pt.y() > m_maxPressure) {
-                m_maxPressure = pt.y() + 2.0;
+void ShotComparisonModel::alignDisplayShots()
+{
+    m_alignedShots.clear();
+
+    QList<ResampleShot> batch;
+    for (const ComparisonShot& shot : std::as_const(m_displayShots)) {
+        ResampleShot resample;
+        resample.curves = shot.curves;
+        switch (m_alignMode) {
+        case AlignMode::Start:
+            break;
+        case AlignMode::FirstDrip:
+            resample.offset = CurveResampler::firstDripTime(shot.curves[CURVE_WEIGHT], shot.curves[CURVE_FLOW]);
+            break;
+        case AlignMode::PhaseMarker: {
+            QList<ResampleMarker> markers;
+            for (const auto& phase : shot.phases) {
+                markers.append({phase.time, phase.label, phase.frameNumber});
             }
+            resample.offset = CurveResampler::phaseMarkerTime(markers, m_alignPhase);
+            break;
         }
+        }
+        batch.append(resample);
+    }
 
-        // Max flow
-        for (const auto& pt : shot.flow) {
-            if (pt.y() > m_maxFlow) {
-                m_maxFlow = pt.y() + 1.0;
-            }
+    // All shots of the window in one pass onto a shared grid
+    const ResampleGrid grid = ResampleGrid::covering(batch, GRID_STEP);
+    const QVector<float> rows = CurveResampler::resampleShots(batch, grid);
+
+    for (int s = 0; s < batch.size(); ++s) {
+        AlignedShot aligned;
+        aligned.offset = batch[s].offset;
+        for (int c = 0; c < CURVE_COUNT; ++c) {
+            aligned.curves[c] = CurveResampler::toPoints(rows.constData() + (s * CURVE_COUNT + c) * grid.count, grid);
         }
+        m_alignedShots.append(aligned);
+    }
 
-        // Max weight
-        for (const auto& pt : shot.weight) {
-            if (pt.y() > m_maxWeight) {
-                m_maxWeight = pt.y() + 10.0;
-            }
+    m_minTime = grid.count > 0 ? std::min(0.0, grid.start) : 0.0;
+}
+
+void ShotComparisonModel::requestShots(const QList<qint64>& shotIds)
+{
+    QList<qint64> missing;
+    for (qint64 id : shotIds) {
+        if (!m_cache.contains(id) && !m_inFlight.contains(id) && !m_unavailable.contains(id)) {
+            missing.append(id);
+            m_inFlight.insert(id);
         }
     }
+    if (missing.isEmpty()) return;
+
+    // Worker only touches its own connection and copies; results come back as a queued call.
+    // The destructor waits for the pool, and queued calls to a deleted object are dropped.
+    const QString dbPath = m_storage->databasePath();
+    m_loader.start([this, dbPath, missing]() {
+        QList<ComparisonShot> shots;
+        for (const ShotRecord& record : ShotHistoryStorage::loadShotsForComparison(dbPath, missing)) {
+            shots.append(fromRecord(record));
+        }
+        QMetaObject::invokeMethod(this, [this, missing, shots]() {
+            onShotsLoaded(missing, shots);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ShotComparisonModel::onShotsLoaded(const QList<qint64>& requested, const QList<ComparisonShot>& shots)
+{
+    for (qint64 id : requested) {
+        m_inFlight.remove(id);
+        if (m_shotIds.contains(id)) {
+            m_unavailable.insert(id);  // Cleared below if it arrived
+        }
+    }
+    for (const ComparisonShot& shot : shots) {
+        // Drop results for shots removed (or cleared) while loading
+        if (!m_shotIds.contains(shot.id)) continue;
+        m_unavailable.remove(shot.id);
+        m_cache.insert(shot.id, shot);
+    }
+
+    if (m_loading && applyDisplayWindow()) {
+        setLoading(false);
+        emit shotsChanged();
+    }
+}
+
+void ShotComparisonModel::trimCache()
+{
+    if (m_cache.size() <= MAX_CACHED_SHOTS) return;
+
+    // Evict the shots furthest from the current window
+    int windowCenter = m_windowStart + DISPLAY_WINDOW_SIZE / 2;
+    QList<qint64> ids = m_cache.keys();
+    std::sort(ids.begin(), ids.end(), [this, windowCenter](qint64 a, qint64 b) {
+        return std::abs(static_cast<int>(m_shotIds.indexOf(a)) - windowCenter)
+             > std::abs(static_cast<int>(m_shotIds.indexOf(b)) - windowCenter);
+    });
+    for (int i = 0; i < ids.size() && m_cache.size() > MAX_CACHED_SHOTS; ++i) {
+        m_cache.remove(ids[i]);
+    }
+}
+
+void ShotComparisonModel::setLoading(bool loading)
+{
+    if (m_loading == loading) return;
+    m_loading = loading;
+    emit loadingChanged();
+}
+
+ShotComparisonModel::ComparisonShot ShotComparisonModel::fromRecord(const ShotRecord& record)
+{
+    ComparisonShot shot;
+    shot.id = record.summary.id;
+    shot.profileName = record.summary.profileName;
+    shot.beanBrand = record.summary.beanBrand;
+    shot.beanType = record.summary.beanType;
+    shot.roastDate = record.roastDate;
+    shot.roastLevel = record.roastLevel;
+    shot.grinderModel = record.grinderModel;
+    shot.grinderSetting = record.grinderSetting;
+    shot.duration = record.summary.duration;
+    shot.doseWeight = record.summary.doseWeight;
+    shot.finalWeight = record.summary.finalWeight;
+    shot.drinkTds = record.drinkTds;
+    shot.drinkEy = record.drinkEy;
+    shot.enjoyment = record.summary.enjoyment;
+    shot.timestamp = record.summary.timestamp;
+    shot.notes = record.espressoNotes;
+    shot.barista = record.barista;
+
+    shot.curves.resize(CURVE_COUNT);
+    shot.curves[CURVE_PRESSURE] = ResampleCurve::fromPoints(record.pressure);
+    shot.curves[CURVE_FLOW] = ResampleCurve::fromPoints(record.flow);
+    shot.curves[CURVE_TEMPERATURE] = ResampleCurve::fromPoints(record.temperature);
+    shot.curves[CURVE_WEIGHT] = ResampleCurve::fromPoints(record.weight);
+
+    for (const auto& pt : record.pressure) shot.peakPressure = std::max(shot.peakPressure, pt.y());
+    for (const auto& pt : record.flow) shot.peakFlow = std::max(shot.peakFlow, pt.y());
+    for (const auto& pt : record.weight) shot.peakWeight = std::max(shot.peakWeight, pt.y());
+
+    for (const auto& phase : record.phases) {
+        ComparisonShot::PhaseMarker marker;
+        marker.time = phase.time;
+        marker.label = phase.label;
+        marker.frameNumber = phase.frameNumber;
+        shot.phases.append(marker);
+    }
+
+    return shot;
+}
+
+void ShotComparisonModel::calculateMaxValues()
+{
+    m_maxTime = 0.0;
+    m_maxPressure = 12.0;
+    m_maxFlow = 8.0;
+    m_maxWeight = 50.0;
+
+    // Peaks are cached per shot, so this is O(shots) - headroom above the highest peak
+    for (int i = 0; i < m_displayShots.size(); ++i) {
+        const auto& shot = m_displayShots[i];
+        double offset = i < m_alignedShots.size() ? m_alignedShots[i].offset : 0.0;
+        m_maxTime = std::max(m_maxTime, shot.duration - offset);
+        if (shot.peakPressure > m_maxPressure) m_maxPressure = shot.peakPressure + 2.0;
+        if (shot.peakFlow > m_maxFlow) m_maxFlow = shot.peakFlow + 1.0;
+        if (shot.peakWeight > m_maxWeight) m_maxWeight = shot.peakWeight + 10.0;
+    }
 }
 
 QVariantList ShotComparisonModel::pointsToVariant(const QVector<QPointF>& points) const
@@ -232,35 +405,41 @@ QVariantList ShotComparisonModel::pointsToVariant(const QVector<QPointF>& points
 QVariantList ShotComparisonModel::getPressureData(int index) const
 {
     if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].pressure);
+    if (index >= m_alignedShots.size()) return QVariantList();
+    return pointsToVariant(m_alignedShots[index].curves[CURVE_PRESSURE]);
 }
 
 QVariantList ShotComparisonModel::getFlowData(int index) const
 {
     if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].flow);
+    if (index >= m_alignedShots.size()) return QVariantList();
+    return pointsToVariant(m_alignedShots[index].curves[CURVE_FLOW]);
 }
 
 QVariantList ShotComparisonModel::getTemperatureData(int index) const
 {
     if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].temperature);
+    if (index >= m_alignedShots.size()) return QVariantList();
+    return pointsToVariant(m_alignedShots[index].curves[CURVE_TEMPERATURE]);
 }
 
 QVariantList ShotComparisonModel::getWeightData(int index) const
 {
     if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].weight);
+    if (index >= m_alignedShots.size()) return QVariantList();
+    return pointsToVariant(m_alignedShots[index].curves[CURVE_WEIGHT]);
 }
 
 QVariantList ShotComparisonModel::getPhaseMarkers(int index) const
 {
     if (index < 0 || index >= m_displayShots.size()) return QVariantList();
 
+    // Marker times follow the curve alignment
+    double offset = index < m_alignedShots.size() ? m_alignedShots[index].offset : 0.0;
     QVariantList result;
     for (const auto& phase : m_displayShots[index].phases) {
         QVariantMap p;
-        p["time"] = phase.time;
+        p["time"] = phase.time - offset;
         p["label"] = phase.label;
         result.append(p);
     }
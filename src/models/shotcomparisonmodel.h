@@ -5,17 +5,24 @@
 #include <QPointF>
 #include <QVariantList>
 #include <QColor>
+#include <QHash>
+#include <QSet>
+#include <QThreadPool>
+#include "curveresampler.h"
 
 class ShotHistoryStorage;
 struct ShotRecord;
 
-// Model for comparing shots with sliding window display (shows 3 at a time)
+// Model for comparing shots with sliding window display (shows 3 at a time).
+// Shots are loaded and decompressed on a worker thread; the shots either side of
+// the window are prefetched so shifting the window is served from the cache.
 class ShotComparisonModel : public QObject {
     Q_OBJECT
 
     // Display window properties (shows max 3 shots at a time)
     Q_PROPERTY(int shotCount READ displayShotCount NOTIFY shotsChanged)
     Q_PROPERTY(QVariantList shots READ shotsVariant NOTIFY shotsChanged)
+    Q_PROPERTY(double minTime READ minTime NOTIFY shotsChanged)
     Q_PROPERTY(double maxTime READ maxTime NOTIFY shotsChanged)
     Q_PROPERTY(double maxPressure READ maxPressure NOTIFY shotsChanged)
     Q_PROPERTY(double maxFlow READ maxFlow NOTIFY shotsChanged)
@@ -26,9 +33,22 @@ class ShotComparisonModel : public QObject {
     Q_PROPERTY(int totalShots READ totalShots NOTIFY shotsChanged)
     Q_PROPERTY(bool canShiftLeft READ canShiftLeft NOTIFY windowChanged)
     Q_PROPERTY(bool canShiftRight READ canShiftRight NOTIFY windowChanged)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+
+    // Curve alignment (curves are resampled onto a common time grid)
+    Q_PROPERTY(AlignMode alignMode READ alignMode WRITE setAlignMode NOTIFY alignmentChanged)
+    Q_PROPERTY(QString alignPhase READ alignPhase WRITE setAlignPhase NOTIFY alignmentChanged)
 
 public:
+    enum class AlignMode {
+        Start,        // t = 0 is the start of each shot
+        FirstDrip,    // t = 0 is the first liquid in the cup
+        PhaseMarker   // t = 0 is a frame boundary (alignPhase, or the first frame change)
+    };
+    Q_ENUM(AlignMode)
+
     explicit ShotComparisonModel(QObject* parent = nullptr);
+    ~ShotComparisonModel();
 
     void setStorage(ShotHistoryStorage* storage);
 
@@ -38,6 +58,7 @@ public:
     int totalShots() const { return static_cast<int>(m_shotIds.size()); }
 
     QVariantList shotsVariant() const;
+    double minTime() const { return m_minTime; }
     double maxTime() const { return m_maxTime; }
     double maxPressure() const { return m_maxPressure; }
     double maxFlow() const { return m_maxFlow; }
@@ -47,6 +68,12 @@ public:
     int windowStart() const { return m_windowStart; }
     bool canShiftLeft() const { return m_windowStart > 0; }
     bool canShiftRight() const { return m_windowStart + DISPLAY_WINDOW_SIZE < static_cast<int>(m_shotIds.size()); }
+    bool isLoading() const { return m_loading; }
+
+    AlignMode alignMode() const { return m_alignMode; }
+    void setAlignMode(AlignMode mode);
+    QString alignPhase() const { return m_alignPhase; }
+    void setAlignPhase(const QString& label);
 
     // Add/remove shots to comparison (unlimited)
     Q_INVOKABLE bool addShot(qint64 shotId);
@@ -76,12 +103,24 @@ public:
 signals:
     void shotsChanged();
     void windowChanged();
+    void loadingChanged();
+    void alignmentChanged();
     void errorOccurred(const QString& message);
 
 private:
+    enum { CURVE_PRESSURE, CURVE_FLOW, CURVE_TEMPERATURE, CURVE_WEIGHT, CURVE_COUNT };
+    struct ComparisonShot;
+
     void loadDisplayWindow();
+    bool applyDisplayWindow();
+    void requestShots(const QList<qint64>& shotIds);
+    void onShotsLoaded(const QList<qint64>& requested, const QList<ComparisonShot>& shots);
+    void trimCache();
+    void setLoading(bool loading);
+    void alignDisplayShots();
     void calculateMaxValues();
     QVariantList pointsToVariant(const QVector<QPointF>& points) const;
+    static ComparisonShot fromRecord(const ShotRecord& record);
 
     struct ComparisonShot {
         qint64 id = 0;
@@ -102,29 +141,52 @@ private:
         QString notes;
         QString barista;
 
-        QVector<QPointF> pressure;
-        QVector<QPointF> flow;
-        QVector<QPointF> temperature;
-        QVector<QPointF> weight;
+        // Columnar curves in CURVE_* order, ready for the resampler
+        QVector<ResampleCurve> curves;
+
+        // Peaks, computed once on load so axis ranges are O(shots)
+        double peakPressure = 0;
+        double peakFlow = 0;
+        double peakWeight = 0;
 
         struct PhaseMarker {
             double time = 0;
             QString label;
+            int frameNumber = 0;
         };
         QList<PhaseMarker> phases;
     };
 
+    // Display shot resampled onto the common grid, alignment offset applied
+    struct AlignedShot {
+        double offset = 0;
+        QVector<QPointF> curves[CURVE_COUNT];
+    };
+
     ShotHistoryStorage* m_storage = nullptr;
     QList<qint64> m_shotIds;              // All selected shot IDs (chronological order)
     QList<ComparisonShot> m_displayShots; // Currently displayed shots (max 3)
+    QList<AlignedShot> m_alignedShots;    // Parallel to m_displayShots
+    AlignMode m_alignMode = AlignMode::Start;
+    QString m_alignPhase;
     int m_windowStart = 0;                // Start index in m_shotIds for display window
 
+    QHash<qint64, ComparisonShot> m_cache;  // Loaded shots (window + prefetched neighbours)
+    QSet<qint64> m_inFlight;                // Requested, not yet loaded
+    QSet<qint64> m_unavailable;             // Requested but not in the database
+    QThreadPool m_loader;                   // Single worker: requests complete in order
+    bool m_loading = false;
+
+    double m_minTime = 0.0;
     double m_maxTime = 60.0;
     double m_maxPressure = 12.0;
     double m_maxFlow = 8.0;
     double m_maxWeight = 50.0;
 
     static constexpr int DISPLAY_WINDOW_SIZE = 3;
+    static constexpr int PREFETCH_MARGIN = 2;     // Shots prefetched on each side of the window
+    static constexpr int MAX_CACHED_SHOTS = 16;
+    static constexpr double GRID_STEP = 0.1;      // Seconds between resampled points
     static const QList<QColor> SHOT_COLORS;
     static const QList<QColor> SHOT_COLORS_LIGHT;
 };
@@ -4,23 +4,14 @@
 ShotDataModel::ShotDataModel(QObject* parent)
     : QObject(parent)
 {
-    // Pre-allocate vectors to avoid reallocations during shot
-    m_pressurePoints.reserve(INITIAL_CAPACITY);
-    m_flowPoints.reserve(INITIAL_CAPACITY);
-    m_temperaturePoints.reserve(INITIAL_CAPACITY);
-    m_temperatureGoalPoints.reserve(INITIAL_CAPACITY);
-    m_weightPoints.reserve(INITIAL_CAPACITY);
-    m_cumulativeWeightPoints.reserve(INITIAL_CAPACITY);
-
-    // Initialize first segments for goal curves
-    m_pressureGoalSegments.append(QVector<QPointF>());
-    m_pressureGoalSegments[0].reserve(INITIAL_CAPACITY);
-    m_flowGoalSegments.append(QVector<QPointF>());
-    m_flowGoalSegments[0].reserve(INITIAL_CAPACITY);
-
-    // Backup timer for edge cases (main updates happen immediately on sample arrival)
+    // Pre-allocate columns to avoid reallocations during shot
+    m_samples.reserve(INITIAL_CAPACITY);
+
+    // Coalesce chart updates: the first change schedules a flush one frame later,
+    // anything arriving before then (pressure + weight + markers) rides along
     m_flushTimer = new QTimer(this);
     m_flushTimer->setInterval(FLUSH_INTERVAL_MS);
+    m_flushTimer->setSingleShot(true);
     m_flushTimer->setTimerType(Qt::PreciseTimer);
     connect(m_flushTimer, &QTimer::timeout, this, &ShotDataModel::flushToChart);
 }
@@ -68,6 +59,11 @@ void ShotDataModel::registerSeries(QLineSeries* pressure, QLineSeries* flow, QLi
         }
     }
 
+    // New series start empty - feeders rebuild them from the full data
+    m_pressureGoalFeeds = QVector<ChartFeeder>(m_pressureGoalSeriesList.size());
+    m_flowGoalFeeds = QVector<ChartFeeder>(m_flowGoalSeriesList.size());
+    setChartPixelWidth(m_pointBudget);
+
     // Enable OpenGL for hardware acceleration on main data series
     // Note: OpenGL causes rendering issues on:
     // - Windows debug builds
@@ -88,40 +84,50 @@ void ShotDataModel::registerSeries(QLineSeries* pressure, QLineSeries* flow, QLi
 
     // If we have existing data (e.g., viewing a just-completed shot on a new page),
     // immediately populate the new series with that data
-    if (!m_pressurePoints.isEmpty() || !m_flowPoints.isEmpty() || !m_weightPoints.isEmpty()) {
+    if (m_samples.sampleCount() > 0 || !m_samples.weight().isEmpty()) {
         qDebug() << "ShotDataModel: Populating new series with existing data ("
-                 << m_pressurePoints.size() << " pressure points,"
-                 << m_flowPoints.size() << " flow points,"
-                 << m_weightPoints.size() << " weight points)";
+                 << m_samples.sampleCount() << " samples,"
+                 << m_samples.weight().size() << " weight points)";
         m_dirty = true;
         flushToChart();
     }
+}
+
+void ShotDataModel::setChartPixelWidth(double pixels) {
+    m_pointBudget = qMax(ChartFeeder::MIN_BUDGET, qRound(pixels));
+    for (ChartFeeder* feed : {&m_pressureFeed, &m_flowFeed, &m_temperatureFeed,
+                              &m_temperatureGoalFeed, &m_weightFeed}) {
+        feed->setPointBudget(m_pointBudget);
+        feed->reset();
+    }
+    for (ChartFeeder& feed : m_pressureGoalFeeds) {
+        feed.setPointBudget(m_pointBudget);
+        feed.reset();
+    }
+    for (ChartFeeder& feed : m_flowGoalFeeds) {
+        feed.setPointBudget(m_pointBudget);
+        feed.reset();
+    }
+    m_dirty = true;
+    scheduleFlush();
+}
 
-    // Start the flush timer
-    m_flushTimer->start();
+void ShotDataModel::scheduleFlush() {
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
 }
 
 void ShotDataModel::clear() {
     // Stop timer during clear
     m_flushTimer->stop();
 
-    // Clear data vectors (keep capacity)
-    m_pressurePoints.clear();
-    m_flowPoints.clear();
-    m_temperaturePoints.clear();
-    m_temperatureGoalPoints.clear();
-    m_weightPoints.clear();
-    m_cumulativeWeightPoints.clear();
+    // Fresh sample store - views handed out for the previous shot stay valid
+    m_samples.clear();
+    m_samples.reserve(INITIAL_CAPACITY);
+    m_phaseStats.clear();
     m_pendingMarkers.clear();
 
-    // Reset goal segments - keep first segment with capacity
-    m_pressureGoalSegments.clear();
-    m_pressureGoalSegments.append(QVector<QPointF>());
-    m_pressureGoalSegments[0].reserve(INITIAL_CAPACITY);
-    m_flowGoalSegments.clear();
-    m_flowGoalSegments.append(QVector<QPointF>());
-    m_flowGoalSegments[0].reserve(INITIAL_CAPACITY);
-
     // Clear chart series
     if (m_pressureSeries) m_pressureSeries->clear();
     if (m_flowSeries) m_flowSeries->clear();
@@ -152,26 +158,29 @@ void ShotDataModel::clear() {
     m_rawTime = 0.0;
     m_lastPumpModeIsFlow = false;
     m_hasPumpModeData = false;
-    m_currentPressureGoalSegment = 0;
-    m_currentFlowGoalSegment = 0;
     m_dirty = false;
 
+    m_pressureFeed.reset();
+    m_flowFeed.reset();
+    m_temperatureFeed.reset();
+    m_temperatureGoalFeed.reset();
+    m_weightFeed.reset();
+    for (ChartFeeder& feed : m_pressureGoalFeeds) feed.reset();
+    for (ChartFeeder& feed : m_flowGoalFeeds) feed.reset();
+
     emit cleared();
     emit phaseMarkersChanged();
     emit maxTimeChanged();
     emit rawTimeChanged();
-
-    // Restart timer
-    m_flushTimer->start();
 }
 
 void ShotDataModel::clearWeightData() {
     // Clear any pre-tare weight samples (race condition fix)
-    m_weightPoints.clear();
-    m_cumulativeWeightPoints.clear();
+    m_samples.clearWeight();
     if (m_weightSeries) {
         m_weightSeries->clear();
     }
+    m_weightFeed.reset();
     qDebug() << "ShotDataModel: Cleared pre-tare weight data";
 }
 
@@ -180,38 +189,22 @@ void ShotDataModel::addSample(double time, double pressure, double flow, double
                               int frameNumber, bool isFlowMode) {
     Q_UNUSED(frameNumber);
 
-    // Pure vector append - no signals, no chart updates
-    m_pressurePoints.append(QPointF(time, pressure));
-    m_flowPoints.append(QPointF(time, flow));
-    m_temperaturePoints.append(QPointF(time, temperature));
-
     // Start new segments when pump mode changes (creates visual gap in goal curves)
     if (m_hasPumpModeData && isFlowMode != m_lastPumpModeIsFlow) {
         if (isFlowMode) {
             // Switching to flow mode: start new pressure goal segment
-            m_currentPressureGoalSegment++;
-            if (m_currentPressureGoalSegment >= m_pressureGoalSegments.size()) {
-                m_pressureGoalSegments.append(QVector<QPointF>());
-            }
+            m_samples.startPressureGoalSegment();
         } else {
             // Switching to pressure mode: start new flow goal segment
-            m_currentFlowGoalSegment++;
-            if (m_currentFlowGoalSegment >= m_flowGoalSegments.size()) {
-                m_flowGoalSegments.append(QVector<QPointF>());
-            }
+            m_samples.startFlowGoalSegment();
         }
     }
     m_lastPumpModeIsFlow = isFlowMode;
     m_hasPumpModeData = true;
 
-    // Add goal points to current segments
-    if (pressureGoal > 0) {
-        m_pressureGoalSegments[m_currentPressureGoalSegment].append(QPointF(time, pressureGoal));
-    }
-    if (flowGoal > 0) {
-        m_flowGoalSegments[m_currentFlowGoalSegment].append(QPointF(time, flowGoal));
-    }
-    m_temperatureGoalPoints.append(QPointF(time, temperatureGoal));
+    // Pure column append - no signals, no chart updates (goals > 0 join the current segment)
+    m_samples.appendSample(time, pressure, flow, temperature, pressureGoal, flowGoal, temperatureGoal);
+    m_phaseStats.addSample(time, pressure, flow, temperature, temperatureGoal);
 
     // Update raw time - QML uses this to calculate axis max with pixel-based padding
     if (time > m_rawTime) {
@@ -220,7 +213,7 @@ void ShotDataModel::addSample(double time, double pressure, double flow, double
     }
 
     m_dirty = true;
-    flushToChart();  // Immediate update for snappy feel
+    scheduleFlush();
 }
 
 void ShotDataModel::addWeightSample(double time, double weight, double flowRate) {
@@ -236,9 +229,10 @@ void ShotDataModel::addWeightSample(double time, double weight) {
 
     // Spike filtering: reject readings that jump unrealistically from the last value
     // Max reasonable flow is ~5g/s, so anything faster is likely a scale glitch
-    if (!m_weightPoints.isEmpty()) {
-        double lastWeight = m_weightPoints.last().y();
-        double lastTime = m_weightPoints.last().x();
+    if (m_samples.weightCount() > 0) {
+        const QPointF last = m_samples.lastWeight();
+        double lastWeight = last.y();
+        double lastTime = last.x();
         double deltaWeight = qAbs(weight - lastWeight);
         double deltaTime = time - lastTime;
 
@@ -257,18 +251,11 @@ void ShotDataModel::addWeightSample(double time, double weight) {
         }
     }
 
-    // Store cumulative weight for export (visualizer, shot history)
-    m_cumulativeWeightPoints.append(QPointF(time, weight));
-
-    // Add initial zero point when weight curve starts (so line starts from zero at correct time)
-    if (m_weightPoints.isEmpty()) {
-        m_weightPoints.append(QPointF(time, 0.0));
-    }
-
-    // Plot cumulative weight (g) - shows weight progression during shot (0g -> 36g typical)
-    m_weightPoints.append(QPointF(time, weight));
+    // Cumulative weight (g) - shows weight progression during shot (0g -> 36g typical).
+    // The store adds an initial zero point so the graph line starts from zero at the correct time.
+    m_samples.appendWeight(time, weight);
     m_dirty = true;
-    flushToChart();  // Immediate update for snappy feel
+    scheduleFlush();
     emit finalWeightChanged();  // For accessibility announcement
 }
 
@@ -280,8 +267,10 @@ void ShotDataModel::markExtractionStart(double time) {
     marker.label = "Start";
     marker.frameNumber = 0;
     m_phaseMarkers.append(marker);
+    m_phaseStats.addPhaseMarker(marker.time, marker.label, marker.frameNumber, marker.isFlowMode, m_samples);
 
     m_dirty = true;
+    scheduleFlush();
     emit phaseMarkersChanged();
 }
 
@@ -291,9 +280,10 @@ void ShotDataModel::markStopAt(double time) {
 
     // Find the weight at or just before the stop time
     m_weightAtStop = 0.0;
-    for (int i = m_weightPoints.size() - 1; i >= 0; --i) {
-        if (m_weightPoints[i].x() <= time) {
-            m_weightAtStop = m_weightPoints[i].y();
+    const SampleView weights = m_samples.weight();
+    for (qsizetype i = weights.size() - 1; i >= 0; --i) {
+        if (weights.time(i) <= time) {
+            m_weightAtStop = weights.value(i);
             break;
         }
     }
@@ -303,8 +293,10 @@ void ShotDataModel::markStopAt(double time) {
     marker.label = "End";
     marker.frameNumber = -1;
     m_phaseMarkers.append(marker);
+    m_phaseStats.addPhaseMarker(marker.time, marker.label, marker.frameNumber, marker.isFlowMode, m_samples);
 
     m_dirty = true;
+    scheduleFlush();
     emit phaseMarkersChanged();
     emit stopTimeChanged();
     emit weightAtStopChanged();
@@ -319,45 +311,40 @@ void ShotDataModel::addPhaseMarker(double time, const QString& label, int frameN
     marker.frameNumber = frameNumber;
     marker.isFlowMode = isFlowMode;
     m_phaseMarkers.append(marker);
+    m_phaseStats.addPhaseMarker(marker.time, marker.label, marker.frameNumber, marker.isFlowMode, m_samples);
 
     m_dirty = true;
+    scheduleFlush();
     emit phaseMarkersChanged();
 }
 
 void ShotDataModel::flushToChart() {
     if (!m_dirty) return;
 
-    // Batch update all series with replace() - single redraw per series
-    if (m_pressureSeries && !m_pressurePoints.isEmpty()) {
-        m_pressureSeries->replace(m_pressurePoints);
-    }
-    if (m_flowSeries && !m_flowPoints.isEmpty()) {
-        m_flowSeries->replace(m_flowPoints);
-    }
-    if (m_temperatureSeries && !m_temperaturePoints.isEmpty()) {
-        m_temperatureSeries->replace(m_temperaturePoints);
+    // Feed only what changed: tail appends, or one decimated replace() per series
+    if (m_samples.sampleCount() > 0) {
+        m_pressureFeed.sync(m_pressureSeries, m_samples.pressure());
+        m_flowFeed.sync(m_flowSeries, m_samples.flow());
+        m_temperatureFeed.sync(m_temperatureSeries, m_samples.temperature());
+        m_temperatureGoalFeed.sync(m_temperatureGoalSeries, m_samples.temperatureGoal());
     }
 
-    // Update pressure goal segments - each segment gets its own LineSeries
-    for (int i = 0; i < m_pressureGoalSegments.size() && i < m_pressureGoalSeriesList.size(); ++i) {
-        if (m_pressureGoalSeriesList[i] && !m_pressureGoalSegments[i].isEmpty()) {
-            m_pressureGoalSeriesList[i]->replace(m_pressureGoalSegments[i]);
+    // Goal segments - each segment gets its own LineSeries
+    for (int i = 0; i < m_samples.pressureGoalSegmentCount() && i < m_pressureGoalSeriesList.size(); ++i) {
+        SampleView segment = m_samples.pressureGoalSegment(i);
+        if (!segment.isEmpty()) {
+            m_pressureGoalFeeds[i].sync(m_pressureGoalSeriesList[i], segment);
         }
     }
-
-    // Update flow goal segments - each segment gets its own LineSeries
-    for (int i = 0; i < m_flowGoalSegments.size() && i < m_flowGoalSeriesList.size(); ++i) {
-        if (m_flowGoalSeriesList[i] && !m_flowGoalSegments[i].isEmpty()) {
-            m_flowGoalSeriesList[i]->replace(m_flowGoalSegments[i]);
+    for (int i = 0; i < m_samples.flowGoalSegmentCount() && i < m_flowGoalSeriesList.size(); ++i) {
+        SampleView segment = m_samples.flowGoalSegment(i);
+        if (!segment.isEmpty()) {
+            m_flowGoalFeeds[i].sync(m_flowGoalSeriesList[i], segment);
         }
     }
 
-    if (m_temperatureGoalSeries && !m_temperatureGoalPoints.isEmpty()) {
-        m_temperatureGoalSeries->replace(m_temperatureGoalPoints);
-    }
-    if (m_weightSeries && !m_weightPoints.isEmpty()) {
-        m_weightSeries->replace(m_weightPoints);
-    }
+    SampleView weights = m_samples.weight();
+    if (!weights.isEmpty()) m_weightFeed.sync(m_weightSeries, weights);
 
     // Process pending vertical markers
     for (const auto& marker : m_pendingMarkers) {
@@ -391,8 +378,9 @@ void ShotDataModel::flushToChart() {
 }
 
 double ShotDataModel::finalWeight() const {
-    if (m_weightPoints.isEmpty()) return 0.0;
-    return m_weightPoints.last().y();
+    const SampleView weights = m_samples.weight();
+    if (weights.isEmpty()) return 0.0;
+    return weights.last().y();
 }
 
 QVariantList ShotDataModel::phaseMarkersVariant() const {
@@ -408,21 +396,3 @@ QVariantList ShotDataModel::phaseMarkersVariant() const {
     }
     return result;
 }
-
-QVector<QPointF> ShotDataModel::pressureGoalData() const {
-    // Combine all segments for export
-    QVector<QPointF> combined;
-    for (const auto& segment : m_pressureGoalSegments) {
-        combined.append(segment);
-    }
-    return combined;
-}
-
-QVector<QPointF> ShotDataModel::flowGoalData() const {
-    // Combine all segments for export
-    QVector<QPointF> combined;
-    for (const auto& segment : m_flowGoalSegments) {
-        combined.append(segment);
-    }
-    return combined;
-}
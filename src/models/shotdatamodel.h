@@ -7,6 +7,9 @@
 #include <QPointer>
 #include <QVariantList>
 #include <QtCharts/QLineSeries>
+#include "chartfeeder.h"
+#include "shotsamplestore.h"
+#include "shotphasestats.h"
 
 struct PhaseMarker {
     double time;
@@ -44,15 +47,22 @@ public:
                                      QLineSeries* stopMarker,
                                      const QVariantList& frameMarkers);
 
-    // Data export for visualizer upload
-    const QVector<QPointF>& pressureData() const { return m_pressurePoints; }
-    const QVector<QPointF>& flowData() const { return m_flowPoints; }
-    const QVector<QPointF>& temperatureData() const { return m_temperaturePoints; }
-    QVector<QPointF> pressureGoalData() const;  // Combines all segments
-    QVector<QPointF> flowGoalData() const;      // Combines all segments
-    const QVector<QPointF>& temperatureGoalData() const { return m_temperatureGoalPoints; }
-    const QVector<QPointF>& weightData() const { return m_weightPoints; }  // Cumulative weight (g) for graph
-    const QVector<QPointF>& cumulativeWeightData() const { return m_cumulativeWeightPoints; }  // Cumulative weight for export
+    // Plot area width in pixels - bounds how many points each series draws
+    Q_INVOKABLE void setChartPixelWidth(double pixels);
+
+    // Data export (storage, visualizer upload, AI) - zero-copy views into the shared sample store
+    const ShotSampleStore& samples() const { return m_samples; }
+    SampleView pressureData() const { return m_samples.pressure(); }
+    SampleView flowData() const { return m_samples.flow(); }
+    SampleView temperatureData() const { return m_samples.temperature(); }
+    SampleView pressureGoalData() const { return m_samples.pressureGoal(); }  // All segments
+    SampleView flowGoalData() const { return m_samples.flowGoal(); }          // All segments
+    SampleView temperatureGoalData() const { return m_samples.temperatureGoal(); }
+    SampleView weightData() const { return m_samples.weight(); }  // Cumulative weight (g) for graph
+    SampleView cumulativeWeightData() const { return m_samples.cumulativeWeight(); }  // Cumulative weight for export
+
+    // Per-phase statistics, kept up to date as samples and markers arrive (AI summary)
+    const ShotPhaseStats& phaseStats() const { return m_phaseStats; }
 
 public slots:
     void clear();
@@ -81,15 +91,11 @@ private slots:
     void flushToChart();  // Called by timer - batched update to chart
 
 private:
-    // Data storage - fast vector appends
-    QVector<QPointF> m_pressurePoints;
-    QVector<QPointF> m_flowPoints;
-    QVector<QPointF> m_temperaturePoints;
-    QVector<QVector<QPointF>> m_pressureGoalSegments;  // Separate segments for clean breaks
-    QVector<QVector<QPointF>> m_flowGoalSegments;      // Separate segments for clean breaks
-    QVector<QPointF> m_temperatureGoalPoints;
-    QVector<QPointF> m_weightPoints;  // Cumulative weight (g) - for graphing
-    QVector<QPointF> m_cumulativeWeightPoints;  // Cumulative weight (g) - for export
+    void scheduleFlush();
+
+    // Data storage - columnar float32, goal segments as index ranges
+    ShotSampleStore m_samples;
+    ShotPhaseStats m_phaseStats;
 
     // Chart series pointers (QPointer auto-nulls when QML destroys them)
     QPointer<QLineSeries> m_pressureSeries;
@@ -103,7 +109,17 @@ private:
     QPointer<QLineSeries> m_stopMarkerSeries;
     QList<QPointer<QLineSeries>> m_frameMarkerSeries;
 
-    // Batched update timer (30fps)
+    // Per-series feeders: incremental append, LTTB decimation past the pixel budget
+    ChartFeeder m_pressureFeed;
+    ChartFeeder m_flowFeed;
+    ChartFeeder m_temperatureFeed;
+    QVector<ChartFeeder> m_pressureGoalFeeds;
+    QVector<ChartFeeder> m_flowGoalFeeds;
+    ChartFeeder m_temperatureGoalFeed;
+    ChartFeeder m_weightFeed;
+    int m_pointBudget = ChartFeeder::DEFAULT_BUDGET;
+
+    // Coalescing timer: samples arriving within one display frame share one redraw
     QTimer* m_flushTimer = nullptr;
     bool m_dirty = false;
 
@@ -112,8 +128,6 @@ private:
     int m_frameMarkerIndex = 0;
     bool m_lastPumpModeIsFlow = false;  // Track for starting new goal segments
     bool m_hasPumpModeData = false;     // True after first sample with pump mode
-    int m_currentPressureGoalSegment = 0;  // Current segment index
-    int m_currentFlowGoalSegment = 0;      // Current segment index
 
     // Phase markers for QML labels
     QList<PhaseMarker> m_phaseMarkers;
@@ -122,6 +136,6 @@ private:
     double m_stopTime = -1;          // Recorded stop time for accessibility
     double m_weightAtStop = 0.0;     // Weight when stop was triggered
 
-    static constexpr int FLUSH_INTERVAL_MS = 33;  // Backup timer; main updates are immediate on sample arrival
+    static constexpr int FLUSH_INTERVAL_MS = 16;  // ~One display frame at 60Hz
     static constexpr int INITIAL_CAPACITY = 600;  // Pre-allocate for 2min at 5Hz
 };
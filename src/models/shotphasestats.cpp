@@ -0,0 +1,217 @@
+#include "shotphasestats.h"
+#include "shotsamplestore.h"
+#include <QJsonArray>
+#include <algorithm>
+
+namespace {
+
+QJsonObject statsToJson(const RunningStats& stats) {
+    QJsonObject json;
+    json["count"] = stats.count;
+    json["mean"] = stats.mean;
+    json["m2"] = stats.m2;
+    json["min"] = stats.minimum();  // JSON has no infinity
+    json["max"] = stats.maximum();
+    return json;
+}
+
+RunningStats statsFromJson(const QJsonObject& json) {
+    RunningStats stats;
+    stats.count = json["count"].toInt();
+    if (stats.count > 0) {
+        stats.mean = json["mean"].toDouble();
+        stats.m2 = json["m2"].toDouble();
+        stats.min = json["min"].toDouble();
+        stats.max = json["max"].toDouble();
+    }
+    return stats;
+}
+
+QJsonObject phaseToJson(const PhaseStats& phase) {
+    QJsonObject json;
+    json["startTime"] = phase.startTime;
+    json["label"] = phase.label;
+    json["frameNumber"] = phase.frameNumber;
+    json["isFlowMode"] = phase.isFlowMode;
+    json["pressure"] = statsToJson(phase.pressure);
+    json["flow"] = statsToJson(phase.flow);
+    json["temperature"] = statsToJson(phase.temperature);
+    return json;
+}
+
+PhaseStats phaseFromJson(const QJsonObject& json) {
+    PhaseStats phase;
+    phase.startTime = json["startTime"].toDouble();
+    phase.label = json["label"].toString();
+    phase.frameNumber = json["frameNumber"].toInt(-1);
+    phase.isFlowMode = json["isFlowMode"].toBool();
+    phase.pressure = statsFromJson(json["pressure"].toObject());
+    phase.flow = statsFromJson(json["flow"].toObject());
+    phase.temperature = statsFromJson(json["temperature"].toObject());
+    return phase;
+}
+
+// Times as ShotSampleStore keeps them (float32). Live samples arrive as double
+// but replay() reads the stored column, and boundary checks compare sample and
+// marker times exactly, so both paths must see the same values.
+double storedTime(double time) {
+    return static_cast<float>(time);
+}
+
+}  // namespace
+
+void ShotPhaseStats::clear() {
+    m_phases.clear();
+    resetStats();
+}
+
+QJsonObject ShotPhaseStats::toJson() const {
+    QJsonArray phases;
+    for (const PhaseStats& phase : m_phases) {
+        phases.append(phaseToJson(phase));
+    }
+
+    QJsonObject json;
+    json["version"] = 1;
+    json["phases"] = phases;
+    json["wholeShot"] = phaseToJson(m_wholeShot);
+    json["temperatureGoalDeviation"] = statsToJson(m_tempGoalDeviation);
+    json["lastSampleTime"] = sampleCount() > 0 ? m_last.time : 0.0;
+    json["timeToFirstDrip"] = m_firstDripTime;
+    json["lastFlowSpikeTime"] = m_lastSpikeTime;
+    return json;
+}
+
+ShotPhaseStats ShotPhaseStats::fromJson(const QJsonObject& json) {
+    ShotPhaseStats stats;
+    for (const QJsonValue& phase : json["phases"].toArray()) {
+        stats.m_phases.append(phaseFromJson(phase.toObject()));
+    }
+    std::stable_sort(stats.m_phases.begin(), stats.m_phases.end(),
+                     [](const PhaseStats& a, const PhaseStats& b) { return a.startTime < b.startTime; });
+    stats.m_openPhases = static_cast<int>(stats.m_phases.size());
+
+    stats.m_wholeShot = phaseFromJson(json["wholeShot"].toObject());
+    stats.m_tempGoalDeviation = statsFromJson(json["temperatureGoalDeviation"].toObject());
+    if (stats.sampleCount() > 0) {
+        stats.m_last.time = json["lastSampleTime"].toDouble();
+    }
+    stats.m_firstDripTime = json["timeToFirstDrip"].toDouble();
+    stats.m_dripped = stats.m_firstDripTime > 0;
+    stats.m_lastSpikeTime = json["lastFlowSpikeTime"].toDouble(-1);
+    return stats;
+}
+
+void ShotPhaseStats::resetStats() {
+    for (PhaseStats& phase : m_phases) {
+        phase.pressure = RunningStats();
+        phase.flow = RunningStats();
+        phase.temperature = RunningStats();
+    }
+    m_openPhases = 0;
+    m_wholeShot = PhaseStats();
+    m_tempGoalDeviation = RunningStats();
+    m_last = Sample();
+    m_firstDripTime = 0;
+    m_dripped = false;
+    m_lastSpikeTime = -1;
+}
+
+void ShotPhaseStats::addSample(double time, double pressure, double flow, double temperature,
+                               double temperatureGoal) {
+    time = storedTime(time);
+    const int index = m_wholeShot.pressure.count;
+    const Sample sample{time, pressure, flow, temperature};
+
+    m_wholeShot.pressure.add(pressure);
+    m_wholeShot.flow.add(flow);
+    m_wholeShot.temperature.add(temperature);
+    addToCurrentPhase(sample);
+
+    if (temperatureGoal > 0) {
+        m_tempGoalDeviation.add(std::abs(temperature - temperatureGoal));
+    }
+
+    if (!m_dripped && flow >= FIRST_DRIP_FLOW) {
+        m_dripped = true;
+        m_firstDripTime = time;
+    }
+
+    // A sample is checked for a spike once SPIKE_LOOKBACK samples follow it
+    m_ringTime[index % RING_SIZE] = time;
+    m_ringFlow[index % RING_SIZE] = flow;
+    if (index >= 2 * SPIKE_LOOKBACK) {
+        const int candidate = index - SPIKE_LOOKBACK;
+        const double before = m_ringFlow[(candidate - SPIKE_LOOKBACK) % RING_SIZE];
+        const double current = m_ringFlow[candidate % RING_SIZE];
+        if (before > FIRST_DRIP_FLOW && current > before * SPIKE_RATIO) {
+            m_lastSpikeTime = m_ringTime[candidate % RING_SIZE];
+        }
+    }
+
+    m_last = sample;
+}
+
+void ShotPhaseStats::addPhaseMarker(double time, const QString& label, int frameNumber, bool isFlowMode,
+                                    const ShotSampleStore& samples) {
+    time = storedTime(time);
+    PhaseStats phase;
+    phase.startTime = time;
+    phase.label = label;
+    phase.frameNumber = frameNumber;
+    phase.isFlowMode = isFlowMode;
+
+    // replay() walks the phases in start order; equal start times keep arrival order
+    auto at = std::upper_bound(m_phases.begin(), m_phases.end(), time,
+                               [](double t, const PhaseStats& p) { return t < p.startTime; });
+    const bool last = at == m_phases.end();
+    m_phases.insert(at, phase);
+
+    if (!last || time < m_last.time) {
+        // Samples after the marker already went to another phase
+        replay(samples);
+        return;
+    }
+
+    m_openPhases = static_cast<int>(m_phases.size());
+    if (m_last.time == time) {
+        addToCurrentPhase(m_last);  // On the boundary: counts towards both phases
+    }
+}
+
+void ShotPhaseStats::addToCurrentPhase(const Sample& sample) {
+    if (m_openPhases == 0) return;
+
+    PhaseStats& phase = m_phases[m_openPhases - 1];
+    phase.pressure.add(sample.pressure);
+    phase.flow.add(sample.flow);
+    phase.temperature.add(sample.temperature);
+}
+
+void ShotPhaseStats::replay(const ShotSampleStore& samples) {
+    resetStats();
+
+    const SampleView pressure = samples.pressure();
+    const SampleView flow = samples.flow();
+    const SampleView temperature = samples.temperature();
+    const SampleView temperatureGoal = samples.temperatureGoal();
+    const float* time = pressure.timeData();
+
+    auto openNextPhase = [this]() {
+        ++m_openPhases;
+        if (m_last.time == m_phases[m_openPhases - 1].startTime) {
+            addToCurrentPhase(m_last);
+        }
+    };
+
+    for (qsizetype i = 0; i < pressure.size(); ++i) {
+        while (m_openPhases < m_phases.size() && m_phases[m_openPhases].startTime < time[i]) {
+            openNextPhase();
+        }
+        addSample(time[i], pressure.valueData()[i], flow.valueData()[i], temperature.valueData()[i],
+                  temperatureGoal.valueData()[i]);
+    }
+    while (m_openPhases < m_phases.size()) {
+        openNextPhase();
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include <array>
+#include <cmath>
+#include <limits>
+
+class ShotSampleStore;
+
+/**
+ * Running mean/variance (Welford) and extrema of one channel.
+ */
+struct RunningStats {
+    int count = 0;
+    double mean = 0;
+    double m2 = 0;  // Sum of squared deviations from the mean
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double value) {
+        ++count;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        if (value < min) min = value;
+        if (value > max) max = value;
+    }
+
+    // 0 when there are no samples
+    double minimum() const { return count > 0 ? min : 0; }
+    double maximum() const { return count > 0 ? max : 0; }
+    double stdDev() const { return count > 1 ? std::sqrt(m2 / (count - 1)) : 0; }  // Sample std deviation
+};
+
+struct PhaseStats {
+    double startTime = 0;
+    QString label;
+    int frameNumber = -1;
+    bool isFlowMode = false;
+
+    RunningStats pressure;
+    RunningStats flow;
+    RunningStats temperature;
+};
+
+/**
+ * Per-phase statistics of a shot, updated as each sample and phase marker
+ * arrives, so a summary is ready the moment the shot ends without rescanning
+ * the curves once per phase.
+ *
+ * A phase runs from its marker to the next one; a sample exactly on a marker
+ * counts towards both phases. Samples before the first marker only count
+ * towards wholeShot(). A marker for a time that has already been recorded
+ * (markers added after the samples) replays the recorded samples. Times are
+ * kept at the store's float32 precision, so a replay gives the same result
+ * as the live run.
+ */
+class ShotPhaseStats {
+public:
+    static constexpr double FIRST_DRIP_FLOW = 0.5;  // mL/s - when we consider "drip" has started
+    static constexpr int SPIKE_LOOKBACK = 5;        // Samples between the flows compared for a spike
+    static constexpr double SPIKE_RATIO = 1.5;      // Flow increase that counts as a spike
+
+    void clear();
+
+    // What a summary reads, saved with the shot (ShotHistoryStorage). A restored
+    // object is for reading: the spike ring isn't saved, so feeding it more
+    // samples continues the averages but not spike detection.
+    QJsonObject toJson() const;
+    static ShotPhaseStats fromJson(const QJsonObject& json);
+
+    void addSample(double time, double pressure, double flow, double temperature, double temperatureGoal);
+    // samples: everything recorded so far, replayed if the marker is late or
+    // lands before a marker already added
+    void addPhaseMarker(double time, const QString& label, int frameNumber, bool isFlowMode,
+                        const ShotSampleStore& samples);
+
+    int sampleCount() const { return m_wholeShot.pressure.count; }
+    double lastSampleTime() const { return m_last.time; }
+
+    const QVector<PhaseStats>& phases() const { return m_phases; }  // By start time
+    const PhaseStats& wholeShot() const { return m_wholeShot; }
+
+    // |temperature - goal| over samples with a goal
+    const RunningStats& temperatureGoalDeviation() const { return m_tempGoalDeviation; }
+
+    // First time flow reached FIRST_DRIP_FLOW, 0 if it never did
+    double timeToFirstDrip() const { return m_firstDripTime; }
+
+    // Time of the latest sudden flow increase (over SPIKE_RATIO within SPIKE_LOOKBACK
+    // samples, from above FIRST_DRIP_FLOW), -1 if none. The last SPIKE_LOOKBACK samples
+    // of the shot are never flagged.
+    double lastFlowSpikeTime() const { return m_lastSpikeTime; }
+
+private:
+    struct Sample {
+        double time = -std::numeric_limits<double>::infinity();
+        double pressure = 0;
+        double flow = 0;
+        double temperature = 0;
+    };
+
+    void resetStats();
+    void addToCurrentPhase(const Sample& sample);
+    void replay(const ShotSampleStore& samples);
+
+    QVector<PhaseStats> m_phases;
+    PhaseStats m_wholeShot;
+    RunningStats m_tempGoalDeviation;
+    Sample m_last;
+    int m_openPhases = 0;  // Phases receiving samples (replay opens them one at a time)
+
+    double m_firstDripTime = 0;
+    bool m_dripped = false;
+    double m_lastSpikeTime = -1;
+
+    // Last 2 * SPIKE_LOOKBACK + 1 samples for spike detection
+    static constexpr int RING_SIZE = 16;
+    std::array<double, RING_SIZE> m_ringTime {};
+    std::array<double, RING_SIZE> m_ringFlow {};
+};
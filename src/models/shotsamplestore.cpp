@@ -0,0 +1,118 @@
+#include "shotsamplestore.h"
+
+SampleView SampleView::mid(qsizetype pos, qsizetype length) const {
+    pos = qBound(qsizetype(0), pos, m_size);
+    qsizetype available = m_size - pos;
+    if (length < 0 || length > available) length = available;
+    if (m_rows) {
+        return SampleView(m_data, m_time, m_value, m_rows + pos, length);
+    }
+    return SampleView(m_data, m_time + pos, m_value + pos, nullptr, length);
+}
+
+QVector<QPointF> SampleView::toPoints() const {
+    QVector<QPointF> points;
+    points.reserve(m_size);
+    for (qsizetype i = 0; i < m_size; ++i) {
+        points.append(at(i));
+    }
+    return points;
+}
+
+ShotSampleStore::ShotSampleStore()
+    : d(new ShotSampleData)
+{
+    d->pressureGoalSegments.append(0);
+    d->flowGoalSegments.append(0);
+}
+
+void ShotSampleStore::clear() {
+    // Fresh data block: outstanding views keep the previous shot alive
+    d.reset(new ShotSampleData);
+    d->pressureGoalSegments.append(0);
+    d->flowGoalSegments.append(0);
+}
+
+void ShotSampleStore::reserve(int samples) {
+    for (QVector<float>* column : {&d->time, &d->pressure, &d->flow, &d->temperature,
+                                   &d->pressureGoal, &d->flowGoal, &d->temperatureGoal,
+                                   &d->weightTime, &d->weight}) {
+        column->reserve(samples);
+    }
+    d->pressureGoalRows.reserve(samples);
+    d->flowGoalRows.reserve(samples);
+}
+
+void ShotSampleStore::appendSample(double time, double pressure, double flow, double temperature,
+                                   double pressureGoal, double flowGoal, double temperatureGoal) {
+    ShotSampleData* data = d.data();  // Detach once, not per column
+    int row = data->time.size();
+    data->time.append(static_cast<float>(time));
+    data->pressure.append(static_cast<float>(pressure));
+    data->flow.append(static_cast<float>(flow));
+    data->temperature.append(static_cast<float>(temperature));
+    data->pressureGoal.append(static_cast<float>(pressureGoal));
+    data->flowGoal.append(static_cast<float>(flowGoal));
+    data->temperatureGoal.append(static_cast<float>(temperatureGoal));
+
+    // Goals are only plotted while their pump mode is active (goal > 0)
+    if (pressureGoal > 0) data->pressureGoalRows.append(row);
+    if (flowGoal > 0) data->flowGoalRows.append(row);
+}
+
+void ShotSampleStore::startPressureGoalSegment() {
+    d->pressureGoalSegments.append(d->pressureGoalRows.size());
+}
+
+void ShotSampleStore::startFlowGoalSegment() {
+    d->flowGoalSegments.append(d->flowGoalRows.size());
+}
+
+void ShotSampleStore::appendWeight(double time, double weight) {
+    ShotSampleData* data = d.data();
+    if (data->weight.isEmpty()) {
+        // Line starts from zero at the time of the first reading
+        data->weightTime.append(static_cast<float>(time));
+        data->weight.append(0.0f);
+    }
+    data->weightTime.append(static_cast<float>(time));
+    data->weight.append(static_cast<float>(weight));
+}
+
+void ShotSampleStore::clearWeight() {
+    d->weightTime.clear();
+    d->weight.clear();
+}
+
+SampleView ShotSampleStore::column(const QVector<float>& values) const {
+    return SampleView(d, d->time.constData(), values.constData(), nullptr, values.size());
+}
+
+SampleView ShotSampleStore::goal(const QVector<float>& values, const QVector<int>& rows,
+                                 qsizetype from, qsizetype to) const {
+    return SampleView(d, d->time.constData(), values.constData(), rows.constData() + from, to - from);
+}
+
+SampleView ShotSampleStore::segment(const QVector<float>& values, const QVector<int>& rows,
+                                    const QVector<int>& segments, int index) const {
+    if (index < 0 || index >= segments.size()) return SampleView();
+    qsizetype from = segments[index];
+    qsizetype to = (index + 1 < segments.size()) ? segments[index + 1] : rows.size();
+    return goal(values, rows, from, to);
+}
+
+SampleView ShotSampleStore::pressureGoalSegment(int index) const {
+    return segment(d->pressureGoal, d->pressureGoalRows, d->pressureGoalSegments, index);
+}
+
+SampleView ShotSampleStore::flowGoalSegment(int index) const {
+    return segment(d->flowGoal, d->flowGoalRows, d->flowGoalSegments, index);
+}
+
+SampleView ShotSampleStore::weight() const {
+    return SampleView(d, d->weightTime.constData(), d->weight.constData(), nullptr, d->weight.size());
+}
+
+SampleView ShotSampleStore::cumulativeWeight() const {
+    return weight().mid(1);
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QVector>
+#include <QPointF>
+#include <QtGlobal>
+#include <iterator>
+
+/**
+ * Columnar storage for one shot's samples.
+ *
+ * DE1 samples share a single float32 time column; each channel is a parallel
+ * float32 column (8 bytes per point for pressure/flow/temperature together
+ * instead of 16 bytes per point per channel). Goal curves only exist while
+ * their pump mode is active, so they are stored as row indices into the time
+ * column plus segment start offsets (a new segment starts on each pump mode
+ * switch, giving clean breaks in the chart). Scale weights arrive on their
+ * own schedule and have their own time column.
+ *
+ * ShotSampleStore is implicitly shared: copies and SampleViews are reference
+ * counted snapshots. Storage, upload and AI code read views without copying;
+ * if the shot is still recording, the writer detaches on its next append.
+ */
+struct ShotSampleData : public QSharedData {
+    QVector<float> time;
+    QVector<float> pressure;
+    QVector<float> flow;
+    QVector<float> temperature;
+    QVector<float> pressureGoal;
+    QVector<float> flowGoal;
+    QVector<float> temperatureGoal;
+
+    QVector<int> pressureGoalRows;       // Rows where a pressure goal was active
+    QVector<int> flowGoalRows;
+    QVector<int> pressureGoalSegments;   // Start offsets into pressureGoalRows
+    QVector<int> flowGoalSegments;
+
+    QVector<float> weightTime;           // Scale weight, first point is the zero baseline
+    QVector<float> weight;
+};
+
+/**
+ * Read-only (time, value) view of one channel. Behaves like a
+ * QVector<QPointF> for reading (size, operator[], first/last, range-for)
+ * but points into the shared columns.
+ */
+class SampleView {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = QPointF;
+        using difference_type = qsizetype;
+        using pointer = void;
+        using reference = QPointF;
+
+        const_iterator(const SampleView* view, qsizetype i) : m_view(view), m_i(i) {}
+        QPointF operator*() const { return m_view->at(m_i); }
+        const_iterator& operator++() { ++m_i; return *this; }
+        bool operator==(const const_iterator& o) const { return m_i == o.m_i; }
+        bool operator!=(const const_iterator& o) const { return m_i != o.m_i; }
+
+    private:
+        const SampleView* m_view;
+        qsizetype m_i;
+    };
+
+    SampleView() = default;
+
+    qsizetype size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    double time(qsizetype i) const { return m_time[row(i)]; }
+    double value(qsizetype i) const { return m_value[row(i)]; }
+    QPointF at(qsizetype i) const { return QPointF(time(i), value(i)); }
+    QPointF operator[](qsizetype i) const { return at(i); }
+    QPointF first() const { return at(0); }
+    QPointF last() const { return at(m_size - 1); }
+
+    // Raw float columns for tight loops; null when the view is indexed (goal curves)
+    const float* timeData() const { return m_rows ? nullptr : m_time; }
+    const float* valueData() const { return m_rows ? nullptr : m_value; }
+
+    SampleView mid(qsizetype pos, qsizetype length = -1) const;
+    QVector<QPointF> toPoints() const;
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+
+private:
+    friend class ShotSampleStore;
+    SampleView(const QSharedDataPointer<ShotSampleData>& data, const float* time, const float* value,
+               const int* rows, qsizetype size)
+        : m_data(data), m_time(time), m_value(value), m_rows(rows), m_size(size) {}
+
+    qsizetype row(qsizetype i) const { return m_rows ? m_rows[i] : i; }
+
+    QSharedDataPointer<ShotSampleData> m_data;  // Keeps the columns alive
+    const float* m_time = nullptr;
+    const float* m_value = nullptr;
+    const int* m_rows = nullptr;
+    qsizetype m_size = 0;
+};
+
+/**
+ * Columns are float32, so 9.1 widens to 9.100000381469727 when read as
+ * double. Writers (history JSON, visualizer upload) round to 1/1000 first:
+ * milliseconds for time, well below sensor resolution for the channels.
+ */
+inline double roundedSample(double value) { return qRound64(value * 1000.0) / 1000.0; }
+
+class ShotSampleStore {
+public:
+    ShotSampleStore();
+
+    void clear();
+    void reserve(int samples);
+
+    void appendSample(double time, double pressure, double flow, double temperature,
+                      double pressureGoal, double flowGoal, double temperatureGoal);
+    void startPressureGoalSegment();
+    void startFlowGoalSegment();
+
+    void appendWeight(double time, double weight);  // Adds the zero baseline before the first reading
+    void clearWeight();
+
+    qsizetype sampleCount() const { return d->time.size(); }
+
+    SampleView pressure() const { return column(d->pressure); }
+    SampleView flow() const { return column(d->flow); }
+    SampleView temperature() const { return column(d->temperature); }
+    SampleView temperatureGoal() const { return column(d->temperatureGoal); }
+
+    // Goal curves across all segments, and per segment
+    SampleView pressureGoal() const { return goal(d->pressureGoal, d->pressureGoalRows, 0, d->pressureGoalRows.size()); }
+    SampleView flowGoal() const { return goal(d->flowGoal, d->flowGoalRows, 0, d->flowGoalRows.size()); }
+    int pressureGoalSegmentCount() const { return d->pressureGoalSegments.size(); }
+    int flowGoalSegmentCount() const { return d->flowGoalSegments.size(); }
+    SampleView pressureGoalSegment(int index) const;
+    SampleView flowGoalSegment(int index) const;
+
+    SampleView weight() const;            // Graph curve: zero baseline + readings
+    SampleView cumulativeWeight() const;  // Readings only
+
+    // Latest weight point without taking a view (a live view makes the next append detach)
+    qsizetype weightCount() const { return d->weight.size(); }
+    QPointF lastWeight() const { return QPointF(d->weightTime.last(), d->weight.last()); }  // weightCount() > 0
+
+private:
+    SampleView column(const QVector<float>& values) const;
+    SampleView goal(const QVector<float>& values, const QVector<int>& rows, qsizetype from, qsizetype to) const;
+    SampleView segment(const QVector<float>& values, const QVector<int>& rows,
+                       const QVector<int>& segments, int index) const;
+
+    QSharedDataPointer<ShotSampleData> d;
+};
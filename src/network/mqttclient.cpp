@@ -10,6 +10,47 @@
 #include <QHostInfo>
 #include <QUuid>
 #include <QMutexLocker>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace {
+
+struct MetricSpec {
+    const char* topic;      // Per-metric topic under the base topic
+    const char* jsonKey;    // Key in the batched <base>/telemetry message
+    int decimals;
+    double deadband;        // Publish only when moved at least this far since the last publish
+};
+
+// Indexed by MqttClient::Metric
+const MetricSpec METRICS[] = {
+    { "temperature/head",  "temperature_head",  1, 0.2 },
+    { "temperature/mix",   "temperature_mix",   1, 0.2 },
+    { "temperature/steam", "temperature_steam", 1, 1.0 },
+    { "pressure",          "pressure",          2, 0.05 },
+    { "flow",              "flow",              2, 0.05 },
+    { "weight",            "weight",            1, 0.2 },
+    { "shot_time",         "shot_time",         1, 0.5 },
+    { "target_weight",     "target_weight",     1, 0.1 },
+    { "water_level",       "water_level",       0, 1.0 },
+    { "water_level_ml",    "water_level_ml",    0, 5.0 },
+};
+
+double roundTo(double value, int decimals)
+{
+    const double scale = std::pow(10.0, decimals);
+    return std::round(value * scale) / scale;
+}
+
+}  // namespace
 
 MqttClient::MqttClient(DE1Device* device, MachineState* machineState,
                        Settings* settings, QObject* parent)
@@ -18,15 +59,21 @@ MqttClient::MqttClient(DE1Device* device, MachineState* machineState,
     , m_machineState(machineState)
     , m_settings(settings)
 {
+    static_assert(sizeof(METRICS) / sizeof(METRICS[0]) == MetricCount, "METRICS must match Metric");
+    resetPublishedValues();
+
     // Connect internal signals for thread-safe callback handling
     connect(this, &MqttClient::internalConnected, this, &MqttClient::onInternalConnected, Qt::QueuedConnection);
     connect(this, &MqttClient::internalDisconnected, this, &MqttClient::onInternalDisconnected, Qt::QueuedConnection);
     connect(this, &MqttClient::internalConnectionFailed, this, &MqttClient::onInternalConnectionFailed, Qt::QueuedConnection);
     connect(this, &MqttClient::internalMessageReceived, this, &MqttClient::onInternalMessageReceived, Qt::QueuedConnection);
+    connect(this, &MqttClient::internalDeliveryComplete, this, &MqttClient::onInternalDeliveryComplete, Qt::QueuedConnection);
 
     // Connect data source signals
     if (m_machineState) {
         connect(m_machineState, &MachineState::phaseChanged, this, &MqttClient::onPhaseChanged);
+        connect(m_machineState, &MachineState::shotStarted, this, &MqttClient::onShotStarted);
+        connect(m_machineState, &MachineState::shotEnded, this, &MqttClient::onShotEnded);
     }
     if (m_device) {
         connect(m_device, &DE1Device::shotSampleReceived, this, &MqttClient::onShotSampleReceived);
@@ -42,6 +89,7 @@ MqttClient::MqttClient(DE1Device* device, MachineState* machineState,
         connect(m_settings, &Settings::mqttBrokerPortChanged, this, &MqttClient::onSettingsChanged);
         connect(m_settings, &Settings::mqttUsernameChanged, this, &MqttClient::onSettingsChanged);
         connect(m_settings, &Settings::mqttPasswordChanged, this, &MqttClient::onSettingsChanged);
+        connect(m_settings, &Settings::mqttJsonStateChanged, this, &MqttClient::onJsonStateChanged);
         connect(m_settings, &Settings::mqttPublishIntervalChanged, this, [this]() {
             if (m_publishTimer.isActive()) {
                 m_publishTimer.setInterval(m_settings->mqttPublishInterval());
@@ -57,6 +105,9 @@ MqttClient::MqttClient(DE1Device* device, MachineState* machineState,
     connect(&m_reconnectTimer, &QTimer::timeout, this, &MqttClient::attemptReconnect);
 
     m_status = "Disconnected";
+
+    // Events left over from the last run are replayed on the first connection
+    loadSpool();
 }
 
 MqttClient::~MqttClient()
@@ -80,6 +131,9 @@ MqttClient::~MqttClient()
         }
         MQTTAsync_destroy(&m_client);
     }
+
+    // Unacknowledged events survive the restart
+    spillQueue();
 }
 
 bool MqttClient::isConnected() const
@@ -162,7 +216,28 @@ void MqttClient::onSubscribeFailure(void* context, MQTTAsync_failureData* respon
     qWarning() << "MqttClient: Subscription failed -" << error;
 }
 
+void MqttClient::onSendSuccess(void* context, MQTTAsync_successData* response)
+{
+    MqttClient* self = static_cast<MqttClient*>(context);
+    emit self->internalDeliveryComplete(response ? response->token : 0, true);
+}
+
+void MqttClient::onSendFailure(void* context, MQTTAsync_failureData* response)
+{
+    MqttClient* self = static_cast<MqttClient*>(context);
+    emit self->internalDeliveryComplete(response ? response->token : 0, false);
+}
+
 void MqttClient::connectToBroker()
+{
+    m_userDisconnected = false;
+    m_reconnectAttempts = 0;
+    emit reconnectAttemptsChanged();
+
+    openConnection();
+}
+
+void MqttClient::openConnection()
 {
     if (!m_settings) {
         m_status = "Error: No settings";
@@ -186,8 +261,8 @@ void MqttClient::connectToBroker()
         m_client = nullptr;
     }
 
-    m_reconnectAttempts = 0;
-    emit reconnectAttemptsChanged();
+    // Tokens of the old client will never be acknowledged
+    requeueInFlight();
 
     // Build server URI
     int port = m_settings->mqttBrokerPort();
@@ -264,6 +339,7 @@ void MqttClient::connectToBroker()
 
 void MqttClient::disconnectFromBroker()
 {
+    m_userDisconnected = true;
     m_reconnectTimer.stop();
     m_publishTimer.stop();
     m_reconnectAttempts = 0;
@@ -303,6 +379,12 @@ void MqttClient::onInternalConnected()
     m_reconnectAttempts = 0;
     emit reconnectAttemptsChanged();
 
+    // Broker may have lost retained values - republish everything once
+    resetPublishedValues();
+
+    // Replay what was queued while offline before anything new
+    drainQueue();
+
     // Publish availability
     publishAvailability(true);
 
@@ -333,18 +415,18 @@ void MqttClient::onInternalDisconnected()
     }
 
     m_publishTimer.stop();
+    m_shotStreamBuffer = QJsonArray();
+    requeueInFlight();
     emit connectedChanged();
 
-    // Attempt reconnection if MQTT is still enabled
-    if (m_settings && m_settings->mqttEnabled() && m_reconnectAttempts < MAX_RECONNECT_ATTEMPTS) {
-        m_status = QString("Disconnected - reconnecting (%1/%2)...")
-            .arg(m_reconnectAttempts + 1)
-            .arg(MAX_RECONNECT_ATTEMPTS);
-        emit statusChanged();
-        m_reconnectTimer.start(RECONNECT_DELAY_MS);
-    } else if (m_reconnectAttempts >= MAX_RECONNECT_ATTEMPTS) {
-        m_status = "Disconnected - max retries reached";
+    // Keep trying for as long as MQTT is enabled; the queue holds events meanwhile
+    if (m_settings && m_settings->mqttEnabled() && !m_userDisconnected) {
+        const int delay = reconnectDelayMs();
+        m_status = QString("Disconnected - reconnecting in %1 s (attempt %2)...")
+            .arg(delay / 1000)
+            .arg(m_reconnectAttempts + 1);
         emit statusChanged();
+        m_reconnectTimer.start(delay);
     } else {
         m_status = "Disconnected";
         emit statusChanged();
@@ -365,11 +447,18 @@ void MqttClient::onInternalConnectionFailed(const QString& error)
     emit connectedChanged();
 
     // Attempt reconnection
-    if (m_settings && m_settings->mqttEnabled() && m_reconnectAttempts < MAX_RECONNECT_ATTEMPTS) {
-        m_reconnectTimer.start(RECONNECT_DELAY_MS);
+    if (m_settings && m_settings->mqttEnabled() && !m_userDisconnected) {
+        m_reconnectTimer.start(reconnectDelayMs());
     }
 }
 
+int MqttClient::reconnectDelayMs() const
+{
+    // 5 s, 10 s, 20 s, 40 s, then once a minute
+    const int doublings = qMin(m_reconnectAttempts, 4);
+    return qMin(RECONNECT_DELAY_MS << doublings, MAX_RECONNECT_DELAY_MS);
+}
+
 void MqttClient::onInternalMessageReceived(const QString& topic, const QString& payload)
 {
     qDebug() << "MqttClient: Received message on" << topic << ":" << payload;
@@ -443,8 +532,9 @@ void MqttClient::setCurrentProfile(const QString& profile)
 
         // Publish profile change
         if (isConnected() && profile != m_lastPublishedProfile) {
-            publish(topicPath("profile"), profile, true);
+            publish(topicPath("profile"), profile, true, MessageClass::State);
             m_lastPublishedProfile = profile;
+            m_jsonStateDirty = true;
             qDebug() << "MqttClient: Published profile change:" << profile;
         }
     }
@@ -459,9 +549,9 @@ void MqttClient::attemptReconnect()
     m_reconnectAttempts++;
     emit reconnectAttemptsChanged();
 
-    qDebug() << "MqttClient: Reconnection attempt" << m_reconnectAttempts << "of" << MAX_RECONNECT_ATTEMPTS;
+    qDebug() << "MqttClient: Reconnection attempt" << m_reconnectAttempts;
 
-    connectToBroker();
+    openConnection();
 }
 
 void MqttClient::onSettingsChanged()
@@ -482,31 +572,230 @@ QString MqttClient::topicPath(const QString& subtopic) const
     return baseTopic + "/" + subtopic;
 }
 
-void MqttClient::publish(const QString& topic, const QString& payload, bool retain)
+void MqttClient::publish(const QString& topic, const QString& payload, bool retain, MessageClass messageClass)
+{
+    if (!m_settings || !m_settings->mqttEnabled()) return;
+
+    OutboundMessage message;
+    message.topic = topic.toUtf8();
+    message.payload = payload.toUtf8();
+    message.qos = messageClass == MessageClass::Telemetry ? 0 : 1;
+    message.retained = retain && m_settings->mqttRetainMessages();
+
+    enqueue(message);
+    drainQueue();
+}
+
+void MqttClient::publishRaw(const QString& subtopic, const QString& payload, bool reliable)
+{
+    publish(topicPath(subtopic), payload, false, reliable ? MessageClass::Event : MessageClass::Telemetry);
+}
+
+void MqttClient::enqueue(const OutboundMessage& message)
+{
+    if (message.qos == 0) {
+        if (m_telemetryQueue.isFull()) {
+            m_telemetryQueue.popFront();
+            m_droppedMessages++;
+        }
+        m_telemetryQueue.push(message);
+        return;
+    }
+
+    // Oldest reliable message moves to the disk spool rather than being lost
+    if (m_reliableQueue.isFull()) {
+        spill(m_reliableQueue.front());
+        m_reliableQueue.popFront();
+    }
+    m_reliableQueue.push(message);
+}
+
+void MqttClient::drainQueue()
 {
-    if (!isConnected() || !m_client) return;
+    if (isConnected() && m_client) {
+        // QoS 1, oldest first: replayed/spooled messages, then the ring
+        while (m_inFlight.size() < MAX_IN_FLIGHT) {
+            if (m_replay.isEmpty() && m_spooledMessages > 0) {
+                loadSpool();
+            }
+
+            OutboundMessage message;
+            if (!m_replay.isEmpty()) {
+                message = m_replay.takeFirst();
+            } else if (!m_reliableQueue.isEmpty()) {
+                message = m_reliableQueue.front();
+                m_reliableQueue.popFront();
+            } else {
+                break;
+            }
+
+            if (!send(message)) {
+                m_replay.prepend(message);
+                break;
+            }
+        }
 
-    bool shouldRetain = retain && m_settings && m_settings->mqttRetainMessages();
+        // Telemetry doesn't wait for acknowledgements
+        while (!m_telemetryQueue.isEmpty()) {
+            if (!send(m_telemetryQueue.front())) {
+                m_droppedMessages++;
+            }
+            m_telemetryQueue.popFront();
+        }
+    }
 
-    QByteArray topicBytes = topic.toUtf8();
-    QByteArray payloadBytes = payload.toUtf8();
+    emit queueStatsChanged();
+}
 
+bool MqttClient::send(const OutboundMessage& message)
+{
     MQTTAsync_message msg = MQTTAsync_message_initializer;
-    msg.payload = payloadBytes.data();
-    msg.payloadlen = payloadBytes.length();
-    msg.qos = 0;
-    msg.retained = shouldRetain ? 1 : 0;
+    msg.payload = const_cast<char*>(message.payload.constData());
+    msg.payloadlen = message.payload.length();
+    msg.qos = message.qos;
+    msg.retained = message.retained ? 1 : 0;
+
+    if (message.qos == 0) {
+        return MQTTAsync_sendMessage(m_client, message.topic.constData(), &msg, nullptr) == MQTTASYNC_SUCCESS;
+    }
+
+    MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+    opts.onSuccess = onSendSuccess;
+    opts.onFailure = onSendFailure;
+    opts.context = this;
+
+    int rc = MQTTAsync_sendMessage(m_client, message.topic.constData(), &msg, &opts);
+    if (rc != MQTTASYNC_SUCCESS) {
+        qWarning() << "MqttClient: Send failed on" << message.topic << "- error" << rc;
+        return false;
+    }
+
+    // The callback is delivered queued, so it can't run before this insert
+    m_inFlight.insert(opts.token, message);
+    return true;
+}
+
+void MqttClient::onInternalDeliveryComplete(int token, bool success)
+{
+    auto it = m_inFlight.find(token);
+    if (it == m_inFlight.end()) return;  // Already requeued after a lost connection
+
+    OutboundMessage message = it.value();
+    m_inFlight.erase(it);
+
+    if (success) {
+        drainQueue();
+    } else {
+        // Resent with the next drain (reconnect or next publish), not in a tight loop
+        qWarning() << "MqttClient: Delivery failed on" << message.topic << "- requeued";
+        m_replay.prepend(message);
+        emit queueStatsChanged();
+    }
+}
+
+void MqttClient::requeueInFlight()
+{
+    if (m_inFlight.isEmpty()) return;
+
+    // Tokens increase with send order
+    QList<int> tokens = m_inFlight.keys();
+    std::sort(tokens.begin(), tokens.end(), std::greater<int>());
+    for (int token : tokens) {
+        m_replay.prepend(m_inFlight.take(token));
+    }
+    emit queueStatsChanged();
+}
+
+int MqttClient::queueDepth() const
+{
+    return static_cast<int>(m_replay.size() + m_reliableQueue.size() + m_telemetryQueue.size()
+                            + m_inFlight.size()) + m_spooledMessages;
+}
 
-    MQTTAsync_sendMessage(m_client, topicBytes.constData(), &msg, nullptr);
+QString MqttClient::spoolPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/mqtt_queue.dat";
+}
+
+void MqttClient::spill(const OutboundMessage& message)
+{
+    if (!m_settings || !m_settings->mqttPersistQueue()) {
+        m_droppedMessages++;
+        return;
+    }
+
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    QFile file(spoolPath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.size() >= MAX_SPOOL_BYTES) {
+        m_droppedMessages++;
+        return;
+    }
+
+    QDataStream out(&file);
+    out << message.topic << message.payload << static_cast<qint32>(message.qos) << message.retained;
+    m_spooledMessages++;
+}
+
+void MqttClient::spillQueue()
+{
+    // Keep the spool in order: whatever is already on disk goes back in first
+    requeueInFlight();
+    if (m_spooledMessages > 0) {
+        loadSpool();
+    }
+
+    QList<OutboundMessage> pending = m_replay;
+    m_replay.clear();
+    while (!m_reliableQueue.isEmpty()) {
+        pending.append(m_reliableQueue.front());
+        m_reliableQueue.popFront();
+    }
+
+    for (const OutboundMessage& message : pending) {
+        spill(message);
+    }
+    if (m_spooledMessages > 0) {
+        qDebug() << "MqttClient: Spooled" << m_spooledMessages << "unsent messages to disk";
+    }
+}
+
+void MqttClient::loadSpool()
+{
+    m_spooledMessages = 0;
+
+    QFile file(spoolPath());
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    QDataStream in(&file);
+    int loaded = 0;
+    while (!in.atEnd()) {
+        OutboundMessage message;
+        qint32 qos = 1;
+        in >> message.topic >> message.payload >> qos >> message.retained;
+        if (in.status() != QDataStream::Ok) break;
+        message.qos = qos;
+        m_replay.append(message);
+        loaded++;
+    }
+    file.close();
+    file.remove();
+
+    if (loaded > 0) {
+        qDebug() << "MqttClient: Loaded" << loaded << "spooled messages";
+    }
 }
 
 void MqttClient::publishAvailability(bool online)
 {
-    publish(topicPath("availability"), online ? "online" : "offline", true);
+    publish(topicPath("availability"), online ? "online" : "offline", true, MessageClass::State);
 }
 
 void MqttClient::onPhaseChanged()
 {
+    // Send the tail of the shot as soon as flow stops
+    if (m_machineState && !m_machineState->isFlowing()) {
+        flushShotStream();
+    }
     publishState();
 }
 
@@ -520,21 +809,82 @@ void MqttClient::onDE1ConnectedChanged()
     if (!isConnected()) return;
 
     bool connected = m_device && m_device->isConnected();
-    publish(topicPath("connected"), connected ? "true" : "false", true);
+    publish(topicPath("connected"), connected ? "true" : "false", true, MessageClass::State);
 }
 
-void MqttClient::onShotSampleReceived()
+void MqttClient::onShotSampleReceived(const ShotSample& sample)
 {
-    // During shots, publish at higher rate if needed
-    // The regular timer handles normal publishing
+    // The regular timer handles telemetry; this only feeds the shot stream
+    if (!m_settings || !m_settings->mqttShotStream() || !isConnected()) return;
+    if (!m_machineState || !m_machineState->isFlowing()) return;
+
+    // Packed as a positional array - field names are sent once per message
+    QJsonArray packed;
+    packed.append(roundTo(sample.timer, 2));
+    packed.append(roundTo(sample.groupPressure, 2));
+    packed.append(roundTo(sample.groupFlow, 2));
+    packed.append(roundTo(m_machineState->scaleWeight(), 1));
+    packed.append(roundTo(sample.mixTemp, 1));
+    packed.append(roundTo(sample.headTemp, 1));
+    packed.append(roundTo(sample.setPressureGoal, 1));
+    packed.append(roundTo(sample.setFlowGoal, 1));
+    packed.append(sample.frameNumber);
+    m_shotStreamBuffer.append(packed);
+
+    if (m_shotStreamBuffer.size() >= SHOT_STREAM_BATCH) {
+        flushShotStream();
+    }
 }
 
-void MqttClient::onWaterLevelChanged()
+void MqttClient::flushShotStream()
+{
+    if (m_shotStreamBuffer.isEmpty()) return;
+
+    static const QJsonArray fields = {
+        "time", "pressure", "flow", "weight", "mix_temp", "head_temp",
+        "pressure_goal", "flow_goal", "frame"
+    };
+
+    QJsonObject message;
+    message["fields"] = fields;
+    message["samples"] = m_shotStreamBuffer;
+    m_shotStreamBuffer = QJsonArray();
+
+    publish(topicPath("shot/stream"), QJsonDocument(message).toJson(QJsonDocument::Compact), false,
+            MessageClass::Telemetry);
+}
+
+void MqttClient::onShotStarted()
+{
+    QJsonObject event;
+    event["event"] = "start";
+    event["time"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    event["profile"] = m_currentProfile;
+    publish(topicPath("shot/event"), QJsonDocument(event).toJson(QJsonDocument::Compact), false,
+            MessageClass::Event);
+}
+
+void MqttClient::onShotEnded()
 {
-    if (!isConnected() || !m_device) return;
+    flushShotStream();
+
+    QJsonObject event;
+    event["event"] = "end";
+    event["time"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    event["profile"] = m_currentProfile;
+    if (m_machineState) {
+        event["duration"] = roundTo(m_machineState->shotTime(), 1);
+        event["weight"] = roundTo(m_machineState->scaleWeight(), 1);
+        event["target_weight"] = roundTo(m_machineState->targetWeight(), 1);
+    }
+    publish(topicPath("shot/event"), QJsonDocument(event).toJson(QJsonDocument::Compact), false,
+            MessageClass::Event);
+}
 
-    publish(topicPath("water_level"), QString::number(static_cast<int>(m_device->waterLevel())), true);
-    publish(topicPath("water_level_ml"), QString::number(m_device->waterLevelMl()), true);
+void MqttClient::onWaterLevelChanged()
+{
+    // Water level goes through the same deadbands as the rest of the telemetry
+    publishTelemetry();
 }
 
 void MqttClient::publishState()
@@ -547,40 +897,126 @@ void MqttClient::publishState()
 
     // Only publish if changed to reduce traffic
     if (state != m_lastPublishedState) {
-        publish(topicPath("state"), state, true);
+        publish(topicPath("state"), state, true, MessageClass::State);
         m_lastPublishedState = state;
+        m_jsonStateDirty = true;
     }
 
     if (phase != m_lastPublishedPhase) {
-        publish(topicPath("phase"), phase, true);
+        publish(topicPath("phase"), phase, true, MessageClass::State);
         m_lastPublishedPhase = phase;
+        m_jsonStateDirty = true;
     }
 
     // Publish profile if changed
     if (!m_currentProfile.isEmpty() && m_currentProfile != m_lastPublishedProfile) {
-        publish(topicPath("profile"), m_currentProfile, true);
+        publish(topicPath("profile"), m_currentProfile, true, MessageClass::State);
         m_lastPublishedProfile = m_currentProfile;
+        m_jsonStateDirty = true;
+    }
+
+    if (substate != m_lastPublishedSubstate) {
+        publish(topicPath("substate"), substate, true, MessageClass::State);
+        m_lastPublishedSubstate = substate;
+        m_jsonStateDirty = true;
     }
 
-    publish(topicPath("substate"), substate, true);
+    if (m_settings && m_settings->mqttJsonState() && m_jsonStateDirty) {
+        publishJsonState();
+    }
 }
 
 void MqttClient::publishTelemetry()
 {
     if (!isConnected()) return;
 
+    double values[MetricCount];
+    std::fill(values, values + MetricCount, std::numeric_limits<double>::quiet_NaN());
     if (m_device) {
-        publish(topicPath("temperature/head"), QString::number(m_device->temperature(), 'f', 1), true);
-        publish(topicPath("temperature/mix"), QString::number(m_device->mixTemperature(), 'f', 1), true);
-        publish(topicPath("temperature/steam"), QString::number(m_device->steamTemperature(), 'f', 1), true);
-        publish(topicPath("pressure"), QString::number(m_device->pressure(), 'f', 2), true);
-        publish(topicPath("flow"), QString::number(m_device->flow(), 'f', 2), true);
+        values[MetricHeadTemp] = m_device->temperature();
+        values[MetricMixTemp] = m_device->mixTemperature();
+        values[MetricSteamTemp] = m_device->steamTemperature();
+        values[MetricPressure] = m_device->pressure();
+        values[MetricFlow] = m_device->flow();
+        values[MetricWaterLevel] = static_cast<int>(m_device->waterLevel());
+        values[MetricWaterLevelMl] = m_device->waterLevelMl();
     }
-
     if (m_machineState) {
-        publish(topicPath("weight"), QString::number(m_machineState->scaleWeight(), 'f', 1), true);
-        publish(topicPath("shot_time"), QString::number(m_machineState->shotTime(), 'f', 1), true);
-        publish(topicPath("target_weight"), QString::number(m_machineState->targetWeight(), 'f', 1), true);
+        values[MetricWeight] = m_machineState->scaleWeight();
+        values[MetricShotTime] = m_machineState->shotTime();
+        values[MetricTargetWeight] = m_machineState->targetWeight();
+    }
+
+    const bool jsonState = m_settings && m_settings->mqttJsonState();
+    for (int i = 0; i < MetricCount; ++i) {
+        if (std::isnan(values[i])) continue;
+        if (!std::isnan(m_lastValues[i]) && std::abs(values[i] - m_lastValues[i]) < METRICS[i].deadband) {
+            continue;
+        }
+
+        m_lastValues[i] = values[i];
+        m_jsonStateDirty = true;
+        if (!jsonState) {
+            publish(topicPath(METRICS[i].topic), QString::number(values[i], 'f', METRICS[i].decimals), true,
+                    MessageClass::Telemetry);
+        }
+    }
+
+    if (jsonState && m_jsonStateDirty) {
+        publishJsonState();
+    }
+}
+
+void MqttClient::publishJsonState()
+{
+    QJsonObject state;
+    state["state"] = m_lastPublishedState;
+    state["substate"] = m_lastPublishedSubstate;
+    state["phase"] = m_lastPublishedPhase;
+    if (!m_lastPublishedProfile.isEmpty()) {
+        state["profile"] = m_lastPublishedProfile;
+    }
+    for (int i = 0; i < MetricCount; ++i) {
+        if (!std::isnan(m_lastValues[i])) {
+            state[METRICS[i].jsonKey] = roundTo(m_lastValues[i], METRICS[i].decimals);
+        }
+    }
+
+    publish(topicPath("telemetry"), QJsonDocument(state).toJson(QJsonDocument::Compact), true,
+            MessageClass::Telemetry);
+    m_jsonStateDirty = false;
+}
+
+void MqttClient::resetPublishedValues()
+{
+    std::fill(m_lastValues, m_lastValues + MetricCount, std::numeric_limits<double>::quiet_NaN());
+    m_lastPublishedState.clear();
+    m_lastPublishedPhase.clear();
+    m_lastPublishedProfile.clear();
+    m_lastPublishedSubstate.clear();
+    m_jsonStateDirty = true;
+}
+
+void MqttClient::onJsonStateChanged()
+{
+    if (!isConnected()) return;
+
+    // Sensors move between per-metric topics and <base>/telemetry
+    if (m_settings && m_settings->mqttHomeAssistantDiscovery()) {
+        publishHomeAssistantDiscovery();
+    }
+    resetPublishedValues();
+    publishState();
+    publishTelemetry();
+}
+
+void MqttClient::setMetricStateTopic(QJsonObject& config, const QString& baseTopic, int metric) const
+{
+    if (m_settings && m_settings->mqttJsonState()) {
+        config["state_topic"] = baseTopic + "/telemetry";
+        config["value_template"] = QString("{{ value_json.%1 }}").arg(METRICS[metric].jsonKey);
+    } else {
+        config["state_topic"] = baseTopic + "/" + METRICS[metric].topic;
     }
 }
 
@@ -609,7 +1045,7 @@ void MqttClient::publishDiscoveryConfig(const QString& component, const QString&
     QString topic = QString("homeassistant/%1/de1_%2/config").arg(component, objectId);
     QString payload = QJsonDocument(config).toJson(QJsonDocument::Compact);
 
-    publish(topic, payload, true);
+    publish(topic, payload, true, MessageClass::State);
     qDebug() << "MqttClient: Published discovery for" << objectId;
 }
 
@@ -636,7 +1072,7 @@ void MqttClient::publishHomeAssistantDiscovery()
     {
         QJsonObject config;
         config["name"] = "DE1 Head Temperature";
-        config["state_topic"] = baseTopic + "/temperature/head";
+        setMetricStateTopic(config, baseTopic, MetricHeadTemp);
         config["device_class"] = "temperature";
         config["unit_of_measurement"] = "\u00B0C";
         config["unique_id"] = QString("de1_%1_temp_head").arg(m_clientId);
@@ -649,7 +1085,7 @@ void MqttClient::publishHomeAssistantDiscovery()
     {
         QJsonObject config;
         config["name"] = "DE1 Mix Temperature";
-        config["state_topic"] = baseTopic + "/temperature/mix";
+        setMetricStateTopic(config, baseTopic, MetricMixTemp);
         config["device_class"] = "temperature";
         config["unit_of_measurement"] = "\u00B0C";
         config["unique_id"] = QString("de1_%1_temp_mix").arg(m_clientId);
@@ -662,7 +1098,7 @@ void MqttClient::publishHomeAssistantDiscovery()
     {
         QJsonObject config;
         config["name"] = "DE1 Pressure";
-        config["state_topic"] = baseTopic + "/pressure";
+        setMetricStateTopic(config, baseTopic, MetricPressure);
         config["device_class"] = "pressure";
         config["unit_of_measurement"] = "bar";
         config["unique_id"] = QString("de1_%1_pressure").arg(m_clientId);
@@ -675,7 +1111,7 @@ void MqttClient::publishHomeAssistantDiscovery()
     {
         QJsonObject config;
         config["name"] = "DE1 Flow";
-        config["state_topic"] = baseTopic + "/flow";
+        setMetricStateTopic(config, baseTopic, MetricFlow);
         config["unit_of_measurement"] = "ml/s";
         config["icon"] = "mdi:water-flow";
         config["unique_id"] = QString("de1_%1_flow").arg(m_clientId);
@@ -688,7 +1124,7 @@ void MqttClient::publishHomeAssistantDiscovery()
     {
         QJsonObject config;
         config["name"] = "DE1 Weight";
-        config["state_topic"] = baseTopic + "/weight";
+        setMetricStateTopic(config, baseTopic, MetricWeight);
         config["device_class"] = "weight";
         config["unit_of_measurement"] = "g";
         config["unique_id"] = QString("de1_%1_weight").arg(m_clientId);
@@ -701,7 +1137,7 @@ void MqttClient::publishHomeAssistantDiscovery()
     {
         QJsonObject config;
         config["name"] = "DE1 Water Level";
-        config["state_topic"] = baseTopic + "/water_level";
+        setMetricStateTopic(config, baseTopic, MetricWaterLevel);
         config["unit_of_measurement"] = "%";
         config["icon"] = "mdi:water";
         config["unique_id"] = QString("de1_%1_water_level").arg(m_clientId);
@@ -714,7 +1150,7 @@ void MqttClient::publishHomeAssistantDiscovery()
     {
         QJsonObject config;
         config["name"] = "DE1 Shot Time";
-        config["state_topic"] = baseTopic + "/shot_time";
+        setMetricStateTopic(config, baseTopic, MetricShotTime);
         config["unit_of_measurement"] = "s";
         config["icon"] = "mdi:timer";
         config["unique_id"] = QString("de1_%1_shot_time").arg(m_clientId);
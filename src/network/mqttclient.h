@@ -3,6 +3,11 @@
 #include <QObject>
 #include <QTimer>
 #include <QMutex>
+#include <QJsonArray>
+#include <QHash>
+#include <QList>
+
+#include "../core/samplering.h"
 
 extern "C" {
 #include <MQTTAsync.h>
@@ -11,7 +16,26 @@ extern "C" {
 class DE1Device;
 class MachineState;
 class Settings;
-
+struct ShotSample;
+
+/**
+ * Publishes machine state and telemetry to an MQTT broker (Home Assistant etc.)
+ *
+ * Telemetry is change-driven: each metric has a deadband and is only published
+ * when it has moved by at least that much since its last publish. With
+ * mqttJsonState, all metrics and the machine state are batched into a single
+ * retained JSON message on <base>/telemetry instead of one topic per metric.
+ * With mqttShotStream, every DE1 sample during an extraction is also packed
+ * into batches on <base>/shot/stream (not retained).
+ *
+ * Everything goes through an outbound queue. State, discovery and shot events
+ * are sent at QoS 1 and kept until the broker acknowledges them; when the
+ * broker is unreachable they wait in a bounded ring, and what overflows the
+ * ring (or is still queued at exit) is spilled to disk if mqttPersistQueue is
+ * set. Telemetry is QoS 0 in its own ring that drops the oldest message when
+ * full. The queue is replayed, oldest first, once the connection is back;
+ * reconnection retries with backoff for as long as MQTT is enabled.
+ */
 class MqttClient : public QObject {
     Q_OBJECT
 
@@ -19,6 +43,8 @@ class MqttClient : public QObject {
     Q_PROPERTY(QString status READ status NOTIFY statusChanged)
     Q_PROPERTY(int reconnectAttempts READ reconnectAttempts NOTIFY reconnectAttemptsChanged)
     Q_PROPERTY(QString currentProfile READ currentProfile WRITE setCurrentProfile NOTIFY currentProfileChanged)
+    Q_PROPERTY(int queueDepth READ queueDepth NOTIFY queueStatsChanged)
+    Q_PROPERTY(int droppedMessages READ droppedMessages NOTIFY queueStatsChanged)
 
 public:
     explicit MqttClient(DE1Device* device, MachineState* machineState,
@@ -30,6 +56,17 @@ public:
     int reconnectAttempts() const { return m_reconnectAttempts; }
     QString currentProfile() const { return m_currentProfile; }
     void setCurrentProfile(const QString& profile);
+    int queueDepth() const;
+    int droppedMessages() const { return m_droppedMessages; }
+    int spooledMessages() const { return m_spooledMessages; }
+
+    // Publish on <base>/<subtopic> through the outbound queue, not retained:
+    // QoS 1 and kept until acknowledged if reliable, else QoS 0 telemetry.
+    // For sources outside the machine state (de1harness --mqtt-bench).
+    void publishRaw(const QString& subtopic, const QString& payload, bool reliable);
+
+    static QString spoolPath();  // Reliable messages that overflowed the queue
+    static constexpr int RELIABLE_QUEUE_SIZE = 256;
 
     Q_INVOKABLE void connectToBroker();
     Q_INVOKABLE void disconnectFromBroker();
@@ -42,35 +79,57 @@ signals:
     void commandReceived(const QString& command);
     void profileSelectRequested(const QString& profileName);
     void currentProfileChanged();
+    void queueStatsChanged();
 
     // Internal signals for thread-safe callback handling
     void internalConnected();
     void internalDisconnected();
     void internalConnectionFailed(const QString& error);
     void internalMessageReceived(const QString& topic, const QString& payload);
+    void internalDeliveryComplete(int token, bool success);
 
 private slots:
     void onInternalConnected();
     void onInternalDisconnected();
     void onInternalConnectionFailed(const QString& error);
     void onInternalMessageReceived(const QString& topic, const QString& payload);
+    void onInternalDeliveryComplete(int token, bool success);
 
     // Data source slots
     void onPhaseChanged();
-    void onShotSampleReceived();
+    void onShotSampleReceived(const ShotSample& sample);
     void onWaterLevelChanged();
     void onDE1StateChanged();
     void onDE1ConnectedChanged();
+    void onShotStarted();
+    void onShotEnded();
 
     // Publishing
     void publishTelemetry();
     void publishState();
+    void onJsonStateChanged();
 
     // Reconnection
     void attemptReconnect();
     void onSettingsChanged();
 
 private:
+    // Delivery policy per topic class
+    enum class MessageClass {
+        Telemetry,  // QoS 0, drop oldest when the queue is full
+        State,      // QoS 1, kept until acknowledged
+        Event       // QoS 1, kept until acknowledged
+    };
+
+    struct OutboundMessage {
+        QByteArray topic;
+        QByteArray payload;
+        int qos = 0;
+        bool retained = false;
+    };
+
+    void openConnection();
+    int reconnectDelayMs() const;
     void setupSubscriptions();
     void publishHomeAssistantDiscovery();
     void handleCommand(const QString& command);
@@ -78,8 +137,19 @@ private:
     QJsonObject buildDeviceInfo() const;
     void publishDiscoveryConfig(const QString& component, const QString& objectId,
                                 const QJsonObject& config);
-    void publish(const QString& topic, const QString& payload, bool retain = true);
+    void publish(const QString& topic, const QString& payload, bool retain, MessageClass messageClass);
+    void enqueue(const OutboundMessage& message);
+    void drainQueue();
+    bool send(const OutboundMessage& message);
+    void requeueInFlight();
+    void spill(const OutboundMessage& message);
+    void spillQueue();
+    void loadSpool();
     void publishAvailability(bool online);
+    void publishJsonState();
+    void flushShotStream();
+    void resetPublishedValues();
+    void setMetricStateTopic(QJsonObject& config, const QString& baseTopic, int metric) const;
     QString generateClientId();
 
     // Paho callbacks (static, call instance methods via context)
@@ -90,6 +160,8 @@ private:
     static void onDisconnectSuccess(void* context, MQTTAsync_successData* response);
     static void onSubscribeSuccess(void* context, MQTTAsync_successData* response);
     static void onSubscribeFailure(void* context, MQTTAsync_failureData* response);
+    static void onSendSuccess(void* context, MQTTAsync_successData* response);
+    static void onSendFailure(void* context, MQTTAsync_failureData* response);
 
     MQTTAsync m_client = nullptr;
     DE1Device* m_device = nullptr;
@@ -99,17 +171,51 @@ private:
     QTimer m_publishTimer;
     QTimer m_reconnectTimer;
     int m_reconnectAttempts = 0;
-    static constexpr int MAX_RECONNECT_ATTEMPTS = 10;
-    static constexpr int RECONNECT_DELAY_MS = 5000;
+    static constexpr int RECONNECT_DELAY_MS = 5000;       // Doubles per attempt...
+    static constexpr int MAX_RECONNECT_DELAY_MS = 60000;  // ...up to once a minute, indefinitely
 
     QString m_status;
     bool m_connected = false;
+    bool m_userDisconnected = false;  // No automatic reconnect after Disconnect
     bool m_discoveryPublished = false;
     QString m_lastPublishedState;
     QString m_lastPublishedPhase;
     QString m_lastPublishedProfile;
+    QString m_lastPublishedSubstate;
     QString m_currentProfile;
     QString m_clientId;
 
+    // Change-driven telemetry: last value published per metric (NaN = never)
+    enum Metric {
+        MetricHeadTemp,
+        MetricMixTemp,
+        MetricSteamTemp,
+        MetricPressure,
+        MetricFlow,
+        MetricWeight,
+        MetricShotTime,
+        MetricTargetWeight,
+        MetricWaterLevel,
+        MetricWaterLevelMl,
+        MetricCount
+    };
+    double m_lastValues[MetricCount];
+    bool m_jsonStateDirty = true;
+
+    // Shot stream: samples waiting to be published as one message
+    QJsonArray m_shotStreamBuffer;
+    static constexpr int SHOT_STREAM_BATCH = 5;  // ~1 message/s at the DE1's 5 Hz
+
+    // Outbound queue (main thread only)
+    static constexpr int TELEMETRY_QUEUE_SIZE = 64;
+    static constexpr int MAX_IN_FLIGHT = 10;
+    static constexpr qint64 MAX_SPOOL_BYTES = 1024 * 1024;
+    QList<OutboundMessage> m_replay;  // Loaded from the spool or requeued after a lost connection
+    SampleRing<OutboundMessage, RELIABLE_QUEUE_SIZE> m_reliableQueue;
+    SampleRing<OutboundMessage, TELEMETRY_QUEUE_SIZE> m_telemetryQueue;
+    QHash<int, OutboundMessage> m_inFlight;  // QoS 1, keyed by Paho token
+    int m_spooledMessages = 0;
+    int m_droppedMessages = 0;
+
     mutable QMutex m_mutex;
 };
@@ -2,12 +2,16 @@
 #include "webdebuglogger.h"
 #include "webtemplates.h"
 #include "../history/shothistorystorage.h"
+#include "../history/shotthumbnailcache.h"
 #include "../ble/de1device.h"
 #include "../machine/machinestate.h"
 #include "../screensaver/screensavervideomanager.h"
 #include "../core/settings.h"
 #include "../core/profilestorage.h"
 #include "../core/settingsserializer.h"
+#include "../core/hotpathlog.h"
+#include "../core/flightrecorder.h"
+#include "../models/curveresampler.h"
 #include "version.h"
 
 #include <QNetworkInterface>
@@ -436,8 +440,14 @@ void ShotServer::handleRequest(QTcpSocket* socket, const QByteArray& request)
         sendHtml(socket, generateShotListPage());
     }
     else if (path.startsWith("/compare/")) {
-        // /compare/1,2,3 - compare shots with IDs 1, 2, 3
+        // /compare/1,2,3 - compare shots with IDs 1, 2, 3 (optional ?align=drip|frame)
         QString idsStr = path.mid(9);
+        QString align;
+        int queryStart = idsStr.indexOf('?');
+        if (queryStart >= 0) {
+            align = QUrlQuery(idsStr.mid(queryStart + 1)).queryItemValue("align");
+            idsStr.truncate(queryStart);
+        }
         QStringList idParts = idsStr.split(",");
         QList<qint64> ids;
         for (const QString& p : std::as_const(idParts)) {
@@ -446,11 +456,31 @@ void ShotServer::handleRequest(QTcpSocket* socket, const QByteArray& request)
             if (ok) ids << id;
         }
         if (ids.size() >= 2) {
-            sendHtml(socket, generateComparisonPage(ids));
+            sendHtml(socket, generateComparisonPage(ids, align));
         } else {
             sendResponse(socket, 400, "text/plain", "Need at least 2 shot IDs to compare");
         }
     }
+    else if (path.startsWith("/shot/") && path.endsWith("/thumb.png")) {
+        // /shot/123/thumb.png - cached sparkline thumbnail
+        QString idPart = path.mid(6);  // Remove "/shot/"
+        idPart = idPart.left(idPart.indexOf("/thumb.png"));
+        bool ok;
+        qint64 shotId = idPart.toLongLong(&ok);
+        QFile file(ok && m_thumbnailCache ? m_thumbnailCache->cachedFilePath(shotId) : QString());
+        if (file.fileName().isEmpty() || !file.open(QIODevice::ReadOnly)) {
+            // Never render on the GUI thread: queue it and serve a blank image for now
+            if (ok && m_thumbnailCache) {
+                m_thumbnailCache->renderInBackground(shotId);
+                sendResponse(socket, 200, "image/png", thumbnailPlaceholder(), "Cache-Control: no-store\r\n");
+            } else {
+                sendResponse(socket, 404, "text/plain", "No thumbnail");
+            }
+        } else {
+            // The cache holds finished PNGs - send the bytes as they are
+            sendResponse(socket, 200, "image/png", file.readAll(), "Cache-Control: max-age=86400\r\n");
+        }
+    }
     else if (path.startsWith("/shot/") && path.endsWith("/profile.json")) {
         // /shot/123/profile.json - download profile JSON for a shot
         QString idPart = path.mid(6);  // Remove "/shot/"
@@ -534,21 +564,26 @@ void ShotServer::handleRequest(QTcpSocket* socket, const QByteArray& request)
         }
     }
     else if (path == "/api/debug" || path.startsWith("/api/debug?")) {
-        // Get afterIndex from query string
+        // Get afterIndex (and hot-path sequence) from query string
         int afterIndex = 0;
+        quint64 hotAfter = 0;
         if (path.contains("?")) {
             QUrlQuery query(path.mid(path.indexOf("?") + 1));
             afterIndex = query.queryItemValue("after").toInt();
+            hotAfter = query.queryItemValue("hotAfter").toULongLong();
         }
 
         int lastIndex = 0;
+        quint64 hotLast = 0;
         QStringList lines;
         if (WebDebugLogger::instance()) {
             lines = WebDebugLogger::instance()->getLines(afterIndex, &lastIndex);
+            lines += WebDebugLogger::instance()->getHotPathLines(hotAfter, &hotLast);
         }
 
         QJsonObject result;
         result["lastIndex"] = lastIndex;
+        result["hotLast"] = QString::number(hotLast);
         QJsonArray linesArray;
         for (const QString& line : std::as_const(lines)) {
             linesArray.append(line);
@@ -556,10 +591,39 @@ void ShotServer::handleRequest(QTcpSocket* socket, const QByteArray& request)
         result["lines"] = linesArray;
         sendJson(socket, QJsonDocument(result).toJson(QJsonDocument::Compact));
     }
+    else if (path == "/api/debug/flight") {
+        // Crash flight recorder: live ring and the ring saved by the last crash
+        QJsonObject result;
+        result["live"] = QJsonArray::fromStringList(FlightRecorder::liveLines());
+        result["crash"] = QJsonArray::fromStringList(FlightRecorder::lastCrashLines());
+        sendJson(socket, QJsonDocument(result).toJson(QJsonDocument::Compact));
+    }
+    else if (path == "/api/debug/categories") {
+        // Hot-path log levels: GET lists them, POST {"name": bool, ...} switches them
+        if (method == "POST" && m_settings) {
+            int bodyStart = request.indexOf("\r\n\r\n");
+            if (bodyStart != -1) {
+                m_settings->setLogCategories(QJsonDocument::fromJson(request.mid(bodyStart + 4)).object().toVariantMap());
+            }
+        }
+        QJsonArray categories;
+        const QVariantMap levels = m_settings ? m_settings->logCategories() : QVariantMap();
+        for (const QString& name : HotPathLog::categoryNames()) {
+            QJsonObject category;
+            category["name"] = name;
+            category["description"] = HotPathLog::categoryDescription(name);
+            category["enabled"] = levels.value(name, HotPathLog::defaultEnabled(name)).toBool();
+            categories.append(category);
+        }
+        QJsonObject result;
+        result["categories"] = categories;
+        sendJson(socket, QJsonDocument(result).toJson(QJsonDocument::Compact));
+    }
     else if (path == "/api/debug/clear") {
         if (WebDebugLogger::instance()) {
             WebDebugLogger::instance()->clear(false);  // Don't clear file by default
         }
+        HotPathLog::clear();
         QJsonObject result;
         result["success"] = true;
         sendJson(socket, QJsonDocument(result).toJson(QJsonDocument::Compact));
@@ -853,6 +917,20 @@ void ShotServer::sendFile(QTcpSocket* socket, const QString& path, const QString
     sendResponse(socket, 200, contentType, data, extraHeaders);
 }
 
+QByteArray ShotServer::thumbnailPlaceholder()
+{
+    static const QByteArray png = [] {
+        QImage image(ShotThumbnailCache::WIDTH, ShotThumbnailCache::HEIGHT, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+        return data;
+    }();
+    return png;
+}
+
 QString ShotServer::getLocalIpAddress() const
 {
     // First, try to determine the primary IP by checking which local address
@@ -1004,6 +1082,7 @@ QString ShotServer::generateShotListPage() const
                             <input type="checkbox" class="shot-checkbox" data-id="%1" onclick="event.stopPropagation(); toggleSelect(%1, this.closest('.shot-card'))">
                         </div>
                     </div>
+                    <img class="shot-thumb" src="/shot/%1/thumb.png" loading="lazy" alt="">
                     <div class="shot-metrics">
                         <div class="dose-group">
                             <div class="shot-metric">
@@ -1140,6 +1219,7 @@ QString ShotServer::generateShotListPage() const
         .shot-profile { font-weight: 600; font-size: 1rem; color: var(--text); }
         .shot-date { font-size: 0.75rem; color: var(--text-secondary); white-space: nowrap; }
         .shot-metrics { display: flex; align-items: center; justify-content: space-between; }
+        .shot-thumb { display: block; width: 100%; height: 48px; object-fit: fill; margin: 0.25rem 0; }
         .dose-group {
             display: flex;
             align-items: center;
@@ -1731,6 +1811,9 @@ QString ShotServer::generateShotDetailPage(qint64 shotId) const
         ratio = shot["finalWeight"].toDouble() / shot["doseWeight"].toDouble();
     }
 
+    // Debug logs live in their own table and aren't part of getShot()
+    const QString debugLog = m_storage->getShotDebugLog(shotId);
+
     int rating = qRound(shot["enjoyment"].toDouble() / 20.0);
     QString stars;
     for (int i = 0; i < 5; i++) {
@@ -2414,51 +2497,85 @@ QString ShotServer::generateShotDetailPage(qint64 shotId) const
     .arg(tempData)
     .arg(pressureGoalData)
     .arg(flowGoalData)
-    .arg(shot["debugLog"].toString().isEmpty() ? "No debug log available" : shot["debugLog"].toString().toHtmlEscaped());
+    .arg(debugLog.isEmpty() ? "No debug log available" : debugLog.toHtmlEscaped());
 }
 
-QString ShotServer::generateComparisonPage(const QList<qint64>& shotIds) const
+QString ShotServer::generateComparisonPage(const QList<qint64>& shotIds, const QString& align) const
 {
     // Load all shots
-    QList<QVariantMap> shots;
-    for (qint64 id : shotIds) {
-        QVariantMap shot = m_storage->getShot(id);
-        if (!shot.isEmpty()) {
-            shots << shot;
-        }
-    }
+    QList<ShotRecord> shots = m_storage->getShotsForComparison(shotIds);
 
     if (shots.size() < 2) {
         return QStringLiteral("<!DOCTYPE html><html><body>Not enough valid shots to compare</body></html>");
     }
 
-    // Colors for each shot (up to 5)
-    QStringList shotColors = {"#c9a227", "#e85d75", "#4ecdc4", "#a855f7", "#f97316"};
+    // Resample every shot onto one 0.1 s grid, aligned on shot start, first drip or first frame change
+    enum { CurvePressure, CurveFlow, CurveWeight, CurveTemp, CurveCount };
+    QList<ResampleShot> batch;
+    for (const ShotRecord& record : std::as_const(shots)) {
+        ResampleShot resample;
+        resample.curves = {
+            ResampleCurve::fromPoints(record.pressure),
+            ResampleCurve::fromPoints(record.flow),
+            ResampleCurve::fromPoints(record.weight),
+            ResampleCurve::fromPoints(record.temperature)
+        };
+        if (align == "drip") {
+            resample.offset = CurveResampler::firstDripTime(resample.curves[CurveWeight], resample.curves[CurveFlow]);
+        } else if (align == "frame") {
+            QList<ResampleMarker> markers;
+            for (const auto& phase : record.phases) {
+                markers.append({phase.time, phase.label, phase.frameNumber});
+            }
+            resample.offset = CurveResampler::phaseMarkerTime(markers, QString());
+        }
+        batch.append(resample);
+    }
+    const ResampleGrid grid = ResampleGrid::covering(batch, 0.1);
+    const QVector<float> rows = CurveResampler::resampleShots(batch, grid);
 
-    auto pointsToJson = [](const QVariantList& points) -> QString {
+    auto rowToJson = [&rows, &grid](int shot, int curve) -> QString {
+        const QVector<QPointF> points = CurveResampler::toPoints(rows.constData() + (shot * CurveCount + curve) * grid.count, grid);
         QStringList items;
-        for (const QVariant& p : points) {
-            QVariantMap pt = p.toMap();
-            items << QString("{x:%1,y:%2}").arg(pt["x"].toDouble(), 0, 'f', 2).arg(pt["y"].toDouble(), 0, 'f', 2);
+        for (const QPointF& pt : points) {
+            items << QString("{x:%1,y:%2}").arg(pt.x(), 0, 'f', 2).arg(pt.y(), 0, 'f', 2);
         }
         return "[" + items.join(",") + "]";
     };
 
+    // Alignment selector links back to this page
+    QStringList idStrings;
+    for (const ShotRecord& record : std::as_const(shots)) {
+        idStrings << QString::number(record.summary.id);
+    }
+    const QString baseUrl = "/compare/" + idStrings.join(",");
+    QString alignLinks;
+    const QList<QPair<QString, QString>> alignModes = {{"", "Start"}, {"drip", "First drip"}, {"frame", "Frame change"}};
+    for (const auto& mode : alignModes) {
+        alignLinks += QString(R"HTML(<a class="toggle-btn%1" style="text-decoration:none" href="%2">%3</a>)HTML")
+            .arg(mode.first == align ? " active" : "",
+                 mode.first.isEmpty() ? baseUrl : baseUrl + "?align=" + mode.first,
+                 mode.second);
+    }
+
+    // Colors for each shot (up to 5)
+    QStringList shotColors = {"#c9a227", "#e85d75", "#4ecdc4", "#a855f7", "#f97316"};
+
     // Build datasets for each shot
     QString datasets;
     QString legendItems;
     int shotIndex = 0;
 
-    for (const QVariantMap& shot : std::as_const(shots)) {
+    for (const ShotRecord& shot : std::as_const(shots)) {
         QString color = shotColors[shotIndex % shotColors.size()];
-        QString name = shot["profileName"].toString();
-        QString date = shot["dateTime"].toString().left(10);
+        QString name = shot.summary.profileName;
+        QString date = QDateTime::fromSecsSinceEpoch(shot.summary.timestamp).toString("yyyy-MM-dd");
         QString label = QString("%1 (%2)").arg(name, date);
 
-        QString pressureData = pointsToJson(shot["pressure"].toList());
-        QString flowData = pointsToJson(shot["flow"].toList());
-        QString weightData = pointsToJson(shot["weight"].toList());
-        QString tempData = pointsToJson(shot["temperature"].toList());
+        QString pressureData = rowToJson(shotIndex, CurvePressure);
+        QString flowData = rowToJson(shotIndex, CurveFlow);
+        QString weightData = rowToJson(shotIndex, CurveWeight);
+        QString tempData = rowToJson(shotIndex, CurveTemp);
 
         // Add datasets for this shot
         datasets += QString(R"HTML(
@@ -2468,8 +2585,8 @@ QString ShotServer::generateComparisonPage(const QList<qint64>& shotIds) const
             { label: "Temp - %1", data: %7, borderColor: "%3", borderWidth: 1, pointRadius: 0, tension: 0.3, yAxisID: "y3", borderDash: [8,4], shotIndex: %4, curveType: "temp" },
         )HTML").arg(label.toHtmlEscaped(), pressureData, color).arg(shotIndex).arg(flowData, weightData, tempData);
 
-        double ratio = shot["doseWeight"].toDouble() > 0 ?
-            shot["finalWeight"].toDouble() / shot["doseWeight"].toDouble() : 0;
+        double ratio = shot.summary.doseWeight > 0 ?
+            shot.summary.finalWeight / shot.summary.doseWeight : 0;
 
         legendItems += QString(R"HTML(
             <div class="legend-item">
@@ -2482,10 +2599,10 @@ QString ShotServer::generateComparisonPage(const QList<qint64>& shotIds) const
         )HTML").arg(color)
                .arg(label.toHtmlEscaped())
                .arg(date)
-               .arg(shot["doseWeight"].toDouble(), 0, 'f', 1)
-               .arg(shot["finalWeight"].toDouble(), 0, 'f', 1)
+               .arg(shot.summary.doseWeight, 0, 'f', 1)
+               .arg(shot.summary.finalWeight, 0, 'f', 1)
                .arg(ratio, 0, 'f', 1)
-               .arg(shot["duration"].toDouble(), 0, 'f', 1);
+               .arg(shot.summary.duration, 0, 'f', 1);
 
         shotIndex++;
     }
@@ -2697,6 +2814,7 @@ QString ShotServer::generateComparisonPage(const QList<qint64>& shotIds) const
         <div class="chart-container">
             <div class="chart-header">
                 <div class="chart-title">Extraction Curves</div>
+                <div class="curve-toggles">%4</div>
                 <div class="curve-toggles">
                     <button class="toggle-btn pressure active" onclick="toggleCurve('pressure', this)">
                         <span class="dot"></span> Pressure
@@ -2927,7 +3045,7 @@ QString ShotServer::generateComparisonPage(const QList<qint64>& shotIds) const
     </script>
 </body>
 </html>
-)HTML").arg(shots.size()).arg(legendItems).arg(datasets);
+)HTML").arg(shots.size()).arg(legendItems, datasets, alignLinks);
 }
 
 QString ShotServer::generateDebugPage() const
@@ -3050,6 +3168,7 @@ QString ShotServer::generateDebugPage() const
                 <button class="btn active" id="autoScrollBtn" onclick="toggleAutoScroll()">Auto-scroll</button>
                 <button class="btn" onclick="clearLog()">Clear</button>
                 <button class="btn" onclick="loadPersistedLog()">Load Saved Log</button>
+                <button class="btn" onclick="loadFlightRecorder()">Flight Recorder</button>
                 <button class="btn" onclick="clearAll()">Clear All</button>
             </div>
         </div>
@@ -3059,10 +3178,12 @@ QString ShotServer::generateDebugPage() const
             <a href="/database.db" class="btn" style="text-decoration:none;">&#128190; Download Database</a>
             <a href="/upload" class="btn" style="text-decoration:none;">&#128230; Upload APK</a>
         </div>
+        <div id="categories" style="margin-bottom:1rem;display:flex;gap:0.5rem;flex-wrap:wrap;"></div>
         <div class="log-container" id="logContainer"></div>
     </main>
     <script>
         var lastIndex = 0;
+        var hotLast = "0";
         var autoScroll = true;
         var container = document.getElementById("logContainer");
         var lineCountEl = document.getElementById("lineCount");
@@ -3084,7 +3205,7 @@ QString ShotServer::generateDebugPage() const
         }
 
         function fetchLogs() {
-            fetch("/api/debug?after=" + lastIndex)
+            fetch("/api/debug?after=" + lastIndex + "&hotAfter=" + hotLast)
                 .then(function(r) { return r.json(); })
                 .then(function(data) {
                     if (data.lines && data.lines.length > 0) {
@@ -3098,10 +3219,32 @@ QString ShotServer::generateDebugPage() const
                         }
                     }
                     lastIndex = data.lastIndex;
+                    hotLast = data.hotLast || hotLast;
                     lineCountEl.textContent = lastIndex + " lines";
                 });
         }
 
+        function loadCategories(body) {
+            var options = body ? { method: "POST", body: JSON.stringify(body) } : {};
+            fetch("/api/debug/categories", options)
+                .then(function(r) { return r.json(); })
+                .then(function(data) {
+                    var html = "";
+                    (data.categories || []).forEach(function(c) {
+                        html += "<button class=\"btn" + (c.enabled ? " active" : "") + "\" title=\"" +
+                                escapeHtml(c.description) + "\" onclick=\"toggleCategory('" + c.name + "', " +
+                                !c.enabled + ")\">" + escapeHtml(c.name) + "</button>";
+                    });
+                    document.getElementById("categories").innerHTML = html;
+                });
+        }
+
+        function toggleCategory(name, enabled) {
+            var body = {};
+            body[name] = enabled;
+            loadCategories(body);
+        }
+
         function toggleAutoScroll() {
             autoScroll = !autoScroll;
             document.getElementById("autoScrollBtn").classList.toggle("active", autoScroll);
@@ -3150,9 +3293,34 @@ QString ShotServer::generateDebugPage() const
                 });
         }
 
+        function loadFlightRecorder() {
+            fetch("/api/debug/flight")
+                .then(function(r) { return r.json(); })
+                .then(function(data) {
+                    var html = "";
+                    var sections = [["LAST CRASH", data.crash || []], ["LIVE", data.live || []]];
+                    for (var s = 0; s < sections.length; s++) {
+                        if (sections[s][1].length === 0) continue;
+                        html += colorize("========== FLIGHT RECORDER: " + sections[s][0] + " ==========");
+                        for (var i = 0; i < sections[s][1].length; i++) {
+                            html += colorize(sections[s][1][i]);
+                        }
+                    }
+                    if (!html) {
+                        alert("Flight recorder is empty");
+                        return;
+                    }
+                    autoScroll = false;
+                    document.getElementById("autoScrollBtn").classList.remove("active");
+                    container.innerHTML = html;
+                    lineCountEl.textContent = "flight recorder";
+                });
+        }
+
         // Poll every 500ms
         setInterval(fetchLogs, 500);
         fetchLogs();
+        loadCategories();
     </script>
 </body>
 </html>
@@ -5173,6 +5341,24 @@ QString ShotServer::generateSettingsPage() const
                             <span>Home Assistant auto-discovery</span>
                         </label>
                     </div>
+                    <div class="form-group">
+                        <label class="form-checkbox">
+                            <input type="checkbox" id="mqttJsonState">
+                            <span>Single JSON state topic</span>
+                        </label>
+                    </div>
+                    <div class="form-group">
+                        <label class="form-checkbox">
+                            <input type="checkbox" id="mqttShotStream">
+                            <span>Stream shot samples</span>
+                        </label>
+                    </div>
+                    <div class="form-group">
+                        <label class="form-checkbox">
+                            <input type="checkbox" id="mqttPersistQueue">
+                            <span>Keep unsent events on disk</span>
+                        </label>
+                    </div>
                 </div>
             </div>
         </div>
@@ -5216,6 +5402,9 @@ QString ShotServer::generateSettingsPage() const
                 document.getElementById('mqttClientId').value = data.mqttClientId || '';
                 document.getElementById('mqttRetainMessages').checked = data.mqttRetainMessages || false;
                 document.getElementById('mqttHomeAssistantDiscovery').checked = data.mqttHomeAssistantDiscovery || false;
+                document.getElementById('mqttJsonState').checked = data.mqttJsonState || false;
+                document.getElementById('mqttShotStream').checked = data.mqttShotStream || false;
+                document.getElementById('mqttPersistQueue').checked = data.mqttPersistQueue || false;
                 updateMqttFields();
             } catch (e) {
                 showStatus('Failed to load settings', true);
@@ -5271,7 +5460,10 @@ QString ShotServer::generateSettingsPage() const
                 mqttPublishInterval: parseInt(document.getElementById('mqttPublishInterval').value) || 5,
                 mqttClientId: document.getElementById('mqttClientId').value,
                 mqttRetainMessages: document.getElementById('mqttRetainMessages').checked,
-                mqttHomeAssistantDiscovery: document.getElementById('mqttHomeAssistantDiscovery').checked
+                mqttHomeAssistantDiscovery: document.getElementById('mqttHomeAssistantDiscovery').checked,
+                mqttJsonState: document.getElementById('mqttJsonState').checked,
+                mqttShotStream: document.getElementById('mqttShotStream').checked,
+                mqttPersistQueue: document.getElementById('mqttPersistQueue').checked
             };
 
             try {
@@ -5342,6 +5534,9 @@ void ShotServer::handleGetSettings(QTcpSocket* socket)
     obj["mqttClientId"] = m_settings->mqttClientId();
     obj["mqttRetainMessages"] = m_settings->mqttRetainMessages();
     obj["mqttHomeAssistantDiscovery"] = m_settings->mqttHomeAssistantDiscovery();
+    obj["mqttJsonState"] = m_settings->mqttJsonState();
+    obj["mqttShotStream"] = m_settings->mqttShotStream();
+    obj["mqttPersistQueue"] = m_settings->mqttPersistQueue();
 
     sendJson(socket, QJsonDocument(obj).toJson(QJsonDocument::Compact));
 }
@@ -5407,6 +5602,12 @@ void ShotServer::handleSaveSettings(QTcpSocket* socket, const QByteArray& body)
         m_settings->setMqttRetainMessages(obj["mqttRetainMessages"].toBool());
     if (obj.contains("mqttHomeAssistantDiscovery"))
         m_settings->setMqttHomeAssistantDiscovery(obj["mqttHomeAssistantDiscovery"].toBool());
+    if (obj.contains("mqttJsonState"))
+        m_settings->setMqttJsonState(obj["mqttJsonState"].toBool());
+    if (obj.contains("mqttShotStream"))
+        m_settings->setMqttShotStream(obj["mqttShotStream"].toBool());
+    if (obj.contains("mqttPersistQueue"))
+        m_settings->setMqttPersistQueue(obj["mqttPersistQueue"].toBool());
 
     sendJson(socket, R"({"success": true})");
 }
@@ -15,6 +15,7 @@ class MachineState;
 class ScreensaverVideoManager;
 class Settings;
 class ProfileStorage;
+class ShotThumbnailCache;
 
 struct PendingRequest {
     QByteArray headerData;          // Only headers stored in memory
@@ -52,6 +53,7 @@ public:
     // Settings and profiles for data migration
     void setSettings(Settings* settings) { m_settings = settings; }
     void setProfileStorage(ProfileStorage* profileStorage) { m_profileStorage = profileStorage; }
+    void setThumbnailCache(ShotThumbnailCache* cache) { m_thumbnailCache = cache; }
 
     // Machine state for home automation API
     void setMachineState(MachineState* machineState) { m_machineState = machineState; }
@@ -77,12 +79,13 @@ private:
     void sendJson(QTcpSocket* socket, const QByteArray& json);
     void sendHtml(QTcpSocket* socket, const QString& html);
     void sendFile(QTcpSocket* socket, const QString& path, const QString& contentType);
+    static QByteArray thumbnailPlaceholder();  // Blank thumbnail PNG while the real one renders
 
     QString getLocalIpAddress() const;
     QString generateIndexPage() const;
     QString generateShotListPage() const;
     QString generateShotDetailPage(qint64 shotId) const;
-    QString generateComparisonPage(const QList<qint64>& shotIds) const;
+    QString generateComparisonPage(const QList<qint64>& shotIds, const QString& align = QString()) const;
     QString generateDebugPage() const;
     QString generateUploadPage() const;
     void handleUpload(QTcpSocket* socket, const QByteArray& request);
@@ -118,6 +121,7 @@ private:
     ScreensaverVideoManager* m_screensaverManager = nullptr;
     Settings* m_settings = nullptr;
     ProfileStorage* m_profileStorage = nullptr;
+    ShotThumbnailCache* m_thumbnailCache = nullptr;
     MachineState* m_machineState = nullptr;
     QTimer* m_cleanupTimer = nullptr;
     int m_port = 8888;
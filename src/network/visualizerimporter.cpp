@@ -184,43 +184,7 @@ void VisualizerImporter::fetchSharedShots() {
 }
 
 bool VisualizerImporter::compareProfileFrames(const Profile& a, const Profile& b) const {
-    const auto& stepsA = a.steps();
-    const auto& stepsB = b.steps();
-
-    if (stepsA.size() != stepsB.size()) {
-        return false;
-    }
-
-    for (int i = 0; i < stepsA.size(); i++) {
-        const ProfileFrame& fa = stepsA[i];
-        const ProfileFrame& fb = stepsB[i];
-
-        // Compare all frame parameters that affect extraction
-        if (qAbs(fa.temperature - fb.temperature) > 0.1) return false;
-        if (fa.sensor != fb.sensor) return false;
-        if (fa.pump != fb.pump) return false;
-        if (fa.transition != fb.transition) return false;
-        if (qAbs(fa.pressure - fb.pressure) > 0.1) return false;
-        if (qAbs(fa.flow - fb.flow) > 0.1) return false;
-        if (qAbs(fa.seconds - fb.seconds) > 0.1) return false;
-        if (qAbs(fa.volume - fb.volume) > 0.1) return false;
-
-        // Exit conditions
-        if (fa.exitIf != fb.exitIf) return false;
-        if (fa.exitIf) {
-            if (fa.exitType != fb.exitType) return false;
-            if (qAbs(fa.exitPressureOver - fb.exitPressureOver) > 0.1) return false;
-            if (qAbs(fa.exitPressureUnder - fb.exitPressureUnder) > 0.1) return false;
-            if (qAbs(fa.exitFlowOver - fb.exitFlowOver) > 0.1) return false;
-            if (qAbs(fa.exitFlowUnder - fb.exitFlowUnder) > 0.1) return false;
-        }
-
-        // Limiter
-        if (qAbs(fa.maxFlowOrPressure - fb.maxFlowOrPressure) > 0.1) return false;
-        if (qAbs(fa.maxFlowOrPressureRange - fb.maxFlowOrPressureRange) > 0.1) return false;
-    }
-
-    return true;
+    return a.hasSameFrames(b);
 }
 
 Profile VisualizerImporter::loadLocalProfile(const QString& filename) const {
@@ -797,9 +761,9 @@ ProfileFrame VisualizerImporter::parseVisualizerStep(const QJsonObject& json) {
 
     frame.name = json["name"].toString();
     frame.temperature = toDouble(json["temperature"], 93.0);
-    frame.sensor = json["sensor"].toString("coffee");
-    frame.pump = json["pump"].toString("pressure");
-    frame.transition = json["transition"].toString("fast");
+    frame.sensor = ProfileFrame::parseSensor(json["sensor"].toString("coffee"));
+    frame.pump = ProfileFrame::parsePump(json["pump"].toString("pressure"));
+    frame.transition = ProfileFrame::parseTransition(json["transition"].toString("fast"));
     frame.pressure = toDouble(json["pressure"], 9.0);
     frame.flow = toDouble(json["flow"], 2.0);
     frame.seconds = toDouble(json["seconds"], 30.0);
@@ -815,7 +779,7 @@ ProfileFrame VisualizerImporter::parseVisualizerStep(const QJsonObject& json) {
         QString condition = exitObj["condition"].toString();
         double value = toDouble(exitObj["value"]);
 
-        frame.exitType = exitType + "_" + condition;
+        frame.exitType = ProfileFrame::parseExit(exitType + "_" + condition);
 
         if (exitType == "pressure") {
             if (condition == "over") {
@@ -833,7 +797,7 @@ ProfileFrame VisualizerImporter::parseVisualizerStep(const QJsonObject& json) {
     } else if (json.contains("exit_if")) {
         // Flat format: {"exit_if": true, "exit_type": "pressure_over", "exit_pressure_over": 4}
         frame.exitIf = json["exit_if"].toBool(false);
-        frame.exitType = json["exit_type"].toString();
+        frame.exitType = ProfileFrame::parseExit(json["exit_type"].toString());
         frame.exitPressureOver = toDouble(json["exit_pressure_over"]);
         frame.exitPressureUnder = toDouble(json["exit_pressure_under"]);
         frame.exitFlowOver = toDouble(json["exit_flow_over"]);
@@ -25,7 +25,9 @@ VisualizerUploader::VisualizerUploader(Settings* settings, QObject* parent)
 // Helper: Interpolate goal data to match elapsed timestamps
 // Goal data may have different timestamps or gaps; we need to align to the master elapsed array
 // Gaps > 0.5s between goal points indicate mode switches (flow/pressure) - return 0 during gaps
-static QJsonArray interpolateGoalData(const QVector<QPointF>& goalData, const QVector<QPointF>& masterData) {
+// Works on stored point vectors as well as live SampleViews.
+template <typename GoalPoints, typename MasterPoints>
+static QJsonArray interpolateGoalData(const GoalPoints& goalData, const MasterPoints& masterData) {
     QJsonArray result;
 
     if (goalData.isEmpty() || masterData.isEmpty()) {
@@ -58,7 +60,7 @@ static QJsonArray interpolateGoalData(const QVector<QPointF>& goalData, const QV
                 // Far past the last goal point - probably in a different mode
                 result.append(0.0);
             } else {
-                result.append(goalData.last().y());
+                result.append(roundedSample(goalData.last().y()));
             }
         } else {
             // Between goalData[goalIdx] and goalData[goalIdx+1]
@@ -72,10 +74,10 @@ static QJsonArray interpolateGoalData(const QVector<QPointF>& goalData, const QV
                 // Gap detected - check which side of the gap we're on
                 if (t - t0 < GAP_THRESHOLD) {
                     // Close to the earlier point - use its value
-                    result.append(v0);
+                    result.append(roundedSample(v0));
                 } else if (t1 - t < GAP_THRESHOLD) {
                     // Close to the later point - use its value
-                    result.append(v1);
+                    result.append(roundedSample(v1));
                 } else {
                     // In the middle of the gap - return 0
                     result.append(0.0);
@@ -83,9 +85,9 @@ static QJsonArray interpolateGoalData(const QVector<QPointF>& goalData, const QV
             } else if (t1 - t0 > 0.001) {
                 // Normal case - interpolate
                 double ratio = (t - t0) / (t1 - t0);
-                result.append(v0 + ratio * (v1 - v0));
+                result.append(roundedSample(v0 + ratio * (v1 - v0)));
             } else {
-                result.append(v0);
+                result.append(roundedSample(v0));
             }
         }
     }
@@ -247,7 +249,7 @@ void VisualizerUploader::uploadShotFromHistory(const QVariantMap& shotData)
     auto extractValues = [](const QVector<QPointF>& points) -> QJsonArray {
         QJsonArray values;
         for (const auto& pt : points) {
-            values.append(pt.y());
+            values.append(roundedSample(pt.y()));
         }
         return values;
     };
@@ -256,7 +258,7 @@ void VisualizerUploader::uploadShotFromHistory(const QVariantMap& shotData)
     auto extractTimes = [](const QVector<QPointF>& points) -> QJsonArray {
         QJsonArray times;
         for (const auto& pt : points) {
-            times.append(pt.x());
+            times.append(roundedSample(pt.x()));
         }
         return times;
     };
@@ -543,7 +545,7 @@ QByteArray VisualizerUploader::buildShotJson(ShotDataModel* shotData,
     // Elapsed time array
     QJsonArray elapsed;
     for (const auto& pt : pressureData) {
-        elapsed.append(pt.x());
+        elapsed.append(roundedSample(pt.x()));
     }
     root["elapsed"] = elapsed;
 
@@ -551,7 +553,7 @@ QByteArray VisualizerUploader::buildShotJson(ShotDataModel* shotData,
     QJsonObject pressure;
     QJsonArray pressureValues;
     for (const auto& pt : pressureData) {
-        pressureValues.append(pt.y());
+        pressureValues.append(roundedSample(pt.y()));
     }
     pressure["pressure"] = pressureValues;
     // Interpolate goal data to match elapsed timestamps
@@ -562,7 +564,7 @@ QByteArray VisualizerUploader::buildShotJson(ShotDataModel* shotData,
     QJsonObject flow;
     QJsonArray flowValues;
     for (const auto& pt : flowData) {
-        flowValues.append(pt.y());
+        flowValues.append(roundedSample(pt.y()));
     }
     flow["flow"] = flowValues;
     // Interpolate goal data to match elapsed timestamps
@@ -577,7 +579,7 @@ QByteArray VisualizerUploader::buildShotJson(ShotDataModel* shotData,
     QJsonObject temperature;
     QJsonArray basketValues;
     for (const auto& pt : temperatureData) {
-        basketValues.append(pt.y());
+        basketValues.append(roundedSample(pt.y()));
     }
     temperature["basket"] = basketValues;
     // Interpolate goal data to match elapsed timestamps
@@ -729,9 +731,9 @@ QJsonObject VisualizerUploader::buildVisualizerProfileJson(const Profile* profil
         // Values as strings (Visualizer format)
         stepObj["name"] = step.name;
         stepObj["temperature"] = QString::number(step.temperature, 'f', 2);
-        stepObj["sensor"] = step.sensor;
-        stepObj["pump"] = step.pump;
-        stepObj["transition"] = step.transition;
+        stepObj["sensor"] = ProfileFrame::toString(step.sensor);
+        stepObj["pump"] = ProfileFrame::toString(step.pump);
+        stepObj["transition"] = ProfileFrame::toString(step.transition);
         stepObj["pressure"] = QString::number(step.pressure, 'f', 2);
         stepObj["flow"] = QString::number(step.flow, 'f', 2);
         stepObj["seconds"] = QString::number(step.seconds, 'f', 2);
@@ -739,21 +741,21 @@ QJsonObject VisualizerUploader::buildVisualizerProfileJson(const Profile* profil
         stepObj["weight"] = "0";  // Per-step weight not used
 
         // Exit condition (Visualizer format: {type, value, condition})
-        if (step.exitIf && !step.exitType.isEmpty()) {
+        if (step.exitIf && step.exitType != ProfileFrame::Exit::None) {
             QJsonObject exitObj;
-            if (step.exitType == "pressure_over") {
+            if (step.exitType == ProfileFrame::Exit::PressureOver) {
                 exitObj["type"] = "pressure";
                 exitObj["value"] = QString::number(step.exitPressureOver, 'f', 2);
                 exitObj["condition"] = "over";
-            } else if (step.exitType == "pressure_under") {
+            } else if (step.exitType == ProfileFrame::Exit::PressureUnder) {
                 exitObj["type"] = "pressure";
                 exitObj["value"] = QString::number(step.exitPressureUnder, 'f', 2);
                 exitObj["condition"] = "under";
-            } else if (step.exitType == "flow_over") {
+            } else if (step.exitType == ProfileFrame::Exit::FlowOver) {
                 exitObj["type"] = "flow";
                 exitObj["value"] = QString::number(step.exitFlowOver, 'f', 2);
                 exitObj["condition"] = "over";
-            } else if (step.exitType == "flow_under") {
+            } else if (step.exitType == ProfileFrame::Exit::FlowUnder) {
                 exitObj["type"] = "flow";
                 exitObj["value"] = QString::number(step.exitFlowUnder, 'f', 2);
                 exitObj["condition"] = "under";
@@ -1,14 +1,44 @@
 #include "webdebuglogger.h"
+#include "../core/crashhandler.h"
+#include "../core/hotpathlog.h"
 
 #include <QDebug>
+#include <QThread>
 #include <QTime>
 #include <QStandardPaths>
 #include <QDir>
-#include <QTextStream>
+#include <QFile>
+#include <QFileInfo>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <limits>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 WebDebugLogger* WebDebugLogger::s_instance = nullptr;
 QtMessageHandler WebDebugLogger::s_previousHandler = nullptr;
 
+// write() until done; async-signal-safe
+static void writeAll(int fd, const char* data, qint64 size)
+{
+    while (size > 0) {
+#ifdef Q_OS_WIN
+        const int written = _write(fd, data, static_cast<unsigned int>(size));
+#else
+        const ssize_t written = ::write(fd, data, static_cast<size_t>(size));
+#endif
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return;
+        data += written;
+        size -= written;
+    }
+}
+
 WebDebugLogger* WebDebugLogger::instance()
 {
     return s_instance;
@@ -28,17 +58,25 @@ WebDebugLogger::WebDebugLogger(QObject* parent)
 {
     m_timer.start();
 
-    // Set up log file path
+    // Queue starts with a stub node the consumer sits on
+    PendingLine* stub = new PendingLine;
+    m_queueHead.store(stub);
+    m_queueTail = stub;
+
+    // Set up log file paths (current and previous segment)
     QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir().mkpath(dataDir);
     m_logFilePath = dataDir + "/debug.log";
+    m_previousSegmentPath = dataDir + "/debug.1.log";
 
     // Write session start marker
-    QFile file(m_logFilePath);
-    if (file.open(QIODevice::Append | QIODevice::Text)) {
-        QTextStream stream(&file);
-        stream << "\n========== SESSION START: " << m_startTime.toString(Qt::ISODate) << " ==========\n";
-    }
+    enqueue("\n========== SESSION START: " + m_startTime.toString(Qt::ISODate) + " ==========", 0);
+
+    m_writer = QThread::create([this]() { writerLoop(); });
+    m_writer->setObjectName("WebDebugLogWriter");
+    m_writer->start(QThread::LowPriority);
+
+    CrashHandler::setLogFlushHook(&WebDebugLogger::crashFlush);
 }
 
 void WebDebugLogger::messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg)
@@ -66,9 +104,9 @@ void WebDebugLogger::handleMessage(QtMsgType type, const QString& message)
     case QtFatalMsg:    category = "FATAL"; break;
     }
 
-    double seconds = m_timer.elapsed() / 1000.0;
+    const qint64 elapsedMs = m_timer.elapsed();
     QString line = QString("[%1] %2 %3")
-        .arg(seconds, 8, 'f', 3)
+        .arg(elapsedMs / 1000.0, 8, 'f', 3)
         .arg(category, -5)
         .arg(message);
 
@@ -79,65 +117,225 @@ void WebDebugLogger::handleMessage(QtMsgType type, const QString& message)
     while (m_lines.size() > m_maxLines) {
         m_lines.removeFirst();
     }
-
-    // Also write to file (outside mutex to avoid blocking)
     locker.unlock();
-    writeToFile(line);
+
+    // Persist off-thread. A fatal message aborts right after this returns,
+    // and after shutdown() there is no writer, so those go to disk now.
+    enqueue(line, elapsedMs);
+    if (type == QtFatalMsg || m_stopping.load(std::memory_order_acquire)) {
+        flush();
+    }
 }
 
-void WebDebugLogger::writeToFile(const QString& line)
+void WebDebugLogger::enqueue(const QString& line, qint64 timeMs)
 {
-    QFile file(m_logFilePath);
-    if (file.open(QIODevice::Append | QIODevice::Text)) {
-        QTextStream stream(&file);
-        stream << line << "\n";
-        file.close();
+    PendingLine* node = new PendingLine;
+    node->data = line.toUtf8();
+    node->data.append('\n');
+    node->timeMs = timeMs;
+    const qint64 size = node->data.size();
+
+    // Vyukov MPSC push: one exchange, no lock, no syscall on the logging thread
+    PendingLine* previous = m_queueHead.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+
+    if (m_pendingBytes.fetch_add(size, std::memory_order_relaxed) + size >= FLUSH_BYTES) {
+        // Under the writer's mutex, so the wake can't land between its check and its wait
+        QMutexLocker lock(&m_wakeMutex);
+        m_wake.wakeOne();
+    }
+}
 
-        // Check if we need to trim
-        if (file.size() > MAX_LOG_FILE_SIZE) {
-            trimLogFile();
+void WebDebugLogger::writerLoop()
+{
+    while (!m_stopping.load(std::memory_order_acquire)) {
+        {
+            QMutexLocker lock(&m_wakeMutex);
+            if (m_pendingBytes.load(std::memory_order_relaxed) < FLUSH_BYTES
+                && !m_stopping.load(std::memory_order_acquire)) {
+                m_wake.wait(&m_wakeMutex, FLUSH_INTERVAL_MS);
+            }
         }
+        flush();
     }
+    flush();
 }
 
-void WebDebugLogger::trimLogFile()
+void WebDebugLogger::flush()
 {
-    QFile file(m_logFilePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    QMutexLocker lock(&m_fileMutex);
+    if (m_fileBusy.exchange(true, std::memory_order_acquire)) {
+        return;  // The crash handler has taken over the file
+    }
+    drainQueue();
+    m_fileBusy.store(false, std::memory_order_release);
+}
+
+void WebDebugLogger::shutdown()
+{
+    if (!m_writer) {
+        flush();
         return;
     }
 
-    // Read all content
-    QByteArray content = file.readAll();
-    file.close();
+    m_stopping.store(true, std::memory_order_release);
+    {
+        QMutexLocker lock(&m_wakeMutex);
+        m_wake.wakeAll();
+    }
+    m_writer->wait();
+    delete m_writer;
+    m_writer = nullptr;
+}
 
-    // Keep last ~80% of max size to avoid frequent trimming
-    qint64 keepSize = MAX_LOG_FILE_SIZE * 80 / 100;
-    if (content.size() <= keepSize) {
-        return;
+void WebDebugLogger::openLogFile()
+{
+    const QByteArray path = QFile::encodeName(m_logFilePath);
+#ifdef Q_OS_WIN
+    const int fd = _open(path.constData(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, 0644);
+#else
+    const int fd = ::open(path.constData(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+    if (fd >= 0) {
+        m_fileSize = QFileInfo(m_logFilePath).size();
     }
+    m_fd.store(fd, std::memory_order_release);
+}
 
-    // Find a newline near the trim point to keep lines intact
-    qint64 trimPoint = content.size() - keepSize;
-    qint64 newlinePos = content.indexOf('\n', trimPoint);
-    if (newlinePos == -1) {
-        newlinePos = trimPoint;
+void WebDebugLogger::closeLogFile()
+{
+    const int fd = m_fd.exchange(-1, std::memory_order_acq_rel);
+    if (fd >= 0) {
+#ifdef Q_OS_WIN
+        _close(fd);
+#else
+        ::close(fd);
+#endif
     }
+}
+
+void WebDebugLogger::rotateSegment()
+{
+    // Current segment becomes the previous one; the older previous is dropped
+    closeLogFile();
+    QFile::remove(m_previousSegmentPath);
+    QFile::rename(m_logFilePath, m_previousSegmentPath);
+    openLogFile();
+}
 
-    // Write trimmed content
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
-        file.write("... [log trimmed] ...\n");
-        file.write(content.mid(newlinePos + 1));
+void WebDebugLogger::drainQueue()
+{
+    if (!isLogFileOpen()) {
+        openLogFile();
     }
+
+    // Hot-path records since the last flush, formatted here on the writer
+    // thread (never on the logging thread) and merged in by time
+    const quint64 after = m_hotPathSequence;
+    const QList<HotPathRecord> records = HotPathLog::since(after, &m_hotPathSequence);
+    const qint64 startMs = m_startTime.toMSecsSinceEpoch();
+    qsizetype nextRecord = 0;
+
+    bool wrote = false;
+    auto writeRecordsUntil = [&](qint64 timeMs) {
+        for (; nextRecord < records.size() && records[nextRecord].timeMs - startMs <= timeMs; ++nextRecord) {
+            if (!isLogFileOpen()) continue;
+            // The ring wrapped (or was cleared) between flushes: say so rather than leave a silent hole
+            const quint64 missed = records.first().sequence - after - 1;
+            if (nextRecord == 0 && after > 0 && missed > 0) {
+                appendToFile(QString("[%1] %2 (%3 hot-path records dropped before they were written)\n")
+                    .arg((records.first().timeMs - startMs) / 1000.0, 8, 'f', 3)
+                    .arg(QStringLiteral("WARN"), -5)
+                    .arg(missed).toUtf8());
+            }
+            appendToFile(formatHotPathRecord(records[nextRecord]));
+            wrote = true;
+        }
+    };
+
+    while (PendingLine* next = m_queueTail->next.load(std::memory_order_acquire)) {
+        writeRecordsUntil(next->timeMs);
+        if (isLogFileOpen()) {
+            appendToFile(next->data);
+            wrote = true;
+        }
+        m_pendingBytes.fetch_sub(next->data.size(), std::memory_order_relaxed);
+
+        // next becomes the new stub
+        delete m_queueTail;
+        m_queueTail = next;
+        next->data.clear();
+    }
+    writeRecordsUntil(std::numeric_limits<qint64>::max());
+
+    if (wrote) {
+        writeBatch();
+    }
+}
+
+void WebDebugLogger::appendToFile(const QByteArray& data)
+{
+    m_batch += data;
+    m_fileSize += data.size();
+    if (m_fileSize >= SEGMENT_SIZE) {
+        writeBatch();
+        rotateSegment();
+    }
+}
+
+void WebDebugLogger::writeBatch()
+{
+    const int fd = m_fd.load(std::memory_order_acquire);
+    if (fd >= 0) {
+        writeAll(fd, m_batch.constData(), m_batch.size());
+    }
+    m_batch.clear();
+}
+
+QByteArray WebDebugLogger::formatHotPathRecord(const HotPathRecord& record) const
+{
+    return QString("[%1] %2 %3\n")
+        .arg((record.timeMs - m_startTime.toMSecsSinceEpoch()) / 1000.0, 8, 'f', 3)
+        .arg(QStringLiteral("DEBUG"), -5)
+        .arg(record.message()).toUtf8();
+}
+
+void WebDebugLogger::crashFlush()
+{
+    // Called from the crash signal handler: no locks, no allocation, no QFile.
+    // Lines are already formatted and the descriptor is already open, so this
+    // is atomics and write() only. If the writer is mid-flush (maybe the
+    // crashing thread), the queue is half consumed - leave it.
+    WebDebugLogger* self = s_instance;
+    if (!self || self->m_fileBusy.exchange(true, std::memory_order_acquire)) {
+        return;
+    }
+
+    const int fd = self->m_fd.load(std::memory_order_acquire);
+    if (fd >= 0) {
+        // Unwritten hot-path records are left alone: formatting them allocates.
+        // FlightRecorder's dump has the last BLE writes and samples instead.
+        PendingLine* node = self->m_queueTail->next.load(std::memory_order_acquire);
+        while (node) {
+            writeAll(fd, node->data.constData(), node->data.size());
+            node = node->next.load(std::memory_order_acquire);
+        }
+    }
+    // Left busy on purpose: the process is going down
 }
 
 QString WebDebugLogger::getPersistedLog() const
 {
-    QFile file(m_logFilePath);
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return QString::fromUtf8(file.readAll());
+    const_cast<WebDebugLogger*>(this)->flush();
+
+    QString result;
+    for (const QString& path : {m_previousSegmentPath, m_logFilePath}) {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            result += QString::fromUtf8(file.readAll());
+        }
     }
-    return QString();
+    return result;
 }
 
 QString WebDebugLogger::logFilePath() const
@@ -177,12 +375,39 @@ void WebDebugLogger::clear(bool clearFile)
 
     if (clearFile && !m_logFilePath.isEmpty()) {
         locker.unlock();
+        QMutexLocker fileLock(&m_fileMutex);
+        if (m_fileBusy.exchange(true, std::memory_order_acquire)) {
+            return;  // The crash handler has taken over the file
+        }
+        drainQueue();
+        HotPathLog::since(0, &m_hotPathSequence);  // Skip records from before the clear
+        closeLogFile();
+        QFile::remove(m_previousSegmentPath);
         QFile file(m_logFilePath);
-        if (file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
-            QTextStream stream(&file);
-            stream << "========== LOG CLEARED: " << QDateTime::currentDateTime().toString(Qt::ISODate) << " ==========\n";
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write("========== LOG CLEARED: " + QDateTime::currentDateTime().toString(Qt::ISODate).toUtf8() + " ==========\n");
+            file.close();
         }
+        openLogFile();
+        m_fileBusy.store(false, std::memory_order_release);
+    }
+}
+
+QStringList WebDebugLogger::getHotPathLines(quint64 afterSequence, quint64* lastSequence) const
+{
+    // Formatting happens here, on read - never when the record was taken
+    const QList<HotPathRecord> records = HotPathLog::since(afterSequence, lastSequence);
+    const qint64 startMs = m_startTime.toMSecsSinceEpoch();
+
+    QStringList lines;
+    lines.reserve(records.size());
+    for (const HotPathRecord& record : records) {
+        lines.append(QString("[%1] %2 %3")
+            .arg((record.timeMs - startMs) / 1000.0, 8, 'f', 3)
+            .arg(QStringLiteral("DEBUG"), -5)
+            .arg(record.message()));
     }
+    return lines;
 }
 
 int WebDebugLogger::lineCount() const
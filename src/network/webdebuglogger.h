@@ -5,12 +5,28 @@
 #include <QStringList>
 #include <QElapsedTimer>
 #include <QDateTime>
-#include <QFile>
+#include <QWaitCondition>
+#include <atomic>
+
+class QThread;
+struct HotPathRecord;
 
 /**
  * Captures Qt debug output for streaming to web interface.
  * Maintains a ring buffer of recent log messages in memory,
  * and persists to a file for crash recovery.
+ *
+ * Persistence is asynchronous: the message handler pushes lines onto a
+ * lock-free queue and a writer thread appends them to the open log file
+ * every FLUSH_INTERVAL_MS (sooner once FLUSH_BYTES are pending). The log is
+ * two segments - debug.log and debug.1.log - rotated by rename when the
+ * current one reaches SEGMENT_SIZE, so nothing is ever read back and rewritten.
+ *
+ * HOT_LOG records (HotPathLog) never pass through the message handler; the
+ * writer formats whatever the ring gained since its last flush and merges it
+ * with the queued lines by time, so debug.log stays in order. crashFlush()
+ * only writes lines that are already formatted; the last BLE writes and
+ * samples before a crash are in the FlightRecorder dump.
  */
 class WebDebugLogger : public QObject {
     Q_OBJECT
@@ -34,17 +50,41 @@ public:
     // Get current line count (for polling comparison)
     int lineCount() const;
 
-    // Get log file path
+    // Hot-path records (see HotPathLog) after a sequence number, formatted like getLines()
+    QStringList getHotPathLines(quint64 afterSequence, quint64* lastSequence = nullptr) const;
+
+    // Get log file path (current segment)
     QString logFilePath() const;
 
+    // Write queued lines to disk now
+    void flush();
+
+    // Final flush and stop the writer thread; later messages are written synchronously
+    void shutdown();
+
 private:
+    struct PendingLine {
+        std::atomic<PendingLine*> next{nullptr};
+        QByteArray data;
+        qint64 timeMs = 0;  // Since session start, for merging with hot-path records
+    };
+
     explicit WebDebugLogger(QObject* parent = nullptr);
 
     void handleMessage(QtMsgType type, const QString& message);
-    void writeToFile(const QString& line);
-    void trimLogFile();
+    void enqueue(const QString& line, qint64 timeMs);
+    void drainQueue();      // Caller holds m_fileMutex (single consumer); merges in hot-path records
+    void appendToFile(const QByteArray& data);  // Caller holds m_fileMutex; rotates when full
+    void writeBatch();      // Caller holds m_fileMutex
+    QByteArray formatHotPathRecord(const HotPathRecord& record) const;
+    void openLogFile();
+    void closeLogFile();
+    bool isLogFileOpen() const { return m_fd.load(std::memory_order_acquire) >= 0; }
+    void rotateSegment();
+    void writerLoop();
 
     static void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg);
+    static void crashFlush();  // Best effort, from the crash signal handler
     static QtMessageHandler s_previousHandler;
     static WebDebugLogger* s_instance;
 
@@ -56,5 +96,25 @@ private:
 
     // File persistence
     QString m_logFilePath;
-    static constexpr qint64 MAX_LOG_FILE_SIZE = 500 * 1024;  // 500KB - enough for ~5-10 min with BLE noise
+    QString m_previousSegmentPath;
+    std::atomic<int> m_fd{-1};      // Raw descriptor, so crashFlush() can use ::write()
+    QByteArray m_batch;             // Lines of the current flush, written in one go
+    qint64 m_fileSize = 0;
+    quint64 m_hotPathSequence = 0;  // Newest HotPathLog record written to the file
+    QMutex m_fileMutex;
+    std::atomic<bool> m_fileBusy{false};  // Queue and file in use; lock-free so the crash handler can test it
+
+    // Multi-producer single-consumer queue: producers swap m_queueHead, the writer walks from m_queueTail
+    std::atomic<PendingLine*> m_queueHead;
+    PendingLine* m_queueTail;
+    std::atomic<qint64> m_pendingBytes{0};
+
+    QThread* m_writer = nullptr;
+    QMutex m_wakeMutex;
+    QWaitCondition m_wake;
+    std::atomic<bool> m_stopping{false};
+
+    static constexpr qint64 SEGMENT_SIZE = 256 * 1024;  // Two segments keep ~5-10 min with BLE noise
+    static constexpr qint64 FLUSH_BYTES = 32 * 1024;
+    static constexpr int FLUSH_INTERVAL_MS = 500;
 };
@@ -2,11 +2,12 @@
 #include "recipegenerator.h"
 #include "recipeanalyzer.h"
 #include "../ble/protocol/binarycodec.h"
+#include "../core/tcltokenizer.h"
+#include <QCryptographicHash>
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QTextStream>
-#include <QRegularExpression>
 #include <QDebug>
 
 // Generate frames for simple pressure profile (settings_2a)
@@ -33,15 +34,15 @@ static QVector<ProfileFrame> generatePressureProfileFrames(
         ProfileFrame preinfusion;
         preinfusion.name = "preinfusion";
         preinfusion.temperature = temp1;
-        preinfusion.sensor = "coffee";
-        preinfusion.pump = "flow";
-        preinfusion.transition = "fast";
+        preinfusion.sensor = ProfileFrame::Sensor::Coffee;
+        preinfusion.pump = ProfileFrame::Pump::Flow;
+        preinfusion.transition = ProfileFrame::Transition::Fast;
         preinfusion.pressure = 1.0;
         preinfusion.flow = preinfusionFlowRate;
         preinfusion.seconds = preinfusionTime;
         preinfusion.volume = 0;
         preinfusion.exitIf = true;
-        preinfusion.exitType = "pressure_over";
+        preinfusion.exitType = ProfileFrame::Exit::PressureOver;
         preinfusion.exitPressureOver = preinfusionStopPressure;
         preinfusion.exitFlowOver = 6.0;
         frames.append(preinfusion);
@@ -54,9 +55,9 @@ static QVector<ProfileFrame> generatePressureProfileFrames(
             ProfileFrame riseNoLimit;
             riseNoLimit.name = "forced rise without limit";
             riseNoLimit.temperature = temp2;
-            riseNoLimit.sensor = "coffee";
-            riseNoLimit.pump = "pressure";
-            riseNoLimit.transition = "fast";
+            riseNoLimit.sensor = ProfileFrame::Sensor::Coffee;
+            riseNoLimit.pump = ProfileFrame::Pump::Pressure;
+            riseNoLimit.transition = ProfileFrame::Transition::Fast;
             riseNoLimit.pressure = espressoPressure;
             riseNoLimit.seconds = 3.0;
             riseNoLimit.volume = 0;
@@ -68,9 +69,9 @@ static QVector<ProfileFrame> generatePressureProfileFrames(
         ProfileFrame hold;
         hold.name = "rise and hold";
         hold.temperature = temp2;
-        hold.sensor = "coffee";
-        hold.pump = "pressure";
-        hold.transition = "fast";
+        hold.sensor = ProfileFrame::Sensor::Coffee;
+        hold.pump = ProfileFrame::Pump::Pressure;
+        hold.transition = ProfileFrame::Transition::Fast;
         hold.pressure = espressoPressure;
         hold.seconds = holdTime;
         hold.volume = 0;
@@ -89,9 +90,9 @@ static QVector<ProfileFrame> generatePressureProfileFrames(
             ProfileFrame riseNoLimit;
             riseNoLimit.name = "forced rise without limit";
             riseNoLimit.temperature = temp3;
-            riseNoLimit.sensor = "coffee";
-            riseNoLimit.pump = "pressure";
-            riseNoLimit.transition = "fast";
+            riseNoLimit.sensor = ProfileFrame::Sensor::Coffee;
+            riseNoLimit.pump = ProfileFrame::Pump::Pressure;
+            riseNoLimit.transition = ProfileFrame::Transition::Fast;
             riseNoLimit.pressure = espressoPressure;
             riseNoLimit.seconds = 3.0;
             riseNoLimit.volume = 0;
@@ -103,9 +104,9 @@ static QVector<ProfileFrame> generatePressureProfileFrames(
         ProfileFrame decline;
         decline.name = "decline";
         decline.temperature = temp3;
-        decline.sensor = "coffee";
-        decline.pump = "pressure";
-        decline.transition = "smooth";
+        decline.sensor = ProfileFrame::Sensor::Coffee;
+        decline.pump = ProfileFrame::Pump::Pressure;
+        decline.transition = ProfileFrame::Transition::Smooth;
         decline.pressure = pressureEnd;
         decline.seconds = declineTime;
         decline.volume = 0;
@@ -123,9 +124,9 @@ static QVector<ProfileFrame> generatePressureProfileFrames(
         ProfileFrame empty;
         empty.name = "empty";
         empty.temperature = 90.0;
-        empty.sensor = "coffee";
-        empty.pump = "flow";
-        empty.transition = "smooth";
+        empty.sensor = ProfileFrame::Sensor::Coffee;
+        empty.pump = ProfileFrame::Pump::Flow;
+        empty.transition = ProfileFrame::Transition::Smooth;
         empty.flow = 0;
         empty.seconds = 0;
         empty.volume = 0;
@@ -160,15 +161,15 @@ static QVector<ProfileFrame> generateFlowProfileFrames(
         ProfileFrame preinfusion;
         preinfusion.name = "preinfusion";
         preinfusion.temperature = temp1;
-        preinfusion.sensor = "coffee";
-        preinfusion.pump = "flow";
-        preinfusion.transition = "fast";
+        preinfusion.sensor = ProfileFrame::Sensor::Coffee;
+        preinfusion.pump = ProfileFrame::Pump::Flow;
+        preinfusion.transition = ProfileFrame::Transition::Fast;
         preinfusion.pressure = 1.0;
         preinfusion.flow = preinfusionFlowRate;
         preinfusion.seconds = preinfusionTime;
         preinfusion.volume = 0;
         preinfusion.exitIf = true;
-        preinfusion.exitType = "pressure_over";
+        preinfusion.exitType = ProfileFrame::Exit::PressureOver;
         preinfusion.exitPressureOver = preinfusionStopPressure;
         frames.append(preinfusion);
     }
@@ -178,9 +179,9 @@ static QVector<ProfileFrame> generateFlowProfileFrames(
         ProfileFrame hold;
         hold.name = "hold";
         hold.temperature = temp2;
-        hold.sensor = "coffee";
-        hold.pump = "flow";
-        hold.transition = "fast";
+        hold.sensor = ProfileFrame::Sensor::Coffee;
+        hold.pump = ProfileFrame::Pump::Flow;
+        hold.transition = ProfileFrame::Transition::Fast;
         hold.flow = flowHold;
         hold.seconds = holdTime;
         hold.volume = 0;
@@ -198,9 +199,9 @@ static QVector<ProfileFrame> generateFlowProfileFrames(
         ProfileFrame decline;
         decline.name = "decline";
         decline.temperature = temp3;
-        decline.sensor = "coffee";
-        decline.pump = "flow";
-        decline.transition = "smooth";
+        decline.sensor = ProfileFrame::Sensor::Coffee;
+        decline.pump = ProfileFrame::Pump::Flow;
+        decline.transition = ProfileFrame::Transition::Smooth;
         decline.flow = flowDecline;
         decline.seconds = declineTime;
         decline.volume = 0;
@@ -217,9 +218,9 @@ static QVector<ProfileFrame> generateFlowProfileFrames(
         ProfileFrame empty;
         empty.name = "empty";
         empty.temperature = 90.0;
-        empty.sensor = "coffee";
-        empty.pump = "flow";
-        empty.transition = "smooth";
+        empty.sensor = ProfileFrame::Sensor::Coffee;
+        empty.pump = ProfileFrame::Pump::Flow;
+        empty.transition = ProfileFrame::Transition::Smooth;
         empty.flow = 0;
         empty.seconds = 0;
         empty.volume = 0;
@@ -391,25 +392,16 @@ Profile Profile::loadFromTclString(const QString& content) {
 
     Profile profile;
 
-    // Helper to extract Tcl variable value
-    // Handles: varName {braced value} OR varName "quoted" OR varName simple_word
-    auto extractValue = [&content](const QString& varName) -> QString {
-        // Try braced value first: varName {content}
-        QRegularExpression reBraced(varName + "\\s+\\{([^}]*)\\}");
-        QRegularExpressionMatch match = reBraced.match(content);
-        if (match.hasMatch()) {
-            return match.captured(1);
-        }
-        // Try quoted value: varName "content"
-        QRegularExpression reQuoted(varName + "\\s+\"([^\"]*)\"");
-        match = reQuoted.match(content);
-        if (match.hasMatch()) {
-            return match.captured(1);
-        }
-        // Try simple word value: varName word
-        QRegularExpression reSimple(varName + "\\s+(\\S+)");
-        match = reSimple.match(content);
-        return match.hasMatch() ? match.captured(1) : QString();
+    // The file is one Tcl dict: varName {braced value} OR varName "quoted" OR varName simple_word.
+    // Tokenized once; values are views into content until converted.
+    bool malformed = false;
+    const QHash<QStringView, QStringView> values = TclTokenizer::dict(content, &malformed);
+    if (malformed) {
+        qWarning() << "loadFromTclString: Unbalanced braces or quotes, profile may be incomplete";
+    }
+
+    auto extractValue = [&values](const QString& varName) -> QString {
+        return values.value(varName).toString();
     };
 
     // Extract metadata
@@ -472,33 +464,12 @@ Profile Profile::loadFromTclString(const QString& content) {
 
     // Extract advanced_shot steps
     // Format: advanced_shot {{step1 props} {step2 props} ...}
-    QRegularExpression shotRe("advanced_shot\\s+\\{(.*?)\\}\\s*$",
-        QRegularExpression::MultilineOption | QRegularExpression::DotMatchesEverythingOption);
-    QRegularExpressionMatch shotMatch = shotRe.match(content);
-
-    if (shotMatch.hasMatch()) {
-        QString stepsContent = shotMatch.captured(1);
-
-        // Parse each step (nested braces)
-        int depth = 0;
-        int stepStart = -1;
-
-        for (int i = 0; i < stepsContent.length(); i++) {
-            QChar c = stepsContent[i];
-            if (c == '{') {
-                if (depth == 0) stepStart = i;
-                depth++;
-            } else if (c == '}') {
-                depth--;
-                if (depth == 0 && stepStart >= 0) {
-                    QString stepStr = stepsContent.mid(stepStart, i - stepStart + 1);
-                    ProfileFrame frame = ProfileFrame::fromTclList(stepStr);
-                    if (!frame.name.isEmpty() || frame.seconds > 0) {
-                        profile.m_steps.append(frame);
-                    }
-                    stepStart = -1;
-                }
-            }
+    TclTokenizer steps(values.value(u"advanced_shot"));
+    QStringView stepStr;
+    while (steps.next(&stepStr)) {
+        ProfileFrame frame = ProfileFrame::fromTclList(stepStr);
+        if (!frame.name.isEmpty() || frame.seconds > 0) {
+            profile.m_steps.append(frame);
         }
     }
 
@@ -569,7 +540,7 @@ Profile Profile::loadFromTclString(const QString& content) {
     // Usually the first step(s) with exit conditions
     profile.m_preinfuseFrameCount = 0;
     for (const auto& step : profile.m_steps) {
-        if (step.exitIf && (step.exitType == "pressure_over" || step.exitType == "flow_over")) {
+        if (step.exitIf && (step.exitType == ProfileFrame::Exit::PressureOver || step.exitType == ProfileFrame::Exit::FlowOver)) {
             profile.m_preinfuseFrameCount++;
         } else {
             break;
@@ -632,9 +603,9 @@ Profile Profile::loadFromDE1AppJson(const QString& jsonContent) {
 
         frame.name = stepJson["name"].toString();
         frame.temperature = toDouble(stepJson["temperature"], 93.0);
-        frame.sensor = stepJson["sensor"].toString("coffee");
-        frame.pump = stepJson["pump"].toString("flow");
-        frame.transition = stepJson["transition"].toString("fast");
+        frame.sensor = ProfileFrame::parseSensor(stepJson["sensor"].toString("coffee"));
+        frame.pump = ProfileFrame::parsePump(stepJson["pump"].toString("flow"));
+        frame.transition = ProfileFrame::parseTransition(stepJson["transition"].toString("fast"));
         frame.pressure = toDouble(stepJson["pressure"], 0.0);
         frame.flow = toDouble(stepJson["flow"], 0.0);
         frame.seconds = toDouble(stepJson["seconds"], 0.0);
@@ -651,22 +622,22 @@ Profile Profile::loadFromDE1AppJson(const QString& jsonContent) {
             // Handle specific exit types
             if (exitType == "pressure") {
                 if (exitCondition == "over") {
-                    frame.exitType = "pressure_over";
+                    frame.exitType = ProfileFrame::Exit::PressureOver;
                     frame.exitPressureOver = exitValue;
                 } else {
-                    frame.exitType = "pressure_under";
+                    frame.exitType = ProfileFrame::Exit::PressureUnder;
                     frame.exitPressureUnder = exitValue;
                 }
             } else if (exitType == "flow") {
                 if (exitCondition == "over") {
-                    frame.exitType = "flow_over";
+                    frame.exitType = ProfileFrame::Exit::FlowOver;
                     frame.exitFlowOver = exitValue;
                 } else {
-                    frame.exitType = "flow_under";
+                    frame.exitType = ProfileFrame::Exit::FlowUnder;
                     frame.exitFlowUnder = exitValue;
                 }
             } else if (exitType == "weight") {
-                frame.exitType = "weight";
+                frame.exitType = ProfileFrame::Exit::Weight;
                 frame.exitWeight = exitValue;
             }
         }
@@ -683,9 +654,9 @@ Profile Profile::loadFromDE1AppJson(const QString& jsonContent) {
         if (weightExit > 0) {
             frame.exitWeight = weightExit;
             // Only set exitIf/exitType if no machine-side exit is defined
-            if (frame.exitType.isEmpty()) {
+            if (frame.exitType == ProfileFrame::Exit::None) {
                 frame.exitIf = true;
-                frame.exitType = "weight";
+                frame.exitType = ProfileFrame::Exit::Weight;
             }
         }
 
@@ -731,6 +702,114 @@ bool Profile::isValid() const {
     return !m_steps.isEmpty() && m_steps.size() <= MAX_FRAMES;
 }
 
+QVector<Profile::FrameInfo> Profile::frameTable() const {
+    QVector<FrameInfo> table;
+    table.reserve(m_steps.size());
+    for (const ProfileFrame& frame : m_steps) {
+        FrameInfo info;
+        info.name = frame.name;
+        info.isFlowMode = frame.isFlowControl();
+        table.append(info);
+    }
+    return table;
+}
+
+QByteArray Profile::contentHash() const {
+    QByteArray canonical;
+    canonical.reserve(64 + m_steps.size() * 96);
+    auto addValue = [&canonical](double value) {
+        canonical.append(QByteArray::number(qRound64(value * 10.0))).append(',');
+    };
+    auto addString = [&canonical](const QString& value) {
+        canonical.append(value.toUtf8()).append(',');
+    };
+
+    addValue(m_targetWeight);
+    addValue(m_targetVolume);
+    canonical.append(QByteArray::number(m_steps.size())).append(';');
+
+    for (const ProfileFrame& frame : m_steps) {
+        addValue(frame.temperature);
+        addString(ProfileFrame::toString(frame.sensor));
+        addString(ProfileFrame::toString(frame.pump));
+        addString(ProfileFrame::toString(frame.transition));
+        addValue(frame.pressure);
+        addValue(frame.flow);
+        addValue(frame.seconds);
+        addValue(frame.volume);
+
+        // Exit condition values only matter when the exit is enabled
+        canonical.append(frame.exitIf ? "1," : "0,");
+        if (frame.exitIf) {
+            addString(ProfileFrame::toString(frame.exitType));
+            addValue(frame.exitPressureOver);
+            addValue(frame.exitPressureUnder);
+            addValue(frame.exitFlowOver);
+            addValue(frame.exitFlowUnder);
+        }
+
+        // Weight exit (independent of exitIf)
+        addValue(frame.exitWeight);
+
+        // Limiter
+        addValue(frame.maxFlowOrPressure);
+        addValue(frame.maxFlowOrPressureRange);
+        canonical.append(';');
+    }
+
+    return QCryptographicHash::hash(canonical, QCryptographicHash::Sha1);
+}
+
+bool Profile::hasSameFrames(const Profile& other) const {
+    if (m_steps.size() != other.m_steps.size()) {
+        return false;
+    }
+
+    auto within = [](double a, double b) { return qAbs(a - b) <= 0.1; };
+    for (int i = 0; i < m_steps.size(); i++) {
+        const ProfileFrame& fa = m_steps[i];
+        const ProfileFrame& fb = other.m_steps[i];
+
+        // Compare all frame parameters that affect extraction
+        if (!within(fa.temperature, fb.temperature)) return false;
+        if (fa.sensor != fb.sensor) return false;
+        if (fa.pump != fb.pump) return false;
+        if (fa.transition != fb.transition) return false;
+        if (!within(fa.pressure, fb.pressure)) return false;
+        if (!within(fa.flow, fb.flow)) return false;
+        if (!within(fa.seconds, fb.seconds)) return false;
+        if (!within(fa.volume, fb.volume)) return false;
+
+        // Exit conditions
+        if (fa.exitIf != fb.exitIf) return false;
+        if (fa.exitIf) {
+            if (fa.exitType != fb.exitType) return false;
+            if (!within(fa.exitPressureOver, fb.exitPressureOver)) return false;
+            if (!within(fa.exitPressureUnder, fb.exitPressureUnder)) return false;
+            if (!within(fa.exitFlowOver, fb.exitFlowOver)) return false;
+            if (!within(fa.exitFlowUnder, fb.exitFlowUnder)) return false;
+        }
+
+        // Limiter
+        if (!within(fa.maxFlowOrPressure, fb.maxFlowOrPressure)) return false;
+        if (!within(fa.maxFlowOrPressureRange, fb.maxFlowOrPressureRange)) return false;
+    }
+
+    return true;
+}
+
+bool Profile::hasSameContent(const Profile& other) const {
+    if (qAbs(m_targetWeight - other.m_targetWeight) > 0.1) return false;
+    if (qAbs(m_targetVolume - other.m_targetVolume) > 0.1) return false;
+    if (!hasSameFrames(other)) return false;
+
+    // Weight exit (independent of exitIf)
+    for (int i = 0; i < m_steps.size(); i++) {
+        if (qAbs(m_steps[i].exitWeight - other.m_steps[i].exitWeight) > 0.1) return false;
+    }
+    return true;
+}
+
 QStringList Profile::validationErrors() const {
     QStringList errors;
 
@@ -94,6 +94,15 @@ public:
         if (index >= 0 && index < m_steps.size()) m_steps[index] = step;
     }
 
+    // Per-frame name and pump mode, flattened for the per-sample shot path so it
+    // does no string work and never touches (or detaches) the step list.
+    // Build once when a shot starts; the machine runs the uploaded copy anyway.
+    struct FrameInfo {
+        QString name;
+        bool isFlowMode = false;
+    };
+    QVector<FrameInfo> frameTable() const;
+
     int preinfuseFrameCount() const { return m_preinfuseFrameCount; }
     void setPreinfuseFrameCount(int count) { m_preinfuseFrameCount = count; }
 
@@ -148,6 +157,21 @@ public:
     bool isValid() const;
     QStringList validationErrors() const;
 
+    // === Comparison ===
+    // Hash of everything that affects extraction (frames and stop targets), with
+    // values rounded to 0.1 so a JSON round trip of a .tcl profile hashes the
+    // same. Metadata (title, notes, author) is not included. Equal hashes imply
+    // hasSameContent(); values within 0.1 of each other can still round apart
+    // (9.04 vs 9.06), so a differing hash needs hasSameContent() to be sure.
+    QByteArray contentHash() const;
+
+    // Frame parameters that affect extraction match within 0.1 (weight exits not included)
+    bool hasSameFrames(const Profile& other) const;
+
+    // Everything contentHash() covers matches within 0.1: the frames, each
+    // frame's weight exit, and the target weight and volume
+    bool hasSameContent(const Profile& other) const;
+
 private:
     // Metadata
     QString m_title = "Default";
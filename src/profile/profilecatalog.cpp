@@ -0,0 +1,174 @@
+#include "profilecatalog.h"
+#include "builtinprofilecatalog.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QDebug>
+#include <iterator>
+
+const QList<QPair<QString, ProfileCatalog::Entry>>& ProfileCatalog::builtInProfiles()
+{
+    static const QList<QPair<QString, Entry>> profiles = [] {
+        QList<QPair<QString, Entry>> list;
+        list.reserve(std::size(BUILTIN_PROFILES));
+        for (const BuiltInProfileEntry& builtIn : BUILTIN_PROFILES) {
+            Entry entry;
+            entry.title = QString::fromUtf8(builtIn.title);
+            entry.beverageType = QString::fromUtf8(builtIn.beverageType);
+            entry.isRecipeMode = builtIn.isRecipeMode;
+            list.append({QString::fromUtf8(builtIn.filename), entry});
+        }
+        return list;
+    }();
+    return profiles;
+}
+
+QString ProfileCatalog::indexPath() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/profile_catalog.dat";
+}
+
+void ProfileCatalog::beginScan()
+{
+    if (!m_loaded) {
+        load();
+    }
+    for (Record& record : m_records) {
+        record.seen = false;
+    }
+}
+
+void ProfileCatalog::endScan()
+{
+    for (auto it = m_records.begin(); it != m_records.end();) {
+        if (!it->seen) {
+            it = m_records.erase(it);
+            m_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (m_dirty) {
+        save();
+    }
+}
+
+bool ProfileCatalog::lookup(const QString& path, Entry* entry)
+{
+    if (!m_loaded) {
+        load();
+    }
+
+    QFileInfo info(path);
+    if (!info.exists()) {
+        return false;
+    }
+
+    const qint64 modifiedMs = info.lastModified().toMSecsSinceEpoch();
+    const qint64 size = info.size();
+
+    // A file written within the timestamp granularity may change again without
+    // its mtime moving, so those always fall through to the hash check
+    const bool settled = QDateTime::currentMSecsSinceEpoch() - modifiedMs > MTIME_GRANULARITY_MS;
+
+    auto it = m_records.find(path);
+    if (settled && it != m_records.end() && it->modifiedMs == modifiedMs && it->size == size) {
+        it->seen = true;
+        *entry = it->entry;
+        return true;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray content = file.readAll();
+    const QByteArray hash = QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+
+    Record record;
+    record.modifiedMs = modifiedMs;
+    record.size = size;
+    record.hash = hash;
+    record.seen = true;
+
+    if (it != m_records.end() && it->hash == hash) {
+        // Touched or copied, but the content is the same
+        record.entry = it->entry;
+    } else {
+        QJsonObject obj = QJsonDocument::fromJson(content).object();
+        record.entry.title = obj["title"].toString();
+        record.entry.beverageType = obj["beverage_type"].toString();
+        record.entry.isRecipeMode = obj["is_recipe_mode"].toBool(false);
+    }
+
+    m_records.insert(path, record);
+    m_dirty = true;
+    *entry = record.entry;
+    return true;
+}
+
+void ProfileCatalog::load()
+{
+    m_loaded = true;
+    m_records.clear();
+
+    QFile file(indexPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION) {
+        qDebug() << "ProfileCatalog: Ignoring index with unknown format";
+        return;
+    }
+
+    qint32 count = 0;
+    in >> count;
+    m_records.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Record record;
+        in >> path >> record.modifiedMs >> record.size >> record.hash
+           >> record.entry.title >> record.entry.beverageType >> record.entry.isRecipeMode;
+        if (in.status() == QDataStream::Ok) {
+            m_records.insert(path, record);
+        }
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "ProfileCatalog: Index is truncated, rebuilding";
+        m_records.clear();
+    }
+}
+
+void ProfileCatalog::save()
+{
+    QDir().mkpath(QFileInfo(indexPath()).absolutePath());
+
+    QFile file(indexPath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "ProfileCatalog: Failed to write index" << indexPath();
+        return;
+    }
+
+    QDataStream out(&file);
+    out << INDEX_MAGIC << INDEX_VERSION << static_cast<qint32>(m_records.size());
+    for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
+        const Record& record = it.value();
+        out << it.key() << record.modifiedMs << record.size << record.hash
+            << record.entry.title << record.entry.beverageType << record.entry.isRecipeMode;
+    }
+
+    m_dirty = false;
+}
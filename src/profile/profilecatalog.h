@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QPair>
+
+/**
+ * ProfileCatalog - Persisted index of profile metadata for the profile picker
+ *
+ * MainController::refreshProfiles() only needs the title, beverage type and
+ * recipe mode of each profile. Built-in profiles come from a table generated
+ * at build time (cmake/GenerateProfileCatalog.cmake). Profiles on disk are
+ * indexed by path and validated with a stat (mtime + size); a file is only
+ * re-read when those change, and only re-parsed when its content hash
+ * changed too. The index is saved to AppData between runs.
+ */
+class ProfileCatalog {
+public:
+    struct Entry {
+        QString title;
+        QString beverageType;
+        bool isRecipeMode = false;
+    };
+
+    // Built-in profiles as (filename without .json, metadata), sorted by filename
+    static const QList<QPair<QString, Entry>>& builtInProfiles();
+
+    // Call around a full refresh: entries not looked up in between are dropped,
+    // and the index is saved if anything changed
+    void beginScan();
+    void endScan();
+
+    // Metadata for a profile file. Returns false if the file can't be read.
+    bool lookup(const QString& path, Entry* entry);
+
+private:
+    struct Record {
+        qint64 modifiedMs = 0;
+        qint64 size = 0;
+        QByteArray hash;
+        Entry entry;
+        bool seen = false;
+    };
+
+    void load();
+    void save();
+    QString indexPath() const;
+
+    QHash<QString, Record> m_records;
+    bool m_loaded = false;
+    bool m_dirty = false;
+
+    static constexpr quint32 INDEX_MAGIC = 0x50434154;  // "PCAT"
+    static constexpr quint32 INDEX_VERSION = 1;
+    static constexpr qint64 MTIME_GRANULARITY_MS = 2000;  // FAT/exFAT external storage
+};
@@ -1,14 +1,59 @@
 #include "profileframe.h"
 #include "../ble/protocol/de1characteristics.h"
-#include <QRegularExpression>
+#include "../core/tcltokenizer.h"
+
+QString ProfileFrame::toString(Sensor sensor) {
+    return sensor == Sensor::Water ? QStringLiteral("water") : QStringLiteral("coffee");
+}
+
+QString ProfileFrame::toString(Pump pump) {
+    return pump == Pump::Flow ? QStringLiteral("flow") : QStringLiteral("pressure");
+}
+
+QString ProfileFrame::toString(Transition transition) {
+    return transition == Transition::Smooth ? QStringLiteral("smooth") : QStringLiteral("fast");
+}
+
+QString ProfileFrame::toString(Exit exit) {
+    switch (exit) {
+    case Exit::PressureOver:  return QStringLiteral("pressure_over");
+    case Exit::PressureUnder: return QStringLiteral("pressure_under");
+    case Exit::FlowOver:      return QStringLiteral("flow_over");
+    case Exit::FlowUnder:     return QStringLiteral("flow_under");
+    case Exit::Weight:        return QStringLiteral("weight");
+    case Exit::None:          break;
+    }
+    return QString();
+}
+
+ProfileFrame::Sensor ProfileFrame::parseSensor(QStringView name) {
+    return name == u"water" ? Sensor::Water : Sensor::Coffee;
+}
+
+ProfileFrame::Pump ProfileFrame::parsePump(QStringView name) {
+    return name == u"flow" ? Pump::Flow : Pump::Pressure;
+}
+
+ProfileFrame::Transition ProfileFrame::parseTransition(QStringView name) {
+    return name == u"smooth" ? Transition::Smooth : Transition::Fast;
+}
+
+ProfileFrame::Exit ProfileFrame::parseExit(QStringView name) {
+    if (name == u"pressure_over") return Exit::PressureOver;
+    if (name == u"pressure_under") return Exit::PressureUnder;
+    if (name == u"flow_over") return Exit::FlowOver;
+    if (name == u"flow_under") return Exit::FlowUnder;
+    if (name == u"weight") return Exit::Weight;
+    return Exit::None;
+}
 
 QJsonObject ProfileFrame::toJson() const {
     QJsonObject obj;
     obj["name"] = name;
     obj["temperature"] = temperature;
-    obj["sensor"] = sensor;
-    obj["pump"] = pump;
-    obj["transition"] = transition;
+    obj["sensor"] = toString(sensor);
+    obj["pump"] = toString(pump);
+    obj["transition"] = toString(transition);
     obj["pressure"] = pressure;
     obj["flow"] = flow;
     obj["seconds"] = seconds;
@@ -17,8 +62,8 @@ QJsonObject ProfileFrame::toJson() const {
     // Always include exit condition fields - they may be used even without exit_if
     // (e.g., weight can trigger exit independently via scale system)
     obj["exit_if"] = exitIf;
-    if (!exitType.isEmpty()) {
-        obj["exit_type"] = exitType;
+    if (exitType != Exit::None) {
+        obj["exit_type"] = toString(exitType);
     }
     if (exitPressureOver > 0) obj["exit_pressure_over"] = exitPressureOver;
     if (exitPressureUnder > 0) obj["exit_pressure_under"] = exitPressureUnder;
@@ -44,16 +89,16 @@ ProfileFrame ProfileFrame::fromJson(const QJsonObject& json) {
     ProfileFrame frame;
     frame.name = json["name"].toString();
     frame.temperature = json["temperature"].toDouble(93.0);
-    frame.sensor = json["sensor"].toString("coffee");
-    frame.pump = json["pump"].toString("pressure");
-    frame.transition = json["transition"].toString("fast");
+    frame.sensor = parseSensor(json["sensor"].toString());
+    frame.pump = parsePump(json["pump"].toString());
+    frame.transition = parseTransition(json["transition"].toString());
     frame.pressure = json["pressure"].toDouble(9.0);
     frame.flow = json["flow"].toDouble(2.0);
     frame.seconds = json["seconds"].toDouble(30.0);
     frame.volume = json["volume"].toDouble(0.0);
 
     frame.exitIf = json["exit_if"].toBool(false);
-    frame.exitType = json["exit_type"].toString();
+    frame.exitType = parseExit(json["exit_type"].toString());
     frame.exitPressureOver = json["exit_pressure_over"].toDouble(0.0);
     frame.exitPressureUnder = json["exit_pressure_under"].toDouble(0.0);
     frame.exitFlowOver = json["exit_flow_over"].toDouble(0.0);
@@ -68,74 +113,54 @@ ProfileFrame ProfileFrame::fromJson(const QJsonObject& json) {
     return frame;
 }
 
-ProfileFrame ProfileFrame::fromTclList(const QString& tclList) {
+ProfileFrame ProfileFrame::fromTclList(QStringView tclList) {
     // Parse de1app Tcl list format: {key value key value ...}
     // Example: {exit_if 1 flow 2.0 volume 100 transition fast exit_flow_under 0.0
     //           temperature 93.0 name {preinfusion} pressure 1.0 sensor coffee
     //           pump pressure exit_type pressure_over popup {$weight} seconds 10}
 
     ProfileFrame frame;
-    QString cleaned = tclList.trimmed();
 
-    // Remove outer braces if present
-    if (cleaned.startsWith('{') && cleaned.endsWith('}')) {
-        cleaned = cleaned.mid(1, cleaned.length() - 2);
-    }
-
-    // Parse key-value pairs
-    // Handle braced values {content}, quoted strings "content", and simple words
-    // Pattern: word + whitespace + ({braced} OR "quoted" OR simple_word)
-    QRegularExpression re("(\\w+)\\s+(?:\\{([^}]*)\\}|\"([^\"]*)\"|([^\\s]+))");
-    QRegularExpressionMatchIterator it = re.globalMatch(cleaned);
-
-    while (it.hasNext()) {
-        QRegularExpressionMatch match = it.next();
-        QString key = match.captured(1);
-        // Value is in capture group 2 (braced), 3 (quoted), or 4 (simple)
-        QString value;
-        if (!match.captured(2).isNull()) {
-            value = match.captured(2);  // Braced value (may be empty string)
-        } else if (!match.captured(3).isEmpty()) {
-            value = match.captured(3);  // Quoted value
-        } else {
-            value = match.captured(4);  // Simple value
-        }
-
-        if (key == "name") {
-            frame.name = value;
-        } else if (key == "temperature") {
+    // Values may be braced {content}, quoted "content" or simple words
+    TclTokenizer tokenizer(TclTokenizer::unwrap(tclList));
+    QStringView key;
+    QStringView value;
+    while (tokenizer.next(&key) && tokenizer.next(&value)) {
+        if (key == u"name") {
+            frame.name = value.toString();
+        } else if (key == u"temperature") {
             frame.temperature = value.toDouble();
-        } else if (key == "sensor") {
-            frame.sensor = value;
-        } else if (key == "pump") {
-            frame.pump = value;
-        } else if (key == "transition") {
-            frame.transition = (value == "smooth" || value == "slow") ? "smooth" : "fast";
-        } else if (key == "pressure") {
+        } else if (key == u"sensor") {
+            frame.sensor = parseSensor(value);
+        } else if (key == u"pump") {
+            frame.pump = parsePump(value);
+        } else if (key == u"transition") {
+            frame.transition = value == u"slow" ? Transition::Smooth : parseTransition(value);
+        } else if (key == u"pressure") {
             frame.pressure = value.toDouble();
-        } else if (key == "flow") {
+        } else if (key == u"flow") {
             frame.flow = value.toDouble();
-        } else if (key == "seconds") {
+        } else if (key == u"seconds") {
             frame.seconds = value.toDouble();
-        } else if (key == "volume") {
+        } else if (key == u"volume") {
             frame.volume = value.toDouble();
-        } else if (key == "exit_if") {
-            frame.exitIf = (value == "1" || value == "true");
-        } else if (key == "exit_type") {
-            frame.exitType = value;
-        } else if (key == "exit_pressure_over") {
+        } else if (key == u"exit_if") {
+            frame.exitIf = (value == u"1" || value == u"true");
+        } else if (key == u"exit_type") {
+            frame.exitType = parseExit(value);
+        } else if (key == u"exit_pressure_over") {
             frame.exitPressureOver = value.toDouble();
-        } else if (key == "exit_pressure_under") {
+        } else if (key == u"exit_pressure_under") {
             frame.exitPressureUnder = value.toDouble();
-        } else if (key == "exit_flow_over") {
+        } else if (key == u"exit_flow_over") {
             frame.exitFlowOver = value.toDouble();
-        } else if (key == "exit_flow_under") {
+        } else if (key == u"exit_flow_under") {
             frame.exitFlowUnder = value.toDouble();
-        } else if (key == "max_flow_or_pressure") {
+        } else if (key == u"max_flow_or_pressure") {
             frame.maxFlowOrPressure = value.toDouble();
-        } else if (key == "max_flow_or_pressure_range") {
+        } else if (key == u"max_flow_or_pressure_range") {
             frame.maxFlowOrPressureRange = value.toDouble();
-        } else if (key == "weight") {
+        } else if (key == u"weight") {
             // Per-frame weight exit condition (requires scale)
             // NOTE: Weight exit is INDEPENDENT of exitIf - in de1app, a frame can have
             // exit_if 0 (no machine-side exit) with weight > 0 (app-side weight exit).
@@ -145,10 +170,10 @@ ProfileFrame ProfileFrame::fromTclList(const QString& tclList) {
                 frame.exitWeight = weightVal;
                 // Do NOT set exitIf or exitType here - weight is independent
             }
-        } else if (key == "popup") {
+        } else if (key == u"popup") {
             // User notification message during this frame
             if (!value.isEmpty()) {
-                frame.popup = value;
+                frame.popup = value.toString();
             }
         }
     }
@@ -158,7 +183,7 @@ ProfileFrame ProfileFrame::fromTclList(const QString& tclList) {
 
 ProfileFrame ProfileFrame::withSetpoint(double pressureOrFlow, double temp) const {
     ProfileFrame copy = *this;
-    if (copy.pump == "flow") {
+    if (copy.pump == Pump::Flow) {
         copy.flow = pressureOrFlow;
     } else {
         copy.pressure = pressureOrFlow;
@@ -171,31 +196,39 @@ uint8_t ProfileFrame::computeFlags() const {
     uint8_t flags = DE1::FrameFlag::IgnoreLimit;  // Default
 
     // Flow vs pressure control
-    if (pump == "flow") {
+    if (pump == Pump::Flow) {
         flags |= DE1::FrameFlag::CtrlF;
     }
 
     // Mix temp vs basket temp
-    if (sensor == "water") {
+    if (sensor == Sensor::Water) {
         flags |= DE1::FrameFlag::TMixTemp;
     }
 
     // Smooth transition (interpolate)
-    if (transition == "smooth") {
+    if (transition == Transition::Smooth) {
         flags |= DE1::FrameFlag::Interpolate;
     }
 
     // Exit conditions
     if (exitIf) {
-        if (exitType == "pressure_under") {
+        switch (exitType) {
+        case Exit::PressureUnder:
             flags |= DE1::FrameFlag::DoCompare;
             // DC_GT = 0 (less than), DC_CompF = 0 (pressure)
-        } else if (exitType == "pressure_over") {
+            break;
+        case Exit::PressureOver:
             flags |= DE1::FrameFlag::DoCompare | DE1::FrameFlag::DC_GT;
-        } else if (exitType == "flow_under") {
+            break;
+        case Exit::FlowUnder:
             flags |= DE1::FrameFlag::DoCompare | DE1::FrameFlag::DC_CompF;
-        } else if (exitType == "flow_over") {
+            break;
+        case Exit::FlowOver:
             flags |= DE1::FrameFlag::DoCompare | DE1::FrameFlag::DC_GT | DE1::FrameFlag::DC_CompF;
+            break;
+        case Exit::None:
+        case Exit::Weight:  // App-side, not a machine compare
+            break;
         }
     }
 
@@ -203,16 +236,19 @@ uint8_t ProfileFrame::computeFlags() const {
 }
 
 double ProfileFrame::getSetVal() const {
-    return (pump == "flow") ? flow : pressure;
+    return (pump == Pump::Flow) ? flow : pressure;
 }
 
 double ProfileFrame::getTriggerVal() const {
     if (!exitIf) return 0.0;
 
-    if (exitType == "pressure_under") return exitPressureUnder;
-    if (exitType == "pressure_over") return exitPressureOver;
-    if (exitType == "flow_under") return exitFlowUnder;
-    if (exitType == "flow_over") return exitFlowOver;
-
+    switch (exitType) {
+    case Exit::PressureUnder: return exitPressureUnder;
+    case Exit::PressureOver:  return exitPressureOver;
+    case Exit::FlowUnder:     return exitFlowUnder;
+    case Exit::FlowOver:      return exitFlowOver;
+    case Exit::None:
+    case Exit::Weight:        break;
+    }
     return 0.0;
 }
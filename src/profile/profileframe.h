@@ -17,14 +17,22 @@
  *
  * Extension Frame (for limiters, +32 to frame number):
  *   FrameToWrite (1), MaxFlowOrPressure (U8P4, 1), Range (U8P4, 1), [padding]
+ *
+ * Sensor, pump, transition and exit type are enums; their de1app/JSON string
+ * names only appear at the JSON/Tcl boundaries (toString / parse* below).
  */
 struct ProfileFrame {
+    enum class Sensor : quint8 { Coffee, Water };
+    enum class Pump : quint8 { Pressure, Flow };
+    enum class Transition : quint8 { Fast, Smooth };
+    enum class Exit : quint8 { None, PressureOver, PressureUnder, FlowOver, FlowUnder, Weight };
+
     // === Basic Frame Properties ===
     QString name;                   // Human-readable step name (e.g., "Preinfusion")
     double temperature = 93.0;      // Target temperature (Celsius, range 0-127.5)
-    QString sensor = "coffee";      // Temperature sensor: "coffee" (basket) or "water" (mix temp)
-    QString pump = "pressure";      // Control mode: "pressure" or "flow"
-    QString transition = "fast";    // Transition type: "fast" (instant) or "smooth" (interpolate)
+    Sensor sensor = Sensor::Coffee; // Temperature sensor: coffee (basket) or water (mix temp)
+    Pump pump = Pump::Pressure;     // Control mode: pressure or flow
+    Transition transition = Transition::Fast;  // Fast (instant) or smooth (interpolate)
     double pressure = 9.0;          // Target pressure (bar, range 0-15.9375)
     double flow = 2.0;              // Target flow (mL/s, range 0-15.9375)
     double seconds = 30.0;          // Frame duration (seconds, max ~127s)
@@ -33,7 +41,7 @@ struct ProfileFrame {
     // === Exit Conditions (DoCompare flag) ===
     // When exitIf is true, frame exits early if the condition is met
     bool exitIf = false;
-    QString exitType;               // "pressure_over", "pressure_under", "flow_over", "flow_under", "weight"
+    Exit exitType = Exit::None;     // Which of the values below the exit compares against
     double exitPressureOver = 0.0;  // Exit when pressure exceeds this (bar)
     double exitPressureUnder = 0.0; // Exit when pressure drops below this (bar)
     double exitFlowOver = 0.0;      // Exit when flow exceeds this (mL/s)
@@ -55,12 +63,24 @@ struct ProfileFrame {
     double previousFlow = 0.0;      // Starting flow for interpolation
     double previousTemperature = 0.0; // Starting temp for interpolation
 
+    // String names used in JSON, Tcl and QML ("coffee", "flow", "smooth", "pressure_over", ...)
+    static QString toString(Sensor sensor);
+    static QString toString(Pump pump);
+    static QString toString(Transition transition);
+    static QString toString(Exit exit);     // Empty for Exit::None
+
+    // Unknown or empty names give the default (coffee, pressure, fast, none)
+    static Sensor parseSensor(QStringView name);
+    static Pump parsePump(QStringView name);
+    static Transition parseTransition(QStringView name);
+    static Exit parseExit(QStringView name);
+
     // Convert to/from JSON (supports both our format and de1app format)
     QJsonObject toJson() const;
     static ProfileFrame fromJson(const QJsonObject& json);
 
     // Parse from de1app Tcl list format: {key value key value ...}
-    static ProfileFrame fromTclList(const QString& tclList);
+    static ProfileFrame fromTclList(QStringView tclList);
 
     // Compute frame flags for BLE
     uint8_t computeFlags() const;
@@ -72,7 +92,7 @@ struct ProfileFrame {
     double getTriggerVal() const;
 
     // Check if this frame uses flow control (vs pressure control)
-    bool isFlowControl() const { return pump == "flow"; }
+    bool isFlowControl() const { return pump == Pump::Flow; }
 
     // Check if this frame needs an extension frame (for limiters)
     bool needsExtensionFrame() const { return maxFlowOrPressure > 0; }
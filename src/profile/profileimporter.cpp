@@ -6,6 +6,8 @@
 #include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
+#include <QDateTime>
+#include <QMutexLocker>
 #include <QStandardPaths>
 #include <QTimer>
 #include <QRegularExpression>
@@ -18,6 +20,12 @@ ProfileImporter::ProfileImporter(MainController* controller, Settings* settings,
 {
 }
 
+ProfileImporter::~ProfileImporter()
+{
+    m_scanPool.clear();
+    m_scanPool.waitForDone();
+}
+
 QString ProfileImporter::detectDE1AppPath() const
 {
     // Common locations for DE1 app profiles
@@ -88,7 +96,7 @@ void ProfileImporter::scanProfilesFromPath(const QString& path)
     m_scanning = true;
     emit isScanningChanged();
 
-    m_pendingFiles.clear();
+    QStringList pendingFiles;
     m_availableProfiles.clear();
     m_processedProfiles = 0;
 
@@ -98,27 +106,27 @@ void ProfileImporter::scanProfilesFromPath(const QString& path)
     if (tclDir.exists()) {
         QDirIterator tclIt(tclPath, QStringList() << "*.tcl", QDir::Files);
         while (tclIt.hasNext()) {
-            m_pendingFiles.append(tclIt.next());
+            pendingFiles.append(tclIt.next());
         }
-        qDebug() << "ProfileImporter: Found" << m_pendingFiles.size() << "TCL profiles in" << tclPath;
+        qDebug() << "ProfileImporter: Found" << pendingFiles.size() << "TCL profiles in" << tclPath;
     }
 
     // Scan profiles_v2/ for JSON files
     QString jsonPath = path + "/profiles_v2";
     QDir jsonDir(jsonPath);
     if (jsonDir.exists()) {
-        int beforeCount = static_cast<int>(m_pendingFiles.size());
+        int beforeCount = static_cast<int>(pendingFiles.size());
         QDirIterator jsonIt(jsonPath, QStringList() << "*.json", QDir::Files);
         while (jsonIt.hasNext()) {
-            m_pendingFiles.append(jsonIt.next());
+            pendingFiles.append(jsonIt.next());
         }
-        qDebug() << "ProfileImporter: Found" << (m_pendingFiles.size() - beforeCount) << "JSON profiles in" << jsonPath;
+        qDebug() << "ProfileImporter: Found" << (pendingFiles.size() - beforeCount) << "JSON profiles in" << jsonPath;
     }
 
-    m_totalProfiles = static_cast<int>(m_pendingFiles.size());
+    m_totalProfiles = static_cast<int>(pendingFiles.size());
     emit progressChanged();
 
-    if (m_pendingFiles.isEmpty()) {
+    if (pendingFiles.isEmpty()) {
         setStatus("No profiles found");
         m_scanning = false;
         emit isScanningChanged();
@@ -129,80 +137,113 @@ void ProfileImporter::scanProfilesFromPath(const QString& path)
 
     setStatus(QString("Scanning %1 profiles...").arg(m_totalProfiles));
 
-    // Process files asynchronously to keep UI responsive
-    QTimer::singleShot(0, this, &ProfileImporter::processNextScan);
+    buildLocalIndex();
+
+    // Parse and hash on the pool; results come back to the GUI thread one by one
+    for (const QString& filePath : std::as_const(pendingFiles)) {
+        m_scanPool.start([this, filePath]() {
+            QVariantMap entry = scanFile(filePath);
+            QMetaObject::invokeMethod(this, [this, entry]() {
+                addScanResult(entry);
+            }, Qt::QueuedConnection);
+        });
+    }
 }
 
-void ProfileImporter::processNextScan()
+void ProfileImporter::buildLocalIndex()
 {
-    if (m_pendingFiles.isEmpty()) {
-        // Scanning complete
-        m_scanning = false;
-        emit isScanningChanged();
-
-        // Sort by title
-        std::sort(m_availableProfiles.begin(), m_availableProfiles.end(),
-                  [](const QVariant& a, const QVariant& b) {
-                      return a.toMap()["title"].toString().toLower() <
-                             b.toMap()["title"].toString().toLower();
-                  });
-
-        setStatus(QString("Found %1 profiles").arg(m_availableProfiles.size()));
-        emit availableProfilesChanged();
-        emit scanComplete(static_cast<int>(m_availableProfiles.size()));
+    m_localProfiles.clear();
+    if (!m_controller) {
         return;
     }
 
-    // Process batch of files
-    int batchSize = 10;
-    for (int i = 0; i < batchSize && !m_pendingFiles.isEmpty(); i++) {
-        QString filePath = m_pendingFiles.takeFirst();
-        QString filename = QFileInfo(filePath).fileName();
-        bool isTcl = filePath.endsWith(".tcl", Qt::CaseInsensitive);
+    // Same precedence as loading: storage, then downloaded, then built-in for the
+    // path; a built-in of the same name still reports the source as built-in
+    ProfileStorage* storage = m_controller->profileStorage();
+    if (storage && storage->isConfigured()) {
+        const auto files = storage->listProfileFiles();
+        for (const auto& file : files) {
+            m_localProfiles.insert(file.first, {file.second, "D"});  // Downloaded
+        }
+    }
 
-        // Load the profile
-        Profile profile;
-        if (isTcl) {
-            profile = Profile::loadFromTclFile(filePath);
-        } else {
-            profile = Profile::loadFromFile(filePath);
+    QDir downloadedDir(downloadedProfilesPath());
+    const QStringList downloaded = downloadedDir.entryList({"*.json"}, QDir::Files);
+    for (const QString& file : downloaded) {
+        QString name = file.chopped(5);
+        if (!m_localProfiles.contains(name)) {
+            m_localProfiles.insert(name, {downloadedDir.filePath(file), "D"});
         }
+    }
 
-        if (!profile.isValid() || profile.title().isEmpty()) {
-            qDebug() << "ProfileImporter: Skipping invalid profile" << filename;
-            m_processedProfiles++;
-            continue;
+    const QStringList builtIn = QDir(":/profiles").entryList({"*.json"}, QDir::Files);
+    for (const QString& file : builtIn) {
+        QString name = file.chopped(5);
+        auto it = m_localProfiles.find(name);
+        if (it == m_localProfiles.end()) {
+            m_localProfiles.insert(name, {":/profiles/" + file, "B"});  // Built-in
+        } else {
+            it->source = "B";
         }
+    }
+}
 
-        QVariantMap entry;
-        entry["sourcePath"] = filePath;
-        entry["filename"] = filename;
-        entry["title"] = profile.title();
-        entry["author"] = profile.author();
-        entry["frameCount"] = profile.steps().size();
-        entry["format"] = isTcl ? "TCL" : "JSON";
-        entry["beverageType"] = profile.beverageType();
+QVariantMap ProfileImporter::scanFile(const QString& filePath) const
+{
+    QString filename = QFileInfo(filePath).fileName();
+    bool isTcl = filePath.endsWith(".tcl", Qt::CaseInsensitive);
 
-        // Check local status
-        QVariantMap status = checkProfileStatus(profile.title(), &profile);
-        entry["exists"] = status["exists"];
-        entry["identical"] = status["identical"];
-        entry["source"] = status["source"];
-        entry["localFilename"] = status["filename"];
+    // Load the profile
+    Profile profile;
+    if (isTcl) {
+        profile = Profile::loadFromTclFile(filePath);
+    } else {
+        profile = Profile::loadFromFile(filePath);
+    }
 
-        // Determine import status
-        if (!status["exists"].toBool()) {
-            entry["status"] = "new";
-        } else if (status["identical"].toBool()) {
-            entry["status"] = "identical";
-        } else {
-            entry["status"] = "different";
-        }
+    if (!profile.isValid() || profile.title().isEmpty()) {
+        qDebug() << "ProfileImporter: Skipping invalid profile" << filename;
+        return QVariantMap();
+    }
+
+    QVariantMap entry;
+    entry["sourcePath"] = filePath;
+    entry["filename"] = filename;
+    entry["title"] = profile.title();
+    entry["author"] = profile.author();
+    entry["frameCount"] = profile.steps().size();
+    entry["format"] = isTcl ? "TCL" : "JSON";
+    entry["beverageType"] = profile.beverageType();
+
+    // Check local status
+    QVariantMap status = checkProfileStatus(profile.title(), &profile);
+    entry["exists"] = status["exists"];
+    entry["identical"] = status["identical"];
+    entry["source"] = status["source"];
+    entry["localFilename"] = status["filename"];
+
+    // Determine import status
+    if (!status["exists"].toBool()) {
+        entry["status"] = "new";
+    } else if (status["identical"].toBool()) {
+        entry["status"] = "identical";
+    } else {
+        entry["status"] = "different";
+    }
 
-        m_availableProfiles.append(entry);
-        m_processedProfiles++;
+    return entry;
+}
+
+void ProfileImporter::addScanResult(const QVariantMap& entry)
+{
+    if (!m_scanning) {
+        return;
     }
 
+    if (!entry.isEmpty()) {
+        m_availableProfiles.append(entry);
+    }
+    m_processedProfiles++;
     emit progressChanged();
 
     // Update status periodically
@@ -210,11 +251,29 @@ void ProfileImporter::processNextScan()
         setStatus(QString("Scanning... %1/%2").arg(m_processedProfiles).arg(m_totalProfiles));
     }
 
-    // Continue processing
-    QTimer::singleShot(0, this, &ProfileImporter::processNextScan);
+    if (m_processedProfiles >= m_totalProfiles) {
+        finishScan();
+    }
 }
 
-QVariantMap ProfileImporter::checkProfileStatus(const QString& profileTitle, const Profile* incomingProfile)
+void ProfileImporter::finishScan()
+{
+    m_scanning = false;
+    emit isScanningChanged();
+
+    // Sort by title
+    std::sort(m_availableProfiles.begin(), m_availableProfiles.end(),
+              [](const QVariant& a, const QVariant& b) {
+                  return a.toMap()["title"].toString().toLower() <
+                         b.toMap()["title"].toString().toLower();
+              });
+
+    setStatus(QString("Found %1 profiles").arg(m_availableProfiles.size()));
+    emit availableProfilesChanged();
+    emit scanComplete(static_cast<int>(m_availableProfiles.size()));
+}
+
+QVariantMap ProfileImporter::checkProfileStatus(const QString& profileTitle, const Profile* incomingProfile) const
 {
     QVariantMap result;
     result["exists"] = false;
@@ -230,110 +289,55 @@ QVariantMap ProfileImporter::checkProfileStatus(const QString& profileTitle, con
     QString filename = generateFilename(profileTitle);
     result["filename"] = filename;
 
-    // Check if profile exists in any location
-    ProfileStorage* storage = m_controller->profileStorage();
-
-    // Check external/downloaded storage first
-    if (storage && storage->isConfigured() && storage->profileExists(filename)) {
-        result["exists"] = true;
-        result["source"] = "D";  // Downloaded
-    }
-
-    // Check local downloaded folder
-    QString downloadedPath = downloadedProfilesPath() + "/" + filename + ".json";
-    if (QFile::exists(downloadedPath)) {
-        result["exists"] = true;
-        result["source"] = "D";
+    auto it = m_localProfiles.constFind(filename);
+    if (it == m_localProfiles.constEnd()) {
+        return result;
     }
 
-    // Check built-in profiles
-    QString builtinPath = ":/profiles/" + filename + ".json";
-    if (QFile::exists(builtinPath)) {
-        result["exists"] = true;
-        result["source"] = "B";  // Built-in
-    }
+    result["exists"] = true;
+    result["source"] = it->source;
 
-    // If exists and we have incoming profile, compare frames
-    if (result["exists"].toBool() && incomingProfile && incomingProfile->isValid()) {
-        Profile localProfile = loadLocalProfile(filename);
-        if (localProfile.isValid()) {
-            bool identical = compareProfileFrames(*incomingProfile, localProfile);
-            result["identical"] = identical;
+    // If exists and we have incoming profile, compare content hashes. Rounding
+    // can split values that are within tolerance, so a different hash falls
+    // back to comparing the same fields within 0.1.
+    if (incomingProfile && incomingProfile->isValid()) {
+        const LocalParse local = parseLocalProfile(it->path);
+        bool identical = !local.hash.isEmpty() && local.hash == incomingProfile->contentHash();
+        if (!identical && !local.hash.isEmpty()) {
+            identical = local.profile.hasSameContent(*incomingProfile);
         }
+        result["identical"] = identical;
     }
 
     return result;
 }
 
-bool ProfileImporter::compareProfileFrames(const Profile& a, const Profile& b) const
+ProfileImporter::LocalParse ProfileImporter::parseLocalProfile(const QString& path) const
 {
-    const auto& stepsA = a.steps();
-    const auto& stepsB = b.steps();
-
-    if (stepsA.size() != stepsB.size()) {
-        return false;
-    }
-
-    for (int i = 0; i < stepsA.size(); i++) {
-        const ProfileFrame& fa = stepsA[i];
-        const ProfileFrame& fb = stepsB[i];
-
-        // Compare all frame parameters that affect extraction
-        if (qAbs(fa.temperature - fb.temperature) > 0.1) return false;
-        if (fa.sensor != fb.sensor) return false;
-        if (fa.pump != fb.pump) return false;
-        if (fa.transition != fb.transition) return false;
-        if (qAbs(fa.pressure - fb.pressure) > 0.1) return false;
-        if (qAbs(fa.flow - fb.flow) > 0.1) return false;
-        if (qAbs(fa.seconds - fb.seconds) > 0.1) return false;
-        if (qAbs(fa.volume - fb.volume) > 0.1) return false;
-
-        // Exit conditions
-        if (fa.exitIf != fb.exitIf) return false;
-        if (fa.exitIf) {
-            if (fa.exitType != fb.exitType) return false;
-            if (qAbs(fa.exitPressureOver - fb.exitPressureOver) > 0.1) return false;
-            if (qAbs(fa.exitPressureUnder - fb.exitPressureUnder) > 0.1) return false;
-            if (qAbs(fa.exitFlowOver - fb.exitFlowOver) > 0.1) return false;
-            if (qAbs(fa.exitFlowUnder - fb.exitFlowUnder) > 0.1) return false;
+    QFileInfo info(path);
+    const qint64 modifiedMs = info.lastModified().toMSecsSinceEpoch();
+    const qint64 size = info.size();
+
+    {
+        QMutexLocker locker(&m_parseMutex);
+        auto it = m_localParses.constFind(path);
+        if (it != m_localParses.constEnd() && it->modifiedMs == modifiedMs && it->size == size) {
+            return *it;
         }
-
-        // Weight exit (independent of exitIf)
-        if (qAbs(fa.exitWeight - fb.exitWeight) > 0.1) return false;
-
-        // Limiter
-        if (qAbs(fa.maxFlowOrPressure - fb.maxFlowOrPressure) > 0.1) return false;
-        if (qAbs(fa.maxFlowOrPressureRange - fb.maxFlowOrPressureRange) > 0.1) return false;
     }
 
-    return true;
-}
-
-Profile ProfileImporter::loadLocalProfile(const QString& filename) const
-{
-    ProfileStorage* storage = m_controller ? m_controller->profileStorage() : nullptr;
-
-    // Try profile storage first
-    if (storage && storage->isConfigured() && storage->profileExists(filename)) {
-        QString content = storage->readProfile(filename);
-        if (!content.isEmpty()) {
-            return Profile::loadFromJsonString(content);
-        }
+    // Parse outside the lock; two workers racing on the same path store the same result
+    LocalParse parse;
+    parse.modifiedMs = modifiedMs;
+    parse.size = size;
+    parse.profile = Profile::loadFromFile(path);
+    if (parse.profile.isValid()) {
+        parse.hash = parse.profile.contentHash();
     }
 
-    // Try local downloaded folder
-    QString localPath = downloadedProfilesPath() + "/" + filename + ".json";
-    if (QFile::exists(localPath)) {
-        return Profile::loadFromFile(localPath);
-    }
-
-    // Try built-in profiles
-    QString builtinPath = ":/profiles/" + filename + ".json";
-    if (QFile::exists(builtinPath)) {
-        return Profile::loadFromFile(builtinPath);
-    }
-
-    return Profile();  // Empty/invalid profile
+    QMutexLocker locker(&m_parseMutex);
+    m_localParses.insert(path, parse);
+    return parse;
 }
 
 QString ProfileImporter::generateFilename(const QString& title) const
@@ -855,6 +859,9 @@ void ProfileImporter::refreshProfileStatus(int index)
     }
 
     if (profile.isValid()) {
+        if (!m_scanning) {
+            buildLocalIndex();  // The profile may have just been imported
+        }
         QVariantMap status = checkProfileStatus(profile.title(), &profile);
         entry["exists"] = status["exists"];
         entry["identical"] = status["identical"];
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <QObject>
+#include <QHash>
+#include <QMutex>
 #include <QString>
 #include <QStringList>
 #include <QVariantList>
 #include <QVariantMap>
+#include <QThreadPool>
 #include "profile.h"
 
 class MainController;
@@ -19,8 +22,14 @@ class Settings;
  * Features:
  * - Auto-detects DE1 app profile folders
  * - Supports both TCL (legacy) and JSON (v2) profile formats
- * - Duplicate detection with frame-by-frame comparison
+ * - Duplicate detection by content hash (frames and targets)
  * - Batch import with overwrite/skip options
+ *
+ * Scanning parses the de1app profiles on a thread pool. Each candidate is
+ * resolved as new / identical / different with one lookup in an index of
+ * local profiles (filename -> path) and a comparison of content hashes,
+ * falling back to Profile::hasSameContent() when the hashes differ; local
+ * profiles are parsed once and cached by path and mtime across scans.
  */
 class ProfileImporter : public QObject {
     Q_OBJECT
@@ -35,6 +44,7 @@ class ProfileImporter : public QObject {
 
 public:
     explicit ProfileImporter(MainController* controller, Settings* settings, QObject* parent = nullptr);
+    ~ProfileImporter();
 
     bool isScanning() const { return m_scanning; }
     bool isImporting() const { return m_importing; }
@@ -85,14 +95,27 @@ signals:
     void batchImportComplete(int imported, int skipped, int failed);
 
 private slots:
-    void processNextScan();
     void processNextImport();
 
 private:
+    struct LocalProfile {
+        QString path;
+        QString source;  // "D" (downloaded) or "B" (built-in)
+    };
+    struct LocalParse {
+        qint64 modifiedMs = 0;
+        qint64 size = 0;
+        Profile profile;
+        QByteArray hash;  // Empty if the file isn't a valid profile
+    };
+
     void setStatus(const QString& message);
-    QVariantMap checkProfileStatus(const QString& profileTitle, const Profile* incomingProfile);
-    bool compareProfileFrames(const Profile& a, const Profile& b) const;
-    Profile loadLocalProfile(const QString& filename) const;
+    void buildLocalIndex();
+    QVariantMap scanFile(const QString& filePath) const;     // Worker thread
+    void addScanResult(const QVariantMap& entry);
+    void finishScan();
+    QVariantMap checkProfileStatus(const QString& profileTitle, const Profile* incomingProfile) const;
+    LocalParse parseLocalProfile(const QString& path) const;  // Thread-safe
     QString generateFilename(const QString& title) const;
     int saveProfile(const Profile& profile, const QString& filename);
     QString downloadedProfilesPath() const;
@@ -106,11 +129,16 @@ private:
     QString m_detectedPath;
 
     // Scanning state
-    QStringList m_pendingFiles;
+    QThreadPool m_scanPool;
     QVariantList m_availableProfiles;
     int m_totalProfiles = 0;
     int m_processedProfiles = 0;
 
+    // Local profiles by filename; rebuilt on the GUI thread while no scan runs
+    QHash<QString, LocalProfile> m_localProfiles;
+    mutable QMutex m_parseMutex;                      // Guards m_localParses
+    mutable QHash<QString, LocalParse> m_localParses;  // Path -> parsed profile and hash
+
     // Import state
     QStringList m_importQueue;
     bool m_batchOverwrite = false;
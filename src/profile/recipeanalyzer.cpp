@@ -130,7 +130,7 @@ RecipeParams RecipeAnalyzer::extractRecipeParams(const Profile& profile) {
     if (pourIndex >= 0 && pourIndex < steps.size()) {
         const auto& pourFrame = steps[pourIndex];
 
-        if (pourFrame.pump == "flow") {
+        if (pourFrame.pump == ProfileFrame::Pump::Flow) {
             params.pourStyle = "flow";
             params.pourFlow = extractPourFlow(pourFrame);
             params.pressureLimit = extractPressureLimit(pourFrame);
@@ -230,7 +230,7 @@ void RecipeAnalyzer::forceConvertToRecipe(Profile& profile) {
         }
 
         // Look for infuse-like frame
-        if (foundFill && !foundInfuse && (isInfuseFrame(frame) || frame.pump == "pressure")) {
+        if (foundFill && !foundInfuse && (isInfuseFrame(frame) || frame.pump == ProfileFrame::Pump::Pressure)) {
             foundInfuse = true;
             params.infusePressure = extractInfusePressure(frame);
             params.infuseTime = extractInfuseTime(frame);
@@ -239,9 +239,9 @@ void RecipeAnalyzer::forceConvertToRecipe(Profile& profile) {
         }
 
         // Look for pour-like frame (last significant frame, or high pressure/flow)
-        if (foundFill && (isPourFrame(frame) || frame.pressure >= 6.0 || frame.pump == "flow")) {
+        if (foundFill && (isPourFrame(frame) || frame.pressure >= 6.0 || frame.pump == ProfileFrame::Pump::Flow)) {
             foundPour = true;
-            if (frame.pump == "flow") {
+            if (frame.pump == ProfileFrame::Pump::Flow) {
                 params.pourStyle = "flow";
                 params.pourFlow = extractPourFlow(frame);
                 params.pressureLimit = extractPressureLimit(frame);
@@ -269,7 +269,7 @@ void RecipeAnalyzer::forceConvertToRecipe(Profile& profile) {
     // If we didn't find a pour frame, use the last frame as pour
     if (!foundPour && steps.size() > 0) {
         const auto& lastFrame = steps.last();
-        if (lastFrame.pump == "flow") {
+        if (lastFrame.pump == ProfileFrame::Pump::Flow) {
             params.pourStyle = "flow";
             params.pourFlow = lastFrame.flow > 0 ? lastFrame.flow : 2.0;
         } else {
@@ -302,7 +302,7 @@ bool RecipeAnalyzer::isFillFrame(const ProfileFrame& frame) {
     }
 
     // Heuristic: first frame with low pressure and pressure_over exit
-    if (frame.pressure <= 6.0 && frame.exitIf && frame.exitType == "pressure_over") {
+    if (frame.pressure <= 6.0 && frame.exitIf && frame.exitType == ProfileFrame::Exit::PressureOver) {
         return true;
     }
 
@@ -322,7 +322,7 @@ bool RecipeAnalyzer::isBloomFrame(const ProfileFrame& frame) {
     }
 
     // Heuristic: zero flow with pressure_under exit
-    if (frame.flow <= 0.1 && frame.exitIf && frame.exitType == "pressure_under") {
+    if (frame.flow <= 0.1 && frame.exitIf && frame.exitType == ProfileFrame::Exit::PressureUnder) {
         return true;
     }
 
@@ -342,7 +342,7 @@ bool RecipeAnalyzer::isRampFrame(const ProfileFrame& frame) {
     }
 
     // Heuristic: smooth transition with short duration
-    if (frame.transition == "smooth" && frame.seconds > 0 && frame.seconds <= 15) {
+    if (frame.transition == ProfileFrame::Transition::Smooth && frame.seconds > 0 && frame.seconds <= 15) {
         return true;
     }
 
@@ -363,7 +363,7 @@ bool RecipeAnalyzer::isInfuseFrame(const ProfileFrame& frame) {
     }
 
     // Heuristic: pressure mode, low pressure, time-based
-    if (frame.pump == "pressure" && frame.pressure <= 6.0 &&
+    if (frame.pump == ProfileFrame::Pump::Pressure && frame.pressure <= 6.0 &&
         frame.seconds > 0 && frame.seconds <= 60) {
         return true;
     }
@@ -384,7 +384,7 @@ bool RecipeAnalyzer::isPourFrame(const ProfileFrame& frame) {
     }
 
     // Heuristic: higher pressure or flow mode with long duration
-    if ((frame.pressure >= 6.0 || frame.pump == "flow") && frame.seconds >= 30) {
+    if ((frame.pressure >= 6.0 || frame.pump == ProfileFrame::Pump::Flow) && frame.seconds >= 30) {
         return true;
     }
 
@@ -404,7 +404,7 @@ bool RecipeAnalyzer::isDeclineFrame(const ProfileFrame& frame, const ProfileFram
     }
 
     // Heuristic: smooth transition to lower pressure
-    if (frame.transition == "smooth" && frame.pump == "pressure" && previousFrame) {
+    if (frame.transition == ProfileFrame::Transition::Smooth && frame.pump == ProfileFrame::Pump::Pressure && previousFrame) {
         if (frame.pressure < previousFrame->pressure) {
             return true;
         }
@@ -417,7 +417,7 @@ bool RecipeAnalyzer::isDeclineFrame(const ProfileFrame& frame, const ProfileFram
 
 double RecipeAnalyzer::extractFillPressure(const ProfileFrame& frame) {
     // For fill frame, use the setpoint pressure
-    if (frame.pump == "pressure") {
+    if (frame.pump == ProfileFrame::Pump::Pressure) {
         return frame.pressure;
     }
     // For flow mode fill, use exit pressure as approximation
@@ -445,7 +445,7 @@ double RecipeAnalyzer::extractPourFlow(const ProfileFrame& frame) {
 
 double RecipeAnalyzer::extractFlowLimit(const ProfileFrame& frame) {
     // Flow limit is stored in maxFlowOrPressure when in pressure mode
-    if (frame.pump == "pressure" && frame.maxFlowOrPressure > 0) {
+    if (frame.pump == ProfileFrame::Pump::Pressure && frame.maxFlowOrPressure > 0) {
         return frame.maxFlowOrPressure;
     }
     return 0.0;
@@ -453,7 +453,7 @@ double RecipeAnalyzer::extractFlowLimit(const ProfileFrame& frame) {
 
 double RecipeAnalyzer::extractPressureLimit(const ProfileFrame& frame) {
     // Pressure limit is stored in maxFlowOrPressure when in flow mode
-    if (frame.pump == "flow" && frame.maxFlowOrPressure > 0) {
+    if (frame.pump == ProfileFrame::Pump::Flow && frame.maxFlowOrPressure > 0) {
         return frame.maxFlowOrPressure;
     }
     return 0.0;
@@ -74,18 +74,18 @@ ProfileFrame RecipeGenerator::createFillFrame(const RecipeParams& recipe) {
     ProfileFrame frame;
 
     frame.name = "Fill";
-    frame.pump = "flow";
+    frame.pump = ProfileFrame::Pump::Flow;
     frame.flow = recipe.fillFlow;
     frame.pressure = recipe.fillPressure;  // Pressure limit
     frame.temperature = recipe.fillTemperature;
     frame.seconds = recipe.fillTimeout;
-    frame.transition = "fast";
-    frame.sensor = "coffee";
+    frame.transition = ProfileFrame::Transition::Fast;
+    frame.sensor = ProfileFrame::Sensor::Coffee;
     frame.volume = 100.0;
 
     // Exit when pressure builds (indicates puck is saturated)
     frame.exitIf = true;
-    frame.exitType = "pressure_over";
+    frame.exitType = ProfileFrame::Exit::PressureOver;
     frame.exitPressureOver = recipe.fillExitPressure;
     frame.exitPressureUnder = 0.0;
     frame.exitFlowOver = 6.0;
@@ -102,18 +102,18 @@ ProfileFrame RecipeGenerator::createBloomFrame(const RecipeParams& recipe) {
     ProfileFrame frame;
 
     frame.name = "Bloom";
-    frame.pump = "flow";
+    frame.pump = ProfileFrame::Pump::Flow;
     frame.flow = 0.0;  // Zero flow - let puck rest
     frame.pressure = 0.0;
     frame.temperature = recipe.fillTemperature;
     frame.seconds = recipe.bloomTime;
-    frame.transition = "fast";
-    frame.sensor = "coffee";
+    frame.transition = ProfileFrame::Transition::Fast;
+    frame.sensor = ProfileFrame::Sensor::Coffee;
     frame.volume = 0.0;
 
     // Exit when pressure drops (CO2 has escaped)
     frame.exitIf = true;
-    frame.exitType = "pressure_under";
+    frame.exitType = ProfileFrame::Exit::PressureUnder;
     frame.exitPressureOver = 11.0;
     frame.exitPressureUnder = 0.5;
     frame.exitFlowOver = 6.0;
@@ -129,12 +129,12 @@ ProfileFrame RecipeGenerator::createInfuseFrame(const RecipeParams& recipe) {
     ProfileFrame frame;
 
     frame.name = "Infuse";
-    frame.pump = "pressure";
+    frame.pump = ProfileFrame::Pump::Pressure;
     frame.pressure = recipe.infusePressure;
     frame.flow = 8.0;
     frame.temperature = recipe.fillTemperature;  // Use fill temp for infuse
-    frame.transition = "fast";
-    frame.sensor = "coffee";
+    frame.transition = ProfileFrame::Transition::Fast;
+    frame.sensor = ProfileFrame::Sensor::Coffee;
     frame.volume = recipe.infuseVolume;
 
     // Duration depends on mode
@@ -147,7 +147,7 @@ ProfileFrame RecipeGenerator::createInfuseFrame(const RecipeParams& recipe) {
 
     // No exit condition for time-based, or weight-based handled by popup
     frame.exitIf = false;
-    frame.exitType = "";
+    frame.exitType = ProfileFrame::Exit::None;
     frame.exitPressureOver = 0.0;
     frame.exitPressureUnder = 0.0;
     frame.exitFlowOver = 0.0;
@@ -166,13 +166,13 @@ ProfileFrame RecipeGenerator::createRampFrame(const RecipeParams& recipe) {
     frame.name = "Ramp";
     frame.temperature = recipe.pourTemperature;
     frame.seconds = recipe.rampTime;
-    frame.transition = "smooth";  // Smooth transition creates the ramp
-    frame.sensor = "coffee";
+    frame.transition = ProfileFrame::Transition::Smooth;  // Smooth transition creates the ramp
+    frame.sensor = ProfileFrame::Sensor::Coffee;
     frame.volume = 100.0;
 
     if (recipe.pourStyle == "flow") {
         // Flow mode ramp
-        frame.pump = "flow";
+        frame.pump = ProfileFrame::Pump::Flow;
         frame.flow = recipe.pourFlow;
         frame.pressure = recipe.pressureLimit;
 
@@ -185,7 +185,7 @@ ProfileFrame RecipeGenerator::createRampFrame(const RecipeParams& recipe) {
         }
     } else {
         // Pressure mode ramp
-        frame.pump = "pressure";
+        frame.pump = ProfileFrame::Pump::Pressure;
         frame.pressure = recipe.pourPressure;
         frame.flow = 8.0;
 
@@ -200,7 +200,7 @@ ProfileFrame RecipeGenerator::createRampFrame(const RecipeParams& recipe) {
 
     // No exit condition - fixed duration
     frame.exitIf = false;
-    frame.exitType = "";
+    frame.exitType = ProfileFrame::Exit::None;
     frame.exitPressureOver = 0.0;
     frame.exitPressureUnder = 0.0;
     frame.exitFlowOver = 0.0;
@@ -215,13 +215,13 @@ ProfileFrame RecipeGenerator::createPourFrame(const RecipeParams& recipe) {
     frame.name = "Pour";
     frame.temperature = recipe.pourTemperature;
     frame.seconds = 60.0;  // Long duration - weight system stops the shot
-    frame.transition = "fast";
-    frame.sensor = "coffee";
+    frame.transition = ProfileFrame::Transition::Fast;
+    frame.sensor = ProfileFrame::Sensor::Coffee;
     frame.volume = 100.0;
 
     if (recipe.pourStyle == "flow") {
         // Flow mode extraction
-        frame.pump = "flow";
+        frame.pump = ProfileFrame::Pump::Flow;
         frame.flow = recipe.pourFlow;
         frame.pressure = recipe.pressureLimit;
 
@@ -234,7 +234,7 @@ ProfileFrame RecipeGenerator::createPourFrame(const RecipeParams& recipe) {
         }
     } else {
         // Pressure mode extraction
-        frame.pump = "pressure";
+        frame.pump = ProfileFrame::Pump::Pressure;
         frame.pressure = recipe.pourPressure;
         frame.flow = 8.0;
 
@@ -249,7 +249,7 @@ ProfileFrame RecipeGenerator::createPourFrame(const RecipeParams& recipe) {
 
     // No exit condition - weight system handles shot termination
     frame.exitIf = false;
-    frame.exitType = "";
+    frame.exitType = ProfileFrame::Exit::None;
     frame.exitPressureOver = 0.0;
     frame.exitPressureUnder = 0.0;
     frame.exitFlowOver = 0.0;
@@ -264,13 +264,13 @@ ProfileFrame RecipeGenerator::createDeclineFrame(const RecipeParams& recipe) {
     frame.name = "Decline";
     frame.temperature = recipe.pourTemperature;
     frame.seconds = recipe.declineTime;
-    frame.transition = "smooth";  // Key: smooth ramp creates the decline curve
-    frame.sensor = "coffee";
+    frame.transition = ProfileFrame::Transition::Smooth;  // Key: smooth ramp creates the decline curve
+    frame.sensor = ProfileFrame::Sensor::Coffee;
     frame.volume = 100.0;
 
     if (recipe.pourStyle == "flow") {
         // Flow mode decline - reduce flow
-        frame.pump = "flow";
+        frame.pump = ProfileFrame::Pump::Flow;
         frame.flow = recipe.pourFlow * 0.5;  // Reduce to 50%
         frame.pressure = recipe.pressureLimit;
 
@@ -280,7 +280,7 @@ ProfileFrame RecipeGenerator::createDeclineFrame(const RecipeParams& recipe) {
         }
     } else {
         // Pressure mode decline
-        frame.pump = "pressure";
+        frame.pump = ProfileFrame::Pump::Pressure;
         frame.pressure = recipe.declineTo;
         frame.flow = 8.0;
 
@@ -295,7 +295,7 @@ ProfileFrame RecipeGenerator::createDeclineFrame(const RecipeParams& recipe) {
 
     // No exit condition - time/weight handles termination
     frame.exitIf = false;
-    frame.exitType = "";
+    frame.exitType = ProfileFrame::Exit::None;
     frame.exitPressureOver = 0.0;
     frame.exitPressureUnder = 0.0;
     frame.exitFlowOver = 0.0;
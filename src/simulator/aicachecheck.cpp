@@ -0,0 +1,301 @@
+#include "aicachecheck.h"
+#include "ollamastandin.h"
+#include "../ai/aimanager.h"
+#include "../ai/airesponsecache.h"
+#include "../core/settings.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QThread>
+#include <cstdio>
+#include <functional>
+
+namespace {
+
+constexpr int REPLY_TIMEOUT_MS = 10000;
+constexpr int CANCEL_SETTLE_MS = 200;
+
+const QString SYSTEM_PROMPT = QStringLiteral("You are an espresso analyst.\nGive ONE recommendation.");
+const QString USER_PROMPT = QStringLiteral(
+    "## Shot Summary\n"
+    "\n"
+    "- **Profile**: Adaptive v2\n"
+    "- **Dose**: 18.0g -> **Yield**: 40.1g (ratio 1:2.2)\n"
+    "\n"
+    "## Tasting Feedback\n"
+    "\n"
+    "- **Score**: 70/100 - Decent, room for improvement\n");
+
+bool spinUntil(const std::function<bool()>& done, int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!done()) {
+        if (timer.elapsed() > timeoutMs) return false;
+        QCoreApplication::processEvents(QEventLoop::AllEvents);
+        QThread::yieldCurrentThread();
+    }
+    return true;
+}
+
+// What one analyze() call produced
+struct Reply
+{
+    QString text;
+    QString error;
+    QStringList chunks;
+    int requests = 0;            // Generate requests that reached the stand-in
+    bool cached = false;         // AIManager::lastRecommendationCached()
+    bool synchronous = false;    // A signal arrived before analyze() returned
+    bool chunkAfterReply = false;
+    bool timedOut = false;
+};
+
+Reply ask(AIManager* manager, const OllamaStandIn& ollama, const QString& systemPrompt, const QString& userPrompt)
+{
+    Reply reply;
+    const int before = ollama.generateRequests();
+    bool returned = false;
+    bool finished = false;
+
+    QObject context;  // Disconnects the lambdas below when it goes out of scope
+    QObject::connect(manager, &AIManager::analysisChunk, &context, [&](const QString& chunk) {
+        if (!returned) reply.synchronous = true;
+        if (finished) reply.chunkAfterReply = true;
+        reply.chunks.append(chunk);
+    });
+    QObject::connect(manager, &AIManager::recommendationReceived, &context, [&](const QString& text) {
+        if (!returned) reply.synchronous = true;
+        reply.text = text;
+        finished = true;
+    });
+    QObject::connect(manager, &AIManager::errorOccurred, &context, [&](const QString& error) {
+        reply.error = error;
+        finished = true;
+    });
+
+    manager->analyze(systemPrompt, userPrompt);
+    returned = true;
+    reply.timedOut = !spinUntil([&] { return finished; }, REPLY_TIMEOUT_MS);
+    reply.requests = ollama.generateRequests() - before;
+    reply.cached = manager->lastRecommendationCached();
+    return reply;
+}
+
+QString describe(const Reply& reply)
+{
+    if (reply.timedOut) return "timed out";
+    if (!reply.error.isEmpty()) {
+        return QString("%1 request(s), error \"%2\"").arg(reply.requests).arg(reply.error);
+    }
+    return QString("%1 request(s), %2 chunk(s)%3, \"%4\"")
+        .arg(reply.requests)
+        .arg(reply.chunks.size())
+        .arg(reply.cached ? ", cached" : "")
+        .arg(reply.text);
+}
+
+// A reply from the network: one request, streamed in several chunks, not marked cached
+bool fromNetwork(const Reply& reply)
+{
+    return !reply.timedOut && reply.error.isEmpty() && reply.requests == 1 && !reply.cached
+        && reply.chunks.size() > 1 && reply.chunks.join(QString()) == reply.text;
+}
+
+// A reply from the cache: no request, one chunk with the whole text, delivered like a network reply
+bool fromCache(const Reply& reply, const QString& expected)
+{
+    return !reply.timedOut && reply.error.isEmpty() && reply.requests == 0 && reply.cached
+        && reply.text == expected && reply.chunks == QStringList{expected}
+        && !reply.synchronous && !reply.chunkAfterReply;
+}
+
+}  // namespace
+
+void AiCacheCheck::plant(AIManager* manager, const QString& provider, const QString& model,
+                         const QString& systemPrompt, const QString& userPrompt, const QString& response)
+{
+    manager->responseCache()->store(AIResponseCache::key(provider, model, systemPrompt, userPrompt),
+                                    provider, model, response);
+}
+
+void AiCacheCheck::advanceClock(AIManager* manager, int days)
+{
+    static qint64 offsetMs = 0;
+    offsetMs += static_cast<qint64>(days) * 24 * 60 * 60 * 1000;
+    const qint64 offset = offsetMs;
+    manager->responseCache()->setClock([offset]() { return QDateTime::currentMSecsSinceEpoch() + offset; });
+}
+
+int AiCacheCheck::run(int lookups)
+{
+    OllamaStandIn ollama;
+    if (!ollama.start()) {
+        fprintf(stderr, "de1harness: can't listen on localhost\n");
+        return 1;
+    }
+
+    Settings settings;
+    settings.setAiProvider("ollama");
+    settings.setOllamaEndpoint(ollama.endpoint());
+    settings.setOllamaModel("model-a");
+    settings.setValue("ai/cacheTtlDays", 30);
+
+    AIManager manager(&settings);
+    manager.clearResponseCache();
+
+    int failures = 0;
+    auto report = [&failures](const char* name, bool ok, const QString& detail) {
+        fprintf(stdout, "%-10s %s%s\n", name, qPrintable(detail), ok ? "" : " [FAILED]");
+        if (!ok) failures++;
+    };
+
+    if (!manager.isConfigured()) {
+        fprintf(stderr, "de1harness: AIManager isn't configured for the stand-in\n");
+        return 2;
+    }
+
+    // Miss: streamed from the stand-in and stored
+    const Reply first = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+    const QString firstText = OllamaStandIn::replyText(ollama.generateRequests(), "model-a");
+    report("miss", fromNetwork(first) && first.text == firstText
+               && manager.responseCacheStats().value("entries").toInt() == 1,
+           describe(first));
+
+    // Hit: same prompt, no request, same signals as a network reply
+    const Reply hit = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+    report("hit", fromCache(hit, firstText), describe(hit) + (hit.synchronous ? " (emitted inside analyze())" : ""));
+
+    // Cancel right after a cached answer was queued: nothing may arrive
+    {
+        bool received = false;
+        QObject context;
+        QObject::connect(&manager, &AIManager::recommendationReceived, &context, [&received]() { received = true; });
+        QObject::connect(&manager, &AIManager::analysisChunk, &context, [&received]() { received = true; });
+        const int before = ollama.generateRequests();
+        manager.analyze(SYSTEM_PROMPT, USER_PROMPT);
+        manager.cancelAnalysis();
+        spinUntil([] { return false; }, CANCEL_SETTLE_MS);
+        const int requests = ollama.generateRequests() - before;
+        report("cancel", !received && requests == 0 && !manager.isAnalyzing(),
+               QString("%1 request(s), %2").arg(requests).arg(received ? "reply delivered" : "nothing delivered"));
+    }
+
+    // Normalization: line endings, trailing and surrounding whitespace don't matter; words do
+    {
+        QString reformatted = USER_PROMPT;
+        reformatted.replace("\n", "  \r\n");
+        reformatted = "\r\n\n" + reformatted + "\n\n";
+        const Reply same = ask(&manager, ollama, SYSTEM_PROMPT + "\t\n", reformatted);
+
+        QString edited = USER_PROMPT;
+        edited.replace("70/100", "75/100");
+        const Reply changed = ask(&manager, ollama, SYSTEM_PROMPT, edited);
+        report("normalize", fromCache(same, firstText) && fromNetwork(changed),
+               QString("reformatted: %1; edited: %2 request(s)").arg(describe(same)).arg(changed.requests));
+    }
+
+    // Model: each model gets its own entry
+    {
+        settings.setOllamaModel("model-b");
+        const Reply otherModel = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+        const QString otherText = OllamaStandIn::replyText(ollama.generateRequests(), "model-b");
+        const Reply otherAgain = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+        settings.setOllamaModel("model-a");
+        const Reply backAgain = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+        report("model", fromNetwork(otherModel) && otherModel.text == otherText
+                   && ollama.generates().last().model == "model-b"
+                   && fromCache(otherAgain, otherText) && fromCache(backAgain, firstText),
+               QString("model-b: %1 then %2 request(s); model-a: %3 request(s)")
+                   .arg(otherModel.requests).arg(otherAgain.requests).arg(backAgain.requests));
+    }
+
+    // Provider: an entry under another provider's key isn't served; one under Ollama's is
+    {
+        const QString planted = "Planted reply";
+        QString userPrompt = USER_PROMPT + "- **Notes**: \"sour\"\n";
+        plant(&manager, "openai", "model-a", SYSTEM_PROMPT, userPrompt, planted);
+        const Reply foreign = ask(&manager, ollama, SYSTEM_PROMPT, userPrompt);
+
+        userPrompt = USER_PROMPT + "- **Notes**: \"bitter\"\n";
+        plant(&manager, "ollama", "model-a", SYSTEM_PROMPT, userPrompt, planted);
+        const Reply own = ask(&manager, ollama, SYSTEM_PROMPT, userPrompt);
+        report("provider", fromNetwork(foreign) && foreign.text != planted && fromCache(own, planted),
+               QString("openai entry: %1 request(s); ollama entry: %2 request(s)%3")
+                   .arg(foreign.requests).arg(own.requests).arg(own.cached ? ", cached" : ""));
+    }
+
+    // Failure: an error reply isn't cached, so asking again goes back to the server
+    {
+        settings.setOllamaModel("model-x");
+        const Reply failed = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+        const Reply retried = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+        settings.setOllamaModel("model-a");
+        report("failure", !failed.error.isEmpty() && failed.requests == 1
+                   && !retried.error.isEmpty() && retried.requests == 1,
+               describe(failed) + QString("; again: %1 request(s)").arg(retried.requests));
+    }
+
+    // Cut off: half a reply and no done line is a failure, not a short answer to cache
+    {
+        QString userPrompt = USER_PROMPT + "- **Notes**: \"thin\"\n";
+        ollama.setCutOff(true);
+        const Reply cut = ask(&manager, ollama, SYSTEM_PROMPT, userPrompt);
+        ollama.setCutOff(false);
+        const Reply whole = ask(&manager, ollama, SYSTEM_PROMPT, userPrompt);
+        report("cutoff", !cut.error.isEmpty() && cut.requests == 1 && !cut.chunks.isEmpty() && fromNetwork(whole),
+               describe(cut) + QString("; again: %1 request(s)").arg(whole.requests));
+    }
+
+    // TTL: 31 days old is expired and replaced, 29 days old still hits, 0 days disables the cache
+    {
+        advanceClock(&manager, 31);
+        const Reply expired = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+        const Reply refreshed = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+        advanceClock(&manager, 29);  // The refreshed entry is now 29 days old
+        const Reply stillValid = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+
+        settings.setValue("ai/cacheTtlDays", 0);
+        const Reply disabledFirst = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+        const Reply disabledSecond = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+        settings.setValue("ai/cacheTtlDays", 30);
+
+        report("ttl", fromNetwork(expired) && fromCache(refreshed, expired.text)
+                   && fromCache(stillValid, expired.text)
+                   && fromNetwork(disabledFirst) && fromNetwork(disabledSecond),
+               QString("31 days: %1 request(s), then %2; 29 days: %3; ttl 0: %4 + %5 request(s)")
+                   .arg(expired.requests).arg(refreshed.requests).arg(stillValid.requests)
+                   .arg(disabledFirst.requests).arg(disabledSecond.requests));
+    }
+
+    // Cached round trips: analyze() to recommendationReceived through the event loop
+    {
+        const int before = ollama.generateRequests();
+        double worstMs = 0.0;
+        int wrong = 0;
+        QElapsedTimer wall;
+        wall.start();
+        for (int i = 0; i < lookups; ++i) {
+            QElapsedTimer one;
+            one.start();
+            const Reply reply = ask(&manager, ollama, SYSTEM_PROMPT, USER_PROMPT);
+            worstMs = qMax(worstMs, one.nsecsElapsed() / 1e6);
+            if (!reply.cached || reply.timedOut) wrong++;
+        }
+        const double meanMs = wall.nsecsElapsed() / 1e6 / lookups;
+        const int requests = ollama.generateRequests() - before;
+        report("lookups", wrong == 0 && requests == 0,
+               QString("%1 cached replies, mean %2 ms, worst %3 ms, %4 request(s)")
+                   .arg(lookups).arg(meanMs, 0, 'f', 3).arg(worstMs, 0, 'f', 3).arg(requests));
+    }
+
+    const QVariantMap stats = manager.responseCacheStats();
+    manager.clearResponseCache();
+    ollama.stop();
+
+    fprintf(stderr, "de1harness: %d generate request(s); cache %d entries, %lld hits, %lld misses; %s\n",
+            ollama.generateRequests(), stats.value("entries").toInt(), stats.value("hits").toLongLong(),
+            stats.value("misses").toLongLong(), failures > 0 ? "FAILED" : "all checks passed");
+    return failures > 0 ? 2 : 0;
+}
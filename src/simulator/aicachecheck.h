@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QString>
+
+class AIManager;
+class OllamaStandIn;
+
+/**
+ * AiCacheCheck - AIManager's response cache against OllamaStandIn
+ *
+ * Drives AIManager::analyze() with the Ollama provider pointed at the
+ * stand-in and checks, by counting the requests that reach it:
+ *
+ *   miss        a new prompt is requested, streamed and stored
+ *   hit         the same prompt again is answered without a request, and
+ *               still arrives as analysisChunk then recommendationReceived,
+ *               after analyze() has returned (like a network reply)
+ *   cancel      cancelAnalysis() right after a hit suppresses the reply
+ *   normalize   CRLF line endings, trailing spaces and surrounding blank
+ *               lines hit the same entry; a changed word misses
+ *   model       the same prompt under another model misses, and each
+ *               model then hits its own entry
+ *   provider    an entry planted under another provider's key for the same
+ *               model and prompt isn't served to Ollama
+ *   failure     an error reply (unknown model) isn't cached
+ *   cutoff      a stream that ends without Ollama's done line fails and
+ *               isn't cached
+ *   ttl         an entry older than ai/cacheTtlDays misses and is replaced;
+ *               a TTL of 0 disables the cache
+ *
+ * then times `lookups` cached round trips. The caller turns on QStandardPaths
+ * test mode first, so the cache database and settings are throwaway.
+ */
+class AiCacheCheck
+{
+public:
+    // Returns 0, 1 if the stand-in can't listen, or 2 if a check failed
+    static int run(int lookups);
+
+private:
+    static void plant(AIManager* manager, const QString& provider, const QString& model,
+                      const QString& systemPrompt, const QString& userPrompt, const QString& response);
+    static void advanceClock(AIManager* manager, int days);  // Cache clock, cumulative
+};
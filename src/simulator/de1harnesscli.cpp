@@ -0,0 +1,61 @@
+// Headless harness for the app's network clients against local stand-in
+// servers. Built from the app's own sources (BUILD_DE1HARNESS), so what runs
+// here is the code that ships. QStandardPaths test mode keeps settings, the
+// MQTT spool and caches out of the user's files.
+//
+// --mqtt-bench runs MqttClient's outbound queue against MqttBrokerStandIn:
+// sustained throughput, a broker outage with reconnect, and a client restart
+// with the disk spool (MqttBench). --repeat sets the steady-state event count:
+//
+//   de1harness --mqtt-bench [--repeat N]
+//
+// --ai-cache-check runs AIManager's response cache against OllamaStandIn:
+// hits, misses, prompt normalization, keys per provider and model, TTL expiry,
+// and that a cached answer still arrives as analysisChunk and
+// recommendationReceived (AiCacheCheck). --repeat sets the timed lookups:
+//
+//   de1harness --ai-cache-check [--repeat N]
+
+#include "aicachecheck.h"
+#include "mqttbench.h"
+#include "../core/hotpathlog.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStandardPaths>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName("DecentEspresso");
+    app.setApplicationName("de1harness");
+    QStandardPaths::setTestModeEnabled(true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Network client harness against local stand-in servers");
+    parser.addHelpOption();
+
+    QCommandLineOption repeatOption("repeat", "Messages (or requests) per phase.", "n");
+    QCommandLineOption verboseOption("verbose", "Show client debug output.");
+    QCommandLineOption mqttBenchOption("mqtt-bench", "MQTT queue throughput and loss across a broker outage.");
+    QCommandLineOption aiCacheCheckOption("ai-cache-check", "AI response cache against an Ollama stand-in.");
+    parser.addOptions({repeatOption, verboseOption, mqttBenchOption, aiCacheCheckOption});
+    parser.process(app);
+
+    // Through HotPathLog so Settings' hot-path levels can't switch debug output back on
+    if (!parser.isSet(verboseOption)) {
+        HotPathLog::setExtraFilterRules(QStringLiteral("*.debug=false"));
+    }
+
+    auto repeatOr = [&parser, &repeatOption](int fallback) {
+        return parser.isSet(repeatOption) ? qMax(1, parser.value(repeatOption).toInt()) : fallback;
+    };
+
+    if (parser.isSet(mqttBenchOption)) {
+        return MqttBench::run(repeatOr(5000));
+    }
+    if (parser.isSet(aiCacheCheckOption)) {
+        return AiCacheCheck::run(repeatOr(200));
+    }
+
+    parser.showHelp(1);
+}
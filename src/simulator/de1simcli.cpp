@@ -0,0 +1,670 @@
+// Headless DE1 simulator: runs a profile to completion as fast as the CPU allows
+// and writes the ShotSample stream as CSV. Reproducible with --seed.
+//
+//   de1sim [--seed N] [--dose g] [--grind setting] [--dt s] [--repeat N] profile.json|profile.tcl
+//
+// With --parse-bench it instead times the de1app Tcl profile parser over a
+// corpus (e.g. de1app/de1plus/profiles), --repeat times per file:
+//
+//   de1sim --parse-bench [--repeat N] dir|profile.tcl...
+//
+// --parse-fuzz truncates the same corpus at random and inserts, drops and
+// replaces braces, quotes and backslashes, then checks TclTokenizer's words
+// and error flag against a reference and that no word leaves the source.
+// Inputs live in exactly sized buffers; configure with -DDE1SIM_SANITIZE=ON
+// so AddressSanitizer reports any read past the end:
+//
+//   de1sim --parse-fuzz [--seed N] [--repeat iterations] dir|profile.tcl...
+//
+// --predict-bench times the offline preview (ShotPhysics::predict) the profile
+// editors run on every edit, against a 60 Hz frame budget:
+//
+//   de1sim --predict-bench [--repeat N] [--dose g] [--grind setting] profile.json|profile.tcl
+//
+// --monte-carlo runs the robustness analysis (RobustnessAnalysis) and prints
+// the spread of shot time, yield time and peak pressure:
+//
+//   de1sim --monte-carlo N [--seed N] [--dose g] [--grind setting] [--dt s] profile.json|profile.tcl
+//
+// --clock-check feeds DeviceClockAligner a synthetic DE1 timer (5 Hz, drifting,
+// wrapping at 65536 ticks, at 50 and 60 Hz mains) with BLE-like delivery jitter
+// and stalls, and reports the chosen tick rate and how far the mapped times
+// land from the true ones:
+//
+//   de1sim --clock-check [--seed N] [--repeat minutes]
+//
+// --resample-bench times the comparison path (CurveResampler: first-drip
+// alignment, resampling onto the 0.1 s grid, conversion to chart points) for
+// synthetic shots of increasing length, against a 60 Hz frame budget. The
+// three-shot comparison window must fit; the 16-shot batch is informational:
+//
+//   de1sim --resample-bench [--seed N] [--repeat N]
+//
+// --scale-bench and --scale-fuzz replay scale notifications through every
+// scale driver (ScaleReplay): reference packets per protocol, plus captures
+// from an optional corpus directory (<type>.txt, hex per line). The fuzz mode
+// mutates and fragments them; configure with -DDE1SIM_SANITIZE=ON so
+// AddressSanitizer catches out-of-bounds reads:
+//
+//   de1sim --scale-bench [--repeat N] [corpus-dir]
+//   de1sim --scale-fuzz [--seed N] [--repeat iterations] [corpus-dir]
+
+#include "de1simulator.h"
+#include "shotphysics.h"
+#include "robustnessanalysis.h"
+#include "scalereplay.h"
+#include "../profile/profile.h"
+#include "../core/monotonicclock.h"
+#include "../core/tcltokenizer.h"
+#include "../models/curveresampler.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <QThread>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+// .tcl files named or found in the given directories, and their contents
+static bool loadTclCorpus(const QStringList& paths, QStringList* filesOut, QStringList* contentsOut)
+{
+    QStringList files;
+    for (const QString& path : paths) {
+        if (QFileInfo(path).isDir()) {
+            const QStringList names = QDir(path).entryList({"*.tcl"}, QDir::Files, QDir::Name);
+            for (const QString& name : names) {
+                files.append(QDir(path).filePath(name));
+            }
+        } else {
+            files.append(path);
+        }
+    }
+
+    QStringList contents;
+    for (const QString& file : files) {
+        QFile f(file);
+        if (!f.open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "de1sim: can't read %s\n", qPrintable(file));
+            return false;
+        }
+        contents.append(QString::fromUtf8(f.readAll()));
+    }
+    if (contents.isEmpty()) {
+        fprintf(stderr, "de1sim: no .tcl profiles found\n");
+        return false;
+    }
+
+    *filesOut = files;
+    *contentsOut = contents;
+    return true;
+}
+
+static int runParseBench(const QStringList& paths, int repeat)
+{
+    QStringList files;
+    QStringList contents;
+    if (!loadTclCorpus(paths, &files, &contents)) return 1;
+    qint64 bytes = 0;
+    for (const QString& content : contents) {
+        bytes += content.size();
+    }
+
+    int empty = 0;
+    for (int i = 0; i < contents.size(); ++i) {
+        if (Profile::loadFromTclString(contents[i]).steps().isEmpty()) {
+            fprintf(stderr, "de1sim: no frames parsed from %s\n", qPrintable(files[i]));
+            empty++;
+        }
+    }
+
+    QElapsedTimer wall;
+    wall.start();
+    qint64 frames = 0;
+    for (int r = 0; r < repeat; ++r) {
+        for (const QString& content : contents) {
+            frames += Profile::loadFromTclString(content).steps().size();
+        }
+    }
+    const double wallSec = wall.nsecsElapsed() / 1e9;
+    const qint64 parses = static_cast<qint64>(contents.size()) * repeat;
+
+    fprintf(stderr, "de1sim: parsed %d profile(s) x %d, %lld frames, %.1f MB in %.3f s "
+                    "(%.1f us/profile, %.0f MB/s)%s\n",
+            static_cast<int>(contents.size()), repeat, static_cast<long long>(frames),
+            bytes * repeat * 2 / 1e6, wallSec, wallSec * 1e6 / parses,
+            wallSec > 0 ? bytes * repeat * 2 / 1e6 / wallSec : 0.0,
+            empty > 0 ? qPrintable(QString(" [%1 without frames]").arg(empty)) : "");
+    return empty > 0 ? 2 : 0;
+}
+
+// Reference for TclTokenizer, written as a state machine rather than a scan
+// per word: number of words and whether the last one was left unclosed
+static void referenceTokenize(QStringView source, int* words, bool* error)
+{
+    enum { Between, Bare, Braced, Quoted } state = Between;
+    int depth = 0;
+    *words = 0;
+    for (qsizetype i = 0; i < source.size(); ++i) {
+        const QChar c = source[i];
+        switch (state) {
+        case Between:
+            if (c.isSpace()) break;
+            ++*words;
+            state = c == u'{' ? Braced : c == u'"' ? Quoted : Bare;
+            depth = 1;
+            break;
+        case Bare:
+            if (c.isSpace()) state = Between;
+            break;
+        case Braced:
+        case Quoted:
+            if (c == u'\\') {
+                ++i;  // Escaped character
+            } else if (state == Braced && c == u'{') {
+                ++depth;
+            } else if (c == (state == Braced ? u'}' : u'"') && --depth == 0) {
+                state = Between;
+            }
+            break;
+        }
+    }
+    *error = state == Braced || state == Quoted;
+}
+
+// Tokenizes list (and, to nestLimit, its braced words) and checks every word
+// against the reference and the bounds of [begin, end). Returns the failures.
+static int checkTokenizer(QStringView list, const QChar* begin, const QChar* end, int nestLimit, QString* why)
+{
+    int expectedWords = 0;
+    bool expectedError = false;
+    referenceTokenize(list, &expectedWords, &expectedError);
+
+    TclTokenizer tokenizer(list);
+    QStringView word;
+    int words = 0;
+    int failures = 0;
+    while (tokenizer.next(&word)) {
+        if (++words > list.size() + 1) {
+            *why = "tokenizer does not terminate";
+            return failures + 1;
+        }
+        if (word.data() < begin || word.data() + word.size() > end) {
+            *why = QString("word %1 outside the source").arg(words);
+            return failures + 1;
+        }
+        if (nestLimit > 0 && !word.isEmpty()) {
+            failures += checkTokenizer(word, begin, end, nestLimit - 1, why);
+        }
+    }
+
+    if (words != expectedWords || tokenizer.hasError() != expectedError) {
+        *why = QString("%1 word(s), error %2; expected %3, error %4")
+                   .arg(words).arg(tokenizer.hasError()).arg(expectedWords).arg(expectedError);
+        failures++;
+    }
+
+    bool dictError = false;
+    TclTokenizer::dict(list, &dictError);
+    if (dictError != (expectedError || expectedWords % 2 != 0)) {
+        *why = QString("dict error %1 for %2 word(s), error %3").arg(dictError).arg(expectedWords).arg(expectedError);
+        failures++;
+    }
+    return failures;
+}
+
+static int runParseFuzz(const QStringList& paths, quint32 seed, int iterations)
+{
+    static constexpr int NEST_LIMIT = 3;  // Profile -> advanced_shot -> frame -> value lists
+    static const char16_t SPECIAL[] = {u'{', u'}', u'"', u'\\', u' ', u'\n'};
+
+    QStringList files;
+    QStringList contents;
+    if (!loadTclCorpus(paths, &files, &contents)) return 1;
+
+    QRandomGenerator rng(seed);
+    auto randomPosition = [&rng](const QString& text) {
+        return static_cast<qsizetype>(rng.bounded(static_cast<int>(text.size()) + 1));
+    };
+    auto special = [&rng]() { return QChar(SPECIAL[rng.bounded(static_cast<int>(std::size(SPECIAL)))]); };
+
+    int failures = 0;
+    int errors = 0;
+    qint64 bytes = 0;
+    QElapsedTimer wall;
+    wall.start();
+    for (int i = 0; i < iterations; ++i) {
+        const int fileIndex = rng.bounded(static_cast<int>(contents.size()));
+        QString text = contents[fileIndex];
+
+        const int mutations = rng.bounded(1, 5);
+        for (int m = 0; m < mutations && !text.isEmpty(); ++m) {
+            switch (rng.bounded(6)) {
+            case 0:  // Truncate anywhere - usually inside a braced word
+                text.truncate(randomPosition(text));
+                break;
+            case 1:
+                text.insert(randomPosition(text), special());
+                break;
+            case 2:
+                text.remove(randomPosition(text), 1);
+                break;
+            case 3:  // Drop a brace, quote or backslash
+                for (int tries = 0; tries < 16; ++tries) {
+                    const qsizetype at = randomPosition(text);
+                    if (at < text.size() && QStringView(SPECIAL, 4).contains(text[at])) {
+                        text.remove(at, 1);
+                        break;
+                    }
+                }
+                break;
+            case 4:
+                if (qsizetype at = randomPosition(text); at < text.size()) text[at] = special();
+                break;
+            case 5:  // Trailing backslash: the escape skips past the end
+                text.append(u'\\');
+                break;
+            }
+        }
+
+        // Exactly sized copy without a terminator, so reading one past the end
+        // is a heap overflow that AddressSanitizer reports
+        std::unique_ptr<QChar[]> buffer(new QChar[std::max<qsizetype>(text.size(), 1)]);
+        std::copy(text.cbegin(), text.cend(), buffer.get());
+        const QStringView view(buffer.get(), text.size());
+        bytes += text.size();
+
+        QString why;
+        if (checkTokenizer(view, buffer.get(), buffer.get() + text.size(), NEST_LIMIT, &why) > 0) {
+            if (++failures <= 10) {
+                fprintf(stderr, "de1sim: iteration %d (%s): %s\n", i, qPrintable(QFileInfo(files[fileIndex]).fileName()),
+                        qPrintable(why));
+            }
+        }
+
+        bool malformed = false;
+        TclTokenizer::dict(view, &malformed);
+        errors += malformed ? 1 : 0;
+
+        // The whole profile parser on the same input must not crash either
+        Profile::loadFromTclString(text);
+    }
+
+    const double wallSec = wall.nsecsElapsed() / 1e9;
+    fprintf(stderr, "de1sim: fuzzed %d input(s) from %d profile(s), %.1f MB in %.2f s, %d flagged malformed, "
+                    "%d failure(s)%s\n",
+            iterations, static_cast<int>(contents.size()), bytes * 2 / 1e6, wallSec, errors, failures,
+            failures > 0 ? " [failed]" : "");
+    return failures > 0 ? 2 : 0;
+}
+
+static int runPredictBench(const Profile& profile, int repeat, double dose, double grindFactor)
+{
+    static constexpr double FRAME_BUDGET_MS = 1000.0 / 60.0;
+
+    QElapsedTimer wall;
+    double worstMs = 0.0;
+    double totalMs = 0.0;
+    ShotPhysics::Prediction prediction;
+    for (int i = 0; i < repeat; ++i) {
+        wall.start();
+        prediction = ShotPhysics::predict(profile, dose, grindFactor, static_cast<quint32>(i + 1));
+        double ms = wall.nsecsElapsed() / 1e6;
+        totalMs += ms;
+        worstMs = qMax(worstMs, ms);
+    }
+
+    const double meanMs = totalMs / repeat;
+    fprintf(stderr, "de1sim: predicted %d shot(s), %.1f s / %.1f g each, mean %.3f ms, worst %.3f ms "
+                    "(%.0fx real time, budget %.1f ms)%s\n",
+            repeat, prediction.shotTime, prediction.finalWeight, meanMs, worstMs,
+            meanMs > 0 ? prediction.shotTime * 1000.0 / meanMs : 0.0, FRAME_BUDGET_MS,
+            worstMs > FRAME_BUDGET_MS ? " [over budget]" : "");
+    return worstMs > FRAME_BUDGET_MS ? 2 : 0;
+}
+
+static int runMonteCarlo(const Profile& profile, const RobustnessAnalysis::Options& options)
+{
+    QElapsedTimer wall;
+    wall.start();
+    const RobustnessAnalysis::Report report = RobustnessAnalysis::analyze(profile, options);
+    const double wallSec = wall.nsecsElapsed() / 1e9;
+
+    auto print = [](const char* name, const char* unit, const RobustnessAnalysis::Distribution& d) {
+        fprintf(stdout, "%-14s n=%-5d mean %6.2f %s  sd %5.2f  min %6.2f  p10 %6.2f  median %6.2f  p90 %6.2f  max %6.2f\n",
+                name, d.count, d.mean, unit, d.stddev, d.min, d.p10, d.median, d.p90, d.max);
+    };
+    print("shot time", "s", report.shotTime);
+    print("yield time", "s", report.yieldTime);
+    print("peak pressure", "bar", report.peakPressure);
+
+    fprintf(stderr, "de1sim: %d run(s) in %.3f s (%.2f ms/run, %d thread(s)), %d missed %.1f g, %d timed out\n",
+            report.runs, wallSec, report.runs > 0 ? wallSec * 1000.0 / report.runs : 0.0,
+            QThread::idealThreadCount(), report.yieldMissed, report.targetWeight, report.timedOut);
+    return report.timedOut > 0 ? 2 : 0;
+}
+
+static int runClockCheck(quint32 seed, int minutes)
+{
+    static constexpr double SAMPLE_INTERVAL = 0.2;     // DE1 shot samples at 5 Hz
+    static constexpr double WRAP_PERIOD = 655.36;      // 16-bit timer, ticks / 100
+    static constexpr double MIN_DELAY = 0.015;         // Fastest BLE delivery
+    static constexpr double MAX_ERROR = 0.01;          // Well inside one sample
+    static constexpr double WARMUP = 10.0;             // Rate measurement, then a few seconds of span
+
+    QRandomGenerator rng(seed);
+    std::exponential_distribution<double> jitter(1.0 / 0.02);   // Mean 20 ms on top of MIN_DELAY
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double trueDrift = (unit(rng) - 0.5) * 2e-4;          // +-100 ppm
+    const double trueOffset = 1000.0 * unit(rng);
+
+    // The timer counts mains half-cycles: 100 ticks/s on 50 Hz, 120 on 60 Hz
+    int result = 0;
+    for (int mainsHz : {50, 60}) {
+        const double rate = mainsHz * 2 / 100.0;  // sample.timer units per second
+
+        DeviceClockAligner aligner(WRAP_PERIOD);
+        aligner.setRateCandidates({1.0, 1.2});
+        std::vector<double> errors;
+        double lastUnwrapped = -1.0;
+        int nonMonotonic = 0;
+
+        const int samples = static_cast<int>(minutes * 60 / SAMPLE_INTERVAL);
+        for (int i = 0; i < samples; ++i) {
+            const double device = i * SAMPLE_INTERVAL;
+            double delay = MIN_DELAY + jitter(rng);
+            if (unit(rng) < 0.01) {
+                delay += 0.25;  // Connection-interval stall
+            }
+            const double host = trueOffset + device * (1.0 + trueDrift) + delay;
+
+            // sample.timer reading: whole ticks / 100, wrapped
+            const double raw = std::fmod(qFloor(device * rate * 100.0 + 0.5) / 100.0, WRAP_PERIOD);
+            const double unwrapped = aligner.addObservation(raw, host);
+            if (device >= WARMUP) {
+                if (unwrapped <= lastUnwrapped) {
+                    nonMonotonic++;
+                }
+
+                // Where the sample would have landed with the fastest delivery
+                const double ideal = trueOffset + device * (1.0 + trueDrift) + MIN_DELAY;
+                errors.push_back(std::abs(aligner.toHostTime(unwrapped) - ideal));
+            }
+            lastUnwrapped = unwrapped;
+        }
+
+        if (errors.empty()) {
+            fprintf(stderr, "de1sim: clock check needs more than %.0f s of samples\n", WARMUP);
+            return 1;
+        }
+
+        std::sort(errors.begin(), errors.end());
+        double sq = 0.0;
+        for (double e : errors) sq += e * e;
+        const double rms = qSqrt(sq / errors.size());
+        const double p99 = errors[static_cast<size_t>(0.99 * (errors.size() - 1))];
+        const double worst = errors.back();
+        const bool failed = worst > MAX_ERROR || nonMonotonic > 0 || aligner.rate() != rate;
+
+        fprintf(stderr, "de1sim: clock check %d Hz over %d min (%d wraps), rate %.1f (chosen %.1f), "
+                        "drift %+.1f ppm (estimated %+.1f ppm), error rms %.2f ms, p99 %.2f ms, max %.2f ms, "
+                        "%d non-monotonic%s\n",
+                mainsHz, minutes, static_cast<int>(samples * SAMPLE_INTERVAL * rate / WRAP_PERIOD), rate,
+                aligner.rate(), trueDrift * 1e6, aligner.drift() * 1e6, rms * 1000.0, p99 * 1000.0,
+                worst * 1000.0, nonMonotonic, failed ? " [failed]" : "");
+        if (failed) result = 2;
+    }
+    return result;
+}
+
+static ResampleShot syntheticShot(QRandomGenerator& rng, double minutes)
+{
+    static constexpr double SAMPLE_INTERVAL = 0.2;  // DE1 shot samples at 5 Hz
+
+    const int samples = static_cast<int>(minutes * 60.0 / SAMPLE_INTERVAL);
+    const double preinfusion = 5.0 + 10.0 * rng.generateDouble();
+    ResampleShot shot;
+    shot.curves.resize(4);  // Pressure, flow, temperature, weight - as in ShotComparisonModel
+    for (ResampleCurve& curve : shot.curves) {
+        curve.time.resize(samples);
+        curve.value.resize(samples);
+    }
+
+    double time = 0.0;
+    double weight = 0.0;
+    for (int i = 0; i < samples; ++i) {
+        time += SAMPLE_INTERVAL * (0.9 + 0.2 * rng.generateDouble());  // BLE delivery jitter
+        const bool extracting = time > preinfusion;
+        const double flow = extracting ? 2.0 + 0.3 * qSin(time * 0.1) : 4.0;
+        weight += extracting ? flow * SAMPLE_INTERVAL : 0.0;
+        const float values[4] = {static_cast<float>(extracting ? 9.0 - time * 0.002 : 2.0),
+                                 static_cast<float>(flow),
+                                 static_cast<float>(92.0 + 0.5 * qSin(time)),
+                                 static_cast<float>(weight)};
+        for (int c = 0; c < 4; ++c) {
+            shot.curves[c].time[i] = static_cast<float>(time);
+            shot.curves[c].value[i] = values[c];
+        }
+    }
+    return shot;
+}
+
+static int runResampleBench(quint32 seed, int repeat)
+{
+    static constexpr double FRAME_BUDGET_MS = 1000.0 / 60.0;
+    static constexpr double GRID_STEP = 0.1;   // ShotComparisonModel::GRID_STEP
+    static constexpr int WINDOW_SHOTS = 3;     // ShotComparisonModel::DISPLAY_WINDOW_SIZE
+    static constexpr int BATCH_SHOTS = 16;     // ShotComparisonModel::MAX_CACHED_SHOTS
+    static const double MINUTES[] = {1.0, 5.0, 15.0, 30.0};
+
+    QRandomGenerator rng(seed);
+    bool overBudget = false;
+    for (double minutes : MINUTES) {
+        QList<ResampleShot> source;
+        for (int s = 0; s < BATCH_SHOTS; ++s) {
+            source.append(syntheticShot(rng, minutes));
+        }
+
+        for (int shots : {WINDOW_SHOTS, BATCH_SHOTS}) {
+            QElapsedTimer wall;
+            double worstMs = 0.0;
+            double totalMs = 0.0;
+            qsizetype gridPoints = 0;
+            qsizetype chartPoints = 0;
+            for (int i = 0; i < repeat; ++i) {
+                wall.start();
+                // Same steps as ShotComparisonModel::alignDisplayShots()
+                QList<ResampleShot> batch = source.mid(0, shots);
+                for (ResampleShot& shot : batch) {
+                    shot.offset = CurveResampler::firstDripTime(shot.curves[3], shot.curves[1]);
+                }
+                const ResampleGrid grid = ResampleGrid::covering(batch, GRID_STEP);
+                const QVector<float> rows = CurveResampler::resampleShots(batch, grid);
+                chartPoints = 0;
+                for (int row = 0; row < shots * 4; ++row) {
+                    chartPoints += CurveResampler::toPoints(rows.constData() + row * grid.count, grid).size();
+                }
+                const double ms = wall.nsecsElapsed() / 1e6;
+                totalMs += ms;
+                worstMs = qMax(worstMs, ms);
+                gridPoints = rows.size();
+            }
+
+            const bool failed = shots == WINDOW_SHOTS && worstMs > FRAME_BUDGET_MS;
+            overBudget = overBudget || failed;
+            fprintf(stderr, "de1sim: %2d shot(s) x %4.0f min, %8lld grid / %8lld chart points, mean %7.3f ms, "
+                            "worst %7.3f ms (%.1f ns/point, budget %.1f ms)%s\n",
+                    shots, minutes, static_cast<long long>(gridPoints), static_cast<long long>(chartPoints),
+                    totalMs / repeat, worstMs, gridPoints > 0 ? totalMs * 1e6 / repeat / gridPoints : 0.0,
+                    FRAME_BUDGET_MS, failed ? " [over budget]" : (worstMs > FRAME_BUDGET_MS ? " [over frame]" : ""));
+        }
+    }
+    return overBudget ? 2 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("de1sim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless fixed-step DE1 shot simulator");
+    parser.addHelpOption();
+    parser.addPositionalArgument("profile", "Profile file (.json or .tcl)");
+    QCommandLineOption seedOption("seed", "Noise seed (0 = random per shot).", "n", "1");
+    QCommandLineOption doseOption("dose", "Dose in grams.", "g", "18");
+    QCommandLineOption grindOption("grind", "Grind setting.", "setting");
+    QCommandLineOption dtOption("dt", "Simulation step in seconds.", "s", "0.1");
+    QCommandLineOption repeatOption("repeat", "Number of shots to run.", "n", "1");
+    QCommandLineOption quietOption("quiet", "Don't write samples, only the summary.");
+    QCommandLineOption verboseOption("verbose", "Show simulator debug output.");
+    QCommandLineOption parseBenchOption("parse-bench", "Time the Tcl profile parser over .tcl files or directories.");
+    QCommandLineOption parseFuzzOption("parse-fuzz", "Fuzz the Tcl tokenizer with mutated .tcl files (--repeat = iterations).");
+    QCommandLineOption predictBenchOption("predict-bench", "Time the offline shot preview for the profile.");
+    QCommandLineOption monteCarloOption("monte-carlo", "Run the robustness analysis with n randomized shots.", "n");
+    QCommandLineOption clockCheckOption("clock-check", "Check DE1 clock alignment against synthetic BLE jitter (--repeat = minutes).");
+    QCommandLineOption resampleBenchOption("resample-bench", "Time comparison resampling of long shots against the frame budget.");
+    QCommandLineOption scaleBenchOption("scale-bench", "Time every scale driver's notification parsing.");
+    QCommandLineOption scaleFuzzOption("scale-fuzz", "Replay mutated scale notifications through every driver (--repeat = iterations).");
+    parser.addOptions({seedOption, doseOption, grindOption, dtOption, repeatOption, quietOption, verboseOption,
+                       parseBenchOption, parseFuzzOption, predictBenchOption, monteCarloOption, clockCheckOption,
+                       resampleBenchOption, scaleBenchOption, scaleFuzzOption});
+    parser.process(app);
+
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("*.debug=false");
+    }
+
+    // --repeat, with a per-mode default
+    auto repeatOr = [&parser, &repeatOption](int fallback) {
+        return parser.isSet(repeatOption) ? qMax(1, parser.value(repeatOption).toInt()) : fallback;
+    };
+
+    if (parser.isSet(clockCheckOption)) {
+        return runClockCheck(parser.value(seedOption).toUInt(), repeatOr(30));
+    }
+
+    if (parser.isSet(resampleBenchOption)) {
+        return runResampleBench(parser.value(seedOption).toUInt(), repeatOr(50));
+    }
+
+    if (parser.isSet(scaleBenchOption) || parser.isSet(scaleFuzzOption)) {
+        const QStringList corpus = parser.positionalArguments();
+        if (corpus.size() > 1) {
+            parser.showHelp(1);
+        }
+        const QString corpusDir = corpus.value(0);
+        if (parser.isSet(scaleBenchOption)) {
+            return ScaleReplay::bench(corpusDir, repeatOr(100000));
+        }
+        return ScaleReplay::fuzz(corpusDir, parser.value(seedOption).toUInt(), repeatOr(100000));
+    }
+
+    const QStringList args = parser.positionalArguments();
+    const bool parseBench = parser.isSet(parseBenchOption);
+    const bool parseFuzz = parser.isSet(parseFuzzOption);
+    if (args.isEmpty() || (!parseBench && !parseFuzz && args.size() != 1)) {
+        parser.showHelp(1);
+    }
+
+    if (parseFuzz) {
+        return runParseFuzz(args, parser.value(seedOption).toUInt(), repeatOr(100000));
+    }
+
+    if (parseBench) {
+        return runParseBench(args, qMax(1, parser.value(repeatOption).toInt()));
+    }
+
+    const QString path = args.first();
+    Profile profile = path.endsWith(".tcl", Qt::CaseInsensitive)
+        ? Profile::loadFromTclFile(path)
+        : Profile::loadFromFile(path);
+    if (profile.steps().isEmpty()) {
+        fprintf(stderr, "de1sim: no frames in profile %s\n", qPrintable(path));
+        return 1;
+    }
+
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+    if (parser.isSet(predictBenchOption)) {
+        return runPredictBench(profile, repeat, parser.value(doseOption).toDouble(),
+                               ShotPhysics::grindFactorFor(parser.value(grindOption)));
+    }
+
+    if (parser.isSet(monteCarloOption)) {
+        RobustnessAnalysis::Options options;
+        options.runs = qMax(1, parser.value(monteCarloOption).toInt());
+        options.dose = parser.value(doseOption).toDouble();
+        options.grindFactor = ShotPhysics::grindFactorFor(parser.value(grindOption));
+        options.seed = parser.value(seedOption).toUInt();
+        if (parser.isSet(dtOption)) {
+            options.dt = parser.value(dtOption).toDouble();
+        }
+        return runMonteCarlo(profile, options);
+    }
+
+    const double dt = parser.value(dtOption).toDouble();
+    const bool quiet = parser.isSet(quietOption);
+    if (dt <= 0) {
+        fprintf(stderr, "de1sim: --dt must be positive\n");
+        return 1;
+    }
+
+    DE1Simulator simulator;
+    simulator.setHeadless(true);
+    simulator.setNoiseSeed(parser.value(seedOption).toUInt());
+    simulator.setProfile(profile);
+    simulator.setDose(parser.value(doseOption).toDouble());
+    if (parser.isSet(grindOption)) {
+        simulator.setGrindSetting(parser.value(grindOption));
+    }
+
+    QTextStream out(stdout);
+    double weight = 0.0;
+    qint64 sampleCount = 0;
+    int shot = 0;
+
+    QObject::connect(&simulator, &DE1Simulator::scaleWeightChanged, [&weight](double w) { weight = w; });
+    QObject::connect(&simulator, &DE1Simulator::shotSampleReceived, [&](const ShotSample& s) {
+        sampleCount++;
+        if (quiet) return;
+        out << shot << ',' << s.timestamp << ',' << s.timer << ',' << s.groupPressure << ','
+            << s.groupFlow << ',' << s.mixTemp << ',' << s.headTemp << ',' << s.setPressureGoal << ','
+            << s.setFlowGoal << ',' << s.setTempGoal << ',' << s.frameNumber << ',' << weight << '\n';
+    });
+
+    if (!quiet) {
+        out << "shot,timestamp,timer,pressure,flow,mixTemp,headTemp,"
+               "setPressure,setFlow,setTemp,frame,weight\n";
+    }
+
+    QElapsedTimer wall;
+    wall.start();
+    double simulated = 0.0;
+    bool timedOut = false;
+
+    for (shot = 0; shot < repeat; ++shot) {
+        weight = 0.0;
+        simulator.startEspresso();
+        if (!simulator.runToCompletion(dt)) {
+            timedOut = true;
+            simulator.stop();
+        }
+        simulated += simulator.elapsed();
+    }
+    out.flush();
+
+    double wallSec = wall.nsecsElapsed() / 1e9;
+    fprintf(stderr, "de1sim: %d shot(s), %lld samples, %.1f s simulated in %.3f s (%.0fx real time)%s\n",
+            repeat, static_cast<long long>(sampleCount), simulated, wallSec,
+            wallSec > 0 ? simulated / wallSec : 0.0, timedOut ? " [timed out]" : "");
+    return timedOut ? 2 : 0;
+}
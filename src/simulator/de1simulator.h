@@ -2,8 +2,7 @@
 
 #include <QObject>
 #include <QTimer>
-#include <QElapsedTimer>
-#include <array>
+#include "shotphysics.h"
 #include "../ble/protocol/de1characteristics.h"
 #include "../ble/de1device.h"
 #include "../profile/profile.h"
@@ -11,18 +10,14 @@
 /**
  * DE1Simulator - Simulates DE1 espresso machine behavior
  *
- * Physics model based on research from:
- * - Coffee ad Astra: Puck resistance studies (R² ∝ Flow² / ΔP)
- * - Darcy's law for flow through porous media
- * - Thermal mass modeling for group head
- * - Perlin noise for natural-looking variations
+ * Machine state machine (sleep/idle/espresso/steam/water) and BLE-style
+ * ShotSample stream around ShotPhysics, which models the shot itself.
  *
- * Realistic behaviors:
- * - Puck swelling during saturation (resistance increases)
- * - Oil extraction causing resistance decline
- * - Micro-channeling events
- * - Pump response lag and system inertia
- * - Thermal lag from group head mass
+ * Physics runs on simulated time only: advance(dt) steps the model by a fixed
+ * interval. In the app a 100ms QTimer calls advance() in real time; headless
+ * runs (see de1simcli.cpp) call it in a tight loop, producing the same
+ * ShotSample stream as fast as the CPU allows. With a fixed noise seed the
+ * stream is fully reproducible.
  */
 class DE1Simulator : public QObject {
     Q_OBJECT
@@ -42,6 +37,23 @@ public:
     void setDose(double grams);
     void setGrindSetting(const QString& setting);
 
+    // Headless: no QTimer, sample timestamps come from simulated time
+    void setHeadless(bool headless) { m_headless = headless; }
+    bool isHeadless() const { return m_headless; }
+
+    // Noise seed for Perlin/channeling noise. 0 = new random seed per shot.
+    void setNoiseSeed(quint32 seed) { m_fixedSeed = seed; }
+    quint32 noiseSeed() const { return m_physics.seed(); }
+
+    // Step the simulation by dt seconds of simulated time
+    void advance(double dt);
+
+    // Step until the current operation stops or maxSeconds of simulated time pass.
+    // Returns true if the operation finished on its own.
+    bool runToCompletion(double dt = TICK_INTERVAL_MS / 1000.0, double maxSeconds = 600.0);
+
+    double elapsed() const { return m_elapsed; }
+
 public slots:
     // Machine control (called from GHC buttons or app)
     void startEspresso();
@@ -67,146 +79,30 @@ private:
     void startOperation(DE1::State state);
     void stopOperation();
 
-    // Profile execution
-    void executeFrame();
-    void executeEnding(double dt);
-    bool checkExitCondition(const ProfileFrame& frame);
-    void advanceToNextFrame();
-
-    // Physics simulation
-    double simulatePuckResistance(double timeInShot, double totalWaterThrough);
-    double calculateFlow(double pressure, double resistance);
-    double calculatePressure(double flow, double resistance);
-
-    // Noise generation for realistic variations
-    double perlinNoise1D(double x);              // Smooth coherent noise
-    double fractalNoise(double x, int octaves);  // Multi-frequency noise
-    double channelNoise(double time);            // Micro-channeling events
-    void initNoisePermutation();                 // Initialize noise tables
+    void advanceEspresso(double dt);
 
     // State
     bool m_running = false;
     DE1::State m_state = DE1::State::Sleep;
     DE1::SubState m_subState = DE1::SubState::Ready;
 
-    // Profile
+    // Shot model
+    ShotPhysics m_physics;
     Profile m_profile;
-    int m_currentFrameIndex = 0;
-    double m_frameStartTime = 0.0;
-    double m_frameVolume = 0.0;
+    int m_lastFrameIndex = 0;
+    uint32_t m_fixedSeed = 0;
 
-    // Dose and grind affect puck resistance
-    double m_dose = 18.0;        // grams of coffee (default 18g)
-    double m_grindFactor = 1.0;  // finer grind = higher factor = more resistance
-
-    // Timing
+    // Timing (simulated seconds - never read from the wall clock)
     QTimer m_tickTimer;
-    QElapsedTimer m_shotTimer;
-    QElapsedTimer m_operationTimer;
+    double m_elapsed = 0.0;           // Since operation start
+    double m_nextSampleTime = 0.0;
+    bool m_headless = false;
     static constexpr int TICK_INTERVAL_MS = 100;  // 10Hz simulation, send samples at 5Hz
+    static constexpr double SAMPLE_INTERVAL = 0.2;
 
-    // Simulated machine state - actual values
+    // Steam and hot water (espresso values come from m_physics)
     double m_pressure = 0.0;
     double m_flow = 0.0;
-    double m_groupTemp = 93.0;   // Start preheated (machine must be hot to start shot)
-    double m_mixTemp = 91.5;     // Slightly lower than group temp
     double m_steamTemp = 140.0;
-
-    // System dynamics - for smooth ramping
-    double m_pressureVelocity = 0.0;  // Rate of pressure change (for inertia)
-    double m_flowVelocity = 0.0;      // Rate of flow change
-    double m_targetPressure = 0.0;    // What we're ramping toward
-    double m_targetFlow = 0.0;
-
-    // Volume tracking
-    double m_totalVolume = 0.0;     // Total water into puck
-    double m_outputVolume = 0.0;    // Water that has exited puck (yield)
-    double m_scaleWeight = 0.0;     // Simulated scale reading
-
-    // Valve and plumbing state
-    bool m_valveOpen = false;           // Group head valve (closed during preheat)
-    double m_plumbingVolume = 0.0;      // Water accumulated in hoses during preheat
-    double m_plumbingPressure = 0.0;    // Pressure built up in plumbing
-
-    // Puck physics state
-    double m_puckResistance = 4.0;
-    double m_baseResistance = 4.0;  // Resistance before noise
-    bool m_waterInPuck = false;
-    bool m_puckFilled = false;
-
-    // Channeling simulation
-    double m_channelIntensity = 0.0;  // Current channeling level (0-1)
-    double m_lastChannelTime = 0.0;   // When last channel event started
-
-    // Ending phase tracking
-    double m_endingStartTime = 0.0;   // When ending phase began
-
-    // Noise permutation table (for Perlin noise)
-    std::array<int, 512> m_perm;
-    uint32_t m_noiseSeed = 0;
-
-    // ============ Physics Constants ============
-    // Based on research from Coffee ad Astra, Barista Hustle, and espresso physics papers
-
-    // Timing
-    static constexpr double PREHEAT_DURATION = 5.0;       // Seconds valve stays closed (builds pressure)
-
-    // Plumbing model (valve closed during preheat)
-    // Water compresses in hoses, building pressure before valve opens
-    static constexpr double PLUMBING_COMPLIANCE = 0.15;   // ml/bar - how much volume per bar of pressure
-    static constexpr double PREHEAT_PUMP_FLOW = 2.5;      // ml/s pump rate during preheat
-
-    // Puck resistance model (Darcy's law based)
-    // Lower resistance for easier flow simulation
-    // R = k * P / Q - lower values = more flow at same pressure
-    static constexpr double REFERENCE_DOSE = 18.0;        // Grams - baseline for resistance calc
-    static constexpr double REFERENCE_GRIND = 25.0;       // Grind setting where factor = 1.0
-    static constexpr double BASELINE_RESISTANCE = 2.5;    // Fresh dry puck at reference dose/grind
-    static constexpr double PEAK_RESISTANCE = 3.5;        // After coffee swells (~40% increase)
-    static constexpr double MIN_RESISTANCE = 0.0;         // No minimum - test mode
-    static constexpr double PUCK_FILL_VOLUME = 8.0;       // ml to saturate puck before dripping
-
-    // Resistance dynamics
-    static constexpr double SWELLING_TIME = 5.0;          // Seconds for puck to fully swell
-    static constexpr double DEGRADATION_RATE = 0.004;     // Resistance drop per ml water
-
-    // Thermal model (75g steel group head)
-    static constexpr double TEMP_RISE_RATE = 6.0;         // °C/s during preheat (with water flowing)
-    static constexpr double TEMP_FALL_RATE = 0.3;         // °C/s cooling (thermal mass limits this)
-    static constexpr double TEMP_APPROACH_RATE = 0.08;    // Exponential approach factor
-
-    // System dynamics (pump, hoses, puck compression)
-    static constexpr double PRESSURE_INERTIA = 0.4;       // Seconds to reach 63% of target
-    static constexpr double FLOW_INERTIA = 0.3;           // Flow responds slightly faster
-    static constexpr double MAX_PRESSURE = 12.0;          // DE1 pump maximum
-    static constexpr double MAX_FLOW = 8.0;               // Vibration pump limit (ml/s)
-
-    // Darcy's law constant: Flow = k * Pressure / Resistance
-    static constexpr double DARCY_K = 1.8;
-
-    // Yield curve (output vs input)
-    static constexpr double DRIP_START_EFFICIENCY = 0.4;  // Initial output/input ratio
-    static constexpr double DRIP_MAX_EFFICIENCY = 0.92;   // Maximum efficiency
-    static constexpr double EFFICIENCY_RAMP_ML = 25.0;    // ml output to reach max efficiency
-
-    // Noise characteristics - subtle for well-prepared puck
-    static constexpr double NOISE_PRESSURE_AMP = 0.08;    // ±0.08 bar random variation
-    static constexpr double NOISE_FLOW_AMP = 0.04;        // ±0.04 ml/s random variation
-    static constexpr double NOISE_RESISTANCE_AMP = 0.03;  // ±3% resistance variation
-
-    // Channeling disabled - simulates a well-prepared puck
-    static constexpr double CHANNEL_PROBABILITY = 0.0;    // No channeling events
-    static constexpr double CHANNEL_DURATION = 1.5;       // (unused when probability is 0)
-    static constexpr double CHANNEL_RESISTANCE_DROP = 0.15; // (unused when probability is 0)
-
-    // Scale simulation
-    static constexpr double COFFEE_DENSITY = 1.03;        // g/ml (dissolved solids increase density)
-    static constexpr double SCALE_NOISE_AMP = 0.05;       // ±0.05g scale jitter
-
-    // Ending phase - pressure decay through puck
-    static constexpr double HEADSPACE_VOLUME = 12.0;      // ml of water above puck under pressure
-    static constexpr double MIN_ENDING_PRESSURE = 0.15;   // Pressure threshold to end simulation
-    static constexpr double MAX_ENDING_TIME = 10.0;       // Safety timeout for ending phase (seconds)
-
-    int m_tickCount = 0;  // For 5Hz sample output
+    double m_outputVolume = 0.0;
 };
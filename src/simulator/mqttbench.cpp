@@ -0,0 +1,228 @@
+#include "mqttbench.h"
+#include "mqttbrokerstandin.h"
+#include "../network/mqttclient.h"
+#include "../core/settings.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSet>
+#include <QThread>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+namespace {
+
+constexpr int CONNECT_TIMEOUT_MS = 10000;
+constexpr int DRAIN_TIMEOUT_MS = 90000;   // First reconnect attempt is 5 s after the drop
+constexpr int PACE_MS = 10;               // Outage traffic: 1 event + 4 telemetry every 10 ms
+constexpr int TELEMETRY_PER_TICK = 4;
+constexpr int RESTART_EVENTS = 50;
+
+bool spinUntil(const std::function<bool()>& done, int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!done()) {
+        if (timer.elapsed() > timeoutMs) return false;
+        QCoreApplication::processEvents(QEventLoop::AllEvents);
+        QThread::yieldCurrentThread();
+    }
+    return true;
+}
+
+// What the broker received, by sequence number
+struct Tally
+{
+    QSet<int> events;
+    QSet<int> telemetry;
+    int duplicates = 0;  // Events received more than once (QoS 1 resends after a drop)
+
+    int missingEvents(int from, int to) const
+    {
+        int missing = 0;
+        for (int i = from; i < to; ++i) {
+            if (!events.contains(i)) missing++;
+        }
+        return missing;
+    }
+
+    int telemetryIn(int from, int to) const
+    {
+        int count = 0;
+        for (int i = from; i < to; ++i) {
+            if (telemetry.contains(i)) count++;
+        }
+        return count;
+    }
+};
+
+}  // namespace
+
+int MqttBench::run(int messages)
+{
+    MqttBrokerStandIn broker;
+    if (!broker.start()) {
+        fprintf(stderr, "de1harness: can't listen on localhost\n");
+        return 1;
+    }
+    const quint16 port = broker.port();
+
+    Settings settings;
+    settings.setMqttBrokerHost("127.0.0.1");
+    settings.setMqttBrokerPort(port);
+    settings.setMqttBaseTopic("de1harness");
+    settings.setMqttHomeAssistantDiscovery(false);
+    settings.setMqttJsonState(false);
+    settings.setMqttShotStream(false);
+    settings.setMqttPersistQueue(true);
+    settings.setMqttEnabled(true);
+    QFile::remove(MqttClient::spoolPath());
+
+    Tally tally;
+    QObject::connect(&broker, &MqttBrokerStandIn::published, [&tally](const QByteArray& topic, const QByteArray& payload) {
+        if (topic.endsWith("/bench/event")) {
+            const int sequence = payload.toInt();
+            if (tally.events.contains(sequence)) {
+                tally.duplicates++;
+            } else {
+                tally.events.insert(sequence);
+            }
+        } else if (topic.endsWith("/bench/telemetry")) {
+            tally.telemetry.insert(payload.toInt());
+        }
+    });
+
+    auto client = std::make_unique<MqttClient>(nullptr, nullptr, &settings);
+    client->connectToBroker();
+    if (!spinUntil([&] { return client->isConnected(); }, CONNECT_TIMEOUT_MS)) {
+        fprintf(stderr, "de1harness: no connection to the broker stand-in: %s\n", qPrintable(client->status()));
+        return 2;
+    }
+
+    int nextEvent = 0;
+    int nextTelemetry = 0;
+    int failures = 0;
+
+    // Steady state: keep the reliable ring half full, one telemetry message per event
+    {
+        QElapsedTimer wall;
+        wall.start();
+        const int droppedBefore = client->droppedMessages();
+        while (nextEvent < messages) {
+            if (client->queueDepth() < MqttClient::RELIABLE_QUEUE_SIZE / 2) {
+                client->publishRaw("bench/event", QString::number(nextEvent++), true);
+                client->publishRaw("bench/telemetry", QString::number(nextTelemetry++), false);
+            } else {
+                QCoreApplication::processEvents(QEventLoop::AllEvents);
+            }
+        }
+        const bool drained = spinUntil([&] { return tally.missingEvents(0, nextEvent) == 0; }, DRAIN_TIMEOUT_MS);
+        const double sec = wall.nsecsElapsed() / 1e9;
+        const int lost = tally.missingEvents(0, nextEvent);
+        fprintf(stdout, "steady   %6d events in %6.2f s (%7.0f acknowledged/s), telemetry %d/%d delivered, "
+                        "%d dropped by the ring, %d lost%s\n",
+                nextEvent, sec, sec > 0 ? nextEvent / sec : 0.0, tally.telemetryIn(0, nextTelemetry), nextTelemetry,
+                client->droppedMessages() - droppedBefore, lost, drained ? "" : " [timed out]");
+        if (!drained || lost > 0) failures++;
+    }
+
+    // Publish at a fixed pace for ms milliseconds
+    auto paced = [&](int ms) {
+        QElapsedTimer timer;
+        timer.start();
+        qint64 due = 0;
+        while (timer.elapsed() < ms) {
+            if (timer.elapsed() >= due) {
+                client->publishRaw("bench/event", QString::number(nextEvent++), true);
+                for (int i = 0; i < TELEMETRY_PER_TICK; ++i) {
+                    client->publishRaw("bench/telemetry", QString::number(nextTelemetry++), false);
+                }
+                due += PACE_MS;
+            }
+            QCoreApplication::processEvents(QEventLoop::AllEvents);
+        }
+    };
+
+    // Outage: the broker drops everyone mid-stream and is back 3 s later
+    {
+        const int firstEvent = nextEvent;
+        const int firstTelemetry = nextTelemetry;
+        const int droppedBefore = client->droppedMessages();
+        tally.duplicates = 0;
+
+        paced(1000);
+        broker.stop();
+        QElapsedTimer down;
+        down.start();
+        const bool noticed = spinUntil([&] { return !client->isConnected(); }, CONNECT_TIMEOUT_MS);
+
+        // More events than the reliable ring holds: the oldest go to the spool
+        for (int i = 0; i < MqttClient::RELIABLE_QUEUE_SIZE + 100; ++i) {
+            client->publishRaw("bench/event", QString::number(nextEvent++), true);
+        }
+        const int spooled = client->spooledMessages();
+        paced(qMax<qint64>(0, 3000 - down.elapsed()));
+
+        if (!broker.start(port)) {
+            fprintf(stderr, "de1harness: can't listen on port %u again\n", port);
+            return 1;
+        }
+        int attempts = 0;  // Reset to 0 once connected, so sample it while waiting
+        const bool reconnected = spinUntil([&] {
+            attempts = qMax(attempts, client->reconnectAttempts());
+            return client->isConnected();
+        }, DRAIN_TIMEOUT_MS);
+        const double reconnectSec = down.nsecsElapsed() / 1e9;
+        const bool drained = spinUntil([&] {
+            return tally.missingEvents(firstEvent, nextEvent) == 0 && client->queueDepth() == 0;
+        }, DRAIN_TIMEOUT_MS);
+        const double drainSec = down.nsecsElapsed() / 1e9 - reconnectSec;
+
+        const int lost = tally.missingEvents(firstEvent, nextEvent);
+        fprintf(stdout, "outage   %6d events, %d lost, %d duplicate(s), %d spooled to disk; telemetry %d/%d delivered, "
+                        "%d dropped by the ring; reconnected %.1f s after the drop (attempt %d), drained in %.2f s%s\n",
+                nextEvent - firstEvent, lost, tally.duplicates, spooled,
+                tally.telemetryIn(firstTelemetry, nextTelemetry), nextTelemetry - firstTelemetry,
+                client->droppedMessages() - droppedBefore, reconnectSec, attempts, drainSec, noticed && reconnected && drained ? "" : " [timed out]");
+        if (!noticed || !reconnected || !drained || lost > 0) failures++;
+    }
+
+    // Restart: events queued while offline outlive the client
+    {
+        broker.stop();
+        const bool noticed = spinUntil([&] { return !client->isConnected(); }, CONNECT_TIMEOUT_MS);
+
+        const int firstEvent = nextEvent;
+        for (int i = 0; i < RESTART_EVENTS; ++i) {
+            client->publishRaw("bench/event", QString::number(nextEvent++), true);
+        }
+        client.reset();  // Destructor spills the queue
+        const qint64 spoolBytes = QFile(MqttClient::spoolPath()).size();
+
+        if (!broker.start(port)) {
+            fprintf(stderr, "de1harness: can't listen on port %u again\n", port);
+            return 1;
+        }
+        QElapsedTimer wall;
+        wall.start();
+        client = std::make_unique<MqttClient>(nullptr, nullptr, &settings);
+        client->connectToBroker();
+        const bool drained = spinUntil([&] { return tally.missingEvents(firstEvent, nextEvent) == 0; },
+                                       DRAIN_TIMEOUT_MS);
+
+        const int lost = tally.missingEvents(firstEvent, nextEvent);
+        fprintf(stdout, "restart  %6d events through a %lld byte spool, %d lost, delivered %.2f s after restart%s\n",
+                RESTART_EVENTS, static_cast<long long>(spoolBytes), lost, wall.nsecsElapsed() / 1e9,
+                noticed && drained ? "" : " [timed out]");
+        if (!noticed || !drained || lost > 0 || spoolBytes == 0) failures++;
+    }
+
+    client.reset();
+    broker.stop();
+    QFile::remove(MqttClient::spoolPath());
+
+    fprintf(stderr, "de1harness: %d broker connection(s), %s\n", broker.connectionsAccepted(),
+            failures > 0 ? "FAILED" : "no events lost");
+    return failures > 0 ? 2 : 0;
+}
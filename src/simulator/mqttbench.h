@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QString>
+
+class MqttClient;
+
+/**
+ * MqttBench - MqttClient's outbound queue against MqttBrokerStandIn
+ *
+ * Three phases, each publishing numbered QoS 1 events and QoS 0 telemetry
+ * through MqttClient::publishRaw() and counting what the broker received:
+ *
+ *   steady   sustained throughput with the broker up, publishing as fast as
+ *            the reliable ring drains
+ *   outage   the broker drops every connection mid-stream and comes back a
+ *            few seconds later; meanwhile events overflow the reliable ring
+ *            into mqtt_queue.dat and telemetry overwrites its ring. Covers
+ *            requeueing of in-flight Paho tokens and the reconnect backoff.
+ *   restart  events queued while the broker is down survive destroying the
+ *            client (spool written in the destructor, read by the next one)
+ *
+ * Every event must arrive at least once; telemetry loss is reported, not
+ * checked. The caller turns on QStandardPaths test mode first, so the spool
+ * and settings never touch the user's files.
+ */
+class MqttBench
+{
+public:
+    // Returns 0, 1 if the broker can't listen, or 2 if an event was lost or a phase timed out
+    static int run(int messages);
+};
@@ -0,0 +1,217 @@
+#include "mqttbrokerstandin.h"
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+namespace {
+
+// Control packet types (high nibble of the fixed header)
+enum PacketType : quint8 {
+    CONNECT = 1,
+    CONNACK = 2,
+    PUBLISH = 3,
+    PUBACK = 4,
+    PUBREC = 5,
+    PUBREL = 6,
+    PUBCOMP = 7,
+    SUBSCRIBE = 8,
+    SUBACK = 9,
+    UNSUBSCRIBE = 10,
+    UNSUBACK = 11,
+    PINGREQ = 12,
+    PINGRESP = 13,
+    DISCONNECT = 14
+};
+
+quint16 readUint16(const QByteArray& data, qsizetype offset)
+{
+    return static_cast<quint16>((static_cast<quint8>(data[offset]) << 8) | static_cast<quint8>(data[offset + 1]));
+}
+
+QByteArray packet(quint8 header, const QByteArray& body)
+{
+    QByteArray out;
+    out.append(static_cast<char>(header));
+    qsizetype length = body.size();
+    do {
+        quint8 digit = length % 128;
+        length /= 128;
+        if (length > 0) digit |= 0x80;
+        out.append(static_cast<char>(digit));
+    } while (length > 0);
+    out.append(body);
+    return out;
+}
+
+QByteArray packetId(quint16 id)
+{
+    QByteArray out;
+    out.append(static_cast<char>(id >> 8));
+    out.append(static_cast<char>(id & 0xFF));
+    return out;
+}
+
+}  // namespace
+
+MqttBrokerStandIn::MqttBrokerStandIn(QObject* parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MqttBrokerStandIn::onNewConnection);
+}
+
+bool MqttBrokerStandIn::start(quint16 port)
+{
+    if (m_server->isListening()) return true;
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        return false;
+    }
+    m_port = m_server->serverPort();
+    return true;
+}
+
+void MqttBrokerStandIn::stop()
+{
+    m_server->close();
+
+    // No DISCONNECT, no FIN handshake wait: the client sees the connection drop
+    const QList<QTcpSocket*> sockets = m_buffers.keys();
+    m_buffers.clear();
+    for (QTcpSocket* socket : sockets) {
+        socket->abort();
+        socket->deleteLater();
+    }
+}
+
+bool MqttBrokerStandIn::isRunning() const
+{
+    return m_server->isListening();
+}
+
+void MqttBrokerStandIn::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            if (m_buffers.remove(socket) > 0) {
+                socket->deleteLater();
+            }
+        });
+    }
+}
+
+void MqttBrokerStandIn::onReadyRead(QTcpSocket* socket)
+{
+    auto it = m_buffers.find(socket);
+    if (it == m_buffers.end()) return;
+    it->append(socket->readAll());
+
+    for (;;) {
+        QByteArray& buffer = m_buffers[socket];
+
+        // Fixed header: type/flags byte, then 1-4 bytes of remaining length
+        if (buffer.size() < 2) return;
+        qsizetype length = 0;
+        qsizetype offset = 1;
+        int shift = 0;
+        for (;;) {
+            if (offset >= buffer.size()) return;
+            if (offset > 4) {
+                socket->abort();
+                return;
+            }
+            const quint8 digit = static_cast<quint8>(buffer[offset++]);
+            length |= static_cast<qsizetype>(digit & 0x7F) << shift;
+            shift += 7;
+            if (!(digit & 0x80)) break;
+        }
+        if (buffer.size() < offset + length) return;
+
+        const quint8 header = static_cast<quint8>(buffer[0]);
+        const QByteArray body = buffer.mid(offset, length);
+        buffer.remove(0, offset + length);
+
+        if (!handlePacket(socket, header, body)) {
+            m_buffers.remove(socket);
+            socket->disconnectFromHost();
+            socket->deleteLater();
+            return;
+        }
+    }
+}
+
+bool MqttBrokerStandIn::handlePacket(QTcpSocket* socket, quint8 header, const QByteArray& body)
+{
+    switch (header >> 4) {
+    case CONNECT:
+        // Accept anyone; no session is kept, so session present is always 0
+        m_connects++;
+        socket->write(packet(CONNACK << 4, QByteArray("\x00\x00", 2)));
+        return true;
+
+    case PUBLISH: {
+        Publish publish;
+        publish.qos = (header >> 1) & 0x03;
+        publish.retained = header & 0x01;
+        publish.duplicate = header & 0x08;
+        if (body.size() < 2) return false;
+        const quint16 topicLength = readUint16(body, 0);
+        qsizetype offset = 2 + topicLength;
+        if (body.size() < offset + (publish.qos > 0 ? 2 : 0)) return false;
+        publish.topic = body.mid(2, topicLength);
+
+        quint16 id = 0;
+        if (publish.qos > 0) {
+            id = readUint16(body, offset);
+            offset += 2;
+        }
+        publish.payload = body.mid(offset);
+        m_publishes.append(publish);
+        emit published(publish.topic, publish.payload);
+
+        if (publish.qos == 1) {
+            socket->write(packet(PUBACK << 4, packetId(id)));
+        } else if (publish.qos == 2) {
+            socket->write(packet(PUBREC << 4, packetId(id)));
+        }
+        return true;
+    }
+
+    case PUBREL:
+        if (body.size() < 2) return false;
+        socket->write(packet(PUBCOMP << 4, body.left(2)));
+        return true;
+
+    case SUBSCRIBE: {
+        // Grant each filter at the requested QoS, capped at 1
+        if (body.size() < 2) return false;
+        QByteArray ack = body.left(2);
+        qsizetype offset = 2;
+        while (offset + 2 <= body.size()) {
+            offset += 2 + readUint16(body, offset);
+            if (offset >= body.size()) return false;
+            ack.append(static_cast<char>(qMin<int>(static_cast<quint8>(body[offset]), 1)));
+            offset++;
+        }
+        socket->write(packet(SUBACK << 4, ack));
+        return true;
+    }
+
+    case UNSUBSCRIBE:
+        if (body.size() < 2) return false;
+        socket->write(packet(UNSUBACK << 4, body.left(2)));
+        return true;
+
+    case PINGREQ:
+        socket->write(packet(PINGRESP << 4, QByteArray()));
+        return true;
+
+    case DISCONNECT:
+        return false;
+
+    default:
+        // PUBACK/PUBREC/PUBCOMP only matter when the broker delivers, which it doesn't
+        return true;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+class QTcpServer;
+class QTcpSocket;
+
+/**
+ * MqttBrokerStandIn - Just enough of an MQTT 3.1.1 broker for MqttClient
+ *
+ * Listens on localhost and answers CONNECT, PUBLISH (QoS 0, 1 and 2),
+ * SUBSCRIBE, UNSUBSCRIBE, PINGREQ and DISCONNECT. Nothing is routed to
+ * subscribers; every PUBLISH is recorded, duplicates included, so a harness
+ * can count what arrived. stop() is a broker outage: the listener closes and
+ * every client connection is aborted without a DISCONNECT. start() again on
+ * the same port brings the broker back.
+ */
+class MqttBrokerStandIn : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Publish
+    {
+        QByteArray topic;
+        QByteArray payload;
+        int qos = 0;
+        bool retained = false;
+        bool duplicate = false;  // DUP flag: a resend of an unacknowledged QoS 1/2 message
+    };
+
+    explicit MqttBrokerStandIn(QObject* parent = nullptr);
+
+    bool start(quint16 port = 0);  // 0 picks a free port
+    void stop();
+    bool isRunning() const;
+    quint16 port() const { return m_port; }
+
+    int connectionsAccepted() const { return m_connects; }
+    const QList<Publish>& publishes() const { return m_publishes; }
+    void clearPublishes() { m_publishes.clear(); }
+
+signals:
+    void published(const QByteArray& topic, const QByteArray& payload);
+
+private:
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    bool handlePacket(QTcpSocket* socket, quint8 header, const QByteArray& body);  // false closes the connection
+
+    QTcpServer* m_server = nullptr;
+    QHash<QTcpSocket*, QByteArray> m_buffers;  // Unparsed bytes per connection
+    QList<Publish> m_publishes;
+    quint16 m_port = 0;
+    int m_connects = 0;
+};
@@ -0,0 +1,183 @@
+#include "ollamastandin.h"
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+namespace {
+
+QByteArray reasonPhrase(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    default: return "Error";
+    }
+}
+
+QByteArray jsonLine(const QJsonObject& object)
+{
+    return QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+}
+
+}  // namespace
+
+OllamaStandIn::OllamaStandIn(QObject* parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_models({"model-a", "model-b"})
+{
+    connect(m_server, &QTcpServer::newConnection, this, &OllamaStandIn::onNewConnection);
+}
+
+bool OllamaStandIn::start(quint16 port)
+{
+    if (m_server->isListening()) return true;
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        return false;
+    }
+    m_port = m_server->serverPort();
+    return true;
+}
+
+void OllamaStandIn::stop()
+{
+    m_server->close();
+
+    const QList<QTcpSocket*> sockets = m_buffers.keys();
+    m_buffers.clear();
+    for (QTcpSocket* socket : sockets) {
+        socket->abort();
+        socket->deleteLater();
+    }
+}
+
+QString OllamaStandIn::endpoint() const
+{
+    return QString("http://127.0.0.1:%1").arg(m_port);
+}
+
+QString OllamaStandIn::replyText(int n, const QString& model)
+{
+    return QString("Grind one step finer and keep the dose. (reply %1 from %2)").arg(n).arg(model);
+}
+
+void OllamaStandIn::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            if (m_buffers.remove(socket) > 0) {
+                socket->deleteLater();
+            }
+        });
+    }
+}
+
+void OllamaStandIn::onReadyRead(QTcpSocket* socket)
+{
+    auto it = m_buffers.find(socket);
+    if (it == m_buffers.end()) return;
+    it->append(socket->readAll());
+
+    // Request line and headers, then Content-Length bytes of body
+    const QByteArray& buffer = *it;
+    const qsizetype headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) return;
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() < 2) {
+        respond(socket, 400, "text/plain", "bad request line\n");
+        return;
+    }
+
+    qsizetype contentLength = 0;
+    for (qsizetype i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines[i].trimmed();
+        if (line.toLower().startsWith("content-length:")) {
+            contentLength = line.mid(15).trimmed().toLongLong();
+        }
+    }
+    if (buffer.size() < headerEnd + 4 + contentLength) return;
+
+    const QByteArray body = buffer.mid(headerEnd + 4, contentLength);
+    handleRequest(socket, requestLine[0], requestLine[1], body);
+}
+
+void OllamaStandIn::handleRequest(QTcpSocket* socket, const QByteArray& method, const QByteArray& path,
+                                  const QByteArray& body)
+{
+    if (method == "GET" && path == "/api/tags") {
+        QJsonArray models;
+        for (const QString& name : m_models) {
+            QJsonObject model;
+            model["name"] = name;
+            models.append(model);
+        }
+        QJsonObject reply;
+        reply["models"] = models;
+        respond(socket, 200, "application/json", QJsonDocument(reply).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    if (method != "POST" || path != "/api/generate") {
+        respond(socket, 404, "text/plain", "404 page not found");
+        return;
+    }
+
+    const QJsonObject request = QJsonDocument::fromJson(body).object();
+    GenerateRequest generate;
+    generate.model = request["model"].toString();
+    generate.system = request["system"].toString();
+    generate.prompt = request["prompt"].toString();
+    generate.stream = request["stream"].toBool();
+    m_generates.append(generate);
+    emit generateRequested(generate.model);
+
+    if (!m_models.contains(generate.model)) {
+        QJsonObject error;
+        error["error"] = QString("model \"%1\" not found, try pulling it first").arg(generate.model);
+        respond(socket, 404, "application/json", QJsonDocument(error).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    // Streamed like Ollama: a word per line, then the done marker
+    QByteArray stream;
+    const QStringList words = replyText(m_generates.size(), generate.model).split(' ');
+    const qsizetype sent = m_cutOff ? words.size() / 2 : words.size();
+    for (qsizetype i = 0; i < sent; ++i) {
+        QJsonObject chunk;
+        chunk["model"] = generate.model;
+        chunk["response"] = i + 1 < words.size() ? words[i] + ' ' : words[i];
+        chunk["done"] = false;
+        stream += jsonLine(chunk);
+    }
+    if (!m_cutOff) {
+        QJsonObject done;
+        done["model"] = generate.model;
+        done["response"] = QString();
+        done["done"] = true;
+        stream += jsonLine(done);
+    }
+
+    respond(socket, 200, "application/x-ndjson", stream);
+}
+
+void OllamaStandIn::respond(QTcpSocket* socket, int status, const QByteArray& contentType, const QByteArray& body)
+{
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reasonPhrase(status) + "\r\n";
+    response += "Content-Type: " + contentType + "\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+
+    // Deleted on disconnected: deleting now would abort the unsent reply
+    m_buffers[socket].clear();
+    socket->write(response);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+class QTcpServer;
+class QTcpSocket;
+
+/**
+ * OllamaStandIn - Just enough of Ollama's HTTP API for OllamaProvider
+ *
+ * Listens on localhost and answers GET /api/tags with the configured models
+ * and POST /api/generate with a streamed reply: one JSON object per line
+ * carrying a word of "response", then a final {"done": true}. The reply text
+ * names the request number and model ("... (reply 3 from model-a)"), so a
+ * harness can tell which request a recommendation came from. A model that
+ * isn't listed gets Ollama's 404 {"error": "..."} body. With setCutOff() the
+ * reply stops halfway, without the done line, as if the connection dropped.
+ * Every generate request is recorded; one request per connection
+ * (Connection: close).
+ */
+class OllamaStandIn : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct GenerateRequest
+    {
+        QString model;
+        QString system;
+        QString prompt;
+        bool stream = false;
+    };
+
+    explicit OllamaStandIn(QObject* parent = nullptr);
+
+    bool start(quint16 port = 0);  // 0 picks a free port
+    void stop();
+    quint16 port() const { return m_port; }
+    QString endpoint() const;      // http://127.0.0.1:<port>
+
+    void setModels(const QStringList& models) { m_models = models; }
+    void setCutOff(bool cutOff) { m_cutOff = cutOff; }
+
+    int generateRequests() const { return m_generates.size(); }
+    const QList<GenerateRequest>& generates() const { return m_generates; }
+
+    // Text a generate request for model gets as request number n (1-based)
+    static QString replyText(int n, const QString& model);
+
+signals:
+    void generateRequested(const QString& model);
+
+private:
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    void handleRequest(QTcpSocket* socket, const QByteArray& method, const QByteArray& path, const QByteArray& body);
+    void respond(QTcpSocket* socket, int status, const QByteArray& contentType, const QByteArray& body);
+
+    QTcpServer* m_server = nullptr;
+    QHash<QTcpSocket*, QByteArray> m_buffers;  // Unparsed bytes per connection
+    QStringList m_models;
+    QList<GenerateRequest> m_generates;
+    quint16 m_port = 0;
+    bool m_cutOff = false;
+};
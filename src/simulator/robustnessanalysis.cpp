@@ -0,0 +1,157 @@
+#include "robustnessanalysis.h"
+#include "shotphysics.h"
+#include <QRandomGenerator>
+#include <QThreadPool>
+#include <QThread>
+#include <QtMath>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double MAX_SHOT_SECONDS = 600.0;
+
+RobustnessAnalysis::Distribution distributionOf(std::vector<double> values)
+{
+    RobustnessAnalysis::Distribution d;
+    d.count = static_cast<int>(values.size());
+    if (values.empty()) {
+        return d;
+    }
+
+    std::sort(values.begin(), values.end());
+    auto percentile = [&values](double p) {
+        // Linear interpolation between closest ranks
+        double rank = p * (values.size() - 1);
+        size_t lower = static_cast<size_t>(rank);
+        size_t upper = qMin(lower + 1, values.size() - 1);
+        return values[lower] + (values[upper] - values[lower]) * (rank - lower);
+    };
+
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    d.mean = sum / values.size();
+
+    double sq = 0.0;
+    for (double v : values) sq += (v - d.mean) * (v - d.mean);
+    d.stddev = values.size() > 1 ? qSqrt(sq / (values.size() - 1)) : 0.0;
+
+    d.min = values.front();
+    d.p10 = percentile(0.10);
+    d.median = percentile(0.50);
+    d.p90 = percentile(0.90);
+    d.max = values.back();
+    return d;
+}
+
+QVariantMap toVariantMap(const RobustnessAnalysis::Distribution& d)
+{
+    QVariantMap map;
+    map["count"] = d.count;
+    map["mean"] = d.mean;
+    map["stddev"] = d.stddev;
+    map["min"] = d.min;
+    map["p10"] = d.p10;
+    map["median"] = d.median;
+    map["p90"] = d.p90;
+    map["max"] = d.max;
+    return map;
+}
+
+} // namespace
+
+RobustnessAnalysis::Report RobustnessAnalysis::analyze(const Profile& profile, const Options& options)
+{
+    Report report;
+    report.runs = qMax(0, options.runs);
+    report.targetWeight = options.targetWeight > 0 ? options.targetWeight : profile.targetWeight();
+    if (report.runs == 0 || profile.steps().isEmpty() || options.dt <= 0) {
+        return report;
+    }
+
+    // One slot per run, written by exactly one worker
+    std::vector<double> shotTimes(report.runs);
+    std::vector<double> yieldTimes(report.runs);
+    std::vector<double> peakPressures(report.runs);
+    std::vector<char> timedOut(report.runs);
+
+    const double target = report.targetWeight;
+    const double dt = options.dt;
+
+    auto runRange = [&](int begin, int end) {
+        ShotPhysics physics;
+        physics.setProfile(profile);
+        physics.setChannelRate(options.channelRate);
+
+        for (int run = begin; run < end; ++run) {
+            // Inputs depend only on the run index, not on which thread runs it
+            QRandomGenerator rng(options.seed * 0x9E3779B1u + static_cast<quint32>(run));
+            std::normal_distribution<double> doseDist(options.dose, options.doseSpread);
+            std::normal_distribution<double> grindDist(1.0, options.grindSpread);
+            physics.setDose(doseDist(rng));
+            physics.setGrindFactor(options.grindFactor * grindDist(rng));
+            physics.reset(rng.generate() | 1u);  // Never 0 (= random seed)
+
+            double peak = 0.0;
+            double yieldTime = -1.0;
+            while (physics.phase() != ShotPhysics::Phase::Done && physics.elapsed() < MAX_SHOT_SECONDS) {
+                physics.step(dt);
+                peak = qMax(peak, physics.pressure());
+                if (yieldTime < 0 && target > 0 && physics.scaleWeight() >= target) {
+                    yieldTime = physics.elapsed();
+                }
+            }
+
+            // Times from the start of frame 0, like the shot graph (preheat excluded);
+            // coffee only drips once the valve has opened
+            const double start = physics.extractionStartTime() >= 0 ? physics.extractionStartTime()
+                                                                     : physics.elapsed();
+            shotTimes[run] = physics.elapsed() - start;
+            yieldTimes[run] = yieldTime >= 0 ? yieldTime - start : -1.0;
+            peakPressures[run] = peak;
+            timedOut[run] = physics.phase() != ShotPhysics::Phase::Done;
+        }
+    };
+
+    QThreadPool pool;
+    const int workers = qBound(1, QThread::idealThreadCount(), report.runs);
+    pool.setMaxThreadCount(workers);
+    const int chunk = (report.runs + workers - 1) / workers;
+    for (int begin = 0; begin < report.runs; begin += chunk) {
+        const int end = qMin(begin + chunk, report.runs);
+        pool.start([&runRange, begin, end]() { runRange(begin, end); });
+    }
+    pool.waitForDone();
+
+    std::vector<double> reachedYield;
+    reachedYield.reserve(report.runs);
+    for (int run = 0; run < report.runs; ++run) {
+        if (yieldTimes[run] >= 0) {
+            reachedYield.push_back(yieldTimes[run]);
+        } else {
+            report.yieldMissed++;
+        }
+        if (timedOut[run]) {
+            report.timedOut++;
+        }
+    }
+
+    report.shotTime = distributionOf(std::move(shotTimes));
+    report.yieldTime = distributionOf(std::move(reachedYield));
+    report.peakPressure = distributionOf(std::move(peakPressures));
+    return report;
+}
+
+QVariantMap RobustnessAnalysis::toVariantMap(const Report& report)
+{
+    QVariantMap map;
+    map["runs"] = report.runs;
+    map["yieldMissed"] = report.yieldMissed;
+    map["timedOut"] = report.timedOut;
+    map["targetWeight"] = report.targetWeight;
+    map["shotTime"] = ::toVariantMap(report.shotTime);
+    map["yieldTime"] = ::toVariantMap(report.yieldTime);
+    map["peakPressure"] = ::toVariantMap(report.peakPressure);
+    return map;
+}
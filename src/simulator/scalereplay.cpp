@@ -0,0 +1,385 @@
+#include "scalereplay.h"
+#include "../ble/protocol/de1characteristics.h"
+#include "../ble/protocol/scalepacket.h"
+#include "../ble/transport/scalebletransport.h"
+#include "../ble/scales/decentscale.h"
+#include "../ble/scales/acaiascale.h"
+#include "../ble/scales/felicitascale.h"
+#include "../ble/scales/skalescale.h"
+#include "../ble/scales/hiroiascale.h"
+#include "../ble/scales/bookooscale.h"
+#include "../ble/scales/smartchefscale.h"
+#include "../ble/scales/difluidscale.h"
+#include "../ble/scales/eurekaprecisascale.h"
+#include "../ble/scales/solobaristascale.h"
+#include "../ble/scales/atomhearteclairscale.h"
+#include "../ble/scales/variaakuscale.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Never connects; the harness emits characteristicChanged() on it
+class ReplayTransport : public ScaleBleTransport
+{
+public:
+    using ScaleBleTransport::connectToDevice;
+    void connectToDevice(const QString&, const QString&) override {}
+    void disconnectFromDevice() override {}
+    void discoverServices() override {}
+    void discoverCharacteristics(const QBluetoothUuid&) override {}
+    void enableNotifications(const QBluetoothUuid&, const QBluetoothUuid&) override {}
+    void writeCharacteristic(const QBluetoothUuid&, const QBluetoothUuid&, const QByteArray&, WriteType) override {}
+    void readCharacteristic(const QBluetoothUuid&, const QBluetoothUuid&) override {}
+    bool isConnected() const override { return true; }
+};
+
+struct Notification
+{
+    int characteristic = 0;  // Index into ScaleSpec::characteristics
+    QByteArray bytes;
+};
+
+struct ScaleSpec
+{
+    const char* type;  // Corpus file name without .txt
+    std::function<ScaleDevice*(ScaleBleTransport*)> create;
+    QList<QBluetoothUuid> characteristics;  // Notifications the driver parses; captures go to the first
+    QList<Notification> packets;
+};
+
+QList<Notification> hexPackets(std::initializer_list<const char*> hex, int characteristic = 0)
+{
+    QList<Notification> packets;
+    for (const char* h : hex) {
+        packets.append(Notification{characteristic, QByteArray::fromHex(h)});
+    }
+    return packets;
+}
+
+// Reference notifications in each protocol's wire format (weights around 18 g)
+QList<ScaleSpec> scaleSpecs()
+{
+    QList<ScaleSpec> specs;
+
+    specs.append(ScaleSpec{"decent", [](ScaleBleTransport* t) { return new DecentScale(t); },
+                  {Scale::Decent::READ},
+                  hexPackets({"03CE00B4000079", "03CA00B500007C", "03CEFFF60000C4", "03AA01000000A8"})});
+
+    // IPS framing: EF DD type len event payload checksum; also split and batched messages
+    specs.append(ScaleSpec{"acaia", [](ScaleBleTransport* t) { return new AcaiaScale(t); },
+                  {Scale::AcaiaIPS::CHARACTERISTIC},
+                  hexPackets({"EFDD0C0805080700000200170F",
+                              "EFDD0C0B0B000000080700000200170F",
+                              "EFDD0C08050807",
+                              "00000200170F",
+                              "EFDD0C0805090700000201180FEFDD0C08050A0700000200190F",
+                              "EFDD070302000000"})});
+
+    specs.append(ScaleSpec{"felicita", [](ScaleBleTransport* t) { return new FelicitaScale(t); },
+                  {Scale::Felicita::CHARACTERISTIC},
+                  hexPackets({"01022B303031383030206720202020A0", "01022D303030303132206720202020A0",
+                              "01022B303031383030"})});
+
+    QList<Notification> skalePackets = hexPackets({"03B400", "034CFF"});
+    skalePackets.append(hexPackets({"01", "02"}, 1));
+    specs.append(ScaleSpec{"skale", [](ScaleBleTransport* t) { return new SkaleScale(t); },
+                  {Scale::Skale::WEIGHT, Scale::Skale::BUTTON}, skalePackets});
+
+    specs.append(ScaleSpec{"hiroia", [](ScaleBleTransport* t) { return new HiroiaScale(t); },
+                  {Scale::HiroiaJimmy::STATUS},
+                  hexPackets({"01000000B4000000", "01000000B40000", "01000000F5FFFF00"})});
+
+    specs.append(ScaleSpec{"bookoo", [](ScaleBleTransport* t) { return new BookooScale(t); },
+                  {Scale::Bookoo::STATUS},
+                  hexPackets({"030B0001F4002B000708000000000000000000F1", "030B0003E8002D00000A000000000000000000E3"})});
+
+    specs.append(ScaleSpec{"smartchef", [](ScaleBleTransport* t) { return new SmartChefScale(t); },
+                  {Scale::Generic::STATUS},
+                  hexPackets({"AA0000000000B4", "AA0000140000B4"})});
+
+    specs.append(ScaleSpec{"difluid", [](ScaleBleTransport* t) { return new DifluidScale(t); },
+                  {Scale::DiFluid::CHARACTERISTIC},
+                  hexPackets({"DFDF010000000000B40000000000000000000000", "DFDF0100000000FFFF0000000000000000000000"})});
+
+    specs.append(ScaleSpec{"eureka_precisa", [](ScaleBleTransport* t) { return new EurekaPrecisaScale(t); },
+                  {Scale::Generic::STATUS},
+                  hexPackets({"AA094100000000B400", "AA0941010101001400", "BB094100000000B400"})});
+
+    specs.append(ScaleSpec{"solo_barista", [](ScaleBleTransport* t) { return new SoloBarristaScale(t); },
+                  {Scale::Generic::STATUS},
+                  hexPackets({"AA094100000000B400"})});
+
+    // 'W', int32 mg, uint32 timer, XOR of the bytes between
+    specs.append(ScaleSpec{"atomheart_eclair", [](ScaleBleTransport* t) { return new AtomheartEclairScale(t); },
+                  {Scale::AtomheartEclair::STATUS},
+                  hexPackets({"57504600000000000016", "57504600001027000021"})});
+
+    specs.append(ScaleSpec{"varia_aku", [](ScaleBleTransport* t) { return new VariaAkuScale(t); },
+                  {Scale::VariaAku::STATUS},
+                  hexPackets({"FA0103000708FF", "FA0103100708EF", "FA850164E0"})});
+
+    return specs;
+}
+
+// Appends captures from corpusDir/<type>.txt; false if a file is unreadable
+bool loadCaptures(const QString& corpusDir, QList<ScaleSpec>& specs)
+{
+    if (corpusDir.isEmpty()) return true;
+
+    for (ScaleSpec& spec : specs) {
+        QFile file(QDir(corpusDir).filePath(QString::fromLatin1(spec.type) + ".txt"));
+        if (!file.exists()) continue;
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            fprintf(stderr, "de1sim: can't read %s\n", qPrintable(file.fileName()));
+            return false;
+        }
+        while (!file.atEnd()) {
+            QByteArray line = file.readLine().trimmed();
+            if (line.isEmpty() || line.startsWith('#')) continue;
+            spec.packets.append(Notification{0, QByteArray::fromHex(line)});
+        }
+    }
+    return true;
+}
+
+struct ScaleUnderTest
+{
+    ReplayTransport* transport = nullptr;  // Owned by scale
+    std::unique_ptr<ScaleDevice> scale;
+};
+
+ScaleUnderTest createScale(const ScaleSpec& spec)
+{
+    ScaleUnderTest t;
+    t.transport = new ReplayTransport;
+    t.scale.reset(spec.create(t.transport));
+    return t;
+}
+
+// Emits a copy of bytes in an exactly sized heap block, so ASan flags any read past the end
+void deliver(ScaleUnderTest& t, const QBluetoothUuid& characteristic, const char* data, qsizetype size)
+{
+    std::unique_ptr<char[]> block(new char[size > 0 ? size : 1]);
+    if (size > 0) {
+        std::memcpy(block.get(), data, size);
+    }
+    emit t.transport->characteristicChanged(characteristic, QByteArray::fromRawData(block.get(), size));
+}
+
+QByteArray randomBytes(QRandomGenerator& rng, int count)
+{
+    QByteArray bytes(count, Qt::Uninitialized);
+    for (int i = 0; i < count; ++i) {
+        bytes[i] = static_cast<char>(rng.bounded(256));
+    }
+    return bytes;
+}
+
+QByteArray mutate(const ScaleSpec& spec, QByteArray bytes, QRandomGenerator& rng)
+{
+    // Header and boundary bytes the protocols branch on
+    static const char INTERESTING[] = {'\x00', '\x01', '\x7F', '\x80', '\xFF', '\xEF', '\xDD', '\x0C',
+                                       '\x05', '\x0B', '\xAA', '\x57', '+', '-', ' ', '9'};
+
+    switch (rng.bounded(8)) {
+    case 0:  // Bit flips
+        for (int i = rng.bounded(1, 5); i > 0 && !bytes.isEmpty(); --i) {
+            bytes[rng.bounded(static_cast<int>(bytes.size()))] ^= static_cast<char>(1 << rng.bounded(8));
+        }
+        break;
+    case 1:  // Interesting values
+        for (int i = rng.bounded(1, 4); i > 0 && !bytes.isEmpty(); --i) {
+            bytes[rng.bounded(static_cast<int>(bytes.size()))] = INTERESTING[rng.bounded(static_cast<int>(sizeof(INTERESTING)))];
+        }
+        break;
+    case 2:  // Truncation
+        bytes.truncate(rng.bounded(static_cast<int>(bytes.size()) + 1));
+        break;
+    case 3:  // Random tail
+        bytes += randomBytes(rng, rng.bounded(1, 32));
+        break;
+    case 4:  // Two packets in one notification
+        bytes += spec.packets[rng.bounded(static_cast<int>(spec.packets.size()))].bytes;
+        break;
+    case 5:  // Repeated slice
+        if (!bytes.isEmpty()) {
+            int from = rng.bounded(static_cast<int>(bytes.size()));
+            bytes.insert(rng.bounded(static_cast<int>(bytes.size()) + 1), bytes.mid(from, rng.bounded(1, 16)));
+        }
+        break;
+    case 6:  // Noise, sometimes longer than any reassembly buffer
+        bytes = randomBytes(rng, rng.bounded(8) == 0 ? rng.bounded(600) : rng.bounded(64));
+        break;
+    default:  // Unmodified, so drivers also see valid frames between broken ones
+        break;
+    }
+    return bytes;
+}
+
+// Reference model of PacketReassembler: same operations on a deque
+bool fuzzReassembler(QRandomGenerator& rng, int iterations)
+{
+    static constexpr int CAPACITY = 64;  // Small, so the overflow paths run often
+    PacketReassembler<CAPACITY> ring;
+    std::deque<uint8_t> model;
+    std::array<uint8_t, 16> scratch;
+
+    for (int i = 0; i < iterations; ++i) {
+        switch (rng.bounded(4)) {
+        case 0: {
+            QByteArray bytes = randomBytes(rng, rng.bounded(8) == 0 ? rng.bounded(200) : rng.bounded(24));
+            // Headers often enough that syncTo() finds some
+            if (!bytes.isEmpty() && rng.bounded(2) == 0) bytes[rng.bounded(static_cast<int>(bytes.size()))] = '\xEF';
+            if (bytes.size() > 1 && rng.bounded(2) == 0) bytes[rng.bounded(static_cast<int>(bytes.size()))] = '\xDD';
+
+            std::unique_ptr<uint8_t[]> block(new uint8_t[bytes.isEmpty() ? 1 : bytes.size()]);
+            if (!bytes.isEmpty()) {
+                std::memcpy(block.get(), bytes.constData(), bytes.size());
+            }
+            ring.append(PacketView(block.get(), bytes.size()));
+
+            qsizetype from = bytes.size() > CAPACITY ? bytes.size() - CAPACITY : 0;
+            if (static_cast<qsizetype>(model.size()) + bytes.size() - from > CAPACITY) model.clear();
+            for (qsizetype j = from; j < bytes.size(); ++j) model.push_back(static_cast<uint8_t>(bytes[j]));
+            break;
+        }
+        case 1: {
+            bool aligned = ring.syncTo(0xEF, 0xDD);
+            size_t j = 0;
+            while (j + 1 < model.size() && !(model[j] == 0xEF && model[j + 1] == 0xDD)) ++j;
+            if (j + 1 >= model.size() && !(!model.empty() && model.back() == 0xEF)) {
+                model.clear();
+            } else {
+                model.erase(model.begin(), model.begin() + j);
+            }
+            if (aligned != (model.size() >= 2)) return false;
+            break;
+        }
+        case 2: {
+            int count = rng.bounded(40);
+            PacketView taken = ring.take(count, scratch);
+            int expected = qMin(qMin(count, static_cast<int>(model.size())), static_cast<int>(scratch.size()));
+            if (taken.size() != expected) return false;
+            for (int j = 0; j < expected; ++j) {
+                if (taken.u8(j) != model[j]) return false;
+            }
+            model.erase(model.begin(), model.begin() + qMin(count, static_cast<int>(model.size())));
+            break;
+        }
+        default: {
+            int count = rng.bounded(10);
+            ring.consume(count);
+            model.erase(model.begin(), model.begin() + qMin(count, static_cast<int>(model.size())));
+            break;
+        }
+        }
+
+        if (ring.size() != static_cast<int>(model.size()) || ring.size() > CAPACITY) return false;
+        for (int j = 0; j < ring.size(); ++j) {
+            if (ring.peek(j) != model[j]) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int ScaleReplay::bench(const QString& corpusDir, int repeat)
+{
+    QList<ScaleSpec> specs = scaleSpecs();
+    if (!loadCaptures(corpusDir, specs)) return 1;
+
+    QElapsedTimer wall;
+    for (const ScaleSpec& spec : specs) {
+        ScaleUnderTest t = createScale(spec);
+        wall.start();
+        for (int r = 0; r < repeat; ++r) {
+            for (const Notification& n : spec.packets) {
+                emit t.transport->characteristicChanged(spec.characteristics[n.characteristic], n.bytes);
+            }
+        }
+        const double ns = static_cast<double>(wall.nsecsElapsed());
+        const qint64 notifications = static_cast<qint64>(spec.packets.size()) * repeat;
+        fprintf(stdout, "%-18s %3d packet(s)  %8.1f ns/notification  weight %8.2f g\n",
+                spec.type, static_cast<int>(spec.packets.size()), notifications > 0 ? ns / notifications : 0.0,
+                t.scale->weight());
+    }
+
+    // Reassembly alone: 20-byte notifications carrying 13-byte frames
+    PacketReassembler<512> frames;
+    std::array<uint8_t, 260> scratch;
+    const QByteArray stream = QByteArray::fromHex("EFDD0C0805080700000200170F").repeated(20);
+    qint64 taken = 0;
+    wall.start();
+    for (int r = 0; r < repeat * 100; ++r) {
+        for (qsizetype offset = 0; offset < stream.size(); offset += 20) {
+            frames.append(PacketView(stream).mid(offset, 20));
+            while (frames.syncTo(0xEF, 0xDD) && frames.size() >= 5 && frames.size() >= 5 + frames.peek(3)) {
+                taken += frames.take(5 + frames.peek(3), scratch).size();
+            }
+        }
+    }
+    const double sec = wall.nsecsElapsed() / 1e9;
+    fprintf(stdout, "%-18s %lld bytes reassembled, %.0f MB/s\n", "PacketReassembler",
+            static_cast<long long>(taken), sec > 0 ? taken / 1e6 / sec : 0.0);
+    return 0;
+}
+
+int ScaleReplay::fuzz(const QString& corpusDir, quint32 seed, int iterations)
+{
+    QList<ScaleSpec> specs = scaleSpecs();
+    if (!loadCaptures(corpusDir, specs)) return 1;
+
+    QRandomGenerator rng(seed);
+    int failures = 0;
+    qint64 notifications = 0;
+
+    for (const ScaleSpec& spec : specs) {
+        ScaleUnderTest t = createScale(spec);
+        for (int i = 0; i < iterations; ++i) {
+            const Notification& base = spec.packets[rng.bounded(static_cast<int>(spec.packets.size()))];
+            const QByteArray bytes = mutate(spec, base.bytes, rng);
+            const QBluetoothUuid& characteristic = spec.characteristics[base.characteristic];
+
+            // Deliver whole or fragmented the way BLE may split a frame
+            const int fragments = rng.bounded(4) == 0 ? rng.bounded(2, 5) : 1;
+            qsizetype offset = 0;
+            for (int f = 0; f < fragments; ++f) {
+                qsizetype remaining = bytes.size() - offset;
+                qsizetype size = (f == fragments - 1) ? remaining
+                               : rng.bounded(static_cast<int>(remaining) + 1);
+                deliver(t, characteristic, bytes.constData() + offset, size);
+                offset += size;
+                notifications++;
+            }
+
+            if (!std::isfinite(t.scale->weight()) || !std::isfinite(t.scale->flowRate())) {
+                fprintf(stderr, "de1sim: %s: weight %f / flow %f after %s\n", spec.type, t.scale->weight(),
+                        t.scale->flowRate(), bytes.toHex().constData());
+                failures++;
+                break;
+            }
+        }
+    }
+
+    const bool reassemblerOk = fuzzReassembler(rng, iterations * 10);
+    if (!reassemblerOk) {
+        fprintf(stderr, "de1sim: PacketReassembler diverged from the reference model (seed %u)\n", seed);
+        failures++;
+    }
+
+    fprintf(stderr, "de1sim: fuzzed %d scale driver(s) with %lld notification(s), seed %u%s\n",
+            static_cast<int>(specs.size()), static_cast<long long>(notifications), seed,
+            failures > 0 ? " [failed]" : "");
+    return failures > 0 ? 2 : 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * ScaleReplay - Feeds scale notifications through the real scale drivers
+ *
+ * Each driver is constructed on a transport that never touches BLE, and
+ * notifications are emitted on it exactly as QtScaleBleTransport would, so the
+ * whole parse path (onCharacteristicChanged, PacketReassembler, PacketView,
+ * ScaleDevice::setWeight and the flow estimator) runs as in the app.
+ *
+ * The corpus is a set of reference packets per scale, built from the formats
+ * the drivers decode, plus any captures found in corpusDir: one file per scale
+ * type (e.g. acaia.txt), one notification per line as hex, '#' comments.
+ *
+ * bench() times each driver's parse path per notification. fuzz() replays
+ * mutated corpus packets (bit flips, truncation, random tails, fragmentation
+ * and concatenation, pure noise) and checks that the weight stays finite;
+ * every notification lives in an exactly sized heap block, so a build with
+ * -fsanitize=address reports any read past the end. It also exercises
+ * PacketReassembler directly with random appends, syncs and takes.
+ */
+class ScaleReplay {
+public:
+    // Returns 0, 1 on a corpus error
+    static int bench(const QString& corpusDir, int repeat);
+
+    // Returns 0, or 2 if an invariant failed
+    static int fuzz(const QString& corpusDir, quint32 seed, int iterations);
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <QList>
+#include <QPointF>
+#include <QRandomGenerator>
+#include <array>
+#include "../profile/profile.h"
+
+/**
+ * ShotPhysics - Espresso shot model shared by DE1Simulator and offline preview
+ *
+ * Physics model based on research from:
+ * - Coffee ad Astra: Puck resistance studies (R² ∝ Flow² / ΔP)
+ * - Darcy's law for flow through porous media
+ * - Thermal mass modeling for group head
+ * - Perlin noise for natural-looking variations
+ *
+ * Realistic behaviors:
+ * - Puck swelling during saturation (resistance increases)
+ * - Oil extraction causing resistance decline
+ * - Micro-channeling events
+ * - Pump response lag and system inertia
+ * - Thermal lag from group head mass
+ *
+ * A plain value class: no signals, timers or logging. step(dt) advances one
+ * espresso shot by a fixed interval of simulated time and never allocates, so
+ * a whole profile runs thousands of times faster than real time and instances
+ * can run on worker threads. DE1Simulator wraps it with the machine state
+ * machine and BLE-style samples; predict() runs a profile to completion and
+ * returns the curves, for showing a predicted shot while editing.
+ */
+class ShotPhysics {
+public:
+    enum class Phase { Heating, Stabilising, Preinfusion, Pouring, Ending, Done };
+
+    struct Prediction {
+        QList<QPointF> pressure;    // bar over extraction time (s, 0 = frame 0 begins)
+        QList<QPointF> flow;        // mL/s
+        QList<QPointF> weight;      // g
+        double shotTime = 0.0;      // From frame 0 until the pressure bled off
+        double peakPressure = 0.0;
+        double finalWeight = 0.0;
+        bool timedOut = false;
+    };
+
+    ShotPhysics();
+
+    void setProfile(const Profile& profile);
+    void setDose(double grams);                 // Clamped to 10-25 g
+    void setGrindFactor(double factor);         // Clamped to 0.5-3x resistance
+    void setChannelRate(double eventsPerSecond) { m_channelRate = eventsPerSecond; }
+    void setTemperatures(double groupTemp, double mixTemp);
+
+    double dose() const { return m_dose; }
+    double grindFactor() const { return m_grindFactor; }
+
+    // Grinder setting -> resistance factor (lower setting = finer = higher factor).
+    // Returns 1.0 when the setting isn't a positive number.
+    static double grindFactorFor(const QString& setting);
+
+    // Start a new shot. seed 0 picks a random noise seed.
+    void reset(quint32 seed);
+    quint32 seed() const { return m_seed; }
+
+    // Advance the shot by dt seconds of simulated time
+    Phase step(double dt);
+
+    Phase phase() const { return m_phase; }
+    double elapsed() const { return m_elapsed; }
+    // Elapsed time at which preheat ended and frame 0 began; negative until then
+    double extractionStartTime() const { return m_extractionStartTime; }
+    int frameIndex() const { return m_currentFrameIndex; }
+    double pressure() const { return m_pressure; }
+    double flow() const { return m_flow; }
+    double groupTemp() const { return m_groupTemp; }
+    double mixTemp() const { return m_mixTemp; }
+
+    // Scale reading (with scale noise); weightUpdated() is true when the last
+    // step produced a new reading (coffee is dripping)
+    double scaleWeight() const { return m_reportedWeight; }
+    bool weightUpdated() const { return m_weightUpdated; }
+
+    // Coherent noise in -1..1 from this shot's permutation table
+    double noise(double x, int octaves) const { return fractalNoise(x, octaves); }
+
+    // Run a whole shot, recording a point every sampleInterval seconds
+    static Prediction predict(const Profile& profile, double dose = 18.0, double grindFactor = 1.0,
+                              quint32 seed = 1, double dt = 0.05, double sampleInterval = 0.2,
+                              double maxSeconds = 600.0);
+
+    // ============ Physics Constants ============
+    // Based on research from Coffee ad Astra, Barista Hustle, and espresso physics papers
+
+    // Timing
+    static constexpr double PREHEAT_DURATION = 5.0;       // Seconds valve stays closed (builds pressure)
+
+    // Plumbing model (valve closed during preheat)
+    // Water compresses in hoses, building pressure before valve opens
+    static constexpr double PLUMBING_COMPLIANCE = 0.15;   // ml/bar - how much volume per bar of pressure
+    static constexpr double PREHEAT_PUMP_FLOW = 2.5;      // ml/s pump rate during preheat
+
+    // Puck resistance model (Darcy's law based)
+    // Lower resistance for easier flow simulation
+    // R = k * P / Q - lower values = more flow at same pressure
+    static constexpr double REFERENCE_DOSE = 18.0;        // Grams - baseline for resistance calc
+    static constexpr double REFERENCE_GRIND = 25.0;       // Grind setting where factor = 1.0
+    static constexpr double BASELINE_RESISTANCE = 2.5;    // Fresh dry puck at reference dose/grind
+    static constexpr double PEAK_RESISTANCE = 3.5;        // After coffee swells (~40% increase)
+    static constexpr double MIN_RESISTANCE = 0.0;         // No minimum - test mode
+    static constexpr double PUCK_FILL_VOLUME = 8.0;       // ml to saturate puck before dripping
+
+    // Resistance dynamics
+    static constexpr double SWELLING_TIME = 5.0;          // Seconds for puck to fully swell
+    static constexpr double DEGRADATION_RATE = 0.004;     // Resistance drop per ml water
+
+    // Thermal model (75g steel group head)
+    static constexpr double TEMP_RISE_RATE = 6.0;         // °C/s during preheat (with water flowing)
+    static constexpr double TEMP_FALL_RATE = 0.3;         // °C/s cooling (thermal mass limits this)
+    static constexpr double TEMP_APPROACH_RATE = 0.08;    // Exponential approach factor
+
+    // System dynamics (pump, hoses, puck compression)
+    static constexpr double PRESSURE_INERTIA = 0.4;       // Seconds to reach 63% of target
+    static constexpr double FLOW_INERTIA = 0.3;           // Flow responds slightly faster
+    static constexpr double MAX_PRESSURE = 12.0;          // DE1 pump maximum
+    static constexpr double MAX_FLOW = 8.0;               // Vibration pump limit (ml/s)
+
+    // Darcy's law constant: Flow = k * Pressure / Resistance
+    static constexpr double DARCY_K = 1.8;
+
+    // Yield curve (output vs input)
+    static constexpr double DRIP_START_EFFICIENCY = 0.4;  // Initial output/input ratio
+    static constexpr double DRIP_MAX_EFFICIENCY = 0.92;   // Maximum efficiency
+    static constexpr double EFFICIENCY_RAMP_ML = 25.0;    // ml output to reach max efficiency
+
+    // Noise characteristics - subtle for well-prepared puck
+    static constexpr double NOISE_PRESSURE_AMP = 0.08;    // ±0.08 bar random variation
+    static constexpr double NOISE_FLOW_AMP = 0.04;        // ±0.04 ml/s random variation
+    static constexpr double NOISE_RESISTANCE_AMP = 0.03;  // ±3% resistance variation
+
+    // Channeling disabled by default - simulates a well-prepared puck
+    static constexpr double CHANNEL_RATE = 0.0;           // Channel events per second of extraction
+    static constexpr double CHANNEL_DURATION = 1.5;       // Seconds to recover (intensity below 10%)
+    static constexpr double CHANNEL_RESISTANCE_DROP = 0.15;
+
+    // Scale simulation
+    static constexpr double COFFEE_DENSITY = 1.03;        // g/ml (dissolved solids increase density)
+    static constexpr double SCALE_NOISE_AMP = 0.05;       // ±0.05g scale jitter
+
+    // Ending phase - pressure decay through puck
+    static constexpr double HEADSPACE_VOLUME = 12.0;      // ml of water above puck under pressure
+    static constexpr double MIN_ENDING_PRESSURE = 0.15;   // Pressure threshold to end simulation
+    static constexpr double MAX_ENDING_TIME = 10.0;       // Safety timeout for ending phase (seconds)
+
+private:
+    void stepPreheat(double dt);
+    void stepFrame(double dt);
+    void stepEnding(double dt);
+    bool checkExitCondition(const ProfileFrame& frame) const;
+    void advanceToNextFrame();
+    void finish();
+
+    double simulatePuckResistance(double timeInExtraction, double totalWater) const;
+    static double calculateFlow(double pressure, double resistance);
+    static double calculatePressure(double flow, double resistance);
+
+    double perlinNoise1D(double x) const;              // Smooth coherent noise
+    double fractalNoise(double x, int octaves) const;  // Multi-frequency noise
+    double channelNoise(double time, double dt);       // Micro-channeling events
+    void initNoisePermutation();                       // Initialize noise tables
+
+    // Profile (implicitly shared, read-only during a shot)
+    QList<ProfileFrame> m_steps;
+    int m_preinfuseFrameCount = 0;
+    int m_currentFrameIndex = 0;
+    double m_frameStartTime = 0.0;
+    double m_frameVolume = 0.0;
+
+    // Dose and grind affect puck resistance
+    double m_dose = REFERENCE_DOSE;
+    double m_grindFactor = 1.0;
+    double m_channelRate = CHANNEL_RATE;
+
+    Phase m_phase = Phase::Done;
+    double m_elapsed = 0.0;
+    double m_extractionStartTime = -1.0;
+
+    // Simulated machine state - actual values
+    double m_pressure = 0.0;
+    double m_flow = 0.0;
+    double m_groupTemp = 93.0;   // Start preheated (machine must be hot to start shot)
+    double m_mixTemp = 91.5;     // Slightly lower than group temp
+
+    // System dynamics - for smooth ramping
+    double m_pressureVelocity = 0.0;  // Rate of pressure change (for inertia)
+    double m_flowVelocity = 0.0;      // Rate of flow change
+    double m_targetPressure = 0.0;    // What we're ramping toward
+    double m_targetFlow = 0.0;
+
+    // Volume tracking
+    double m_totalVolume = 0.0;     // Total water into puck
+    double m_outputVolume = 0.0;    // Water that has exited puck (yield)
+    double m_reportedWeight = 0.0;  // Scale reading including noise
+    bool m_weightUpdated = false;
+
+    // Plumbing state (valve closed during preheat)
+    double m_plumbingVolume = 0.0;      // Water accumulated in hoses during preheat
+    double m_plumbingPressure = 0.0;    // Pressure built up in plumbing
+
+    // Puck physics state
+    double m_puckResistance = BASELINE_RESISTANCE;
+    bool m_puckFilled = false;
+
+    // Channeling simulation
+    double m_channelIntensity = 0.0;  // Current channeling level (0-1)
+    double m_nextChannelTime = -1.0;  // Elapsed time of the next channel event, -1 = not drawn yet
+
+    // Ending phase tracking
+    double m_endingStartTime = 0.0;
+
+    // Noise permutation table (for Perlin noise)
+    std::array<int, 512> m_perm;
+    quint32 m_seed = 0;
+    QRandomGenerator m_rng;           // Channeling events, seeded from m_seed
+};